@@ -255,6 +255,10 @@ int sim_netdriver_init(void)
       dev->quota[NETPKT_RX] = 1;
       dev->ops              = &g_ops;
 
+      /* Reading the host device does not need the RX interrupt */
+
+      dev->features         = NETDEV_F_BUSYPOLL;
+
 #if CONFIG_SIM_WIFIDEV_NUMBER != 0
       if (devidx < CONFIG_SIM_WIFIDEV_NUMBER)
         {
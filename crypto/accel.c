@@ -0,0 +1,604 @@
+/****************************************************************************
+ * crypto/accel.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/* AES, GHASH and SHA-256 with the crypto instructions of x86_64 (AES-NI,
+ * PCLMULQDQ and SHA-NI) and ARMv8 (the Cryptographic Extension).  The
+ * instructions are only used after the CPU reports them, so one image
+ * still runs on CPUs without them.  Only inline assembly on generic
+ * vector types is used, no intrinsic headers or -m/-march flags are
+ * needed.
+ */
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <endian.h>
+#include <string.h>
+#include <strings.h>
+
+#include <crypto/gmac.h>
+
+#include "accel.h"
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#if !defined(__x86_64__) && !defined(__aarch64__)
+#  error "CONFIG_CRYPTO_ACCEL needs a x86_64 or arm64 target"
+#endif
+
+#ifdef __aarch64__
+/* Let the assembler accept the crypto instructions whatever -march is */
+
+#  define ACCEL_ASM(insn) \
+     ".arch_extension aes\n\t.arch_extension sha2\n\t" insn
+#endif
+
+/* Carry-less multiply the 64 bits halves a[imm & 1] and b[imm >> 4] */
+
+#ifdef __x86_64__
+#  define ACCEL_MUL64(r, a, b, imm) \
+     do \
+       { \
+         (r) = (a); \
+         __asm__("pclmulqdq %2, %1, %0" : "+x"(r) : "x"(b), "i"(imm)); \
+       } \
+     while (0)
+#else
+#  define ACCEL_MUL64(r, a, b, imm) \
+     do \
+       { \
+         v2u64_t x_ = accel_v2u64((a)[(imm) & 1], 0); \
+         v2u64_t y_ = accel_v2u64((b)[(imm) >> 4], 0); \
+         __asm__(ACCEL_ASM("pmull %0.1q, %1.1d, %2.1d") \
+                 : "=w"(r) : "w"(x_), "w"(y_)); \
+       } \
+     while (0)
+#endif
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+typedef uint64_t v2u64_t __attribute__((vector_size(16)));
+typedef uint32_t v4u32_t __attribute__((vector_size(16)));
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+static inline v2u64_t accel_v2u64(uint64_t e0, uint64_t e1);
+static inline v4u32_t accel_v4u32(uint32_t e0, uint32_t e1,
+                                  uint32_t e2, uint32_t e3);
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static const uint32_t g_accel_k256[64] =
+{
+  0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5,
+  0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+  0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3,
+  0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+  0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc,
+  0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+  0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7,
+  0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+  0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13,
+  0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+  0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3,
+  0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+  0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5,
+  0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+  0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208,
+  0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2
+};
+
+static unsigned int g_accel_features;
+static bool g_accel_probed;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: accel_probe
+ *
+ * Description:
+ *   Ask the CPU which crypto instructions it implements.
+ *
+ ****************************************************************************/
+
+static unsigned int accel_probe(void)
+{
+  unsigned int features = 0;
+
+#ifdef __x86_64__
+  uint32_t eax;
+  uint32_t ebx;
+  uint32_t ecx;
+  uint32_t edx;
+  uint32_t max;
+
+  __asm__ volatile("cpuid"
+                   : "=a"(max), "=b"(ebx), "=c"(ecx), "=d"(edx)
+                   : "a"(0), "c"(0));
+
+  __asm__ volatile("cpuid"
+                   : "=a"(eax), "=b"(ebx), "=c"(ecx), "=d"(edx)
+                   : "a"(1), "c"(0));
+
+  if (ecx & (1 << 25))
+    {
+      features |= ACCEL_AES;
+    }
+
+  if (ecx & (1 << 1))
+    {
+      features |= ACCEL_CLMUL;
+    }
+
+  if (max >= 7)
+    {
+      __asm__ volatile("cpuid"
+                       : "=a"(eax), "=b"(ebx), "=c"(ecx), "=d"(edx)
+                       : "a"(7), "c"(0));
+
+      if (ebx & (1 << 29))
+        {
+          features |= ACCEL_SHA256;
+        }
+    }
+#else
+  uint64_t isar0;
+
+  __asm__ volatile("mrs %0, id_aa64isar0_el1" : "=r"(isar0));
+
+  if (((isar0 >> 4) & 0xf) >= 1)
+    {
+      features |= ACCEL_AES;
+    }
+
+  if (((isar0 >> 4) & 0xf) >= 2)
+    {
+      features |= ACCEL_CLMUL;
+    }
+
+  if (((isar0 >> 12) & 0xf) >= 1)
+    {
+      features |= ACCEL_SHA256;
+    }
+#endif
+
+  return features;
+}
+
+/****************************************************************************
+ * Name: accel_v2u64/accel_v4u32
+ *
+ * Description:
+ *   Build a vector from its elements, element 0 being the lowest one.
+ *
+ ****************************************************************************/
+
+static inline v2u64_t accel_v2u64(uint64_t e0, uint64_t e1)
+{
+  v2u64_t v;
+
+  v[0] = e0;
+  v[1] = e1;
+  return v;
+}
+
+static inline v4u32_t accel_v4u32(uint32_t e0, uint32_t e1,
+                                  uint32_t e2, uint32_t e3)
+{
+  v4u32_t v;
+
+  v[0] = e0;
+  v[1] = e1;
+  v[2] = e2;
+  v[3] = e3;
+  return v;
+}
+
+/****************************************************************************
+ * Name: accel_load/accel_store
+ *
+ * Description:
+ *   Move a 16 bytes block between memory of any alignment and a register.
+ *
+ ****************************************************************************/
+
+static inline v2u64_t accel_load(FAR const uint8_t *src)
+{
+  v2u64_t v;
+
+  memcpy(&v, src, sizeof(v));
+  return v;
+}
+
+static inline void accel_store(FAR uint8_t *dst, v2u64_t v)
+{
+  memcpy(dst, &v, sizeof(v));
+}
+
+/****************************************************************************
+ * Name: accel_ghash_load/accel_ghash_store
+ *
+ * Description:
+ *   GHASH operates on the blocks as big endian 128 bits integers with the
+ *   bits reflected, carry-less multiply them byte reversed instead.
+ *
+ ****************************************************************************/
+
+static inline v2u64_t accel_ghash_load(FAR const uint8_t *src)
+{
+  uint64_t hi;
+  uint64_t lo;
+  v2u64_t v;
+
+  memcpy(&hi, src, sizeof(hi));
+  memcpy(&lo, src + 8, sizeof(lo));
+
+  v[0] = be64toh(lo);
+  v[1] = be64toh(hi);
+  return v;
+}
+
+static inline void accel_ghash_store(FAR uint8_t *dst, v2u64_t v)
+{
+  uint64_t hi = htobe64(v[1]);
+  uint64_t lo = htobe64(v[0]);
+
+  memcpy(dst, &hi, sizeof(hi));
+  memcpy(dst + 8, &lo, sizeof(lo));
+}
+
+/****************************************************************************
+ * Name: accel_gfmul
+ *
+ * Description:
+ *   Multiply two byte reversed elements of GF(2^128) and reduce the result
+ *   modulo the GCM polynomial x^128 + x^7 + x^2 + x + 1, as described in
+ *   the Intel "Carry-Less Multiplication and Its Usage for Computing the
+ *   GCM Mode" white paper.
+ *
+ ****************************************************************************/
+
+static v2u64_t accel_gfmul(v2u64_t a, v2u64_t b)
+{
+  v2u64_t lo;
+  v2u64_t hi;
+  v2u64_t mid;
+  v2u64_t tmp;
+  v4u32_t x;
+  v4u32_t y;
+  v4u32_t t1;
+  v4u32_t t2;
+  v4u32_t t3;
+
+  /* The 256 bits product hi:lo from the four 64 bits partial products */
+
+  ACCEL_MUL64(lo, a, b, 0x00);
+  ACCEL_MUL64(mid, a, b, 0x10);
+  ACCEL_MUL64(tmp, a, b, 0x01);
+  ACCEL_MUL64(hi, a, b, 0x11);
+
+  mid ^= tmp;
+  lo  ^= accel_v2u64(0, mid[0]);
+  hi  ^= accel_v2u64(mid[1], 0);
+
+  /* Shift the product left by one bit to undo the bit reflection */
+
+  x  = (v4u32_t)lo;
+  y  = (v4u32_t)hi;
+  t1 = x >> 31;
+  t2 = y >> 31;
+  x <<= 1;
+  y <<= 1;
+  x |= accel_v4u32(0, t1[0], t1[1], t1[2]);
+  y |= accel_v4u32(t1[3], t2[0], t2[1], t2[2]);
+
+  /* Reduce the low 128 bits into the high ones */
+
+  t1 = (x << 31) ^ (x << 30) ^ (x << 25);
+  t3 = accel_v4u32(t1[1], t1[2], t1[3], 0);
+  x ^= accel_v4u32(0, 0, 0, t1[0]);
+
+  t2 = (x >> 1) ^ (x >> 2) ^ (x >> 7) ^ t3;
+  x ^= t2;
+  y ^= x;
+
+  return (v2u64_t)y;
+}
+
+/****************************************************************************
+ * Name: accel_ghash_update
+ *
+ * Description:
+ *   The accelerated replacement of ghash_update_mi() in gmac.c.
+ *
+ ****************************************************************************/
+
+static void accel_ghash_update(FAR GHASH_CTX *ctx, FAR uint8_t *x,
+                               size_t len)
+{
+  v2u64_t h;
+  v2u64_t y;
+
+  if (len < GMAC_BLOCK_LEN)
+    {
+      bcopy(ctx->S, ctx->Z, GMAC_BLOCK_LEN);
+      return;
+    }
+
+  h = accel_ghash_load(ctx->H);
+  y = accel_ghash_load(ctx->Z);
+
+  for (; len >= GMAC_BLOCK_LEN; len -= GMAC_BLOCK_LEN)
+    {
+      y = accel_gfmul(y ^ accel_ghash_load(x), h);
+      x += GMAC_BLOCK_LEN;
+    }
+
+  accel_ghash_store(ctx->S, y);
+  accel_ghash_store(ctx->Z, y);
+}
+
+/****************************************************************************
+ * Name: accel_sha256_load
+ *
+ * Description:
+ *   Load four big endian message words.
+ *
+ ****************************************************************************/
+
+static inline v4u32_t accel_sha256_load(FAR const uint8_t *data)
+{
+  uint32_t w[4];
+
+  memcpy(w, data, sizeof(w));
+  return accel_v4u32(be32toh(w[0]), be32toh(w[1]),
+                     be32toh(w[2]), be32toh(w[3]));
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+unsigned int accel_features(void)
+{
+  if (!g_accel_probed)
+    {
+      g_accel_features = accel_probe();
+      g_accel_probed = true;
+    }
+
+  return g_accel_features;
+}
+
+void accel_initialize(void)
+{
+  if (accel_features() & ACCEL_CLMUL)
+    {
+      ghash_update = accel_ghash_update;
+    }
+}
+
+void accel_aes_invkey(FAR uint8_t *drk, FAR const uint8_t *rk,
+                      unsigned int rounds)
+{
+  v2u64_t k;
+  unsigned int i;
+
+  memcpy(drk, rk + 16 * rounds, 16);
+  for (i = 1; i < rounds; i++)
+    {
+      k = accel_load(rk + 16 * (rounds - i));
+#ifdef __x86_64__
+      __asm__("aesimc %1, %0" : "=x"(k) : "x"(k));
+#else
+      __asm__(ACCEL_ASM("aesimc %0.16b, %1.16b") : "=w"(k) : "w"(k));
+#endif
+      accel_store(drk + 16 * i, k);
+    }
+
+  memcpy(drk + 16 * rounds, rk, 16);
+}
+
+void accel_aes_encrypt(FAR const uint8_t *rk, unsigned int rounds,
+                       FAR const uint8_t *src, FAR uint8_t *dst,
+                       size_t nblocks)
+{
+  unsigned int i;
+  v2u64_t s;
+
+  for (; nblocks > 0; nblocks--, src += 16, dst += 16)
+    {
+      s = accel_load(src);
+#ifdef __x86_64__
+      s ^= accel_load(rk);
+      for (i = 1; i < rounds; i++)
+        {
+          __asm__("aesenc %1, %0" : "+x"(s) : "x"(accel_load(rk + 16 * i)));
+        }
+
+      __asm__("aesenclast %1, %0"
+              : "+x"(s) : "x"(accel_load(rk + 16 * rounds)));
+#else
+      for (i = 0; i < rounds - 1; i++)
+        {
+          __asm__(ACCEL_ASM("aese %0.16b, %1.16b\n\t"
+                            "aesmc %0.16b, %0.16b")
+                  : "+w"(s) : "w"(accel_load(rk + 16 * i)));
+        }
+
+      __asm__(ACCEL_ASM("aese %0.16b, %1.16b")
+              : "+w"(s) : "w"(accel_load(rk + 16 * i)));
+      s ^= accel_load(rk + 16 * rounds);
+#endif
+      accel_store(dst, s);
+    }
+}
+
+void accel_aes_decrypt(FAR const uint8_t *drk, unsigned int rounds,
+                       FAR const uint8_t *src, FAR uint8_t *dst,
+                       size_t nblocks)
+{
+  unsigned int i;
+  v2u64_t s;
+
+  for (; nblocks > 0; nblocks--, src += 16, dst += 16)
+    {
+      s = accel_load(src);
+#ifdef __x86_64__
+      s ^= accel_load(drk);
+      for (i = 1; i < rounds; i++)
+        {
+          __asm__("aesdec %1, %0" : "+x"(s) : "x"(accel_load(drk + 16 * i)));
+        }
+
+      __asm__("aesdeclast %1, %0"
+              : "+x"(s) : "x"(accel_load(drk + 16 * rounds)));
+#else
+      for (i = 0; i < rounds - 1; i++)
+        {
+          __asm__(ACCEL_ASM("aesd %0.16b, %1.16b\n\t"
+                            "aesimc %0.16b, %0.16b")
+                  : "+w"(s) : "w"(accel_load(drk + 16 * i)));
+        }
+
+      __asm__(ACCEL_ASM("aesd %0.16b, %1.16b")
+              : "+w"(s) : "w"(accel_load(drk + 16 * i)));
+      s ^= accel_load(drk + 16 * rounds);
+#endif
+      accel_store(dst, s);
+    }
+}
+
+void accel_sha256_transform(FAR uint32_t *state, FAR const uint8_t *data,
+                            size_t nblocks)
+{
+  v4u32_t w[4];
+  v4u32_t save0;
+  v4u32_t save1;
+  v4u32_t state0;
+  v4u32_t state1;
+  v4u32_t wk;
+#ifdef __x86_64__
+  register v4u32_t k __asm__("xmm0");
+#else
+  v4u32_t abcd;
+#endif
+  int i;
+
+#ifdef __x86_64__
+  /* SHA256RNDS2 keeps the working variables as ABEF and CDGH */
+
+  state0 = accel_v4u32(state[5], state[4], state[1], state[0]);
+  state1 = accel_v4u32(state[7], state[6], state[3], state[2]);
+#else
+  state0 = accel_v4u32(state[0], state[1], state[2], state[3]);
+  state1 = accel_v4u32(state[4], state[5], state[6], state[7]);
+#endif
+
+  for (; nblocks > 0; nblocks--, data += 64)
+    {
+      save0 = state0;
+      save1 = state1;
+
+      for (i = 0; i < 4; i++)
+        {
+          w[i] = accel_sha256_load(data + 16 * i);
+        }
+
+      /* 16 groups of 4 rounds, w[i & 3] holds the message words of group
+       * i and is then advanced to group i + 4.
+       */
+
+      for (i = 0; i < 16; i++)
+        {
+          FAR v4u32_t *w0 = &w[i & 3];
+          FAR v4u32_t *w1 = &w[(i + 1) & 3];
+          FAR v4u32_t *w2 = &w[(i + 2) & 3];
+          FAR v4u32_t *w3 = &w[(i + 3) & 3];
+
+          memcpy(&wk, &g_accel_k256[4 * i], sizeof(wk));
+          wk += *w0;
+
+#ifdef __x86_64__
+          /* SHA256RNDS2 takes the two round constants in xmm0 */
+
+          k = wk;
+          __asm__("sha256rnds2 %2, %1, %0"
+                  : "+x"(state1) : "x"(state0), "x"(k));
+
+          k = accel_v4u32(wk[2], wk[3], 0, 0);
+          __asm__("sha256rnds2 %2, %1, %0"
+                  : "+x"(state0) : "x"(state1), "x"(k));
+
+          if (i < 12)
+            {
+              __asm__("sha256msg1 %1, %0" : "+x"(*w0) : "x"(*w1));
+              *w0 += accel_v4u32((*w2)[1], (*w2)[2], (*w2)[3], (*w3)[0]);
+              __asm__("sha256msg2 %1, %0" : "+x"(*w0) : "x"(*w3));
+            }
+#else
+          if (i < 12)
+            {
+              __asm__(ACCEL_ASM("sha256su0 %0.4s, %1.4s\n\t"
+                                "sha256su1 %0.4s, %2.4s, %3.4s")
+                      : "+w"(*w0) : "w"(*w1), "w"(*w2), "w"(*w3));
+            }
+
+          abcd = state0;
+          __asm__(ACCEL_ASM("sha256h %q0, %q1, %2.4s")
+                  : "+w"(state0) : "w"(state1), "w"(wk));
+          __asm__(ACCEL_ASM("sha256h2 %q0, %q1, %2.4s")
+                  : "+w"(state1) : "w"(abcd), "w"(wk));
+#endif
+        }
+
+      state0 += save0;
+      state1 += save1;
+    }
+
+#ifdef __x86_64__
+  state[0] = state0[3];
+  state[1] = state0[2];
+  state[4] = state0[1];
+  state[5] = state0[0];
+  state[2] = state1[3];
+  state[3] = state1[2];
+  state[6] = state1[1];
+  state[7] = state1[0];
+#else
+  memcpy(state, &state0, 16);
+  memcpy(state + 4, &state1, 16);
+#endif
+}
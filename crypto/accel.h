@@ -0,0 +1,115 @@
+/****************************************************************************
+ * crypto/accel.h
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+#ifndef __CRYPTO_ACCEL_H
+#define __CRYPTO_ACCEL_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef CONFIG_CRYPTO_ACCEL
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* CPU crypto instructions found by accel_features() */
+
+#define ACCEL_AES          (1 << 0) /* AES rounds */
+#define ACCEL_CLMUL        (1 << 1) /* 64x64 carry-less multiply */
+#define ACCEL_SHA256       (1 << 2) /* SHA-256 rounds and schedule */
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: accel_features
+ *
+ * Description:
+ *   Return the ACCEL_* instructions that the running CPU supports.  The
+ *   CPU is probed on the first call only.
+ *
+ ****************************************************************************/
+
+unsigned int accel_features(void);
+
+/****************************************************************************
+ * Name: accel_initialize
+ *
+ * Description:
+ *   Install the accelerated GHASH as the ghash_update() of gmac.c if the
+ *   CPU supports it.  AES and SHA-256 check accel_features() by themselves.
+ *
+ ****************************************************************************/
+
+void accel_initialize(void);
+
+/****************************************************************************
+ * Name: accel_aes_invkey
+ *
+ * Description:
+ *   Convert the rounds + 1 encryption round keys rk, in FIPS-197 byte
+ *   order, into the round keys of the equivalent inverse cipher used by
+ *   accel_aes_decrypt().
+ *
+ ****************************************************************************/
+
+void accel_aes_invkey(FAR uint8_t *drk, FAR const uint8_t *rk,
+                      unsigned int rounds);
+
+/****************************************************************************
+ * Name: accel_aes_encrypt/accel_aes_decrypt
+ *
+ * Description:
+ *   Encrypt or decrypt nblocks independent 16 bytes blocks from src to
+ *   dst, which may be the same buffer.
+ *
+ ****************************************************************************/
+
+void accel_aes_encrypt(FAR const uint8_t *rk, unsigned int rounds,
+                       FAR const uint8_t *src, FAR uint8_t *dst,
+                       size_t nblocks);
+void accel_aes_decrypt(FAR const uint8_t *drk, unsigned int rounds,
+                       FAR const uint8_t *src, FAR uint8_t *dst,
+                       size_t nblocks);
+
+/****************************************************************************
+ * Name: accel_sha256_transform
+ *
+ * Description:
+ *   Run the SHA-256 compression function over nblocks 64 bytes blocks.
+ *
+ ****************************************************************************/
+
+void accel_sha256_transform(FAR uint32_t *state, FAR const uint8_t *data,
+                            size_t nblocks);
+
+#endif /* CONFIG_CRYPTO_ACCEL */
+#endif /* __CRYPTO_ACCEL_H */
@@ -35,6 +35,8 @@
 #include <sys/types.h>
 #include <crypto/aes.h>
 
+#include "accel.h"
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -844,6 +846,35 @@ void aes_ct_bitslice_decrypt(unsigned num_rounds,
 
 int aes_setkey(FAR AES_CTX *ctx, FAR const uint8_t *key, int len)
 {
+#ifdef CONFIG_CRYPTO_ACCEL
+  /* The CPU instructions want the plain round keys in FIPS-197 byte
+   * order, keep them in sk and the decryption ones in sk_exp.
+   */
+
+  ctx->accel = (accel_features() & ACCEL_AES) != 0;
+  if (ctx->accel)
+    {
+      uint32_t skey[60];
+      unsigned u;
+
+      ctx->num_rounds = aes_keysched_base(skey, key, len);
+      if (ctx->num_rounds == 0)
+        {
+          return -1;
+        }
+
+      for (u = 0; u < ((ctx->num_rounds + 1) << 2); u++)
+        {
+          enc32le(&ctx->sk[u], skey[u]);
+        }
+
+      accel_aes_invkey((FAR uint8_t *)ctx->sk_exp,
+                       (FAR const uint8_t *)ctx->sk, ctx->num_rounds);
+      explicit_bzero(skey, sizeof(skey));
+      return 0;
+    }
+#endif
+
   ctx->num_rounds = aes_ct_keysched(ctx->sk, key, len);
   if (ctx->num_rounds == 0)
     {
@@ -857,6 +888,15 @@ int aes_setkey(FAR AES_CTX *ctx, FAR const uint8_t *key, int len)
 void aes_encrypt_ecb(FAR AES_CTX *ctx, FAR const uint8_t *src,
                      FAR uint8_t *dst, size_t num_blocks)
 {
+#ifdef CONFIG_CRYPTO_ACCEL
+  if (ctx->accel)
+    {
+      accel_aes_encrypt((FAR const uint8_t *)ctx->sk, ctx->num_rounds,
+                        src, dst, num_blocks);
+      return;
+    }
+#endif
+
   while (num_blocks > 0)
     {
       uint32_t q[8];
@@ -907,6 +947,15 @@ void aes_encrypt_ecb(FAR AES_CTX *ctx, FAR const uint8_t *src,
 void aes_decrypt_ecb(FAR AES_CTX *ctx, FAR const uint8_t *src,
                      FAR uint8_t *dst, size_t num_blocks)
 {
+#ifdef CONFIG_CRYPTO_ACCEL
+  if (ctx->accel)
+    {
+      accel_aes_decrypt((FAR const uint8_t *)ctx->sk_exp, ctx->num_rounds,
+                        src, dst, num_blocks);
+      return;
+    }
+#endif
+
   while (num_blocks > 0)
     {
       uint32_t q[8];
@@ -36,10 +36,12 @@
 #include <errno.h>
 #include <crypto/cryptodev.h>
 #include <nuttx/fs/fs.h>
-#include <nuttx/mutex.h>
+#include <nuttx/rwsem.h>
 #include <nuttx/kmalloc.h>
 #include <nuttx/crypto/crypto.h>
 
+#include "accel.h"
+
 /****************************************************************************
  * Public Data
  ****************************************************************************/
@@ -51,7 +53,11 @@ int crypto_drivers_num = 0;
  * Private Data
  ****************************************************************************/
 
-static mutex_t g_crypto_lock = NXMUTEX_INITIALIZER;
+/* Sessions and drivers are changed under the write lock, operations only
+ * read the driver table so that independent sessions run in parallel.
+ */
+
+static rw_semaphore_t g_crypto_lock = RWSEM_INITIALIZER;
 
 /****************************************************************************
  * Public Functions
@@ -76,7 +82,7 @@ int crypto_newsession(FAR uint64_t *sid,
       return -EINVAL;
     }
 
-  nxmutex_lock(&g_crypto_lock);
+  down_write(&g_crypto_lock);
 
   /* The algorithm we use here is pretty stupid; just use the
    * first driver that supports all the algorithms we need. Do
@@ -200,7 +206,7 @@ int crypto_newsession(FAR uint64_t *sid,
 
   if (hid == -1)
     {
-      nxmutex_unlock(&g_crypto_lock);
+      up_write(&g_crypto_lock);
       return -EINVAL;
     }
 
@@ -216,7 +222,7 @@ int crypto_newsession(FAR uint64_t *sid,
       crypto_drivers[hid].cc_sessions++;
     }
 
-  nxmutex_unlock(&g_crypto_lock);
+  up_write(&g_crypto_lock);
   return err;
 }
 
@@ -243,7 +249,7 @@ int crypto_freesession(uint64_t sid)
       return -ENOENT;
     }
 
-  nxmutex_lock(&g_crypto_lock);
+  down_write(&g_crypto_lock);
 
   if (crypto_drivers[hid].cc_sessions)
     {
@@ -267,7 +273,7 @@ int crypto_freesession(uint64_t sid)
       explicit_bzero(&crypto_drivers[hid], sizeof(struct cryptocap));
     }
 
-  nxmutex_unlock(&g_crypto_lock);
+  up_write(&g_crypto_lock);
   return err;
 }
 
@@ -278,7 +284,7 @@ int crypto_get_driverid(uint8_t flags)
   FAR struct cryptocap *newdrv;
   int i;
 
-  nxmutex_lock(&g_crypto_lock);
+  down_write(&g_crypto_lock);
 
   if (crypto_drivers_num == 0)
     {
@@ -288,7 +294,7 @@ int crypto_get_driverid(uint8_t flags)
       if (crypto_drivers == NULL)
         {
           crypto_drivers_num = 0;
-          nxmutex_unlock(&g_crypto_lock);
+          up_write(&g_crypto_lock);
           return -1;
         }
 
@@ -304,7 +310,7 @@ int crypto_get_driverid(uint8_t flags)
         {
           crypto_drivers[i].cc_sessions = 1; /* Mark */
           crypto_drivers[i].cc_flags = flags;
-          nxmutex_unlock(&g_crypto_lock);
+          up_write(&g_crypto_lock);
           return i;
         }
     }
@@ -315,7 +321,7 @@ int crypto_get_driverid(uint8_t flags)
     {
       if (crypto_drivers_num >= CRYPTO_DRIVERS_MAX)
         {
-          nxmutex_unlock(&g_crypto_lock);
+          up_write(&g_crypto_lock);
           return -1;
         }
 
@@ -323,7 +329,7 @@ int crypto_get_driverid(uint8_t flags)
                           sizeof(struct cryptocap));
       if (newdrv == NULL)
         {
-          nxmutex_unlock(&g_crypto_lock);
+          up_write(&g_crypto_lock);
           return -1;
         }
 
@@ -338,13 +344,13 @@ int crypto_get_driverid(uint8_t flags)
 
       kmm_free(crypto_drivers);
       crypto_drivers = newdrv;
-      nxmutex_unlock(&g_crypto_lock);
+      up_write(&g_crypto_lock);
       return i;
     }
 
   /* Shouldn't really get here... */
 
-  nxmutex_unlock(&g_crypto_lock);
+  up_write(&g_crypto_lock);
   return -1;
 }
 
@@ -363,7 +369,7 @@ int crypto_kregister(uint32_t driverid, FAR int *kalg,
       return -EINVAL;
     }
 
-  nxmutex_lock(&g_crypto_lock);
+  down_write(&g_crypto_lock);
 
   for (i = 0; i <= CRK_ALGORITHM_MAX; i++)
     {
@@ -377,7 +383,7 @@ int crypto_kregister(uint32_t driverid, FAR int *kalg,
 
   crypto_drivers[driverid].cc_kprocess = kprocess;
 
-  nxmutex_unlock(&g_crypto_lock);
+  up_write(&g_crypto_lock);
   return 0;
 }
 
@@ -397,7 +403,7 @@ int crypto_register(uint32_t driverid, FAR int *alg,
       return -EINVAL;
     }
 
-  nxmutex_lock(&g_crypto_lock);
+  down_write(&g_crypto_lock);
 
   for (i = 0; i <= CRYPTO_ALGORITHM_MAX; i++)
     {
@@ -414,7 +420,7 @@ int crypto_register(uint32_t driverid, FAR int *alg,
   crypto_drivers[driverid].cc_freesession = freeses;
   crypto_drivers[driverid].cc_sessions = 0; /* Unmark */
 
-  nxmutex_unlock(&g_crypto_lock);
+  up_write(&g_crypto_lock);
 
   return 0;
 }
@@ -430,14 +436,14 @@ int crypto_unregister(uint32_t driverid, int alg)
   int i = CRYPTO_ALGORITHM_MAX + 1;
   uint32_t ses;
 
-  nxmutex_lock(&g_crypto_lock);
+  down_write(&g_crypto_lock);
 
   /* Sanity checks. */
 
   if (driverid >= crypto_drivers_num || crypto_drivers == NULL ||
       alg <= 0 || alg > (CRYPTO_ALGORITHM_MAX + 1))
     {
-      nxmutex_unlock(&g_crypto_lock);
+      up_write(&g_crypto_lock);
       return -EINVAL;
     }
 
@@ -445,7 +451,7 @@ int crypto_unregister(uint32_t driverid, int alg)
     {
       if (crypto_drivers[driverid].cc_alg[alg] == 0)
         {
-          nxmutex_unlock(&g_crypto_lock);
+          up_write(&g_crypto_lock);
           return -EINVAL;
         }
 
@@ -479,7 +485,7 @@ int crypto_unregister(uint32_t driverid, int alg)
         }
     }
 
-  nxmutex_unlock(&g_crypto_lock);
+  up_write(&g_crypto_lock);
   return 0;
 }
 
@@ -498,7 +504,7 @@ int crypto_kinvoke(FAR struct cryptkop *krp)
       return -EINVAL;
     }
 
-  nxmutex_lock(&g_crypto_lock);
+  down_read(&g_crypto_lock);
   for (hid = 0; hid < crypto_drivers_num; hid++)
     {
       if ((crypto_drivers[hid].cc_flags & CRYPTOCAP_F_SOFTWARE) &&
@@ -524,7 +530,7 @@ int crypto_kinvoke(FAR struct cryptkop *krp)
   if (hid == crypto_drivers_num)
     {
       krp->krp_status = -ENODEV;
-      nxmutex_unlock(&g_crypto_lock);
+      up_read(&g_crypto_lock);
       return 0;
     }
 
@@ -538,7 +544,7 @@ int crypto_kinvoke(FAR struct cryptkop *krp)
       krp->krp_status = error;
     }
 
-  nxmutex_unlock(&g_crypto_lock);
+  up_read(&g_crypto_lock);
   return 0;
 }
 
@@ -558,35 +564,39 @@ int crypto_invoke(FAR struct cryptop *crp)
       return -EINVAL;
     }
 
-  nxmutex_lock(&g_crypto_lock);
+  down_read(&g_crypto_lock);
   if (crp->crp_desc == NULL || crypto_drivers == NULL)
     {
       crp->crp_etype = -EINVAL;
-      nxmutex_unlock(&g_crypto_lock);
+      up_read(&g_crypto_lock);
       return 0;
     }
 
   hid = (crp->crp_sid >> 32) & 0xffffffff;
-  if (hid >= crypto_drivers_num)
+  if (hid >= crypto_drivers_num ||
+      crypto_drivers[hid].cc_process == NULL)
     {
+      up_read(&g_crypto_lock);
       goto migrate;
     }
 
   if (crypto_drivers[hid].cc_flags & CRYPTOCAP_F_CLEANUP)
     {
+      up_read(&g_crypto_lock);
       crypto_freesession(crp->crp_sid);
       goto migrate;
     }
 
-  if (crypto_drivers[hid].cc_process == NULL)
-    {
-      goto migrate;
-    }
+  /* The counters are statistics only, a lost update under concurrent
+   * readers is harmless.
+   */
 
   crypto_drivers[hid].cc_operations++;
   crypto_drivers[hid].cc_bytes += crp->crp_ilen;
 
   error = crypto_drivers[hid].cc_process(crp);
+  up_read(&g_crypto_lock);
+
   if (error)
     {
       if (error == -ERESTART)
@@ -602,12 +612,13 @@ int crypto_invoke(FAR struct cryptop *crp)
         }
     }
 
-  nxmutex_unlock(&g_crypto_lock);
   return 0;
 
 migrate:
 
-  /* Migrate session. */
+  /* Migrate session, this takes the write lock so the read lock must
+   * have been released.
+   */
 
   for (crd = crp->crp_desc; crd->crd_next; crd = crd->crd_next)
     {
@@ -620,7 +631,6 @@ migrate:
     }
 
   crp->crp_etype = -EAGAIN;
-  nxmutex_unlock(&g_crypto_lock);
   return 0;
 }
 
@@ -635,8 +645,6 @@ void crypto_freereq(FAR struct cryptop *crp)
       return;
     }
 
-  nxmutex_lock(&g_crypto_lock);
-
   while ((crd = crp->crp_desc) != NULL)
     {
       crp->crp_desc = crd->crd_next;
@@ -644,7 +652,6 @@ void crypto_freereq(FAR struct cryptop *crp)
     }
 
   kmm_free(crp);
-  nxmutex_unlock(&g_crypto_lock);
 }
 
 /* Acquire a set of crypto descriptors. */
@@ -654,12 +661,9 @@ FAR struct cryptop *crypto_getreq(int num)
   FAR struct cryptodesc *crd;
   FAR struct cryptop *crp;
 
-  nxmutex_lock(&g_crypto_lock);
-
   crp = kmm_malloc(sizeof(struct cryptop));
   if (crp == NULL)
     {
-      nxmutex_unlock(&g_crypto_lock);
       return NULL;
     }
 
@@ -670,7 +674,6 @@ FAR struct cryptop *crypto_getreq(int num)
       crd = kmm_calloc(1, sizeof(struct cryptodesc));
       if (crd == NULL)
         {
-          nxmutex_unlock(&g_crypto_lock);
           crypto_freereq(crp);
           return NULL;
         }
@@ -679,7 +682,6 @@ FAR struct cryptop *crypto_getreq(int num)
       crp->crp_desc = crd;
     }
 
-  nxmutex_unlock(&g_crypto_lock);
   return crp;
 }
 
@@ -726,6 +728,10 @@ out:
 
 int up_cryptoinitialize(void)
 {
+#ifdef CONFIG_CRYPTO_ACCEL
+  accel_initialize();
+#endif
+
 #ifdef CONFIG_CRYPTO_ALGTEST
   int ret = crypto_test();
   if (ret)
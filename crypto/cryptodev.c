@@ -40,8 +40,12 @@
 #include <string.h>
 #include <poll.h>
 #include <errno.h>
+#include <assert.h>
 
 #include <nuttx/kmalloc.h>
+#include <nuttx/mutex.h>
+#include <nuttx/semaphore.h>
+#include <nuttx/wqueue.h>
 #include <nuttx/fs/fs.h>
 #include <nuttx/crypto/crypto.h>
 #include <nuttx/drivers/drivers.h>
@@ -70,6 +74,16 @@ int cryptodevallowsoft = 0;
  * Private Types
  ****************************************************************************/
 
+#ifdef CONFIG_CRYPTO_CRYPTODEV_ASYNC
+struct cryptreq
+{
+  TAILQ_ENTRY(cryptreq) next;
+  struct crypt_op cop;        /* Private copy of the operation */
+  FAR struct crypt_op *ucop;  /* Caller's operation, for its status */
+  FAR sem_t *done;            /* Posted when a batch entry completes */
+};
+#endif
+
 struct csession
 {
   TAILQ_ENTRY(csession) next;
@@ -88,6 +102,18 @@ struct csession
   caddr_t mackey;
   int mackeylen;
   int error;
+  mutex_t lock;               /* Serializes the operations on the session */
+
+#ifdef CONFIG_CRYPTO_CRYPTODEV_ASYNC
+  /* Operations of one session run in order on one worker at a time,
+   * different sessions run in parallel on the worker pool.
+   */
+
+  FAR struct fcrypt *fcr;
+  TAILQ_HEAD(cryptreqlist, cryptreq) pending;
+  struct work_s work;
+  bool queued;                /* work is queued or draining pending */
+#endif
 };
 
 struct fcrypt
@@ -96,6 +122,10 @@ struct fcrypt
   TAILQ_HEAD(cryptkoplist, cryptkop) crpk_ret;
   int sesn;
   FAR struct pollfd *fds;
+#ifdef CONFIG_CRYPTO_CRYPTODEV_ASYNC
+  struct cryptreqlist crp_ret;  /* Completed asynchronous operations */
+  mutex_t lock;                 /* Protects the queues and fds */
+#endif
 };
 
 /****************************************************************************
@@ -139,6 +169,13 @@ static int cryptodev_key(FAR struct fcrypt *, FAR struct crypt_kop *);
 static int cryptodevkey_cb(FAR struct cryptkop *);
 static int cryptodev_getkeystatus(FAR struct fcrypt *,
                                   FAR struct crypt_kop *);
+static int cryptodev_mop(FAR struct fcrypt *, FAR struct crypt_mop *);
+#ifdef CONFIG_CRYPTO_CRYPTODEV_ASYNC
+static int cryptodev_queue(FAR struct fcrypt *, FAR struct crypt_op *,
+                           FAR sem_t *);
+static int cryptodev_getstatus(FAR struct fcrypt *, FAR struct crypt_op *);
+#endif
+static void fcrinit(FAR struct fcrypt *);
 
 /****************************************************************************
  * Private Data
@@ -177,6 +214,10 @@ static struct inode g_cryptoinode =
   .u.i_ops = &g_cryptofops
 };
 
+#ifdef CONFIG_CRYPTO_CRYPTODEV_ASYNC
+static FAR struct kwork_wqueue_s *g_cryptodev_wq;
+#endif
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
@@ -358,6 +399,16 @@ bail:
         break;
       case CIOCCRYPT:
         cop = (FAR struct crypt_op *)arg;
+        if (cop->flags & COP_FLAG_ASYNC)
+          {
+#ifdef CONFIG_CRYPTO_CRYPTODEV_ASYNC
+            error = cryptodev_queue(fcr, cop, NULL);
+#else
+            error = -ENOTSUP;
+#endif
+            break;
+          }
+
         cse = csefind(fcr, cop->ses);
         if (cse == NULL)
           {
@@ -366,6 +417,14 @@ bail:
 
         error = cryptodev_op(cse, cop);
         break;
+      case CIOCCRYPTM:
+        error = cryptodev_mop(fcr, (FAR struct crypt_mop *)arg);
+        break;
+#ifdef CONFIG_CRYPTO_CRYPTODEV_ASYNC
+      case CIOCCRYPTRET:
+        error = cryptodev_getstatus(fcr, (FAR struct crypt_op *)arg);
+        break;
+#endif
       case CIOCKEY:
         error = cryptodev_key(fcr, (FAR struct crypt_kop *)arg);
         break;
@@ -496,6 +555,7 @@ static int cryptodev_op(FAR struct csession *cse,
 
   /* try the fast path first */
 
+  nxmutex_lock(&cse->lock);
   crp->crp_flags = CRYPTO_F_IOV | CRYPTO_F_NOQUEUE;
   hid = (crp->crp_sid >> 32) & 0xffffffff;
   if (hid >= crypto_drivers_num)
@@ -527,6 +587,7 @@ dispatch:
   crp->crp_flags = CRYPTO_F_IOV;
   crypto_invoke(crp);
 processed:
+  nxmutex_unlock(&cse->lock);
 
   if (crde && (cop->flags & COP_FLAG_UPDATE) == 0)
     {
@@ -554,6 +615,195 @@ bail:
   return error;
 }
 
+#ifdef CONFIG_CRYPTO_CRYPTODEV_ASYNC
+/* Hand a finished request back, called with fcr->lock held */
+
+static void cryptodev_done(FAR struct fcrypt *fcr,
+                           FAR struct cryptreq *req)
+{
+  if (req->done != NULL)
+    {
+      /* The batch submitter waits for all its entries together */
+
+      req->ucop->status = req->cop.status;
+      nxsem_post(req->done);
+      kmm_free(req);
+    }
+  else
+    {
+      TAILQ_INSERT_TAIL(&fcr->crp_ret, req, next);
+      if (fcr->fds != NULL)
+        {
+          poll_notify(&fcr->fds, 1, POLLIN);
+        }
+    }
+}
+
+/* Run the pending operations of one session on a pool thread */
+
+static void cryptodev_worker(FAR void *arg)
+{
+  FAR struct csession *cse = arg;
+  FAR struct fcrypt *fcr = cse->fcr;
+  FAR struct cryptreq *req;
+
+  nxmutex_lock(&fcr->lock);
+  while ((req = TAILQ_FIRST(&cse->pending)) != NULL)
+    {
+      TAILQ_REMOVE(&cse->pending, req, next);
+      nxmutex_unlock(&fcr->lock);
+
+      req->cop.status = cryptodev_op(cse, &req->cop);
+
+      nxmutex_lock(&fcr->lock);
+      cryptodev_done(fcr, req);
+    }
+
+  cse->queued = false;
+  nxmutex_unlock(&fcr->lock);
+}
+
+static int cryptodev_queue(FAR struct fcrypt *fcr,
+                           FAR struct crypt_op *cop, FAR sem_t *done)
+{
+  FAR struct csession *cse;
+  FAR struct cryptreq *req;
+
+  cse = csefind(fcr, cop->ses);
+  if (cse == NULL)
+    {
+      return -EINVAL;
+    }
+
+  if (g_cryptodev_wq == NULL)
+    {
+      return -ENOSYS;
+    }
+
+  req = kmm_malloc(sizeof(struct cryptreq));
+  if (req == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  req->cop = *cop;
+  req->ucop = cop;
+  req->done = done;
+
+  /* Only one worker may drain a session at a time, a busy worker picks
+   * the new request up before it returns.
+   */
+
+  nxmutex_lock(&fcr->lock);
+  TAILQ_INSERT_TAIL(&cse->pending, req, next);
+  if (!cse->queued)
+    {
+      cse->queued = true;
+      work_queue_wq(g_cryptodev_wq, &cse->work, cryptodev_worker, cse, 0);
+    }
+
+  nxmutex_unlock(&fcr->lock);
+  return OK;
+}
+
+static int cryptodev_getstatus(FAR struct fcrypt *fcr,
+                               FAR struct crypt_op *cop)
+{
+  FAR struct cryptreq *req;
+
+  nxmutex_lock(&fcr->lock);
+  req = TAILQ_FIRST(&fcr->crp_ret);
+  if (req == NULL)
+    {
+      nxmutex_unlock(&fcr->lock);
+      return -EAGAIN;
+    }
+
+  TAILQ_REMOVE(&fcr->crp_ret, req, next);
+  nxmutex_unlock(&fcr->lock);
+
+  *cop = req->cop;
+  kmm_free(req);
+  return OK;
+}
+#endif
+
+/* Run a batch of operations, their results are returned in the status
+ * of each entry.  With the worker pool the entries of different sessions
+ * run in parallel and asynchronous entries complete via CIOCCRYPTRET.
+ */
+
+static int cryptodev_mop(FAR struct fcrypt *fcr, FAR struct crypt_mop *mop)
+{
+  FAR struct crypt_op *cop;
+#ifdef CONFIG_CRYPTO_CRYPTODEV_ASYNC
+  unsigned int nwait = 0;
+  sem_t done;
+  int ret;
+#else
+  FAR struct csession *cse;
+#endif
+  unsigned int i;
+
+  if (mop->count == 0 || mop->reqs == NULL)
+    {
+      return -EINVAL;
+    }
+
+#ifdef CONFIG_CRYPTO_CRYPTODEV_ASYNC
+  nxsem_init(&done, 0, 0);
+
+  for (i = 0; i < mop->count; i++)
+    {
+      cop = &mop->reqs[i];
+      if (cop->flags & COP_FLAG_ASYNC)
+        {
+          ret = cryptodev_queue(fcr, cop, NULL);
+        }
+      else
+        {
+          ret = cryptodev_queue(fcr, cop, &done);
+          if (ret >= 0)
+            {
+              nwait++;
+            }
+        }
+
+      if (ret < 0)
+        {
+          cop->status = ret;
+        }
+    }
+
+  while (nwait-- > 0)
+    {
+      nxsem_wait_uninterruptible(&done);
+    }
+
+  nxsem_destroy(&done);
+#else
+  for (i = 0; i < mop->count; i++)
+    {
+      cop = &mop->reqs[i];
+      cse = csefind(fcr, cop->ses);
+      if (cse == NULL)
+        {
+          cop->status = -EINVAL;
+        }
+      else if (cop->flags & COP_FLAG_ASYNC)
+        {
+          cop->status = -ENOTSUP;
+        }
+      else
+        {
+          cop->status = cryptodev_op(cse, cop);
+        }
+    }
+#endif
+
+  return OK;
+}
+
 static int cryptodev_key(FAR struct fcrypt *fcr, FAR struct crypt_kop *kop)
 {
   FAR struct cryptkop *krp = NULL;
@@ -800,23 +1050,37 @@ static int cryptof_poll(FAR struct file *filep,
                         FAR struct pollfd *fds, bool setup)
 {
   FAR struct fcrypt *fcr = filep->f_priv;
+  int ret = OK;
 
   if (fcr == NULL || fds == NULL)
     {
       return -EINVAL;
     }
 
+#ifdef CONFIG_CRYPTO_CRYPTODEV_ASYNC
+  nxmutex_lock(&fcr->lock);
+#endif
+
   if (setup)
     {
       if (!TAILQ_EMPTY(&fcr->crpk_ret))
         {
           poll_notify(&fds, 1, POLLIN);
-          return OK;
+          goto out;
         }
 
+#ifdef CONFIG_CRYPTO_CRYPTODEV_ASYNC
+      if (!TAILQ_EMPTY(&fcr->crp_ret))
+        {
+          poll_notify(&fds, 1, POLLIN);
+          goto out;
+        }
+#endif
+
       if (fcr->fds)
         {
-          return -EBUSY;
+          ret = -EBUSY;
+          goto out;
         }
 
       fcr->fds = fds;
@@ -826,7 +1090,11 @@ static int cryptof_poll(FAR struct file *filep,
       fcr->fds = NULL;
     }
 
-  return OK;
+out:
+#ifdef CONFIG_CRYPTO_CRYPTODEV_ASYNC
+  nxmutex_unlock(&fcr->lock);
+#endif
+  return ret;
 }
 
 /* ARGSUSED */
@@ -836,6 +1104,9 @@ static int cryptof_close(FAR struct file *filep)
   FAR struct fcrypt *fcr = filep->f_priv;
   FAR struct csession *cse;
   FAR struct cryptkop *krp;
+#ifdef CONFIG_CRYPTO_CRYPTODEV_ASYNC
+  FAR struct cryptreq *req;
+#endif
   int i;
 
   while ((cse = TAILQ_FIRST(&fcr->csessions)))
@@ -860,6 +1131,16 @@ static int cryptof_close(FAR struct file *filep)
       kmm_free(krp);
     }
 
+#ifdef CONFIG_CRYPTO_CRYPTODEV_ASYNC
+  while ((req = TAILQ_FIRST(&fcr->crp_ret)))
+    {
+      TAILQ_REMOVE(&fcr->crp_ret, req, next);
+      kmm_free(req);
+    }
+
+  nxmutex_destroy(&fcr->lock);
+#endif
+
   kmm_free(fcr);
   filep->f_priv = NULL;
   return 0;
@@ -898,7 +1179,7 @@ static int cryptof_open(FAR struct file *filep)
       return -ENOMEM;
     }
 
-  TAILQ_INIT(&fcrd->csessions);
+  fcrinit(fcrd);
   TAILQ_FOREACH(cse, &fcr->csessions, next)
     {
       bzero(&crie, sizeof(crie));
@@ -1023,13 +1304,15 @@ static int cryptoioctl(FAR struct file *filep, int cmd, unsigned long arg)
             return -ENOMEM;
           }
 
-        TAILQ_INIT(&fcr->csessions);
-        TAILQ_INIT(&fcr->crpk_ret);
+        fcrinit(fcr);
 
         fd = file_allocate(&g_cryptoinode, 0,
                            0, fcr, 0, true);
         if (fd < 0)
           {
+#ifdef CONFIG_CRYPTO_CRYPTODEV_ASYNC
+            nxmutex_destroy(&fcr->lock);
+#endif
             kmm_free(fcr);
             return fd;
           }
@@ -1045,6 +1328,16 @@ static int cryptoioctl(FAR struct file *filep, int cmd, unsigned long arg)
   return error;
 }
 
+static void fcrinit(FAR struct fcrypt *fcr)
+{
+  TAILQ_INIT(&fcr->csessions);
+  TAILQ_INIT(&fcr->crpk_ret);
+#ifdef CONFIG_CRYPTO_CRYPTODEV_ASYNC
+  TAILQ_INIT(&fcr->crp_ret);
+  nxmutex_init(&fcr->lock);
+#endif
+}
+
 static FAR struct csession *csefind(FAR struct fcrypt *fcr, u_int ses)
 {
   FAR struct csession *cse;
@@ -1090,7 +1383,7 @@ static FAR struct csession *csecreate(FAR struct fcrypt *fcr, uint64_t sid,
 {
   FAR struct csession *cse;
 
-  cse = kmm_malloc(sizeof(struct csession));
+  cse = kmm_zalloc(sizeof(struct csession));
   if (cse != NULL)
     {
       cse->key = key;
@@ -1103,6 +1396,11 @@ static FAR struct csession *csecreate(FAR struct fcrypt *fcr, uint64_t sid,
       cse->txform = txform;
       cse->thash = thash;
       cse->error = 0;
+      nxmutex_init(&cse->lock);
+#ifdef CONFIG_CRYPTO_CRYPTODEV_ASYNC
+      cse->fcr = fcr;
+      TAILQ_INIT(&cse->pending);
+#endif
       cseadd(fcr, cse);
     }
 
@@ -1111,8 +1409,28 @@ static FAR struct csession *csecreate(FAR struct fcrypt *fcr, uint64_t sid,
 
 static int csefree(FAR struct csession *cse)
 {
+#ifdef CONFIG_CRYPTO_CRYPTODEV_ASYNC
+  FAR struct fcrypt *fcr = cse->fcr;
+  FAR struct cryptreq *req;
+#endif
   int error;
 
+#ifdef CONFIG_CRYPTO_CRYPTODEV_ASYNC
+  /* Wait for a running worker, then fail what is still pending */
+
+  work_cancel_sync_wq(g_cryptodev_wq, &cse->work);
+
+  nxmutex_lock(&fcr->lock);
+  while ((req = TAILQ_FIRST(&cse->pending)) != NULL)
+    {
+      TAILQ_REMOVE(&cse->pending, req, next);
+      req->cop.status = -ECANCELED;
+      cryptodev_done(fcr, req);
+    }
+
+  nxmutex_unlock(&fcr->lock);
+#endif
+
   error = crypto_freesession(cse->sid);
   if (cse->key)
     {
@@ -1124,6 +1442,7 @@ static int csefree(FAR struct csession *cse)
       kmm_free(cse->mackey);
     }
 
+  nxmutex_destroy(&cse->lock);
   kmm_free(cse);
   return error;
 }
@@ -1136,6 +1455,14 @@ void devcrypto_register(void)
 {
   register_driver("/dev/crypto", &g_cryptoops, 0666, NULL);
 
+#ifdef CONFIG_CRYPTO_CRYPTODEV_ASYNC
+  g_cryptodev_wq = work_queue_create("cryptodev",
+                                     CONFIG_CRYPTO_CRYPTODEV_PRIORITY,
+                                     CONFIG_CRYPTO_CRYPTODEV_STACKSIZE,
+                                     CONFIG_CRYPTO_CRYPTODEV_NWORKERS);
+  DEBUGASSERT(g_cryptodev_wq != NULL);
+#endif
+
 #ifdef CONFIG_CRYPTO_CRYPTODEV_SOFTWARE
   swcr_init();
 #endif
@@ -43,6 +43,8 @@
 #include <sys/time.h>
 #include <crypto/sha2.h>
 
+#include "accel.h"
+
 /* UNROLLED TRANSFORM LOOP NOTE:
  * You can define SHA2_UNROLL_TRANSFORM to use the unrolled transform
  * loop version for the hash transform rounds (defined using macros
@@ -172,6 +174,7 @@
 void sha512last(FAR SHA2_CTX *);
 void sha256transform(FAR uint32_t *, FAR const uint8_t *);
 void sha512transform(FAR uint64_t *, FAR const uint8_t *);
+static void sha256blocks(FAR uint32_t *, FAR const uint8_t *, size_t);
 
 /* SHA-XYZ INITIAL HASH VALUES AND CONSTANTS */
 
@@ -521,6 +524,24 @@ void sha256transform(FAR uint32_t *state, FAR const uint8_t *data)
 
 #endif /* SHA2_UNROLL_TRANSFORM */
 
+static void sha256blocks(FAR uint32_t *state, FAR const uint8_t *data,
+                         size_t nblocks)
+{
+#ifdef CONFIG_CRYPTO_ACCEL
+  if (accel_features() & ACCEL_SHA256)
+    {
+      accel_sha256_transform(state, data, nblocks);
+      return;
+    }
+#endif
+
+  while (nblocks-- > 0)
+    {
+      sha256transform(state, data);
+      data += SHA256_BLOCK_LENGTH;
+    }
+}
+
 void sha256update(FAR SHA2_CTX *context,
                   FAR const void *dataptr,
                   size_t len)
@@ -551,7 +572,7 @@ void sha256update(FAR SHA2_CTX *context,
           context->bitcount[0] += freespace << 3;
           len -= freespace;
           data += freespace;
-          sha256transform(context->state.st32, context->buffer);
+          sha256blocks(context->state.st32, context->buffer, 1);
         }
       else
         {
@@ -567,14 +588,16 @@ void sha256update(FAR SHA2_CTX *context,
         }
     }
 
-  while (len >= SHA256_BLOCK_LENGTH)
+  if (len >= SHA256_BLOCK_LENGTH)
     {
+      size_t nblocks = len / SHA256_BLOCK_LENGTH;
+
       /* Process as many complete blocks as we can */
 
-      sha256transform(context->state.st32, data);
-      context->bitcount[0] += SHA256_BLOCK_LENGTH << 3;
-      len -= SHA256_BLOCK_LENGTH;
-      data += SHA256_BLOCK_LENGTH;
+      sha256blocks(context->state.st32, data, nblocks);
+      context->bitcount[0] += (uint64_t)nblocks * SHA256_BLOCK_LENGTH << 3;
+      len -= nblocks * SHA256_BLOCK_LENGTH;
+      data += nblocks * SHA256_BLOCK_LENGTH;
     }
 
   if (len > 0)
@@ -625,7 +648,7 @@ void sha256last(FAR SHA2_CTX *context)
 
           /* Do second-to-last transform: */
 
-          sha256transform(context->state.st32, context->buffer);
+          sha256blocks(context->state.st32, context->buffer, 1);
 
           /* And set-up for the last transform: */
 
@@ -651,7 +674,7 @@ void sha256last(FAR SHA2_CTX *context)
 
   /* Final transform: */
 
-  sha256transform(context->state.st32, context->buffer);
+  sha256blocks(context->state.st32, context->buffer, 1);
 }
 
 void sha256final(FAR uint8_t *digest, FAR SHA2_CTX *context)
@@ -26,6 +26,7 @@
 
 #include <debug.h>
 #include <errno.h>
+#include <limits.h>
 #include <stdbool.h>
 #include <stdio.h>
 #include <string.h>
@@ -33,10 +34,13 @@
 #include <nuttx/kmalloc.h>
 #include <nuttx/kthread.h>
 #include <nuttx/mm/iob.h>
+#include <nuttx/nuttx.h>
 #include <nuttx/net/can.h>
+#include <nuttx/net/ethernet.h>
 #include <nuttx/net/net.h>
 #include <nuttx/net/netdev_lowerhalf.h>
 #include <nuttx/net/pkt.h>
+#include <nuttx/net/tcp.h>
 #include <nuttx/semaphore.h>
 #include <nuttx/spinlock.h>
 
@@ -60,6 +64,10 @@
 #  define NETDEV_THREAD_COUNT 1
 #endif
 
+/* Entries of the table steering the flows to the queues, by hash */
+
+#define NETDEV_RSS_TABLE_SIZE 128
+
 /****************************************************************************
  * Private Types
  ****************************************************************************/
@@ -85,8 +93,57 @@ struct netdev_upperhalf_s
 #if CONFIG_IOB_NCHAINS > 0
   struct iob_queue_s txq;
 #endif
+
+  /* TCP segment being coalesced by GRO, the ones' complement sum of its
+   * payload and the number of segments merged into it.
+   */
+
+#ifdef CONFIG_NETDEV_GRO
+  FAR netpkt_t *gro;
+  uint16_t gro_sum;
+  uint16_t gro_segs;
+#endif
+
+  /* Budgeted receive polling: the entry in the poll list, the packets
+   * received per poll, whether a poll is scheduled (RX interrupt
+   * masked) and whether RX became ready again while it was.
+   */
+
+#ifdef CONFIG_NETDEV_NAPI
+#  ifndef CONFIG_NETDEV_WORK_THREAD
+  sq_entry_t napi_node;
+#  endif
+  uint16_t napi_weight;
+  bool napi_sched;
+  bool napi_missed;
+#endif
+
+  /* The queue of each flow hash bucket, spread over the queues at first
+   * and then updated to follow the CPU receiving the flow.
+   */
+
+#ifdef CONFIG_NETDEV_RSS
+  uint8_t rss_table[NETDEV_RSS_TABLE_SIZE];
+#endif
 };
 
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+#ifdef CONFIG_NETDEV_NAPI
+static spinlock_t g_napi_lock = SP_UNLOCKED;
+
+/* Devices waiting for their receive poll, served in round-robin by a
+ * single work shared by all of them.
+ */
+
+#  ifndef CONFIG_NETDEV_WORK_THREAD
+static sq_queue_t g_napi_list;
+static struct work_s g_napi_work;
+#  endif
+#endif
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
@@ -246,6 +303,286 @@ static inline bool netdev_upper_can_tx(FAR struct netdev_upperhalf_s *upper)
   return quota > 0;
 }
 
+/****************************************************************************
+ * Name: netdev_upper_gso_size
+ *
+ * Description:
+ *   Get the segment size if the packet in the device buffer is a TCP/IPv4
+ *   GSO packet that needs to be segmented, zero otherwise.
+ *
+ * Assumptions:
+ *   Called with the network locked.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NETDEV_GSO
+static uint16_t netdev_upper_gso_size(FAR struct net_driver_s *dev)
+{
+  FAR struct ipv4_hdr_s *ipv4;
+  FAR struct tcp_hdr_s *tcp;
+  unsigned int iphdrlen;
+
+  if (dev->d_gsosize == 0 || dev->d_iob == NULL)
+    {
+      return 0;
+    }
+
+  /* The TCP packet may have been replaced by an ARP request */
+
+  ipv4 = IPv4BUF;
+  if ((ipv4->vhl & IP_VERSION_MASK) != IPv4_VERSION ||
+      ipv4->proto != IP_PROTO_TCP)
+    {
+      return 0;
+    }
+
+  iphdrlen = (ipv4->vhl & IPv4_HLMASK) << 2;
+  tcp      = IPBUF(iphdrlen);
+
+  if (dev->d_iob->io_pktlen <=
+      iphdrlen + ((tcp->tcpoffset >> 4) << 2) + dev->d_gsosize)
+    {
+      return 0;
+    }
+
+  return dev->d_gsosize;
+}
+
+/****************************************************************************
+ * Name: netdev_upper_gso_segment
+ *
+ * Description:
+ *   Cut the TCP/IPv4 packet in the device buffer into segments carrying
+ *   gsosize bytes of payload and append them to the TX queue.  This is
+ *   done for the lower halves without NETDEV_F_TSO4 and for the packets
+ *   queued from the RX path.
+ *
+ * Input Parameters:
+ *   dev     - Reference to the NuttX driver state structure
+ *   gsosize - The payload size of the segments
+ *
+ * Assumptions:
+ *   Called with the network locked.
+ *
+ ****************************************************************************/
+
+static void netdev_upper_gso_segment(FAR struct net_driver_s *dev,
+                                     uint16_t gsosize)
+{
+  FAR struct netdev_upperhalf_s *upper = dev->d_private;
+  FAR struct iob_s *iob = dev->d_iob;
+  FAR struct ipv4_hdr_s *ipv4 = IPv4BUF;
+  FAR struct tcp_hdr_s *tcp;
+  FAR struct iob_s *seg;
+  unsigned int llhdrlen = NET_LL_HDRLEN(dev);
+  unsigned int iphdrlen;
+  unsigned int hdrlen;
+  unsigned int paylen;
+  unsigned int seglen;
+  unsigned int offset;
+  uint32_t seqno;
+  uint16_t ipid;
+  uint16_t len;
+  uint8_t flags;
+
+  iphdrlen = (ipv4->vhl & IPv4_HLMASK) << 2;
+  tcp      = IPBUF(iphdrlen);
+  hdrlen   = iphdrlen + ((tcp->tcpoffset >> 4) << 2);
+  paylen   = iob->io_pktlen - hdrlen;
+  seqno    = ((uint32_t)tcp->seqno[0] << 24) |
+             ((uint32_t)tcp->seqno[1] << 16) |
+             ((uint32_t)tcp->seqno[2] << 8) | tcp->seqno[3];
+  ipid     = ((uint16_t)ipv4->ipid[0] << 8) | ipv4->ipid[1];
+  flags    = tcp->flags;
+
+  DEBUGASSERT(iob->io_len >= hdrlen);
+
+  /* Take the packet away, the segments are checksummed in turn in the
+   * device buffer.
+   */
+
+  netdev_iob_clear(dev);
+
+  for (offset = 0; offset < paylen; offset += seglen)
+    {
+      seglen = MIN(paylen - offset, gsosize);
+
+      seg = iob_tryalloc(false);
+      if (seg == NULL)
+        {
+          nwarn("WARNING: No IOB for GSO segment of %s\n", dev->d_ifname);
+          NETDEV_TXERRORS(dev);
+          break;
+        }
+
+      iob_reserve(seg, CONFIG_NET_LL_GUARDSIZE);
+      if (iob_trycopyin(seg, (FAR const uint8_t *)ipv4, hdrlen, 0,
+                        false) < 0 ||
+          iob_clone_partial(iob, seglen, hdrlen + offset, seg, hdrlen,
+                            false, false) < 0)
+        {
+          nwarn("WARNING: No IOB for GSO segment of %s\n", dev->d_ifname);
+          NETDEV_TXERRORS(dev);
+          iob_free_chain(seg);
+          break;
+        }
+
+      /* The link layer header has been built in the guard area */
+
+      memcpy(IOB_DATA(seg) - llhdrlen, IOB_DATA(iob) - llhdrlen, llhdrlen);
+
+      /* Then fix up the IPv4 and the TCP headers of the segment */
+
+      dev->d_iob = seg;
+      dev->d_len = seg->io_pktlen;
+
+      len = hdrlen + seglen;
+      IPv4BUF->len[0]   = len >> 8;
+      IPv4BUF->len[1]   = len & 0xff;
+      IPv4BUF->ipid[0]  = ipid >> 8;
+      IPv4BUF->ipid[1]  = ipid & 0xff;
+      IPv4BUF->ipchksum = 0;
+      IPv4BUF->ipchksum = ~ipv4_chksum(IPv4BUF);
+      ipid++;
+
+      tcp           = IPBUF(iphdrlen);
+      tcp->seqno[0] = (seqno + offset) >> 24;
+      tcp->seqno[1] = (seqno + offset) >> 16;
+      tcp->seqno[2] = (seqno + offset) >> 8;
+      tcp->seqno[3] = (seqno + offset);
+
+      if (offset + seglen < paylen)
+        {
+          tcp->flags = flags & ~(TCP_FIN | TCP_PSH);
+        }
+
+      tcp->tcpchksum = 0;
+#ifdef CONFIG_NET_TCP_CHECKSUMS
+      tcp->tcpchksum = ~ipv4_upperlayer_chksum(dev, IP_PROTO_TCP);
+#endif
+
+      netdev_iob_clear(dev);
+
+      if (iob_tryadd_queue(seg, &upper->txq) < 0)
+        {
+          nwarn("WARNING: Failed to queue GSO segment of %s\n",
+                dev->d_ifname);
+          NETDEV_TXERRORS(dev);
+          iob_free_chain(seg);
+          break;
+        }
+    }
+
+  iob_free_chain(iob);
+}
+#endif
+
+/****************************************************************************
+ * Name: netdev_upper_select_queue
+ *
+ * Description:
+ *   Select the TX queue of the packet in dev->d_iob.  TCP and UDP flows
+ *   are steered by the RSS hash of their addresses and ports, the other
+ *   packets go out through the queue of the current CPU.
+ *
+ * Assumptions:
+ *   Called with the network locked.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NETDEV_RSS
+static int netdev_upper_select_queue(FAR struct net_driver_s *dev)
+{
+  FAR struct netdev_upperhalf_s *upper = dev->d_private;
+  FAR struct netdev_lowerhalf_s *lower = upper->lower;
+  FAR const uint16_t *ports;
+  uint32_t srcaddr[4];
+  uint32_t dstaddr[4];
+  uint32_t hash;
+  uint8_t domain;
+  uint8_t proto;
+
+  if (lower->nqueues <= 1)
+    {
+      return 0;
+    }
+
+#ifdef CONFIG_NET_IPv4
+  if ((IPv4BUF->vhl & IP_VERSION_MASK) == IPv4_VERSION)
+    {
+      domain = PF_INET;
+      proto  = IPv4BUF->proto;
+      ports  = IPBUF((IPv4BUF->vhl & IPv4_HLMASK) << 2);
+      memcpy(srcaddr, IPv4BUF->srcipaddr, sizeof(in_addr_t));
+      memcpy(dstaddr, IPv4BUF->destipaddr, sizeof(in_addr_t));
+    }
+  else
+#endif
+#ifdef CONFIG_NET_IPv6
+  if ((IPv6BUF->vtc & IP_VERSION_MASK) == IPv6_VERSION)
+    {
+      domain = PF_INET6;
+      proto  = IPv6BUF->proto;
+      ports  = IPBUF(IPv6_HDRLEN);
+      memcpy(srcaddr, IPv6BUF->srcipaddr, sizeof(net_ipv6addr_t));
+      memcpy(dstaddr, IPv6BUF->destipaddr, sizeof(net_ipv6addr_t));
+    }
+  else
+#endif
+    {
+      return this_cpu() % lower->nqueues;
+    }
+
+  if (proto != IP_PROTO_TCP && proto != IP_PROTO_UDP)
+    {
+      return this_cpu() % lower->nqueues;
+    }
+
+  /* Both ports are the first fields of the TCP and UDP headers */
+
+  hash = netdev_rss_hash(domain, srcaddr, ports[0], dstaddr, ports[1]);
+  return upper->rss_table[hash % NETDEV_RSS_TABLE_SIZE];
+}
+#endif
+
+/****************************************************************************
+ * Name: netdev_upper_transmit/receive
+ *
+ * Description:
+ *   Send or receive a packet through the given queue of the lower half.
+ *
+ ****************************************************************************/
+
+static inline int netdev_upper_transmit(FAR struct netdev_lowerhalf_s *lower,
+                                        FAR netpkt_t *pkt, int queue)
+{
+#ifdef CONFIG_NETDEV_RSS
+  if (lower->nqueues > 1)
+    {
+      return lower->ops->transmit_queue(lower, pkt, queue);
+    }
+#else
+  UNUSED(queue);
+#endif
+
+  return lower->ops->transmit(lower, pkt);
+}
+
+static inline FAR netpkt_t *
+netdev_upper_receive(FAR struct netdev_lowerhalf_s *lower, int queue)
+{
+#ifdef CONFIG_NETDEV_RSS
+  if (lower->nqueues > 1)
+    {
+      return lower->ops->receive_queue(lower, queue);
+    }
+#else
+  UNUSED(queue);
+#endif
+
+  return lower->ops->receive(lower);
+}
+
 /****************************************************************************
  * Name: netdev_upper_txpoll
  *
@@ -276,10 +613,37 @@ static int netdev_upper_txpoll(FAR struct net_driver_s *dev)
   FAR struct netdev_upperhalf_s *upper = dev->d_private;
   FAR struct netdev_lowerhalf_s *lower = upper->lower;
   FAR netpkt_t                  *pkt;
+  unsigned int                   maxlen = NETDEV_PKTSIZE(dev);
+  int                            queue  = 0;
   int                            ret;
+#ifdef CONFIG_NETDEV_GSO
+  FAR struct tcp_hdr_s          *tcp;
+  uint16_t                       gsosize;
+#endif
 
   DEBUGASSERT(dev->d_len > 0);
 
+#ifdef CONFIG_NETDEV_GSO
+  gsosize = netdev_upper_gso_size(dev);
+  if (gsosize > 0)
+    {
+      if ((lower->features & NETDEV_F_TSO4) == 0)
+        {
+          /* Segment it here, the segments are sent from the TX queue */
+
+          netdev_upper_gso_segment(dev, gsosize);
+          return NETDEV_TX_CONTINUE;
+        }
+
+      /* The lower half completes the TCP checksum of each segment */
+
+      tcp = IPBUF((IPv4BUF->vhl & IPv4_HLMASK) << 2);
+      tcp->tcpchksum = HTONS(ipv4_upperlayer_header_chksum(dev,
+                                                           IP_PROTO_TCP));
+      maxlen = dev->d_gsomax;
+    }
+#endif
+
   NETDEV_TXPACKETS(dev);
 
 #ifdef CONFIG_NET_PKT
@@ -288,16 +652,26 @@ static int netdev_upper_txpoll(FAR struct net_driver_s *dev)
   pkt_input(dev);
 #endif
 
+#ifdef CONFIG_NETDEV_RSS
+  queue = netdev_upper_select_queue(dev);
+#endif
+
   pkt = netpkt_get(dev, NETPKT_TX);
 
-  if (netpkt_getdatalen(lower, pkt) > NETDEV_PKTSIZE(dev))
+  if (netpkt_getdatalen(lower, pkt) > maxlen)
     {
       nerr("ERROR: Packet too long to send!\n");
       ret = -EMSGSIZE;
     }
   else
     {
-      ret = lower->ops->transmit(lower, pkt);
+#ifdef CONFIG_NETDEV_GSO
+      dev->d_gsosize = gsosize;
+      ret = netdev_upper_transmit(lower, pkt, queue);
+      dev->d_gsosize = 0;
+#else
+      ret = netdev_upper_transmit(lower, pkt, queue);
+#endif
     }
 
   if (ret != OK)
@@ -401,6 +775,17 @@ static void netdev_upper_queue_tx(FAR struct net_driver_s *dev)
 #if CONFIG_IOB_NCHAINS > 0
   FAR struct netdev_upperhalf_s *upper = dev->d_private;
   int ret;
+#ifdef CONFIG_NETDEV_GSO
+  uint16_t gsosize = netdev_upper_gso_size(dev);
+
+  /* The segment size is not kept in the queue, segment it now */
+
+  if (gsosize > 0)
+    {
+      netdev_upper_gso_segment(dev, gsosize);
+      return;
+    }
+#endif
 
   if ((ret = iob_tryadd_queue(dev->d_iob, &upper->txq)) >= 0)
     {
@@ -490,196 +875,780 @@ static void eth_input(FAR struct net_driver_s *dev)
 
       /* Handle ARP packet */
 
-      arp_input(dev);
-    }
-  else
-#endif
-    {
-      ninfo("INFO: Dropped, Unknown type: %04x\n", eth_hdr->type);
-      NETDEV_RXDROPPED(dev);
-      dev->d_len = 0;
-    }
+      arp_input(dev);
+    }
+  else
+#endif
+    {
+      ninfo("INFO: Dropped, Unknown type: %04x\n", eth_hdr->type);
+      NETDEV_RXDROPPED(dev);
+      dev->d_len = 0;
+    }
+
+  /* If the above function invocation resulted in data
+   * that should be sent out on the network,
+   * the field d_len will set to a value > 0.
+   */
+
+  if (dev->d_len > 0)
+    {
+      /* And queue the packet for sending later.
+       * Note: RX is tried before TX, so we don't need to call txavail here.
+       */
+
+      netdev_upper_queue_tx(dev);
+    }
+}
+#endif
+
+/****************************************************************************
+ * Name: ip_input
+ *
+ * Description:
+ *   Handle L3 packet input.
+ *
+ * Input Parameters:
+ *   dev - Reference to the NuttX network driver state structure
+ *
+ * Assumptions:
+ *   Called with the network locked.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_MBIM
+static void ip_input(FAR struct net_driver_s *dev)
+{
+  /* We only accept IP packets of the configured type */
+
+#ifdef CONFIG_NET_IPv4
+  if ((IPv4BUF->vhl & IP_VERSION_MASK) == IPv4_VERSION)
+    {
+      ninfo("IPv4 frame\n");
+      NETDEV_RXIPV4(dev);
+
+      /* Receive an IPv4 packet from the network device */
+
+      ipv4_input(dev);
+    }
+  else
+#endif
+#ifdef CONFIG_NET_IPv6
+  if ((IPv6BUF->vtc & IP_VERSION_MASK) == IPv6_VERSION)
+    {
+      ninfo("IPv6 frame\n");
+      NETDEV_RXIPV6(dev);
+
+      /* Give the IPv6 packet to the network layer */
+
+      ipv6_input(dev);
+    }
+  else
+#endif
+    {
+      ninfo("INFO: Dropped, Unknown type\n");
+      NETDEV_RXDROPPED(dev);
+      dev->d_len = 0;
+    }
+
+  /* If the above function invocation resulted in data
+   * that should be sent out on the network,
+   * the field d_len will set to a value > 0.
+   */
+
+  if (dev->d_len > 0)
+    {
+      /* And queue the packet for sending later.
+       * Note: RX is tried before TX, so we don't need to call txavail here.
+       */
+
+      netdev_upper_queue_tx(dev);
+    }
+}
+#endif
+
+/****************************************************************************
+ * Name: netdev_upper_input
+ *
+ * Description:
+ *   Pass a received packet into the network stack.
+ *
+ * Input Parameters:
+ *   upper - Reference to the upper half driver structure
+ *   pkt   - The received packet
+ *
+ * Assumptions:
+ *   Called with the network locked.
+ *
+ ****************************************************************************/
+
+static void netdev_upper_input(FAR struct netdev_upperhalf_s *upper,
+                               FAR netpkt_t *pkt)
+{
+  FAR struct net_driver_s *dev = &upper->lower->netdev;
+
+  netpkt_put(dev, pkt, NETPKT_RX);
+  NETDEV_RXPACKETS(dev);
+
+#ifdef CONFIG_NET_PKT
+  /* When packet sockets are enabled, feed the frame into the tap */
+
+  pkt_input(dev);
+#endif
+
+  switch (dev->d_lltype)
+    {
+#ifdef CONFIG_NET_LOOPBACK
+    case NET_LL_LOOPBACK:
+#endif
+#ifdef CONFIG_NET_ETHERNET
+    case NET_LL_ETHERNET:
+#endif
+#ifdef CONFIG_DRIVERS_IEEE80211
+    case NET_LL_IEEE80211:
+#endif
+#if defined(CONFIG_NET_LOOPBACK) || defined(CONFIG_NET_ETHERNET) || \
+    defined(CONFIG_DRIVERS_IEEE80211)
+      eth_input(dev);
+      break;
+#endif
+#ifdef CONFIG_NET_MBIM
+    case NET_LL_MBIM:
+      ip_input(dev);
+      break;
+#endif
+#ifdef CONFIG_NET_CAN
+    case NET_LL_CAN:
+      ninfo("CAN frame");
+      can_input(dev);
+      break;
+#endif
+    default:
+      nerr("Unknown link type %d\n", dev->d_lltype);
+      break;
+    }
+}
+
+#ifdef CONFIG_NETDEV_GRO
+/****************************************************************************
+ * Name: netdev_upper_csum_add
+ *
+ * Description:
+ *   Ones' complement addition of two 16-bit checksums.
+ *
+ ****************************************************************************/
+
+static uint16_t netdev_upper_csum_add(uint16_t a, uint16_t b)
+{
+  uint32_t sum = (uint32_t)a + b;
+
+  return (uint16_t)((sum & 0xffff) + (sum >> 16));
+}
+
+/****************************************************************************
+ * Name: netdev_upper_gro_tcp
+ *
+ * Description:
+ *   Check if a received frame is a TCP/IPv4 data segment for us that GRO
+ *   can coalesce: no IP options or fragmentation, only ACK and PSH set
+ *   and the headers in the first buffer.
+ *
+ * Returned Value:
+ *   The TCP header of the segment, NULL if it is to be input as is.
+ *
+ ****************************************************************************/
+
+static FAR struct tcp_hdr_s *
+netdev_upper_gro_tcp(FAR struct net_driver_s *dev, FAR netpkt_t *pkt)
+{
+  FAR struct eth_hdr_s *eth;
+  FAR struct ipv4_hdr_s *ipv4;
+  FAR struct tcp_hdr_s *tcp;
+  unsigned int totlen;
+  unsigned int hdrlen;
+
+  if (NET_LL_HDRLEN(dev) != ETH_HDRLEN ||
+      pkt->io_len < IPv4_HDRLEN + TCP_HDRLEN)
+    {
+      return NULL;
+    }
+
+  eth  = (FAR struct eth_hdr_s *)(IOB_DATA(pkt) - ETH_HDRLEN);
+  ipv4 = (FAR struct ipv4_hdr_s *)IOB_DATA(pkt);
+  tcp  = (FAR struct tcp_hdr_s *)(IOB_DATA(pkt) + IPv4_HDRLEN);
+
+  if (eth->type != HTONS(ETHTYPE_IP) ||
+      ipv4->vhl != (IPv4_VERSION | (IPv4_HDRLEN >> 2)) ||
+      ipv4->proto != IP_PROTO_TCP ||
+      (ipv4->ipoffset[0] & 0x3f) != 0 || ipv4->ipoffset[1] != 0 ||
+      !net_ipv4addr_cmp(net_ip4addr_conv32(ipv4->destipaddr),
+                        dev->d_ipaddr) ||
+      (tcp->flags & ~TCP_PSH) != TCP_ACK)
+    {
+      return NULL;
+    }
+
+  totlen = ((unsigned int)ipv4->len[0] << 8) | ipv4->len[1];
+  hdrlen = IPv4_HDRLEN + ((tcp->tcpoffset >> 4) << 2);
+
+  if (totlen != pkt->io_pktlen || hdrlen < IPv4_HDRLEN + TCP_HDRLEN ||
+      hdrlen >= totlen || hdrlen > pkt->io_len)
+    {
+      return NULL;
+    }
+
+#ifdef CONFIG_NET_IPV4_CHECKSUMS
+  /* The IPv4 header is rebuilt on merging, check it before */
+
+  if (ipv4_chksum(ipv4) != 0xffff)
+    {
+      return NULL;
+    }
+#endif
+
+  return tcp;
+}
+
+/****************************************************************************
+ * Name: netdev_upper_gro_sum
+ *
+ * Description:
+ *   Sum the pseudo header and the TCP header of a segment.  With the
+ *   checksum field left in, the complement of the result is the sum that
+ *   the payload must have for the checksum to be right.
+ *
+ ****************************************************************************/
+
+static uint16_t netdev_upper_gro_sum(FAR struct ipv4_hdr_s *ipv4,
+                                     FAR struct tcp_hdr_s *tcp)
+{
+  unsigned int tcplen = ((tcp->tcpoffset >> 4) << 2);
+  uint16_t sum;
+
+  sum = (((uint16_t)ipv4->len[0] << 8) | ipv4->len[1]) - IPv4_HDRLEN +
+        IP_PROTO_TCP;
+  sum = chksum(sum, (FAR const uint8_t *)ipv4->srcipaddr,
+               2 * sizeof(in_addr_t));
+  return chksum(sum, (FAR const uint8_t *)tcp, tcplen);
+}
+
+/****************************************************************************
+ * Name: netdev_upper_gro_flush
+ *
+ * Description:
+ *   Pass the segment being coalesced into the network stack, with the
+ *   IPv4 and TCP checksums updated if more segments were merged into it.
+ *
+ *   The TCP checksum is derived from the checksums that the segments came
+ *   with, so that a corrupted segment still fails the check in tcp_input.
+ *
+ * Assumptions:
+ *   Called with the network locked.
+ *
+ ****************************************************************************/
+
+static void netdev_upper_gro_flush(FAR struct netdev_upperhalf_s *upper)
+{
+  FAR netpkt_t *pkt = upper->gro;
+  FAR struct ipv4_hdr_s *ipv4;
+  FAR struct tcp_hdr_s *tcp;
+  uint16_t sum;
+
+  if (pkt == NULL)
+    {
+      return;
+    }
+
+  upper->gro = NULL;
+
+  if (upper->gro_segs > 1)
+    {
+      ipv4 = (FAR struct ipv4_hdr_s *)IOB_DATA(pkt);
+      tcp  = (FAR struct tcp_hdr_s *)(IOB_DATA(pkt) + IPv4_HDRLEN);
+
+      ipv4->ipchksum = 0;
+      ipv4->ipchksum = ~ipv4_chksum(ipv4);
+
+      tcp->tcpchksum = 0;
+      sum = netdev_upper_csum_add(netdev_upper_gro_sum(ipv4, tcp),
+                                  upper->gro_sum);
+      tcp->tcpchksum = ~HTONS(sum);
+    }
+
+  netdev_upper_input(upper, pkt);
+}
+
+/****************************************************************************
+ * Name: netdev_upper_gro_receive
+ *
+ * Description:
+ *   Try to coalesce a received TCP segment with the one held back, if it
+ *   is the next in-order segment of the same flow.  A segment that cannot
+ *   be merged flushes the held one and may be held back itself.
+ *
+ * Returned Value:
+ *   true if the packet was taken by GRO, false if it is still owned by the
+ *   caller and must be input as is.
+ *
+ * Assumptions:
+ *   Called with the network locked.
+ *
+ ****************************************************************************/
+
+static bool netdev_upper_gro_receive(FAR struct netdev_upperhalf_s *upper,
+                                     FAR netpkt_t *pkt)
+{
+  FAR struct netdev_lowerhalf_s *lower = upper->lower;
+  FAR struct ipv4_hdr_s *ipv4;
+  FAR struct ipv4_hdr_s *gipv4;
+  FAR struct tcp_hdr_s *tcp;
+  FAR struct tcp_hdr_s *gtcp;
+  unsigned int hdrlen;
+  unsigned int paylen;
+  unsigned int gpaylen;
+  uint32_t seqno;
+  uint32_t gseqno;
+  uint16_t sum;
+  uint16_t len;
+
+  tcp = netdev_upper_gro_tcp(&lower->netdev, pkt);
+  if (tcp == NULL)
+    {
+      /* Keep the order of the flow */
+
+      netdev_upper_gro_flush(upper);
+      return false;
+    }
+
+  ipv4   = (FAR struct ipv4_hdr_s *)IOB_DATA(pkt);
+  hdrlen = IPv4_HDRLEN + ((tcp->tcpoffset >> 4) << 2);
+  paylen = pkt->io_pktlen - hdrlen;
+  sum    = ~netdev_upper_gro_sum(ipv4, tcp);
+
+  if (upper->gro != NULL)
+    {
+      gipv4   = (FAR struct ipv4_hdr_s *)IOB_DATA(upper->gro);
+      gtcp    = (FAR struct tcp_hdr_s *)(IOB_DATA(upper->gro) + IPv4_HDRLEN);
+      gpaylen = upper->gro->io_pktlen - hdrlen;
+      seqno   = ((uint32_t)tcp->seqno[0] << 24) |
+                ((uint32_t)tcp->seqno[1] << 16) |
+                ((uint32_t)tcp->seqno[2] << 8) | tcp->seqno[3];
+      gseqno  = ((uint32_t)gtcp->seqno[0] << 24) |
+                ((uint32_t)gtcp->seqno[1] << 16) |
+                ((uint32_t)gtcp->seqno[2] << 8) | gtcp->seqno[3];
+
+      /* Same flow, next in order, same ACK, window and options */
+
+      if (gtcp->tcpoffset == tcp->tcpoffset &&
+          gipv4->tos == ipv4->tos &&
+          upper->gro->io_pktlen + paylen <= CONFIG_NETDEV_GRO_MAXSIZE &&
+          gseqno + gpaylen == seqno &&
+          memcmp(gipv4->srcipaddr, ipv4->srcipaddr,
+                 2 * sizeof(in_addr_t)) == 0 &&
+          memcmp(gtcp, tcp, offsetof(struct tcp_hdr_s, seqno)) == 0 &&
+          memcmp(gtcp->ackno, tcp->ackno, sizeof(tcp->ackno)) == 0 &&
+          memcmp(gtcp->wnd, tcp->wnd, sizeof(tcp->wnd)) == 0 &&
+          memcmp(gtcp->optdata, tcp->optdata,
+                 hdrlen - IPv4_HDRLEN - TCP_HDRLEN) == 0)
+        {
+          /* The payload sum of the new segment lands byte swapped if it
+           * starts at an odd offset.
+           */
+
+          if ((gpaylen & 1) != 0)
+            {
+              sum = (uint16_t)((sum << 8) | (sum >> 8));
+            }
+
+          upper->gro_sum = netdev_upper_csum_add(upper->gro_sum, sum);
+          upper->gro_segs++;
+
+          gtcp->flags |= tcp->flags & TCP_PSH;
+          len = upper->gro->io_pktlen + paylen;
+          gipv4->len[0] = len >> 8;
+          gipv4->len[1] = len & 0xff;
+
+          iob_concat(upper->gro, iob_trimhead(pkt, hdrlen));
+
+          /* The merged buffers now count against the held packet */
+
+          atomic_fetch_add(&lower->quota[NETPKT_RX], 1);
+
+          if ((gtcp->flags & TCP_PSH) != 0)
+            {
+              netdev_upper_gro_flush(upper);
+            }
+
+          return true;
+        }
+
+      netdev_upper_gro_flush(upper);
+    }
+
+  if ((tcp->flags & TCP_PSH) != 0)
+    {
+      return false;
+    }
+
+  /* Hold it back, the next segment may follow it */
+
+  upper->gro      = pkt;
+  upper->gro_sum  = sum;
+  upper->gro_segs = 1;
+  return true;
+}
+#endif
+
+/****************************************************************************
+ * Function: netdev_upper_rxpoll_work
+ *
+ * Description:
+ *   Try to receive packets from device and pass packets into IP
+ *   stack and send packets which is from IP stack if necessary.
+ *
+ * Input Parameters:
+ *   upper  - Reference to the upper half driver structure
+ *   queue  - The queue to receive from
+ *   budget - The most packets to receive
+ *
+ * Returned Value:
+ *   The number of packets received, less than budget if the driver has
+ *   no more packets.
+ *
+ * Assumptions:
+ *   Called with the network locked.
+ *
+ ****************************************************************************/
+
+static int netdev_upper_rxpoll_work(FAR struct netdev_upperhalf_s *upper,
+                                    int queue, int budget)
+{
+  FAR struct netdev_lowerhalf_s *lower = upper->lower;
+  FAR struct net_driver_s       *dev   = &lower->netdev;
+  FAR netpkt_t                  *pkt;
+  int                            work  = 0;
+
+  /* Loop while receive() successfully retrieves valid Ethernet frames. */
+
+  while (work < budget && (pkt = netdev_upper_receive(lower, queue)) != NULL)
+    {
+      work++;
+
+      if (!IFF_IS_UP(dev->d_flags))
+        {
+          /* Interface down, drop frame */
+
+          NETDEV_RXDROPPED(dev);
+          netpkt_free(lower, pkt, NETPKT_RX);
+          continue;
+        }
+
+#ifdef CONFIG_NETDEV_GRO
+      if ((lower->features & NETDEV_F_GRO) != 0 &&
+          netdev_upper_gro_receive(upper, pkt))
+        {
+          continue;
+        }
+#endif
+
+      netdev_upper_input(upper, pkt);
+    }
+
+#ifdef CONFIG_NETDEV_GRO
+  /* Do not hold a segment beyond the batch that the driver had ready */
+
+  netdev_upper_gro_flush(upper);
+#endif
+
+  return work;
+}
+
+/****************************************************************************
+ * Name: netdev_upper_napi_schedule
+ *
+ * Description:
+ *   Mark the device as having a receive poll pending and mask its RX
+ *   interrupt until the poll has drained it.  If a poll is already
+ *   pending, it is told to look at the device again before completing,
+ *   as the packet may have arrived after it found the queue empty.
+ *
+ * Returned Value:
+ *   True if the poll was not already pending and has to be scheduled.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NETDEV_NAPI
+static bool netdev_upper_napi_schedule(FAR struct netdev_upperhalf_s *upper)
+{
+  FAR struct netdev_lowerhalf_s *lower = upper->lower;
+  irqstate_t flags;
+  bool sched;
+
+  flags = spin_lock_irqsave(&g_napi_lock);
+
+  sched = !upper->napi_sched;
+  if (sched)
+    {
+      upper->napi_sched = true;
+      if (lower->ops->rxint)
+        {
+          lower->ops->rxint(lower, false);
+        }
+
+#  ifndef CONFIG_NETDEV_WORK_THREAD
+      sq_addlast(&upper->napi_node, &g_napi_list);
+#  endif
+    }
+  else
+    {
+      upper->napi_missed = true;
+    }
+
+  spin_unlock_irqrestore(&g_napi_lock, flags);
+  return sched;
+}
+
+/****************************************************************************
+ * Name: netdev_upper_napi_cancel
+ *
+ * Description:
+ *   Forget the pending receive poll of the device, if any.
+ *
+ * Assumptions:
+ *   Called with the network locked.
+ *
+ ****************************************************************************/
+
+static void netdev_upper_napi_cancel(FAR struct netdev_upperhalf_s *upper)
+{
+  irqstate_t flags;
 
-  /* If the above function invocation resulted in data
-   * that should be sent out on the network,
-   * the field d_len will set to a value > 0.
-   */
+  flags = spin_lock_irqsave(&g_napi_lock);
 
-  if (dev->d_len > 0)
+  if (upper->napi_sched)
     {
-      /* And queue the packet for sending later.
-       * Note: RX is tried before TX, so we don't need to call txavail here.
-       */
-
-      netdev_upper_queue_tx(dev);
+      upper->napi_sched  = false;
+      upper->napi_missed = false;
+#  ifndef CONFIG_NETDEV_WORK_THREAD
+      sq_rem(&upper->napi_node, &g_napi_list);
+#  endif
     }
+
+  spin_unlock_irqrestore(&g_napi_lock, flags);
 }
-#endif
 
 /****************************************************************************
- * Name: ip_input
+ * Name: netdev_upper_napi_poll
  *
  * Description:
- *   Handle L3 packet input.
+ *   Receive at most weight packets from the queue.  If it has been
+ *   drained, the poll is completed and the RX interrupt unmasked, unless
+ *   RX became ready again meanwhile, then the queue is polled once more.
  *
- * Input Parameters:
- *   dev - Reference to the NuttX network driver state structure
+ * Returned Value:
+ *   The number of packets received, the device still has packets ready
+ *   if it is weight.
  *
  * Assumptions:
  *   Called with the network locked.
  *
  ****************************************************************************/
 
-#ifdef CONFIG_NET_MBIM
-static void ip_input(FAR struct net_driver_s *dev)
+static int netdev_upper_napi_poll(FAR struct netdev_upperhalf_s *upper,
+                                  int queue, int weight)
 {
-  /* We only accept IP packets of the configured type */
+  FAR struct netdev_lowerhalf_s *lower = upper->lower;
+  irqstate_t flags;
+  bool missed;
+  int work = 0;
 
-#ifdef CONFIG_NET_IPv4
-  if ((IPv4BUF->vhl & IP_VERSION_MASK) == IPv4_VERSION)
+  NETDEV_RXPOLLS(&lower->netdev);
+
+  do
     {
-      ninfo("IPv4 frame\n");
-      NETDEV_RXIPV4(dev);
+      work += netdev_upper_rxpoll_work(upper, queue, weight - work);
+      if (work >= weight)
+        {
+          NETDEV_RXSQUEEZED(&lower->netdev);
+          return work;
+        }
 
-      /* Receive an IPv4 packet from the network device */
+      flags = spin_lock_irqsave(&g_napi_lock);
 
-      ipv4_input(dev);
+      missed = upper->napi_missed;
+      upper->napi_missed = false;
+
+      if (upper->napi_sched && !missed)
+        {
+          upper->napi_sched = false;
+          if (lower->ops->rxint)
+            {
+              lower->ops->rxint(lower, true);
+            }
+        }
+
+      spin_unlock_irqrestore(&g_napi_lock, flags);
     }
-  else
-#endif
-#ifdef CONFIG_NET_IPv6
-  if ((IPv6BUF->vtc & IP_VERSION_MASK) == IPv6_VERSION)
+  while (missed);
+
+  return work;
+}
+
+/****************************************************************************
+ * Name: netdev_upper_napi_work
+ *
+ * Description:
+ *   Poll the devices in the poll list in round-robin, each at most for its
+ *   weight, until CONFIG_NETDEV_NAPI_BUDGET packets have been received.
+ *   The devices left with packets are polled again by a new work queued
+ *   behind the other pending ones.
+ *
+ ****************************************************************************/
+
+#  ifndef CONFIG_NETDEV_WORK_THREAD
+static void netdev_upper_napi_work(FAR void *arg)
+{
+  FAR struct netdev_upperhalf_s *upper;
+  FAR sq_entry_t *node;
+  irqstate_t flags;
+  int budget = CONFIG_NETDEV_NAPI_BUDGET;
+  int weight;
+  int work;
+  bool more;
+
+  net_lock();
+
+  while (budget > 0)
     {
-      ninfo("IPv6 frame\n");
-      NETDEV_RXIPV6(dev);
+      flags = spin_lock_irqsave(&g_napi_lock);
+      node  = sq_remfirst(&g_napi_list);
+      spin_unlock_irqrestore(&g_napi_lock, flags);
 
-      /* Give the IPv6 packet to the network layer */
+      if (node == NULL)
+        {
+          break;
+        }
 
-      ipv6_input(dev);
+      upper  = container_of(node, struct netdev_upperhalf_s, napi_node);
+      weight = MIN(upper->napi_weight, budget);
+      work   = netdev_upper_napi_poll(upper, 0, weight);
+      budget -= work;
+
+      if (work >= weight)
+        {
+          /* Still scheduled, go to the tail for the next round */
+
+          flags = spin_lock_irqsave(&g_napi_lock);
+          sq_addlast(&upper->napi_node, &g_napi_list);
+          spin_unlock_irqrestore(&g_napi_lock, flags);
+        }
+
+      /* Send the replies and what the poll made room for */
+
+      netdev_upper_txavail_work(upper);
     }
-  else
-#endif
+
+  net_unlock();
+
+  flags = spin_lock_irqsave(&g_napi_lock);
+  more  = !sq_empty(&g_napi_list);
+  spin_unlock_irqrestore(&g_napi_lock, flags);
+
+  if (more && work_available(&g_napi_work))
     {
-      ninfo("INFO: Dropped, Unknown type\n");
-      NETDEV_RXDROPPED(dev);
-      dev->d_len = 0;
+      work_queue(NETDEV_WORK, &g_napi_work, netdev_upper_napi_work,
+                 NULL, 0);
     }
+}
+#  endif
+#endif /* CONFIG_NETDEV_NAPI */
 
-  /* If the above function invocation resulted in data
-   * that should be sent out on the network,
-   * the field d_len will set to a value > 0.
-   */
+/****************************************************************************
+ * Name: netdev_upper_post
+ *
+ * Description:
+ *   Wake up the dedicated thread of the given index, if not already.
+ *
+ ****************************************************************************/
 
-  if (dev->d_len > 0)
-    {
-      /* And queue the packet for sending later.
-       * Note: RX is tried before TX, so we don't need to call txavail here.
-       */
+#ifdef CONFIG_NETDEV_WORK_THREAD
+static void netdev_upper_post(FAR struct netdev_upperhalf_s *upper,
+                              int index)
+{
+  int semcount;
 
-      netdev_upper_queue_tx(dev);
+  if (nxsem_get_value(&upper->sem[index], &semcount) == OK &&
+      semcount <= 0)
+    {
+      nxsem_post(&upper->sem[index]);
     }
 }
 #endif
 
 /****************************************************************************
- * Function: netdev_upper_rxpoll_work
+ * Name: netdev_upper_poll
  *
  * Description:
- *   Try to receive packets from device and pass packets into IP
- *   stack and send packets which is from IP stack if necessary.
+ *   Receive from the queue served by the thread of the given index (0 on
+ *   the worker thread), then send what is pending.
  *
  * Input Parameters:
  *   upper - Reference to the upper half driver structure
- *
- * Assumptions:
- *   Called with the network locked.
+ *   index - The index of the dedicated thread
  *
  ****************************************************************************/
 
-static void netdev_upper_rxpoll_work(FAR struct netdev_upperhalf_s *upper)
+static void netdev_upper_poll(FAR struct netdev_upperhalf_s *upper,
+                              int index)
 {
-  FAR struct netdev_lowerhalf_s *lower = upper->lower;
-  FAR struct net_driver_s       *dev   = &lower->netdev;
-  FAR netpkt_t                  *pkt;
+  int queue = 0;
 
-  /* Loop while receive() successfully retrieves valid Ethernet frames. */
+#ifdef CONFIG_NETDEV_RSS
+  /* Each queue has its own thread, the remaining threads help queue 0 */
 
-  while ((pkt = lower->ops->receive(lower)) != NULL)
+  if (index < upper->lower->nqueues)
     {
-      if (!IFF_IS_UP(dev->d_flags))
-        {
-          /* Interface down, drop frame */
-
-          NETDEV_RXDROPPED(dev);
-          netpkt_free(lower, pkt, NETPKT_RX);
-          continue;
-        }
+      queue = index;
+    }
+#endif
 
-      netpkt_put(dev, pkt, NETPKT_RX);
-      NETDEV_RXPACKETS(dev);
+  /* RX may release quota and driver buffer, so do RX first. */
 
-#ifdef CONFIG_NET_PKT
-      /* When packet sockets are enabled, feed the frame into the tap */
+  net_lock();
+#if !defined(CONFIG_NETDEV_NAPI)
+  netdev_upper_rxpoll_work(upper, queue, INT_MAX);
+#elif defined(CONFIG_NETDEV_WORK_THREAD)
+  if (netdev_upper_napi_poll(upper, queue, upper->napi_weight) >=
+      upper->napi_weight)
+    {
+      /* Packets are left, come back after the others had the lock */
 
-      pkt_input(dev);
+      netdev_upper_post(upper, index);
+    }
+#else
+  UNUSED(queue); /* Received by netdev_upper_napi_work() */
 #endif
 
-      switch (dev->d_lltype)
-        {
-#ifdef CONFIG_NET_LOOPBACK
-        case NET_LL_LOOPBACK:
-#endif
-#ifdef CONFIG_NET_ETHERNET
-        case NET_LL_ETHERNET:
-#endif
-#ifdef CONFIG_DRIVERS_IEEE80211
-        case NET_LL_IEEE80211:
-#endif
-#if defined(CONFIG_NET_LOOPBACK) || defined(CONFIG_NET_ETHERNET) || \
-    defined(CONFIG_DRIVERS_IEEE80211)
-          eth_input(dev);
-          break;
-#endif
-#ifdef CONFIG_NET_MBIM
-        case NET_LL_MBIM:
-          ip_input(dev);
-          break;
-#endif
-#ifdef CONFIG_NET_CAN
-        case NET_LL_CAN:
-          ninfo("CAN frame");
-          can_input(dev);
-          break;
-#endif
-        default:
-          nerr("Unknown link type %d\n", dev->d_lltype);
-          break;
-        }
-    }
+  netdev_upper_txavail_work(upper);
+  net_unlock();
 }
 
 /****************************************************************************
  * Name: netdev_upper_work
  *
  * Description:
- *   Perform an out-of-cycle poll on a dedicated thread or the worker thread.
+ *   Perform an out-of-cycle poll on the worker thread.
  *
  * Input Parameters:
  *   arg - Reference to the upper half driver structure (cast to void *)
  *
  ****************************************************************************/
 
+#ifndef CONFIG_NETDEV_WORK_THREAD
 static void netdev_upper_work(FAR void *arg)
 {
-  FAR struct netdev_upperhalf_s *upper = arg;
-
-  /* RX may release quota and driver buffer, so do RX first. */
-
-  net_lock();
-  netdev_upper_rxpoll_work(upper);
-  netdev_upper_txavail_work(upper);
-  net_unlock();
+  netdev_upper_poll(arg, 0);
 }
+#endif
 
 /****************************************************************************
  * Name: netdev_upper_wait
@@ -727,7 +1696,7 @@ static int netdev_upper_loop(int argc, FAR char *argv[])
   while (netdev_upper_wait(&upper->sem[cpu]) == OK &&
          upper->tid[cpu] != INVALID_PROCESS_ID)
     {
-      netdev_upper_work(upper);
+      netdev_upper_poll(upper, cpu);
     }
 
   nwarn("WARNING: Netdev work thread quitting.");
@@ -752,14 +1721,7 @@ static inline void netdev_upper_queue_work(FAR struct net_driver_s *dev)
   FAR struct netdev_upperhalf_s *upper = dev->d_private;
 
 #ifdef CONFIG_NETDEV_WORK_THREAD
-  int cpu = this_cpu();
-  int semcount;
-
-  if (nxsem_get_value(&upper->sem[cpu], &semcount) == OK &&
-      semcount <= 0)
-    {
-      nxsem_post(&upper->sem[cpu]);
-    }
+  netdev_upper_post(upper, this_cpu());
 #else
   if (work_available(&upper->work))
     {
@@ -787,6 +1749,47 @@ static int netdev_upper_txavail(FAR struct net_driver_s *dev)
   return OK;
 }
 
+/****************************************************************************
+ * Name: netdev_upper_busypoll
+ *
+ * Description:
+ *   Receive at most budget packets for a busy polling socket, then send
+ *   the replies.
+ *
+ * Input Parameters:
+ *   dev    - Reference to the NuttX driver state structure
+ *   budget - The most packets to receive
+ *
+ * Returned Value:
+ *   The number of packets received.
+ *
+ * Assumptions:
+ *   Called with the network locked.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_BUSY_POLL
+static int netdev_upper_busypoll(FAR struct net_driver_s *dev, int budget)
+{
+  FAR struct netdev_upperhalf_s *upper = dev->d_private;
+  int nqueues = MAX(upper->lower->nqueues, 1);
+  int work = 0;
+  int queue;
+
+  for (queue = 0; queue < nqueues && work < budget; queue++)
+    {
+      work += netdev_upper_rxpoll_work(upper, queue, budget - work);
+    }
+
+  if (work > 0)
+    {
+      netdev_upper_txavail_work(upper);
+    }
+
+  return work;
+}
+#endif
+
 /****************************************************************************
  * Name: netdev_upper_wireless_ioctl
  *
@@ -1093,6 +2096,9 @@ static int netdev_upper_ifdown(FAR struct net_driver_s *dev)
 #ifndef CONFIG_NETDEV_WORK_THREAD
   work_cancel(NETDEV_WORK, &upper->work);
 #endif
+#ifdef CONFIG_NETDEV_NAPI
+  netdev_upper_napi_cancel(upper);
+#endif
 
   if (upper->lower->ops->ifdown)
     {
@@ -1139,6 +2145,24 @@ static int netdev_upper_ioctl(FAR struct net_driver_s *dev, int cmd,
   FAR struct netdev_upperhalf_s *upper = dev->d_private;
   FAR struct netdev_lowerhalf_s *lower = upper->lower;
 
+#ifdef CONFIG_NETDEV_RSS
+  if (cmd == SIOCNOTIFYRECVCPU && lower->nqueues > 1)
+    {
+      FAR struct netdev_rss_s *rss = (FAR struct netdev_rss_s *)arg;
+
+      /* Send the flow through the queue of the CPU receiving it, so that
+       * the devices steering RX by the TX queue deliver it there.
+       */
+
+      upper->rss_table[rss->hash % NETDEV_RSS_TABLE_SIZE] =
+        rss->cpu % lower->nqueues;
+      if (lower->ops->ioctl == NULL)
+        {
+          return OK;
+        }
+    }
+#endif
+
 #ifdef CONFIG_NETDEV_WIRELESS_HANDLER
   if (lower->iw_ops)
     {
@@ -1185,7 +2209,7 @@ int netdev_lower_register(FAR struct netdev_lowerhalf_s *dev,
 {
   FAR struct netdev_upperhalf_s *upper;
   int ret;
-#ifdef CONFIG_NETDEV_WORK_THREAD
+#if defined(CONFIG_NETDEV_WORK_THREAD) || defined(CONFIG_NETDEV_RSS)
   int i;
 #endif
 
@@ -1195,6 +2219,12 @@ int netdev_lower_register(FAR struct netdev_lowerhalf_s *dev,
       return -EINVAL;
     }
 
+  if (dev->nqueues > 1 && (dev->nqueues > NETDEV_MAX_QUEUES ||
+      dev->ops->transmit_queue == NULL || dev->ops->receive_queue == NULL))
+    {
+      return -EINVAL;
+    }
+
   if ((upper = netdev_upper_alloc(dev)) == NULL)
     {
       return -ENOMEM;
@@ -1210,8 +2240,40 @@ int netdev_lower_register(FAR struct netdev_lowerhalf_s *dev,
 #ifdef CONFIG_NETDEV_IOCTL
   dev->netdev.d_ioctl   = netdev_upper_ioctl;
 #endif
+#ifdef CONFIG_NET_BUSY_POLL
+  if ((dev->features & NETDEV_F_BUSYPOLL) != 0)
+    {
+      dev->netdev.d_busypoll = netdev_upper_busypoll;
+    }
+#endif
+
   dev->netdev.d_private = upper;
 
+#ifdef CONFIG_NETDEV_GSO
+  /* TCP may build packets up to the GSO limit, they are segmented by the
+   * lower half if it can, or by netdev_upper_gso_segment() otherwise.
+   */
+
+  dev->netdev.d_gsomax  = CONFIG_NETDEV_GSO_MAXSIZE;
+  if ((dev->features & NETDEV_F_TSO4) != 0 && dev->gso_maxsize > 0 &&
+      dev->gso_maxsize < CONFIG_NETDEV_GSO_MAXSIZE)
+    {
+      dev->netdev.d_gsomax = dev->gso_maxsize;
+    }
+#endif
+
+#ifdef CONFIG_NETDEV_NAPI
+  upper->napi_weight = dev->napi_weight > 0 ? dev->napi_weight :
+                       CONFIG_NETDEV_NAPI_WEIGHT;
+#endif
+
+#ifdef CONFIG_NETDEV_RSS
+  for (i = 0; i < NETDEV_RSS_TABLE_SIZE; i++)
+    {
+      upper->rss_table[i] = dev->nqueues > 1 ? i % dev->nqueues : 0;
+    }
+#endif
+
   ret = netdev_register(&dev->netdev, lltype);
   if (ret < 0)
     {
@@ -1265,6 +2327,12 @@ int netdev_lower_unregister(FAR struct netdev_lowerhalf_s *dev)
       return ret;
     }
 
+#ifdef CONFIG_NETDEV_NAPI
+  net_lock();
+  netdev_upper_napi_cancel(upper);
+  net_unlock();
+#endif
+
 #ifdef CONFIG_NETDEV_WORK_THREAD
   for (i = 0; i < NETDEV_THREAD_COUNT; i++)
     {
@@ -1339,11 +2407,61 @@ void netdev_lower_carrier_off(FAR struct netdev_lowerhalf_s *dev)
 
 void netdev_lower_rxready(FAR struct netdev_lowerhalf_s *dev)
 {
-#if CONFIG_NETDEV_WORK_THREAD_POLLING_PERIOD == 0
+#ifdef CONFIG_NETDEV_NAPI
+  NETDEV_RXIRQS(&dev->netdev);
+
+  if (netdev_upper_napi_schedule(dev->netdev.d_private))
+    {
+#  if !defined(CONFIG_NETDEV_WORK_THREAD)
+      if (work_available(&g_napi_work))
+        {
+          work_queue(NETDEV_WORK, &g_napi_work, netdev_upper_napi_work,
+                     NULL, 0);
+        }
+#  elif CONFIG_NETDEV_WORK_THREAD_POLLING_PERIOD == 0
+      netdev_upper_queue_work(&dev->netdev);
+#  endif
+    }
+#elif CONFIG_NETDEV_WORK_THREAD_POLLING_PERIOD == 0
   netdev_upper_queue_work(&dev->netdev);
 #endif
 }
 
+/****************************************************************************
+ * Name: netdev_lower_rxready_queue
+ *
+ * Description:
+ *   Notifies the networking layer about an RX packet is ready to read from
+ *   the given queue.
+ *
+ * Input Parameters:
+ *   dev   - The lower half device driver structure
+ *   queue - The queue having packets
+ *
+ ****************************************************************************/
+
+void netdev_lower_rxready_queue(FAR struct netdev_lowerhalf_s *dev,
+                                int queue)
+{
+#ifdef CONFIG_NETDEV_RSS
+  if (dev->nqueues > 1)
+    {
+      /* The thread of the queue runs on its own CPU, with the interrupt of
+       * the queue ideally.
+       */
+
+#  if CONFIG_NETDEV_WORK_THREAD_POLLING_PERIOD == 0
+      netdev_upper_post(dev->netdev.d_private, queue);
+#  endif
+      return;
+    }
+#else
+  UNUSED(queue);
+#endif
+
+  netdev_lower_rxready(dev);
+}
+
 /****************************************************************************
  * Name: netdev_lower_txdone
  *
@@ -34,10 +34,13 @@
 
 #include <poll.h>
 #include <fcntl.h>
+#include <sys/mman.h>
 #include <nuttx/list.h>
 #include <nuttx/kmalloc.h>
 #include <nuttx/circbuf.h>
 #include <nuttx/mutex.h>
+#include <nuttx/nuttx.h>
+#include <nuttx/spinlock.h>
 #include <nuttx/sensors/sensor.h>
 #include <nuttx/lib/lib.h>
 
@@ -51,6 +54,8 @@
 #define DEVNAME_FMT         "/dev/uorb/sensor_%s%s%d"
 #define DEVNAME_UNCAL       "_uncal"
 #define TIMING_BUF_ESIZE    (sizeof(uint32_t))
+#define RING_OFFSET         ALIGN_UP(sizeof(struct sensor_ring_s), \
+                                     sizeof(uint64_t))
 
 /****************************************************************************
  * Private Types
@@ -101,6 +106,10 @@ struct sensor_user_s
   bool             flushing;   /* The is used to indicate user is flushing */
   sem_t            buffersem;  /* Wakeup user waiting for data in circular buffer */
   size_t           bufferpos;  /* The index of user generation in buffer */
+#ifdef CONFIG_SENSORS_MMAP
+  bool             mapped;     /* The user reads the ring in place */
+  uint32_t         ringseq;    /* The ring sequence seen by the last poll */
+#endif
 
   /* The subscriber info
    * Support multi advertisers to subscribe their own data when they
@@ -118,6 +127,9 @@ struct sensor_upperhalf_s
   struct sensor_state_s          state;  /* The state of sensor device */
   struct circbuf_s   timing;             /* The circular buffer of generation */
   struct circbuf_s   buffer;             /* The circular buffer of data */
+#ifdef CONFIG_SENSORS_MMAP
+  FAR struct sensor_ring_s *ring;        /* The header of the mapped buffer */
+#endif
   rmutex_t           lock;               /* Manages exclusive access to file operations */
   struct list_node   userlist;           /* List of users */
 };
@@ -138,6 +150,10 @@ static int     sensor_ioctl(FAR struct file *filep, int cmd,
                             unsigned long arg);
 static int     sensor_poll(FAR struct file *filep, FAR struct pollfd *fds,
                            bool setup);
+#ifdef CONFIG_SENSORS_MMAP
+static int     sensor_mmap(FAR struct file *filep,
+                           FAR struct mm_map_entry_s *map);
+#endif
 static ssize_t sensor_push_event(FAR void *priv, FAR const void *data,
                                  size_t bytes);
 
@@ -222,7 +238,11 @@ static const struct file_operations g_sensor_fops =
   sensor_write,   /* write */
   NULL,           /* seek  */
   sensor_ioctl,   /* ioctl */
+#ifdef CONFIG_SENSORS_MMAP
+  sensor_mmap,    /* mmap */
+#else
   NULL,           /* mmap */
+#endif
   NULL,           /* truncate */
   sensor_poll     /* poll  */
 };
@@ -384,6 +404,64 @@ update:
   return ret;
 }
 
+static int sensor_buffer_init(FAR struct sensor_upperhalf_s *upper)
+{
+  FAR struct sensor_lowerhalf_s *lower = upper->lower;
+  size_t size = lower->nbuffer * upper->state.esize;
+  FAR void *base = NULL;
+  int ret;
+
+#ifdef CONFIG_SENSORS_MMAP
+  /* Put the data right behind a header describing it, from memory that
+   * subscribers can map.
+   */
+
+  upper->ring = kumm_zalloc(RING_OFFSET + size);
+  if (upper->ring == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  upper->ring->esize   = upper->state.esize;
+  upper->ring->nbuffer = lower->nbuffer;
+  upper->ring->offset  = RING_OFFSET;
+  base = (FAR char *)upper->ring + RING_OFFSET;
+#endif
+
+  ret = circbuf_init(&upper->buffer, base, size);
+  if (ret < 0)
+    {
+      goto errout;
+    }
+
+  ret = circbuf_init(&upper->timing, NULL, lower->nbuffer *
+                     TIMING_BUF_ESIZE);
+  if (ret < 0)
+    {
+      circbuf_uninit(&upper->buffer);
+      goto errout;
+    }
+
+  return ret;
+
+errout:
+#ifdef CONFIG_SENSORS_MMAP
+  kumm_free(upper->ring);
+  upper->ring = NULL;
+#endif
+  return ret;
+}
+
+static void sensor_buffer_uninit(FAR struct sensor_upperhalf_s *upper)
+{
+  circbuf_uninit(&upper->buffer);
+  circbuf_uninit(&upper->timing);
+#ifdef CONFIG_SENSORS_MMAP
+  kumm_free(upper->ring);
+  upper->ring = NULL;
+#endif
+}
+
 static void sensor_generate_timing(FAR struct sensor_upperhalf_s *upper,
                                    unsigned long nums)
 {
@@ -1057,6 +1135,20 @@ static int sensor_poll(FAR struct file *filep,
                 }
             }
         }
+#ifdef CONFIG_SENSORS_MMAP
+      else if (user->mapped)
+        {
+          /* Mapped readers consume the ring without telling us, so report
+           * what was published since they polled last time.
+           */
+
+          if (user->ringseq != upper->ring->seq)
+            {
+              user->ringseq = upper->ring->seq;
+              eventset |= POLLIN;
+            }
+        }
+#endif
       else if (sensor_is_updated(upper, user))
         {
           eventset |= POLLIN;
@@ -1080,11 +1172,59 @@ errout:
   return ret;
 }
 
+#ifdef CONFIG_SENSORS_MMAP
+static int sensor_mmap(FAR struct file *filep,
+                       FAR struct mm_map_entry_s *map)
+{
+  FAR struct inode *inode = filep->f_inode;
+  FAR struct sensor_upperhalf_s *upper = inode->i_private;
+  FAR struct sensor_lowerhalf_s *lower = upper->lower;
+  FAR struct sensor_user_s *user = filep->f_priv;
+  int ret = 0;
+
+  /* Only topics buffered by the upper half can be mapped, read only */
+
+  if (lower->ops->fetch)
+    {
+      return -ENOTSUP;
+    }
+
+  if ((map->prot & PROT_WRITE) != 0)
+    {
+      return -EACCES;
+    }
+
+  nxrmutex_lock(&upper->lock);
+  if (!circbuf_is_init(&upper->buffer))
+    {
+      ret = sensor_buffer_init(upper);
+      if (ret < 0)
+        {
+          goto out;
+        }
+    }
+
+  if (map->offset != 0 ||
+      map->length > upper->ring->offset + upper->buffer.size)
+    {
+      ret = -EINVAL;
+      goto out;
+    }
+
+  map->vaddr    = upper->ring;
+  user->mapped  = true;
+  user->ringseq = upper->ring->seq;
+
+out:
+  nxrmutex_unlock(&upper->lock);
+  return ret;
+}
+#endif
+
 static ssize_t sensor_push_event(FAR void *priv, FAR const void *data,
                                  size_t bytes)
 {
   FAR struct sensor_upperhalf_s *upper = priv;
-  FAR struct sensor_lowerhalf_s *lower = upper->lower;
   FAR struct sensor_user_s *user;
   unsigned long envcount;
   int semcount;
@@ -1119,25 +1259,32 @@ static ssize_t sensor_push_event(FAR void *priv, FAR const void *data,
     {
       /* Initialize sensor buffer when data is first generated */
 
-      ret = circbuf_init(&upper->buffer, NULL, lower->nbuffer *
-                         upper->state.esize);
-      if (ret < 0)
-        {
-          nxrmutex_unlock(&upper->lock);
-          return ret;
-        }
-
-      ret = circbuf_init(&upper->timing, NULL, lower->nbuffer *
-                         TIMING_BUF_ESIZE);
+      ret = sensor_buffer_init(upper);
       if (ret < 0)
         {
-          circbuf_uninit(&upper->buffer);
           nxrmutex_unlock(&upper->lock);
           return ret;
         }
     }
 
+#ifdef CONFIG_SENSORS_MMAP
+  /* Tell mapped readers which elements are about to be overwritten before
+   * touching them, and publish the new ones only once they are complete.
+   */
+
+  upper->ring->wseq += envcount;
+  SP_DMB();
+#endif
+
   circbuf_overwrite(&upper->buffer, data, bytes);
+
+#ifdef CONFIG_SENSORS_MMAP
+  upper->ring->head = upper->buffer.head % upper->buffer.size /
+                      upper->state.esize;
+  SP_DMB();
+  upper->ring->seq = upper->ring->wseq;
+#endif
+
   sensor_generate_timing(upper, envcount);
   list_for_every_entry(&upper->userlist, user, struct sensor_user_s, node)
     {
@@ -1149,6 +1296,15 @@ static ssize_t sensor_push_event(FAR void *priv, FAR const void *data,
               nxsem_post(&user->buffersem);
             }
 
+#ifdef CONFIG_SENSORS_MMAP
+          /* A mapped reader woken up now will see this batch anyway */
+
+          if (user->mapped && user->fds != NULL)
+            {
+              user->ringseq = upper->ring->seq;
+            }
+#endif
+
           sensor_pollnotify_one(user, POLLIN, SENSOR_ROLE_RD);
         }
     }
@@ -1439,8 +1595,7 @@ void sensor_custom_unregister(FAR struct sensor_lowerhalf_s *lower,
   nxrmutex_destroy(&upper->lock);
   if (circbuf_is_init(&upper->buffer))
     {
-      circbuf_uninit(&upper->buffer);
-      circbuf_uninit(&upper->timing);
+      sensor_buffer_uninit(upper);
     }
 
   kmm_free(upper);
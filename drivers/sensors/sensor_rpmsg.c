@@ -26,11 +26,14 @@
 
 #include <fcntl.h>
 #include <debug.h>
+#include <string.h>
+#include <sys/stat.h>
 
 #include <nuttx/nuttx.h>
 #include <nuttx/list.h>
 #include <nuttx/kmalloc.h>
 #include <nuttx/mutex.h>
+#include <nuttx/fs/procfs.h>
 #include <nuttx/sensors/sensor.h>
 #include <nuttx/rpmsg/rpmsg.h>
 
@@ -49,6 +52,13 @@
 #define SENSOR_RPMSG_IOCTL         7
 #define SENSOR_RPMSG_IOCTL_ACK     8
 
+#ifdef CONFIG_SENSORS_RPMSG_STATS
+#  define SENSOR_RPMSG_STAT(sre, name, n) ((sre)->stats.name += (n))
+#  define SENSOR_RPMSG_LINELEN          128
+#else
+#  define SENSOR_RPMSG_STAT(sre, name, n)
+#endif
+
 #define SENSOR_RPMSG_FUNCTION(name, cmd, arg1, arg2, size, wait, type) \
 static int sensor_rpmsg_##name(FAR struct sensor_lowerhalf_s *lower, \
                                FAR struct file *filep, \
@@ -93,7 +103,26 @@ struct sensor_rpmsg_dev_s
   char                           path[1];
 };
 
-/* This structure describes the context of sensor rpmsg endpoint. */
+/* This structure describes the batching statistics of one remote cpu. */
+
+#ifdef CONFIG_SENSORS_RPMSG_STATS
+struct sensor_rpmsg_stats_s
+{
+  uint32_t                       txmsgs;   /* Publish messages sent */
+  uint32_t                       txcells;  /* Topic batches in messages */
+  uint32_t                       txbytes;  /* Bytes of publish messages */
+  uint32_t                       txfull;   /* Messages sent when full */
+  uint32_t                       txerrors; /* Messages failed to send */
+  uint32_t                       rxmsgs;   /* Publish messages received */
+  uint32_t                       rxcells;  /* Topic batches received */
+};
+#endif
+
+/* This structure describes the context of sensor rpmsg endpoint.  The
+ * samples published to all the topics subscribed by the remote cpu are
+ * batched in buffer, which is sent when it is full or at expire, the
+ * earliest deadline of the samples in it.
+ */
 
 struct sensor_rpmsg_ept_s
 {
@@ -106,6 +135,9 @@ struct sensor_rpmsg_ept_s
   uint64_t                       expire;
   uint32_t                       space;
   size_t                         written;
+#ifdef CONFIG_SENSORS_RPMSG_STATS
+  struct sensor_rpmsg_stats_s    stats;
+#endif
 };
 
 /* This structure describes the stub info about remote subscribers. */
@@ -252,6 +284,19 @@ static int sensor_rpmsg_ioctlack_handler(FAR struct rpmsg_endpoint *ept,
                                          FAR void *data, size_t len,
                                          uint32_t src, FAR void *priv);
 
+#ifdef CONFIG_SENSORS_RPMSG_STATS
+static int     sensor_rpmsg_procfs_open(FAR struct file *filep,
+                                        FAR const char *relpath,
+                                        int oflags, mode_t mode);
+static int     sensor_rpmsg_procfs_close(FAR struct file *filep);
+static ssize_t sensor_rpmsg_procfs_read(FAR struct file *filep,
+                                        FAR char *buffer, size_t buflen);
+static int     sensor_rpmsg_procfs_dup(FAR const struct file *oldp,
+                                       FAR struct file *newp);
+static int     sensor_rpmsg_procfs_stat(FAR const char *relpath,
+                                        FAR struct stat *buf);
+#endif
+
 /****************************************************************************
  * Private Data
  ****************************************************************************/
@@ -284,6 +329,31 @@ static const rpmsg_ept_cb g_sensor_rpmsg_handler[] =
   [SENSOR_RPMSG_IOCTL_ACK]     = sensor_rpmsg_ioctlack_handler,
 };
 
+#ifdef CONFIG_SENSORS_RPMSG_STATS
+static const struct procfs_operations g_sensor_rpmsg_procfs_operations =
+{
+  sensor_rpmsg_procfs_open,  /* open */
+  sensor_rpmsg_procfs_close, /* close */
+  sensor_rpmsg_procfs_read,  /* read */
+  NULL,                      /* write */
+  NULL,                      /* poll */
+
+  sensor_rpmsg_procfs_dup,   /* dup */
+
+  NULL,                      /* opendir */
+  NULL,                      /* closedir */
+  NULL,                      /* readdir */
+  NULL,                      /* rewinddir */
+
+  sensor_rpmsg_procfs_stat   /* stat */
+};
+
+static const struct procfs_entry_s g_sensor_rpmsg_procfs =
+{
+  "sensor_rpmsg", &g_sensor_rpmsg_procfs_operations, PROCFS_FILE_TYPE
+};
+#endif
+
 static struct list_node g_devlist = LIST_INITIAL_VALUE(g_devlist);
 static struct list_node g_eptlist = LIST_INITIAL_VALUE(g_eptlist);
 static rmutex_t g_ept_lock = NXRMUTEX_INITIALIZER;
@@ -802,23 +872,39 @@ static int sensor_rpmsg_control(FAR struct sensor_lowerhalf_s *lower,
   return -ENOTTY;
 }
 
+static void sensor_rpmsg_send_buffer(FAR struct sensor_rpmsg_ept_s *sre,
+                                     bool full)
+{
+  int ret;
+
+  ret = rpmsg_send_nocopy(&sre->ept, sre->buffer, sre->written);
+  if (ret < 0)
+    {
+      rpmsg_release_tx_buffer(&sre->ept, sre->buffer);
+      SENSOR_RPMSG_STAT(sre, txerrors, 1);
+      snerr("ERROR: push event rpmsg send failed:%d, %s\n",
+            ret, rpmsg_get_cpuname(sre->ept.rdev));
+    }
+  else
+    {
+      SENSOR_RPMSG_STAT(sre, txmsgs, 1);
+      SENSOR_RPMSG_STAT(sre, txbytes, sre->written);
+      SENSOR_RPMSG_STAT(sre, txfull, full);
+    }
+
+  UNUSED(full);
+  sre->buffer = NULL;
+  sre->expire = UINT64_MAX;
+}
+
 static void sensor_rpmsg_data_worker(FAR void *arg)
 {
   FAR struct sensor_rpmsg_ept_s *sre = arg;
-  int ret;
 
   nxrmutex_lock(&sre->lock);
   if (sre->buffer)
     {
-      ret = rpmsg_send_nocopy(&sre->ept, sre->buffer, sre->written);
-      if (ret < 0)
-        {
-          rpmsg_release_tx_buffer(&sre->ept, sre->buffer);
-          snerr("ERROR: push event rpmsg send failed:%d, %s\n",
-                ret, rpmsg_get_cpuname(sre->ept.rdev));
-        }
-
-      sre->buffer = NULL;
+      sensor_rpmsg_send_buffer(sre, false);
     }
 
   nxrmutex_unlock(&sre->lock);
@@ -832,7 +918,11 @@ static void sensor_rpmsg_push_event_one(FAR struct sensor_rpmsg_dev_s *dev,
   FAR struct sensor_rpmsg_ept_s *sre;
   FAR struct sensor_rpmsg_data_s *msg;
   struct sensor_ustate_s state;
+  uint64_t expire;
+  uint64_t budget;
+  uint64_t start;
   uint64_t now;
+  bool expired;
   bool updated;
   int ret;
 
@@ -849,15 +939,23 @@ static void sensor_rpmsg_push_event_one(FAR struct sensor_rpmsg_dev_s *dev,
       state.interval = 0;
     }
 
+  if (state.latency == UINT32_MAX)
+    {
+      state.latency = 0;
+    }
+
+  /* The samples may be held for the batch latency the remote subscriber
+   * asked for, or else for half of its interval.
+   */
+
+  budget = state.latency ? state.latency : state.interval / 2;
+
   sre = container_of(stub->ept, struct sensor_rpmsg_ept_s, ept);
   nxrmutex_lock(&sre->lock);
 
-  /* Cancel work to fill new data to buffer */
-
-  if (sre->buffer)
-    {
-      work_cancel(HPWORK, &sre->work);
-    }
+  now     = sensor_get_timestamp();
+  expire  = sre->buffer ? sre->expire : UINT64_MAX;
+  expired = expire <= now;
 
   for (; ; )
     {
@@ -876,8 +974,7 @@ static void sensor_rpmsg_push_event_one(FAR struct sensor_rpmsg_dev_s *dev,
         {
           if (sre->buffer)
             {
-              rpmsg_send_nocopy(&sre->ept, sre->buffer, sre->written);
-              sre->buffer = NULL;
+              sensor_rpmsg_send_buffer(sre, true);
             }
 
           msg = rpmsg_get_tx_payload_buffer(&sre->ept, &sre->space, true);
@@ -893,9 +990,12 @@ static void sensor_rpmsg_push_event_one(FAR struct sensor_rpmsg_dev_s *dev,
           msg->command = SENSOR_RPMSG_PUBLISH;
           sre->written = sizeof(*msg);
           sre->expire  = UINT64_MAX;
+          expire       = UINT64_MAX;
+          expired      = false;
         }
 
-      cell = sre->buffer + sre->written;
+      cell  = sre->buffer + sre->written;
+      start = now;
       if (flushed)
         {
           flushed = false;
@@ -909,6 +1009,21 @@ static void sensor_rpmsg_push_event_one(FAR struct sensor_rpmsg_dev_s *dev,
             {
               break;
             }
+
+          /* All the topics begin with the timestamp of the sample, count
+           * the budget from the oldest one, so the samples batched by the
+           * lower half already are not delayed again.
+           */
+
+          if (ret >= (int)sizeof(uint64_t))
+            {
+              uint64_t timestamp = *(FAR uint64_t *)cell->data;
+
+              if (timestamp != 0 && timestamp < start)
+                {
+                  start = timestamp;
+                }
+            }
         }
 
       cell->len     = ret;
@@ -916,35 +1031,30 @@ static void sensor_rpmsg_push_event_one(FAR struct sensor_rpmsg_dev_s *dev,
       cell->nbuffer = dev->lower.nbuffer;
 
       sre->written += (sizeof(*cell) + ret + 0x7) & ~0x7;
+      SENSOR_RPMSG_STAT(sre, txcells, 1);
+
+      if (sre->expire > start + budget)
+        {
+          sre->expire = start + budget;
+        }
     }
 
-  /* If buffer timeout is expired, do rpmsg_send_nocopy, otherwise using
-   * delay work to send data.
+  /* If buffer timeout was already expired, do rpmsg_send_nocopy, otherwise
+   * using delay work to send data at the earliest deadline, so the samples
+   * of all topics bound for the same remote cpu share one message.
    */
 
-  now = sensor_get_timestamp();
-  if (sre->expire <= now && sre->buffer)
+  if (sre->buffer && expired)
     {
-      ret = rpmsg_send_nocopy(&sre->ept, sre->buffer, sre->written);
-      if (ret < 0)
-        {
-          rpmsg_release_tx_buffer(&sre->ept, sre->buffer);
-          snerr("ERROR: push event rpmsg send failed:%d, %s\n",
-                ret, rpmsg_get_cpuname(sre->ept.rdev));
-        }
-
-      sre->buffer = NULL;
+      work_cancel(HPWORK, &sre->work);
+      sensor_rpmsg_send_buffer(sre, false);
     }
-  else
+  else if (sre->buffer && sre->expire != UINT64_MAX &&
+           (sre->expire < expire || work_available(&sre->work)))
     {
-      if (sre->expire == UINT64_MAX ||
-          sre->expire - now > state.interval / 2)
-        {
-          sre->expire = now + state.interval / 2;
-        }
-
       work_queue(HPWORK, &sre->work, sensor_rpmsg_data_worker, sre,
-                 (sre->expire - now) / USEC_PER_TICK);
+                 sre->expire > now ?
+                 (sre->expire - now) / USEC_PER_TICK : 0);
     }
 
   nxrmutex_unlock(&sre->lock);
@@ -1184,8 +1294,15 @@ static int sensor_rpmsg_publish_handler(FAR struct rpmsg_endpoint *ept,
   FAR struct sensor_rpmsg_dev_s *dev;
   size_t written = sizeof(*msg);
 
+#ifdef CONFIG_SENSORS_RPMSG_STATS
+  FAR struct sensor_rpmsg_ept_s *sre = ept->priv;
+
+  sre->stats.rxmsgs++;
+#endif
+
   while (written < len)
     {
+      SENSOR_RPMSG_STAT(sre, rxcells, 1);
       cell = (FAR struct sensor_rpmsg_cell_s *)
              ((FAR char *)data + written);
       dev = (FAR struct sensor_rpmsg_dev_s *)(uintptr_t)cell->cookie;
@@ -1396,6 +1513,7 @@ static void sensor_rpmsg_ept_release(FAR struct rpmsg_endpoint *ept)
 
   nxrmutex_unlock(&g_ept_lock);
 
+  work_cancel_sync(HPWORK, &sre->work);
   nxrmutex_destroy(&sre->lock);
   kmm_free(sre);
 }
@@ -1427,6 +1545,103 @@ static void sensor_rpmsg_device_created(FAR struct rpmsg_device *rdev,
     }
 }
 
+#ifdef CONFIG_SENSORS_RPMSG_STATS
+static int sensor_rpmsg_procfs_open(FAR struct file *filep,
+                                    FAR const char *relpath,
+                                    int oflags, mode_t mode)
+{
+  FAR struct procfs_file_s *priv;
+
+  if ((oflags & O_WRONLY) != 0 || (oflags & O_RDONLY) == 0)
+    {
+      return -EACCES;
+    }
+
+  priv = kmm_zalloc(sizeof(*priv));
+  if (priv == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  filep->f_priv = priv;
+  return OK;
+}
+
+static int sensor_rpmsg_procfs_close(FAR struct file *filep)
+{
+  kmm_free(filep->f_priv);
+  filep->f_priv = NULL;
+  return OK;
+}
+
+static ssize_t sensor_rpmsg_procfs_read(FAR struct file *filep,
+                                        FAR char *buffer, size_t buflen)
+{
+  FAR struct sensor_rpmsg_ept_s *sre;
+  char line[SENSOR_RPMSG_LINELEN];
+  size_t linesize;
+  size_t totalsize;
+  off_t offset = filep->f_pos;
+
+  linesize  = procfs_snprintf(line, sizeof(line),
+                              "%-16s %10s %10s %10s %10s %8s %10s %10s\n",
+                              "CPU", "TXMSGS", "TXCELLS", "TXBYTES",
+                              "TXFULL", "TXERRORS", "RXMSGS", "RXCELLS");
+  totalsize = procfs_memcpy(line, linesize, buffer, buflen, &offset);
+
+  nxrmutex_lock(&g_ept_lock);
+  list_for_every_entry(&g_eptlist, sre, struct sensor_rpmsg_ept_s, node)
+    {
+      FAR struct sensor_rpmsg_stats_s *stats = &sre->stats;
+
+      if (totalsize >= buflen)
+        {
+          break;
+        }
+
+      linesize   = procfs_snprintf(line, sizeof(line),
+                                   "%-16s %10" PRIu32 " %10" PRIu32
+                                   " %10" PRIu32 " %10" PRIu32 " %8" PRIu32
+                                   " %10" PRIu32 " %10" PRIu32 "\n",
+                                   rpmsg_get_cpuname(sre->rdev),
+                                   stats->txmsgs, stats->txcells,
+                                   stats->txbytes, stats->txfull,
+                                   stats->txerrors, stats->rxmsgs,
+                                   stats->rxcells);
+      totalsize += procfs_memcpy(line, linesize, buffer + totalsize,
+                                 buflen - totalsize, &offset);
+    }
+
+  nxrmutex_unlock(&g_ept_lock);
+
+  filep->f_pos += totalsize;
+  return totalsize;
+}
+
+static int sensor_rpmsg_procfs_dup(FAR const struct file *oldp,
+                                   FAR struct file *newp)
+{
+  FAR struct procfs_file_s *priv;
+
+  priv = kmm_zalloc(sizeof(*priv));
+  if (priv == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  newp->f_priv = priv;
+  return OK;
+}
+
+static int sensor_rpmsg_procfs_stat(FAR const char *relpath,
+                                    FAR struct stat *buf)
+{
+  memset(buf, 0, sizeof(struct stat));
+  buf->st_mode = S_IFREG | S_IROTH | S_IRGRP | S_IRUSR;
+  return OK;
+}
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -1541,6 +1756,16 @@ void sensor_rpmsg_unregister(FAR struct sensor_lowerhalf_s *lower)
 
 int sensor_rpmsg_initialize(void)
 {
+#ifdef CONFIG_SENSORS_RPMSG_STATS
+  int ret;
+
+  ret = procfs_register(&g_sensor_rpmsg_procfs);
+  if (ret < 0)
+    {
+      return ret;
+    }
+#endif
+
   return rpmsg_register_callback(NULL, sensor_rpmsg_device_created,
                                  NULL, NULL, NULL);
 }
@@ -27,9 +27,11 @@
 #include <stdint.h>
 #include <string.h>
 
+#include <nuttx/arch.h>
 #include <nuttx/compiler.h>
 #include <nuttx/kmalloc.h>
 #include <nuttx/net/ip.h>
+#include <nuttx/net/tcp.h>
 #include <nuttx/net/netdev_lowerhalf.h>
 #include <nuttx/virtio/virtio.h>
 #include <nuttx/net/wifi_sim.h>
@@ -42,7 +44,23 @@
 
 /* Virtio net feature bits */
 
-#define VIRTIO_NET_F_MAC      5
+#define VIRTIO_NET_F_CSUM       0
+#define VIRTIO_NET_F_MAC        5
+#define VIRTIO_NET_F_HOST_TSO4  11
+#define VIRTIO_NET_F_CTRL_VQ    17
+#define VIRTIO_NET_F_MQ         22
+
+/* Virtio net header flags and GSO types */
+
+#define VIRTIO_NET_HDR_F_NEEDS_CSUM  1
+#define VIRTIO_NET_HDR_GSO_TCPV4     1
+
+/* Virtio net control commands and the polls of 10us for their completion */
+
+#define VIRTIO_NET_CTRL_MQ               4
+#define VIRTIO_NET_CTRL_MQ_VQ_PAIRS_SET  0
+#define VIRTIO_NET_OK                    0
+#define VIRTIO_NET_CTRL_RETRY            10000
 
 /* Virtio net header size and packet buffer size */
 
@@ -56,11 +74,32 @@
 #define VIRTIO_NET_TX         1
 #define VIRTIO_NET_NUM        2
 
+/* The virtqueues of the queue pair q, the control virtqueue follows the
+ * max_virtqueue_pairs pairs of the device.
+ */
+
+#define VIRTIO_NET_RXQ(q)     (VIRTIO_NET_NUM * (q) + VIRTIO_NET_RX)
+#define VIRTIO_NET_TXQ(q)     (VIRTIO_NET_NUM * (q) + VIRTIO_NET_TX)
+#define VIRTIO_NET_MAX_QUEUES NETDEV_MAX_QUEUES
+#define VIRTIO_NET_MAX_VQ     (VIRTIO_NET_NUM * VIRTIO_NET_MAX_QUEUES)
+
 #define VIRTIO_NET_MAX_PKT_SIZE \
     ((CONFIG_NET_LL_GUARDSIZE - ETH_HDRLEN) + VIRTIO_NET_BUFSIZE)
 #define VIRTIO_NET_MAX_NIOB \
     ((VIRTIO_NET_MAX_PKT_SIZE + CONFIG_IOB_BUFSIZE - 1) / CONFIG_IOB_BUFSIZE)
 
+/* A TSO packet spans up to VIRTIO_NET_TSO_NIOB buffers */
+
+#ifdef CONFIG_NETDEV_GSO
+#  define VIRTIO_NET_TSO_NIOB     16
+#  define VIRTIO_NET_TSO_MAXSIZE \
+    MIN(VIRTIO_NET_TSO_NIOB * CONFIG_IOB_BUFSIZE - CONFIG_NET_LL_GUARDSIZE + \
+        ETH_HDRLEN, UINT16_MAX)
+#  define VIRTIO_NET_MAX_IOV      MAX(VIRTIO_NET_MAX_NIOB, VIRTIO_NET_TSO_NIOB)
+#else
+#  define VIRTIO_NET_MAX_IOV      VIRTIO_NET_MAX_NIOB
+#endif
+
 /****************************************************************************
  * Private Types
  ****************************************************************************/
@@ -79,6 +118,16 @@ begin_packed_struct struct virtio_net_hdr_s
   uint16_t csum_offset;
 } end_packed_struct;
 
+/* Virtio net control command setting the number of queue pairs */
+
+begin_packed_struct struct virtio_net_ctrl_mq_s
+{
+  uint8_t  class;
+  uint8_t  cmd;
+  uint16_t pairs;
+  uint8_t  ack;
+} end_packed_struct;
+
 /* The definition of the struct virtio_net_config refers to the link
  * https://docs.oasis-open.org/virtio/virtio/v1.2/cs01/
  * virtio-v1.2-cs01.html#x1-2230004.
@@ -110,12 +159,17 @@ struct virtio_net_priv_s
   struct netdev_lowerhalf_s lower;     /* The netdev lowerhalf */
 #endif
 
-  spinlock_t                lock[VIRTIO_NET_NUM];
+  spinlock_t                lock[VIRTIO_NET_MAX_VQ];
 
   /* Virtio device information */
 
   FAR struct virtio_device *vdev;      /* Virtio device pointer */
   int                       bufnum;    /* TX and RX Buffer number */
+  int                       nqueues;   /* Queue pairs in use */
+
+  /* RX buffers posted to the RX virtqueue of each queue pair */
+
+  int                       rxbufs[VIRTIO_NET_MAX_QUEUES];
 };
 
 /* Virtio Link Layer Header, follow shows the iob buffer layout:
@@ -152,6 +206,10 @@ static int virtio_net_ifdown(FAR struct netdev_lowerhalf_s *dev);
 static int virtio_net_send(FAR struct netdev_lowerhalf_s *dev,
                            FAR netpkt_t *pkt);
 static netpkt_t *virtio_net_recv(FAR struct netdev_lowerhalf_s *dev);
+static int virtio_net_send_queue(FAR struct netdev_lowerhalf_s *dev,
+                                 FAR netpkt_t *pkt, int queue);
+static netpkt_t *virtio_net_recv_queue(FAR struct netdev_lowerhalf_s *dev,
+                                       int queue);
 #ifdef CONFIG_NET_MCASTGROUP
 static int virtio_net_addmac(FAR struct netdev_lowerhalf_s *dev,
                              FAR const uint8_t *mac);
@@ -192,7 +250,10 @@ static const struct netdev_ops_s g_virtio_net_ops =
 #ifdef CONFIG_NETDEV_IOCTL
   virtio_net_ioctl,
 #endif
-  virtio_net_txfree
+  virtio_net_txfree,
+  NULL,                   /* rxint */
+  virtio_net_send_queue,
+  virtio_net_recv_queue
 };
 
 #ifdef CONFIG_DRIVERS_WIFI_SIM
@@ -203,6 +264,37 @@ static uint8_t g_netdev_num = 0;
  * Private Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: virtio_net_tso
+ *
+ * Description:
+ *   Fill in the virtio net header of a TCP/IPv4 packet that the device is
+ *   to segment.  Its TCP checksum holds the pseudo header sum, which the
+ *   device completes for each segment.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NETDEV_GSO
+static void virtio_net_tso(FAR struct netdev_lowerhalf_s *dev,
+                           FAR netpkt_t *pkt,
+                           FAR struct virtio_net_hdr_s *vhdr)
+{
+  FAR struct ipv4_hdr_s *ipv4 = (FAR struct ipv4_hdr_s *)IOB_DATA(pkt);
+  FAR struct tcp_hdr_s *tcp;
+  unsigned int iphdrlen;
+
+  iphdrlen = (ipv4->vhl & IPv4_HLMASK) << 2;
+  tcp      = (FAR struct tcp_hdr_s *)(IOB_DATA(pkt) + iphdrlen);
+
+  vhdr->flags       = VIRTIO_NET_HDR_F_NEEDS_CSUM;
+  vhdr->gso_type    = VIRTIO_NET_HDR_GSO_TCPV4;
+  vhdr->hdr_len     = ETH_HDRLEN + iphdrlen + ((tcp->tcpoffset >> 4) << 2);
+  vhdr->gso_size    = dev->netdev.d_gsosize;
+  vhdr->csum_start  = ETH_HDRLEN + iphdrlen;
+  vhdr->csum_offset = offsetof(struct tcp_hdr_s, tcpchksum);
+}
+#endif
+
 /****************************************************************************
  * Name: virtio_net_addbuffer
  ****************************************************************************/
@@ -213,14 +305,14 @@ static int virtio_net_addbuffer(FAR struct netdev_lowerhalf_s *dev,
 {
   FAR struct virtio_net_priv_s *priv = (FAR struct virtio_net_priv_s *)dev;
   FAR struct virtio_net_llhdr_s *hdr;
-  struct virtqueue_buf vb[VIRTIO_NET_MAX_NIOB + 1];
-  struct iovec iov[VIRTIO_NET_MAX_NIOB];
+  struct virtqueue_buf vb[VIRTIO_NET_MAX_IOV + 1];
+  struct iovec iov[VIRTIO_NET_MAX_IOV];
   int iov_cnt;
   int i;
 
   /* Convert netpkt to virtqueue_buf */
 
-  iov_cnt = netpkt_to_iov(dev, pkt, iov, VIRTIO_NET_MAX_NIOB);
+  iov_cnt = netpkt_to_iov(dev, pkt, iov, VIRTIO_NET_MAX_IOV);
 
   /* Alloc cookie and net header from transport layer */
 
@@ -230,6 +322,14 @@ static int virtio_net_addbuffer(FAR struct netdev_lowerhalf_s *dev,
   memset(&hdr->vhdr, 0, sizeof(hdr->vhdr));
   hdr->pkt = pkt;
 
+#ifdef CONFIG_NETDEV_GSO
+  if (vq_id % VIRTIO_NET_NUM == VIRTIO_NET_TX &&
+      dev->netdev.d_gsosize > 0)
+    {
+      virtio_net_tso(dev, pkt, &hdr->vhdr);
+    }
+#endif
+
   /* Prepare buffers depends on the feature VIRTIO_F_ANY_LAYOUT */
 
   if (virtio_has_feature(priv->vdev, VIRTIO_F_ANY_LAYOUT))
@@ -239,7 +339,7 @@ static int virtio_net_addbuffer(FAR struct netdev_lowerhalf_s *dev,
       vb[0].buf = &hdr->vhdr;
       vb[0].len = iov[0].iov_len + VIRTIO_NET_HDRSIZE;
 
-#if VIRTIO_NET_MAX_NIOB > 1
+#if VIRTIO_NET_MAX_IOV > 1
       for (i = 1; i < iov_cnt; i++)
         {
           vb[i].buf = iov[i].iov_base;
@@ -264,7 +364,7 @@ static int virtio_net_addbuffer(FAR struct netdev_lowerhalf_s *dev,
     }
 
   vrtinfo("Fill vq=%u, hdr=%p, count=%d\n", vq_id, hdr, iov_cnt);
-  if (vq_id == VIRTIO_NET_RX)
+  if (vq_id % VIRTIO_NET_NUM == VIRTIO_NET_RX)
     {
       return virtqueue_add_buffer_lock(vq, vb, 0, iov_cnt, hdr,
                                        &priv->lock[vq_id]);
@@ -280,14 +380,19 @@ static int virtio_net_addbuffer(FAR struct netdev_lowerhalf_s *dev,
  * Name: virtio_net_rxfill
  ****************************************************************************/
 
-static void virtio_net_rxfill(FAR struct netdev_lowerhalf_s *dev)
+static void virtio_net_rxfill(FAR struct netdev_lowerhalf_s *dev,
+                              int queue)
 {
   FAR struct virtio_net_priv_s *priv = (FAR struct virtio_net_priv_s *)dev;
-  FAR struct virtqueue *vq = priv->vdev->vrings_info[VIRTIO_NET_RX].vq;
+  FAR struct virtqueue *vq =
+    priv->vdev->vrings_info[VIRTIO_NET_RXQ(queue)].vq;
   FAR netpkt_t *pkt;
   int i;
 
-  for (i = 0; i < priv->bufnum; i++)
+  /* The RX buffers are shared evenly by the queues */
+
+  for (i = 0; priv->rxbufs[queue] < MAX(priv->bufnum / priv->nqueues, 1);
+       i++)
     {
       /* IOB Offload, Alloc buffer from RX netpkt */
 
@@ -310,12 +415,13 @@ static void virtio_net_rxfill(FAR struct netdev_lowerhalf_s *dev)
 
       /* Add buffer to RX virtqueue */
 
-      virtio_net_addbuffer(dev, vq, pkt, VIRTIO_NET_RX);
+      virtio_net_addbuffer(dev, vq, pkt, VIRTIO_NET_RXQ(queue));
+      priv->rxbufs[queue]++;
     }
 
   if (i > 0)
     {
-      virtqueue_kick_lock(vq, &priv->lock[VIRTIO_NET_RX]);
+      virtqueue_kick_lock(vq, &priv->lock[VIRTIO_NET_RXQ(queue)]);
     }
 }
 
@@ -326,22 +432,28 @@ static void virtio_net_rxfill(FAR struct netdev_lowerhalf_s *dev)
 static void virtio_net_txfree(FAR struct netdev_lowerhalf_s *dev)
 {
   FAR struct virtio_net_priv_s *priv = (FAR struct virtio_net_priv_s *)dev;
-  FAR struct virtqueue *vq = priv->vdev->vrings_info[VIRTIO_NET_TX].vq;
   FAR struct virtio_net_llhdr_s *hdr;
+  FAR struct virtqueue *vq;
+  int i;
 
-  while (1)
+  for (i = 0; i < priv->nqueues; i++)
     {
-      /* Get buffer from tx virtqueue */
+      vq = priv->vdev->vrings_info[VIRTIO_NET_TXQ(i)].vq;
 
-      hdr = virtqueue_get_buffer_lock(vq, NULL, NULL,
-                                      &priv->lock[VIRTIO_NET_TX]);
-      if (hdr == NULL)
+      while (1)
         {
-          break;
-        }
+          /* Get buffer from tx virtqueue */
 
-      netpkt_free(dev, hdr->pkt, NETPKT_TX);
-      vrtinfo("Free, hdr: %p, pkt: %p\n", hdr, hdr->pkt);
+          hdr = virtqueue_get_buffer_lock(vq, NULL, NULL,
+                                          &priv->lock[VIRTIO_NET_TXQ(i)]);
+          if (hdr == NULL)
+            {
+              break;
+            }
+
+          netpkt_free(dev, hdr->pkt, NETPKT_TX);
+          vrtinfo("Free, hdr: %p, pkt: %p\n", hdr, hdr->pkt);
+        }
     }
 }
 
@@ -352,6 +464,7 @@ static void virtio_net_txfree(FAR struct netdev_lowerhalf_s *dev)
 static int virtio_net_ifup(FAR struct netdev_lowerhalf_s *dev)
 {
   FAR struct virtio_net_priv_s *priv = (FAR struct virtio_net_priv_s *)dev;
+  int i;
 
 #ifdef CONFIG_NET_IPv4
   vrtinfo("Bringing up: %u.%u.%u.%u\n",
@@ -368,9 +481,13 @@ static int virtio_net_ifup(FAR struct netdev_lowerhalf_s *dev)
 
   /* Prepare interrupt and packets for receiving */
 
-  virtqueue_enable_cb_lock(priv->vdev->vrings_info[VIRTIO_NET_RX].vq,
-                           &priv->lock[VIRTIO_NET_RX]);
-  virtio_net_rxfill(dev);
+  for (i = 0; i < priv->nqueues; i++)
+    {
+      virtqueue_enable_cb_lock(
+        priv->vdev->vrings_info[VIRTIO_NET_RXQ(i)].vq,
+        &priv->lock[VIRTIO_NET_RXQ(i)]);
+      virtio_net_rxfill(dev, i);
+    }
 
 #ifdef CONFIG_DRIVERS_WIFI_SIM
   if (priv->lower.wifi == NULL)
@@ -393,7 +510,7 @@ static int virtio_net_ifdown(FAR struct netdev_lowerhalf_s *dev)
 
   /* Disable the Ethernet interrupt */
 
-  for (i = 0; i < VIRTIO_NET_NUM; i++)
+  for (i = 0; i < VIRTIO_NET_NUM * priv->nqueues; i++)
     {
       virtqueue_disable_cb_lock(priv->vdev->vrings_info[i].vq,
                                 &priv->lock[i]);
@@ -418,13 +535,28 @@ static int virtio_net_ifdown(FAR struct netdev_lowerhalf_s *dev)
 
 static int virtio_net_send(FAR struct netdev_lowerhalf_s *dev,
                            FAR netpkt_t *pkt)
+{
+  return virtio_net_send_queue(dev, pkt, 0);
+}
+
+/****************************************************************************
+ * Name: virtio_net_send_queue
+ ****************************************************************************/
+
+static int virtio_net_send_queue(FAR struct netdev_lowerhalf_s *dev,
+                                 FAR netpkt_t *pkt, int queue)
 {
   FAR struct virtio_net_priv_s *priv = (FAR struct virtio_net_priv_s *)dev;
-  FAR struct virtqueue *vq = priv->vdev->vrings_info[VIRTIO_NET_TX].vq;
+  FAR struct virtqueue *vq =
+    priv->vdev->vrings_info[VIRTIO_NET_TXQ(queue)].vq;
 
-  /* Check the send length */
+  /* Check the send length, TSO packets have been checked by upper half */
 
-  if (netpkt_getdatalen(dev, pkt) > VIRTIO_NET_BUFSIZE)
+  if (netpkt_getdatalen(dev, pkt) > VIRTIO_NET_BUFSIZE
+#ifdef CONFIG_NETDEV_GSO
+      && dev->netdev.d_gsosize == 0
+#endif
+     )
     {
       vrterr("net send buffer too large\n");
       return -EINVAL;
@@ -432,8 +564,8 @@ static int virtio_net_send(FAR struct netdev_lowerhalf_s *dev,
 
   /* Add buffer to vq and notify the other side */
 
-  virtio_net_addbuffer(dev, vq, pkt, VIRTIO_NET_TX);
-  virtqueue_kick_lock(vq, &priv->lock[VIRTIO_NET_TX]);
+  virtio_net_addbuffer(dev, vq, pkt, VIRTIO_NET_TXQ(queue));
+  virtqueue_kick_lock(vq, &priv->lock[VIRTIO_NET_TXQ(queue)]);
 
   /* Try return Netpkt TX buffer to upper-half. */
 
@@ -443,7 +575,7 @@ static int virtio_net_send(FAR struct netdev_lowerhalf_s *dev,
 
   if (netdev_lower_quota_load(dev, NETPKT_TX) <= 0)
     {
-      virtqueue_enable_cb_lock(vq, &priv->lock[VIRTIO_NET_TX]);
+      virtqueue_enable_cb_lock(vq, &priv->lock[VIRTIO_NET_TXQ(queue)]);
     }
 
   return OK;
@@ -454,36 +586,50 @@ static int virtio_net_send(FAR struct netdev_lowerhalf_s *dev,
  ****************************************************************************/
 
 static netpkt_t *virtio_net_recv(FAR struct netdev_lowerhalf_s *dev)
+{
+  return virtio_net_recv_queue(dev, 0);
+}
+
+/****************************************************************************
+ * Name: virtio_net_recv_queue
+ ****************************************************************************/
+
+static netpkt_t *virtio_net_recv_queue(FAR struct netdev_lowerhalf_s *dev,
+                                       int queue)
 {
   FAR struct virtio_net_priv_s *priv = (FAR struct virtio_net_priv_s *)dev;
-  FAR struct virtqueue *vq = priv->vdev->vrings_info[VIRTIO_NET_RX].vq;
+  FAR struct virtqueue *vq =
+    priv->vdev->vrings_info[VIRTIO_NET_RXQ(queue)].vq;
+  FAR spinlock_t *lock = &priv->lock[VIRTIO_NET_RXQ(queue)];
   FAR struct virtio_net_llhdr_s *hdr;
   irqstate_t flags;
   uint32_t len;
 
   /* Fill the free Netpkt RX buffer to the RX virtqueue */
 
-  virtio_net_rxfill(dev);
+  virtio_net_rxfill(dev, queue);
 
   /* Get received buffer form RX virtqueue */
 
-  flags = spin_lock_irqsave(&priv->lock[VIRTIO_NET_RX]);
+  flags = spin_lock_irqsave(lock);
   hdr = virtqueue_get_buffer(vq, &len, NULL);
   if (hdr == NULL)
     {
       /* If we have no buffer left, enable RX callback. */
 
       virtqueue_enable_cb(vq);
-      spin_unlock_irqrestore(&priv->lock[VIRTIO_NET_RX], flags);
+      spin_unlock_irqrestore(lock, flags);
 
       vrtinfo("get NULL buffer\n");
       return NULL;
     }
   else
     {
-      spin_unlock_irqrestore(&priv->lock[VIRTIO_NET_RX], flags);
+      spin_unlock_irqrestore(lock, flags);
     }
 
+  priv->rxbufs[queue]--;
+
   /* Set the received pkt length */
 
   netpkt_setdatalen(dev, hdr->pkt, len - VIRTIO_NET_HDRSIZE);
@@ -533,8 +679,9 @@ static void virtio_net_rxready(FAR struct virtqueue *vq)
 {
   FAR struct virtio_net_priv_s *priv = vq->vq_dev->priv;
 
-  virtqueue_disable_cb_lock(vq, &priv->lock[VIRTIO_NET_RX]);
-  netdev_lower_rxready((FAR struct netdev_lowerhalf_s *)priv);
+  virtqueue_disable_cb_lock(vq, &priv->lock[vq->vq_queue_index]);
+  netdev_lower_rxready_queue((FAR struct netdev_lowerhalf_s *)priv,
+                             vq->vq_queue_index / VIRTIO_NET_NUM);
 }
 
 /****************************************************************************
@@ -545,10 +692,75 @@ static void virtio_net_txdone(FAR struct virtqueue *vq)
 {
   FAR struct virtio_net_priv_s *priv = vq->vq_dev->priv;
 
-  virtqueue_disable_cb_lock(vq, &priv->lock[VIRTIO_NET_TX]);
+  virtqueue_disable_cb_lock(vq, &priv->lock[vq->vq_queue_index]);
   netdev_lower_txdone((FAR struct netdev_lowerhalf_s *)priv);
 }
 
+/****************************************************************************
+ * Name: virtio_net_set_queues
+ *
+ * Description:
+ *   Ask the device to spread the received packets over priv->nqueues
+ *   queue pairs.
+ *
+ ****************************************************************************/
+
+#if VIRTIO_NET_MAX_QUEUES > 1
+static int virtio_net_set_queues(FAR struct virtio_net_priv_s *priv,
+                                 FAR struct virtqueue *vq)
+{
+  FAR struct virtio_net_ctrl_mq_s *cmd;
+  struct virtqueue_buf vb[3];
+  int ret;
+  int i;
+
+  cmd = virtio_zalloc_buf(priv->vdev, sizeof(*cmd), 16);
+  if (cmd == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  cmd->class = VIRTIO_NET_CTRL_MQ;
+  cmd->cmd   = VIRTIO_NET_CTRL_MQ_VQ_PAIRS_SET;
+  cmd->pairs = priv->nqueues;
+  cmd->ack   = ~VIRTIO_NET_OK;
+
+  vb[0].buf = &cmd->class;
+  vb[0].len = sizeof(cmd->class) + sizeof(cmd->cmd);
+  vb[1].buf = &cmd->pairs;
+  vb[1].len = sizeof(cmd->pairs);
+  vb[2].buf = &cmd->ack;
+  vb[2].len = sizeof(cmd->ack);
+
+  ret = virtqueue_add_buffer(vq, vb, 2, 1, cmd);
+  if (ret < 0)
+    {
+      virtio_free_buf(priv->vdev, cmd);
+      return ret;
+    }
+
+  virtqueue_kick(vq);
+
+  /* The device handles the command right away, poll for its completion */
+
+  for (i = 0; i < VIRTIO_NET_CTRL_RETRY; i++)
+    {
+      if (virtqueue_get_buffer(vq, NULL, NULL) == cmd)
+        {
+          ret = cmd->ack == VIRTIO_NET_OK ? OK : -EIO;
+          virtio_free_buf(priv->vdev, cmd);
+          return ret;
+        }
+
+      up_udelay(10);
+    }
+
+  /* Still owned by the device, leak it */
+
+  return -ETIMEDOUT;
+}
+#endif
+
 /****************************************************************************
  * Name: virtio_net_init
  ****************************************************************************/
@@ -556,28 +768,83 @@ static void virtio_net_txdone(FAR struct virtqueue *vq)
 static int virtio_net_init(FAR struct virtio_net_priv_s *priv,
                            FAR struct virtio_device *vdev)
 {
-  FAR const char *vqnames[VIRTIO_NET_NUM];
-  vq_callback callbacks[VIRTIO_NET_NUM];
+  FAR const char **vqnames;
+  FAR vq_callback *callbacks;
+  uint16_t maxpairs = 1;
+  int nvqs = VIRTIO_NET_NUM;
   int ret;
+  int i;
+
+  for (i = 0; i < VIRTIO_NET_MAX_VQ; i++)
+    {
+      spin_lock_init(&priv->lock[i]);
+    }
 
-  spin_lock_init(&priv->lock[VIRTIO_NET_RX]);
-  spin_lock_init(&priv->lock[VIRTIO_NET_TX]);
-  priv->vdev = vdev;
-  vdev->priv = priv;
+  priv->vdev    = vdev;
+  priv->nqueues = 1;
+  vdev->priv    = priv;
 
   /* Initialize the virtio device */
 
   virtio_set_status(vdev, VIRTIO_CONFIG_STATUS_DRIVER);
   virtio_negotiate_features(vdev, (1UL << VIRTIO_NET_F_MAC) |
+#ifdef CONFIG_NETDEV_GSO
+                                  (1UL << VIRTIO_NET_F_CSUM) |
+                                  (1UL << VIRTIO_NET_F_HOST_TSO4) |
+#endif
+#if VIRTIO_NET_MAX_QUEUES > 1
+                                  (1UL << VIRTIO_NET_F_CTRL_VQ) |
+                                  (1UL << VIRTIO_NET_F_MQ) |
+#endif
                                   (1UL << VIRTIO_F_ANY_LAYOUT), NULL);
   virtio_set_status(vdev, VIRTIO_CONFIG_FEATURES_OK);
 
-  vqnames[VIRTIO_NET_RX]   = "virtio_net_rx";
-  vqnames[VIRTIO_NET_TX]   = "virtio_net_tx";
-  callbacks[VIRTIO_NET_RX] = virtio_net_rxready;
-  callbacks[VIRTIO_NET_TX] = virtio_net_txdone;
-  ret = virtio_create_virtqueues(vdev, 0, VIRTIO_NET_NUM, vqnames,
-                                 callbacks, NULL);
+#if VIRTIO_NET_MAX_QUEUES > 1
+  /* Use one queue pair per CPU at most.  All the virtqueues up to the
+   * control one are created, the unused pairs have no callback.
+   */
+
+  if (virtio_has_feature(vdev, VIRTIO_NET_F_CTRL_VQ) &&
+      virtio_has_feature(vdev, VIRTIO_NET_F_MQ))
+    {
+      virtio_read_config_member(vdev, struct virtio_net_config_s,
+                                max_virtqueue_pairs, &maxpairs);
+      if (maxpairs > 1)
+        {
+          priv->nqueues = MIN(maxpairs, VIRTIO_NET_MAX_QUEUES);
+          nvqs = VIRTIO_NET_NUM * maxpairs + 1;
+        }
+    }
+#endif
+
+  vqnames   = kmm_malloc(nvqs * sizeof(*vqnames));
+  callbacks = kmm_zalloc(nvqs * sizeof(*callbacks));
+  if (vqnames == NULL || callbacks == NULL)
+    {
+      kmm_free(vqnames);
+      kmm_free(callbacks);
+      return -ENOMEM;
+    }
+
+  for (i = 0; i < VIRTIO_NET_NUM * maxpairs; i += VIRTIO_NET_NUM)
+    {
+      vqnames[i + VIRTIO_NET_RX] = "virtio_net_rx";
+      vqnames[i + VIRTIO_NET_TX] = "virtio_net_tx";
+      if (i < VIRTIO_NET_NUM * priv->nqueues)
+        {
+          callbacks[i + VIRTIO_NET_RX] = virtio_net_rxready;
+          callbacks[i + VIRTIO_NET_TX] = virtio_net_txdone;
+        }
+    }
+
+  if (nvqs > VIRTIO_NET_NUM * maxpairs)
+    {
+      vqnames[nvqs - 1] = "virtio_net_ctrl";
+    }
+
+  ret = virtio_create_virtqueues(vdev, 0, nvqs, vqnames, callbacks, NULL);
+  kmm_free(vqnames);
+  kmm_free(callbacks);
   if (ret < 0)
     {
       vrterr("virtio_device_create_virtqueue failed, ret=%d\n", ret);
@@ -586,6 +853,19 @@ static int virtio_net_init(FAR struct virtio_net_priv_s *priv,
 
   virtio_set_status(vdev, VIRTIO_CONFIG_STATUS_DRIVER_OK);
 
+#if VIRTIO_NET_MAX_QUEUES > 1
+  if (priv->nqueues > 1)
+    {
+      ret = virtio_net_set_queues(priv, vdev->vrings_info[nvqs - 1].vq);
+      if (ret < 0)
+        {
+          vrtwarn("Failed to set %d queue pairs, ret=%d\n",
+                  priv->nqueues, ret);
+          priv->nqueues = 1;
+        }
+    }
+#endif
+
 #if CONFIG_DRIVERS_VIRTIO_NET_BUFNUM > 0
   priv->bufnum = CONFIG_DRIVERS_VIRTIO_NET_BUFNUM;
 #else
@@ -668,8 +948,35 @@ static int virtio_net_probe(FAR struct virtio_device *vdev)
   netdev = (FAR struct netdev_lowerhalf_s *)priv;
   netdev->quota[NETPKT_RX] = priv->bufnum;
   netdev->quota[NETPKT_TX] = priv->bufnum;
+  netdev->nqueues = priv->nqueues;
   netdev->ops = &g_virtio_net_ops;
 
+#ifdef CONFIG_NETDEV_GSO
+  /* Let the device segment TCP, limiting the TX packets in flight so that
+   * full sized TSO packets never run out of descriptors.
+   */
+
+  if (virtio_has_feature(vdev, VIRTIO_NET_F_CSUM) &&
+      virtio_has_feature(vdev, VIRTIO_NET_F_HOST_TSO4) &&
+      vdev->vrings_info[VIRTIO_NET_TX].info.num_descs >
+      VIRTIO_NET_TSO_NIOB + 1)
+    {
+      netdev->features   |= NETDEV_F_TSO4;
+      netdev->gso_maxsize = VIRTIO_NET_TSO_MAXSIZE;
+      netdev->quota[NETPKT_TX] =
+        MIN(priv->bufnum, vdev->vrings_info[VIRTIO_NET_TX].info.num_descs /
+                          (VIRTIO_NET_TSO_NIOB + 1));
+    }
+#endif
+
+#ifdef CONFIG_NETDEV_GRO
+  netdev->features |= NETDEV_F_GRO;
+#endif
+
+  /* The RX virtqueues may be drained at any time, under their lock */
+
+  netdev->features |= NETDEV_F_BUSYPOLL;
+
 #ifdef CONFIG_DRIVERS_WIFI_SIM
   /* If the WiFi interfaces has reached the setting value,
    * no more WiFi interfaces will be created.
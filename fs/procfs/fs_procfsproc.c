@@ -40,7 +40,7 @@
 #include <malloc.h>
 #include <execinfo.h>
 
-#ifdef CONFIG_SCHED_CRITMONITOR
+#if defined(CONFIG_SCHED_CRITMONITOR) || defined(CONFIG_SCHED_SCHEDSTAT)
 #  include <time.h>
 #endif
 
@@ -61,7 +61,8 @@
 
 #include "fs_heap.h"
 
-#if !defined(CONFIG_SCHED_CPULOAD_NONE) || defined(CONFIG_SCHED_CRITMONITOR)
+#if !defined(CONFIG_SCHED_CPULOAD_NONE) || defined(CONFIG_SCHED_CRITMONITOR) || \
+    defined(CONFIG_SCHED_SCHEDSTAT)
 #  include <nuttx/clock.h>
 #endif
 
@@ -97,6 +98,9 @@ enum proc_node_e
 #ifdef CONFIG_SCHED_CRITMONITOR
   PROC_CRITMON,                       /* Critical section monitor */
 #endif
+#ifdef CONFIG_SCHED_SCHEDSTAT
+  PROC_SCHEDSTAT,                     /* Run time and latency histograms */
+#endif
 #if CONFIG_MM_BACKTRACE >= 0
   PROC_HEAP,                          /* Task heap info */
 #endif
@@ -188,6 +192,11 @@ static ssize_t proc_critmon(FAR struct proc_file_s *procfile,
                  FAR struct tcb_s *tcb, FAR char *buffer, size_t buflen,
                  off_t offset);
 #endif
+#ifdef CONFIG_SCHED_SCHEDSTAT
+static ssize_t proc_schedstat(FAR struct proc_file_s *procfile,
+                 FAR struct tcb_s *tcb, FAR char *buffer, size_t buflen,
+                 off_t offset);
+#endif
 #if CONFIG_MM_BACKTRACE >= 0
 static ssize_t proc_heap(FAR struct proc_file_s *procfile,
                          FAR struct tcb_s *tcb, FAR char *buffer,
@@ -300,6 +309,13 @@ static const struct proc_node_s g_critmon =
 };
 #endif
 
+#ifdef CONFIG_SCHED_SCHEDSTAT
+static const struct proc_node_s g_schedstat =
+{
+  "schedstat",   "schedstat", (uint8_t)PROC_SCHEDSTAT,   DTYPE_FILE        /* Run time and latency histograms */
+};
+#endif
+
 #if CONFIG_MM_BACKTRACE >= 0
 static const struct proc_node_s g_heap =
 {
@@ -354,6 +370,9 @@ static FAR const struct proc_node_s * const g_nodeinfo[] =
 #ifdef CONFIG_SCHED_CRITMONITOR
   &g_critmon,      /* Critical section Monitor */
 #endif
+#ifdef CONFIG_SCHED_SCHEDSTAT
+  &g_schedstat,    /* Run time and latency histograms */
+#endif
 #if CONFIG_MM_BACKTRACE >= 0
   &g_heap,         /* Task heap info */
 #endif
@@ -383,6 +402,9 @@ static const struct proc_node_s * const g_level0info[] =
 #ifdef CONFIG_SCHED_CRITMONITOR
   &g_critmon,      /* Critical section monitor */
 #endif
+#ifdef CONFIG_SCHED_SCHEDSTAT
+  &g_schedstat,    /* Run time and latency histograms */
+#endif
 #if CONFIG_MM_BACKTRACE >= 0
   &g_heap,         /* Task heap info */
 #endif
@@ -878,6 +900,92 @@ static ssize_t proc_critmon(FAR struct proc_file_s *procfile,
 }
 #endif
 
+/****************************************************************************
+ * Name: proc_schedstat
+ *
+ * Description:
+ *   Output the exact time the thread has run, the number of times it was
+ *   switched in and its wakeup latency, runnable wait and time slice
+ *   histograms.  Histogram bucket 0 counts samples below 1us and bucket n
+ *   samples below 2^n us.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SCHED_SCHEDSTAT
+static ssize_t proc_schedstat(FAR struct proc_file_s *procfile,
+                              FAR struct tcb_s *tcb, FAR char *buffer,
+                              size_t buflen, off_t offset)
+{
+  FAR struct schedstat_s *stat = &tcb->schedstat;
+  FAR const char *names[3] =
+  {
+    "wakeup", "wait", "slice"
+  };
+
+  FAR const uint32_t *hists[3] =
+  {
+    stat->wakeup, stat->wait, stat->slice
+  };
+
+  struct timespec runtime;
+  clock_t run_time;
+  size_t remaining;
+  size_t linesize;
+  size_t copysize;
+  size_t totalsize;
+  int i;
+  int j;
+
+  remaining = buflen;
+  totalsize = 0;
+
+  /* Include the current time slice of a running thread */
+
+  run_time = stat->run_time;
+  if (tcb->task_state == TSTATE_TASK_RUNNING)
+    {
+      run_time += perf_gettime() - stat->run_start;
+    }
+
+  perf_convert(run_time, &runtime);
+
+  linesize = procfs_snprintf(procfile->line, STATUS_LINELEN,
+                             "%-9s %lu.%09lu\n%-9s %" PRIu32 "\n",
+                             "runtime", (unsigned long)runtime.tv_sec,
+                             (unsigned long)runtime.tv_nsec,
+                             "switches", stat->nswitch);
+  copysize = procfs_memcpy(procfile->line, linesize, buffer, remaining,
+                           &offset);
+
+  totalsize += copysize;
+  buffer    += copysize;
+  remaining -= copysize;
+
+  for (i = 0; i < 3 && totalsize < buflen; i++)
+    {
+      linesize = procfs_snprintf(procfile->line, STATUS_LINELEN, "%-9s",
+                                 names[i]);
+      for (j = 0; j < CONFIG_SCHED_SCHEDSTAT_NBUCKETS; j++)
+        {
+          linesize += procfs_snprintf(procfile->line + linesize,
+                                      STATUS_LINELEN - linesize,
+                                      " %" PRIu32, hists[i][j]);
+        }
+
+      linesize += procfs_snprintf(procfile->line + linesize,
+                                  STATUS_LINELEN - linesize, "\n");
+      copysize = procfs_memcpy(procfile->line, linesize, buffer, remaining,
+                               &offset);
+
+      totalsize += copysize;
+      buffer    += copysize;
+      remaining -= copysize;
+    }
+
+  return totalsize;
+}
+#endif
+
 /****************************************************************************
  * Name: proc_heap
  ****************************************************************************/
@@ -1624,6 +1732,11 @@ static ssize_t proc_read(FAR struct file *filep, FAR char *buffer,
       ret = proc_critmon(procfile, tcb, buffer, buflen, filep->f_pos);
       break;
 #endif
+#ifdef CONFIG_SCHED_SCHEDSTAT
+    case PROC_SCHEDSTAT: /* Run time and latency histograms */
+      ret = proc_schedstat(procfile, tcb, buffer, buflen, filep->f_pos);
+      break;
+#endif
 #if CONFIG_MM_BACKTRACE >= 0
     case PROC_HEAP: /* Task heap info */
       ret = proc_heap(procfile, tcb, buffer, buflen, filep->f_pos);
@@ -316,6 +316,42 @@ static int epoll_setup(FAR epoll_head_t *eph)
   return ret;
 }
 
+/****************************************************************************
+ * Name: epoll_busypoll
+ *
+ * Description:
+ *   Let the first socket with a busy poll time receive from its device
+ *   before epoll_wait() sleeps, until an event is reported.
+ *
+ * Input Parameters:
+ *   eph       - The epoll head pointer
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_BUSY_POLL
+static void epoll_busypoll(FAR epoll_head_t *eph)
+{
+  FAR epoll_node_t *epn;
+  int semcount = 0;
+
+  nxsem_get_value(&eph->sem, &semcount);
+  if (semcount > 0 || nxmutex_lock(&eph->lock) < 0)
+    {
+      return;
+    }
+
+  list_for_every_entry(&eph->setup, epn, epoll_node_t, node)
+    {
+      if (poll_fdbusypoll(&epn->pfd, &eph->sem))
+        {
+          break;
+        }
+    }
+
+  nxmutex_unlock(&eph->lock);
+}
+#endif
+
 /****************************************************************************
  * Name: epoll_teardown
  *
@@ -712,6 +748,9 @@ int epoll_pwait(int epfd, FAR struct epoll_event *evs,
   FAR struct file *filep;
   FAR epoll_head_t *eph;
   sigset_t oldsigmask;
+#ifdef CONFIG_NET_BUSY_POLL
+  bool busypolled = false;
+#endif
   int ret;
 
   eph = epoll_head_from_fd(epfd, &filep);
@@ -727,6 +766,16 @@ retry:
       goto err;
     }
 
+#ifdef CONFIG_NET_BUSY_POLL
+  /* Before the first wait, unless epoll_wait() must not sleep */
+
+  if (timeout != 0 && !busypolled)
+    {
+      epoll_busypoll(eph);
+      busypolled = true;
+    }
+#endif
+
   /* Wait the poll ready */
 
   nxsig_procmask(SIG_SETMASK, sigmask, &oldsigmask);
@@ -787,6 +836,9 @@ int epoll_wait(int epfd, FAR struct epoll_event *evs,
 {
   FAR struct file *filep;
   FAR epoll_head_t *eph;
+#ifdef CONFIG_NET_BUSY_POLL
+  bool busypolled = false;
+#endif
   int ret;
 
   eph = epoll_head_from_fd(epfd, &filep);
@@ -802,6 +854,16 @@ retry:
       goto err;
     }
 
+#ifdef CONFIG_NET_BUSY_POLL
+  /* Before the first wait, unless epoll_wait() must not sleep */
+
+  if (timeout != 0 && !busypolled)
+    {
+      epoll_busypoll(eph);
+      busypolled = true;
+    }
+#endif
+
   /* Wait the poll ready */
 
   if (timeout == 0)
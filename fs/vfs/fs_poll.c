@@ -222,6 +222,43 @@ int poll_fdsetup(int fd, FAR struct pollfd *fds, bool setup)
   return ret;
 }
 
+/****************************************************************************
+ * Name: poll_fdbusypoll
+ *
+ * Description:
+ *   Busy poll the network device of a socket descriptor waiting for
+ *   POLLIN, until sem is posted or the busy poll time of the socket has
+ *   elapsed.
+ *
+ * Returned Value:
+ *   True if the descriptor is a socket with a busy poll time.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_BUSY_POLL
+bool poll_fdbusypoll(FAR struct pollfd *fds, FAR sem_t *sem)
+{
+  FAR struct socket *psock;
+  FAR struct file *filep;
+  bool ret = false;
+
+  if (fds->fd < 0 || (fds->events & POLLIN) == 0 ||
+      fs_getfilep(fds->fd, &filep) < 0)
+    {
+      return false;
+    }
+
+  psock = file_socket(filep);
+  if (psock != NULL)
+    {
+      ret = psock_busypoll(psock, sem);
+    }
+
+  fs_putfilep(filep);
+  return ret;
+}
+#endif
+
 /****************************************************************************
  * Name: poll_default_cb
  *
@@ -472,6 +509,22 @@ int poll(FAR struct pollfd *fds, nfds_t nfds, int timeout)
       fdsinfo.nfds = nfds;
       tls_cleanup_push(tls_get_info(), poll_cleanup, &fdsinfo);
 
+#ifdef CONFIG_NET_BUSY_POLL
+      /* Nothing is ready yet: if poll() may sleep, let the first socket
+       * with a busy poll time receive from its device first.  This stops
+       * as soon as any descriptor reports an event.
+       */
+
+      if (timeout != 0)
+        {
+          nfds_t i;
+
+          for (i = 0; i < nfds && !poll_fdbusypoll(&kfds[i], &sem); i++)
+            {
+            }
+        }
+#endif
+
       if (timeout > 0)
         {
           /* "Implementations may place limitations on the granularity of
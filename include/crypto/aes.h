@@ -34,6 +34,7 @@
  ****************************************************************************/
 
 #include <sys/types.h>
+#include <stdbool.h>
 
 #ifndef AES_MAXROUNDS
 #  define AES_MAXROUNDS (14)
@@ -45,6 +46,9 @@ typedef struct aes_ctx
   uint32_t sk_exp[120];
 
   unsigned num_rounds;
+#ifdef CONFIG_CRYPTO_ACCEL
+  bool accel; /* sk and sk_exp hold the round keys of accel.c */
+#endif
 } AES_CTX;
 
 int aes_setkey(FAR AES_CTX *, FAR const uint8_t *, int);
@@ -355,6 +355,11 @@ struct crypt_op
 /* Indicates that this operation processes aad
  * (Additional Authenticated Data), which is only used
  * in the authentication algorithm.
+ */
+#define COP_FLAG_ASYNC      (1 << 2)
+/* Queue the operation to the cryptodev workers and return at once.
+ * The result is fetched with CIOCCRYPTRET once the descriptor polls
+ * readable, the buffers must stay valid until then.
  */
 
   uint16_t flags;
@@ -364,6 +369,17 @@ struct crypt_op
   caddr_t mac;        /* must be big enough for chosen MAC */
   caddr_t iv;
   caddr_t aad;
+
+  uint32_t reqid;     /* handed back as is by CIOCCRYPTRET */
+  int status;         /* returns: result of CIOCCRYPTM and async requests */
+};
+
+/* ioctl parameter to submit several operations at once */
+
+struct crypt_mop
+{
+  unsigned count;             /* number of operations in reqs */
+  FAR struct crypt_op *reqs;  /* operations, each returns its status */
 };
 
 /* hamc buffer, software & hardware need it */
@@ -387,6 +403,8 @@ extern const uint8_t hmac_opad_buffer[HMAC_MAX_BLOCK_LEN];
 #define CIOCKEY                 104
 #define CIOCKEYRET              105
 #define CIOCASYMFEAT            106
+#define CIOCCRYPTM              107
+#define CIOCCRYPTRET            108
 
 int crypto_newsession(FAR uint64_t *, FAR struct cryptoini *, int);
 int crypto_freesession(uint64_t);
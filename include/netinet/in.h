@@ -114,6 +114,8 @@
 #define IP_TTL                (__SO_PROTOCOL + 14) /* The IP TTL (time to live)
                                                     * of IP packets sent by the
                                                     * network stack */
+#define IP_RECVERR            (__SO_PROTOCOL + 15) /* Level/type of the error
+                                                    * queue messages */
 
 /* SOL_IPV6 protocol-level socket options. */
 
@@ -136,6 +138,19 @@
                                                     * field */
 #define IPV6_RECVHOPLIMIT     (__SO_PROTOCOL + 11) /* Access the hop limit field */
 #define IPV6_HOPLIMIT         (__SO_PROTOCOL + 12) /* Hop limit */
+#define IPV6_RECVERR          (__SO_PROTOCOL + 13) /* Level/type of the error
+                                                    * queue messages */
+
+/* Origins and codes of struct sock_extended_err */
+
+#define SO_EE_ORIGIN_NONE           0
+#define SO_EE_ORIGIN_LOCAL          1
+#define SO_EE_ORIGIN_ICMP           2
+#define SO_EE_ORIGIN_ICMP6          3
+#define SO_EE_ORIGIN_ZEROCOPY       5
+
+#define SO_EE_CODE_ZEROCOPY_COPIED  1 /* The data was copied, not sent in
+                                       * place */
 
 /* Values used with SIOCSIFMCFILTER and SIOCGIFMCFILTER ioctl's */
 
@@ -308,6 +323,22 @@ struct in_pktinfo
   struct in_addr ipi_addr;          /* Header Destination address */
 };
 
+/* Error queue message, read with recvmsg(MSG_ERRQUEUE).  For
+ * SO_EE_ORIGIN_ZEROCOPY, ee_info..ee_data is the range of MSG_ZEROCOPY
+ * sends that completed.
+ */
+
+struct sock_extended_err
+{
+  uint32_t       ee_errno;          /* Error number */
+  uint8_t        ee_origin;         /* Where the error originated */
+  uint8_t        ee_type;           /* Type */
+  uint8_t        ee_code;           /* Code */
+  uint8_t        ee_pad;            /* Padding */
+  uint32_t       ee_info;           /* Additional information */
+  uint32_t       ee_data;           /* Other data */
+};
+
 /* IPv6 Internet address */
 
 struct in6_addr
@@ -58,4 +58,12 @@
                                            * Argument: max retry count */
 #define TCP_MAXSEG    (__SO_PROTOCOL + 4) /* The maximum segment size */
 
+/* Congestion control algorithm.  Argument: name string */
+
+#define TCP_CONGESTION (__SO_PROTOCOL + 5)
+
+/* Maximum length of a TCP_CONGESTION name */
+
+#define TCP_CA_NAME_MAX 16
+
 #endif /* __INCLUDE_NETINET_TCP_H */
@@ -33,6 +33,11 @@
  * Pre-processor Definitions
  ****************************************************************************/
 
+/* UDP protocol (SOL_UDP) socket options */
+
+#define UDP_SEGMENT     103  /* Split the sends into datagrams of this size */
+#define UDP_GRO         104  /* Coalesce the received datagrams */
+
 /* UDP header as specified by RFC 768, August 1980. */
 
 struct udphdr
@@ -128,7 +128,8 @@ struct iob_s
   unsigned int io_pktlen; /* Total length of the packet */
 
 #ifdef CONFIG_IOB_ALLOC
-  iob_free_cb_t io_free;  /* Custom free callback */
+  iob_free_cb_t io_free;    /* Custom free callback */
+  FAR void     *io_freearg; /* Argument of the free callback */
   FAR uint8_t  *io_data;
 #else
   uint8_t       io_data[CONFIG_IOB_BUFSIZE];
@@ -266,6 +267,25 @@ FAR struct iob_s *iob_alloc_dynamic(uint16_t size);
 
 FAR struct iob_s *iob_alloc_with_data(FAR void *data, uint16_t size,
                                       iob_free_cb_t free_cb);
+
+/****************************************************************************
+ * Name: iob_alloc_with_arg
+ *
+ * Description:
+ *   Like iob_alloc_with_data(), but free_cb is called with arg instead of
+ *   the data pointer, so that the caller can find the state owning each
+ *   I/O buffer directly.
+ *
+ * Input Parameters:
+ *   data    - The external payload, see iob_alloc_with_data()
+ *   size    - The size of the data parameter
+ *   free_cb - Called with arg when the iob is freed
+ *   arg     - The argument passed to free_cb
+ *
+ ****************************************************************************/
+
+FAR struct iob_s *iob_alloc_with_arg(FAR void *data, uint16_t size,
+                                     iob_free_cb_t free_cb, FAR void *arg);
 #endif
 
 /****************************************************************************
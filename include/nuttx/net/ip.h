@@ -200,6 +200,18 @@ struct ipv4_stats_s
                            * checksum errors */
   net_stats_t protoerr;   /* Number of packets dropped since they
                            * were neither ICMP, UDP nor TCP */
+#ifdef CONFIG_NET_IPFORWARD_FLOWTABLE
+  net_stats_t flowhit;    /* Number of packets forwarded by the flow
+                           * table */
+  net_stats_t flowmiss;   /* Number of TCP/UDP packets that missed the
+                           * flow table */
+#endif
+#ifdef CONFIG_NET_ARP
+  net_stats_t arphit;     /* Number of ARP table lookups that found the
+                           * hardware address */
+  net_stats_t arpmiss;    /* Number of ARP table lookups that did not */
+  net_stats_t arppending; /* Number of ARP requests waiting for a reply */
+#endif
 };
 #endif /* CONFIG_NET_IPv6 */
 
@@ -215,6 +227,18 @@ struct ipv6_stats_s
                            * were IP fragments */
   net_stats_t protoerr;   /* Number of packets dropped since they
                            * were neither ICMP, UDP nor TCP */
+#ifdef CONFIG_NET_IPFORWARD_FLOWTABLE
+  net_stats_t flowhit;    /* Number of packets forwarded by the flow
+                           * table */
+  net_stats_t flowmiss;   /* Number of TCP/UDP packets that missed the
+                           * flow table */
+#endif
+  net_stats_t nbhit;      /* Number of Neighbor table lookups that found
+                           * the link layer address */
+  net_stats_t nbmiss;     /* Number of Neighbor table lookups that did
+                           * not */
+  net_stats_t nbpending;  /* Number of Neighbor Solicitations waiting for
+                           * an advertisement */
 };
 #endif /* CONFIG_NET_IPv6 */
 #endif /* CONFIG_NET_STATISTICS */
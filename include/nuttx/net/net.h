@@ -220,6 +220,13 @@ struct socket_conn_s
   uint8_t       s_boundto;   /* Index of the interface we are bound to.
                               * Unbound: 0, Bound: 1-MAX_IFINDEX */
 #  endif
+#  ifdef CONFIG_NET_ZEROCOPY
+  sq_queue_t    s_zcdone;    /* Completed MSG_ZEROCOPY sends */
+  uint32_t      s_zcnext;    /* Notification id of the next one */
+#  endif
+#  ifdef CONFIG_NET_BUSY_POLL
+  uint16_t      s_busypoll;  /* Busy poll time (in microseconds) */
+#  endif
 #endif
 
   /* Definitions of 8-bit socket flags */
@@ -928,6 +935,58 @@ ssize_t psock_sendmsg(FAR struct socket *psock, FAR struct msghdr *msg,
 ssize_t psock_recvmsg(FAR struct socket *psock, FAR struct msghdr *msg,
                       int flags);
 
+/****************************************************************************
+ * Name: psock_sendmmsg
+ *
+ * Description:
+ *   psock_sendmmsg() sends up to vlen messages to a socket with a single
+ *   call.  This is an internal OS interface.  It is functionally equivalent
+ *   to sendmmsg() except that it is not a cancellation point, it does not
+ *   modify the errno variable and it accepts the internal socket structure
+ *   as an input.
+ *
+ * Input Parameters:
+ *   psock     A pointer to a NuttX-specific, internal socket structure
+ *   msgvec    Vector of the messages to send
+ *   vlen      Number of entries in msgvec
+ *   flags     Send flags
+ *
+ * Returned Value:
+ *   On success, returns the number of messages sent.  If no message could
+ *   be sent, a negated errno value is returned.
+ *
+ ****************************************************************************/
+
+int psock_sendmmsg(FAR struct socket *psock, FAR struct mmsghdr *msgvec,
+                   unsigned int vlen, int flags);
+
+/****************************************************************************
+ * Name: psock_recvmmsg
+ *
+ * Description:
+ *   psock_recvmmsg() receives up to vlen messages from a socket with a
+ *   single call.  This is an internal OS interface.  It is functionally
+ *   equivalent to recvmmsg() except that it is not a cancellation point,
+ *   it does not modify the errno variable and it accepts the internal
+ *   socket structure as an input.
+ *
+ * Input Parameters:
+ *   psock     A pointer to a NuttX-specific, internal socket structure
+ *   msgvec    Vector of the message headers to receive into
+ *   vlen      Number of entries in msgvec
+ *   flags     Receive flags
+ *   timeout   Time limit of the whole call, may be NULL
+ *
+ * Returned Value:
+ *   On success, returns the number of messages received.  If no message
+ *   could be received, a negated errno value is returned.
+ *
+ ****************************************************************************/
+
+int psock_recvmmsg(FAR struct socket *psock, FAR struct mmsghdr *msgvec,
+                   unsigned int vlen, int flags,
+                   FAR struct timespec *timeout);
+
 /****************************************************************************
  * Name: psock_send
  *
@@ -1330,6 +1389,27 @@ int psock_shutdown(FAR struct socket *psock, int how);
 struct pollfd; /* Forward reference -- see poll.h */
 int psock_poll(FAR struct socket *psock, struct pollfd *fds, bool setup);
 
+/****************************************************************************
+ * Name: psock_busypoll
+ *
+ * Description:
+ *   Receive from the network device of a TCP or UDP socket for its
+ *   SO_BUSY_POLL time, or until the semaphore of the poll() call has been
+ *   posted.  poll() and epoll_wait() call this once before they sleep.
+ *
+ * Input Parameters:
+ *   psock - An instance of the internal socket structure.
+ *   sem   - The semaphore posted when an event is reported.
+ *
+ * Returned Value:
+ *   True if the socket has a busy poll time and the device was polled.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_BUSY_POLL
+bool psock_busypoll(FAR struct socket *psock, FAR sem_t *sem);
+#endif
+
 /****************************************************************************
  * Name: psock_dup2
  *
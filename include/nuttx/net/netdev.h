@@ -174,6 +174,16 @@
 #  define NETDEV_TXTIMEOUTS(dev)  _NETDEV_ERROR(dev,tx_timeouts)
 #  define NETDEV_ERRORS(dev)      _NETDEV_STATISTIC(dev,errors)
 
+#  ifdef CONFIG_NETDEV_NAPI
+#    define NETDEV_RXPOLLS(dev)   _NETDEV_STATISTIC(dev,rx_polls)
+#    define NETDEV_RXSQUEEZED(dev) _NETDEV_STATISTIC(dev,rx_squeezed)
+#    define NETDEV_RXIRQS(dev)    _NETDEV_STATISTIC(dev,rx_irqs)
+#  else
+#    define NETDEV_RXPOLLS(dev)
+#    define NETDEV_RXSQUEEZED(dev)
+#    define NETDEV_RXIRQS(dev)
+#  endif
+
 #else
 #  define NETDEV_RESET_STATISTICS(dev)
 #  define NETDEV_RXPACKETS(dev)
@@ -190,6 +200,10 @@
 #  define NETDEV_TXTIMEOUTS(dev)
 
 #  define NETDEV_ERRORS(dev)
+
+#  define NETDEV_RXPOLLS(dev)
+#  define NETDEV_RXSQUEEZED(dev)
+#  define NETDEV_RXIRQS(dev)
 #endif
 
 /* There are some helper pointers for accessing the contents of the IP
@@ -203,6 +217,15 @@
 #define IPv4BUF ((FAR struct ipv4_hdr_s *)IPBUF(0))
 #define IPv6BUF ((FAR struct ipv6_hdr_s *)IPBUF(0))
 
+/* True if the TCP packet being built carries more than d_gsosize bytes of
+ * payload, so that the driver has to cut it into segments.
+ */
+
+#ifdef CONFIG_NETDEV_GSO
+#  define NETDEV_IS_GSO(dev) \
+     ((dev)->d_gsosize > 0 && (dev)->d_sndlen > (dev)->d_gsosize)
+#endif
+
 #ifdef CONFIG_NET_IPv6
 #  ifndef CONFIG_NETDEV_MAX_IPv6_ADDR
 #    define CONFIG_NETDEV_MAX_IPv6_ADDR 1
@@ -257,6 +280,14 @@ struct netdev_statistics_s
 
   uint32_t errors;         /* Total number of errors */
 
+#ifdef CONFIG_NETDEV_NAPI
+  /* Budgeted receive polling */
+
+  uint32_t rx_polls;       /* Number of receive polls */
+  uint32_t rx_squeezed;    /* Polls that ran out of budget */
+  uint32_t rx_irqs;        /* Number of RX ready notifications */
+#endif
+
 #if CONFIG_NETDEV_STATISTICS_LOG_PERIOD > 0
   struct work_s logwork;   /* For periodic log work */
 #endif
@@ -339,6 +370,17 @@ struct net_driver_s
 
   uint16_t d_pktsize;           /* Maximum packet size */
 
+#ifdef CONFIG_NETDEV_GSO
+  /* Generic segmentation offload: d_gsomax is the biggest packet, link
+   * layer header included, that TCP may build for this device (0 if the
+   * driver does not support it).  d_gsosize is the payload size of the
+   * segments that the outgoing TCP packet has to be cut into.
+   */
+
+  uint16_t d_gsomax;
+  uint16_t d_gsosize;
+#endif
+
   /* Link layer address */
 
 #if defined(CONFIG_NET_ETHERNET) || defined(CONFIG_NET_6LOWPAN) || \
@@ -474,6 +516,15 @@ struct net_driver_s
 
   uint16_t d_sndlen;
 
+#ifdef CONFIG_NET_CHKSUM_COPY
+  /* Raw checksum of the d_sndsumlen bytes of application data, computed
+   * while they were copied in.  Only valid while d_sndsumlen == d_sndlen.
+   */
+
+  uint16_t d_sndsum;
+  uint16_t d_sndsumlen;
+#endif
+
   /* Multicast group support */
 
 #ifdef CONFIG_NET_IGMP
@@ -541,6 +592,14 @@ struct net_driver_s
   CODE int (*d_ioctl)(FAR struct net_driver_s *dev, int cmd,
                       unsigned long arg);
 #endif
+#ifdef CONFIG_NET_BUSY_POLL
+  /* Receive at most budget packets in the context of the caller, with the
+   * network locked.  Returns the number of packets received.  NULL if the
+   * driver does not support busy polling.
+   */
+
+  CODE int (*d_busypoll)(FAR struct net_driver_s *dev, int budget);
+#endif
 
   /* Drivers may attached device-specific, private information */
 
@@ -830,6 +889,28 @@ uint16_t chksum(uint16_t sum, FAR const uint8_t *data, uint16_t len);
 
 uint16_t chksum_iob(uint16_t sum, FAR struct iob_s *iob, uint16_t offset);
 
+/****************************************************************************
+ * Name: chksum_copy, chksum_iob_copyin and chksum_iob_clone
+ *
+ * Description:
+ *   Copy data to a flat buffer, from a flat buffer into an iob chain or
+ *   from one iob chain to another, and calculate the checksum of the copied
+ *   data in the same pass.  The iob chain copied to is grown or trimmed so
+ *   that it ends with the copied data.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_CHKSUM_COPY
+uint16_t chksum_copy(uint16_t sum, FAR uint8_t *dest,
+                     FAR const uint8_t *src, uint16_t len);
+int chksum_iob_copyin(FAR struct iob_s *iob, FAR const uint8_t *src,
+                      unsigned int len, unsigned int offset,
+                      FAR uint16_t *sum);
+int chksum_iob_clone(FAR struct iob_s *iob1, unsigned int len,
+                     unsigned int offset1, FAR struct iob_s *iob2,
+                     unsigned int offset2, FAR uint16_t *sum);
+#endif
+
 /****************************************************************************
  * Name: net_chksum
  *
@@ -1347,4 +1428,29 @@ int netdev_ipv6_foreach(FAR struct net_driver_s *dev,
 void netdev_statistics_log(FAR void *arg);
 #endif
 
+/****************************************************************************
+ * Name: netdev_rss_hash
+ *
+ * Description:
+ *   Calculate the Toeplitz RSS hash of a flow, with the addresses in
+ *   network order as found in the packets and the source first.
+ *
+ * Input Parameters:
+ *   domain   - The layer 3 protocol, PF_INET/PF_INET6
+ *   src_addr - The source address
+ *   src_port - The source port
+ *   dst_addr - The destination address
+ *   dst_port - The destination port
+ *
+ * Returned Value:
+ *   The hash value of the flow
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NETDEV_RSS
+uint32_t netdev_rss_hash(uint8_t domain,
+                         FAR const void *src_addr, uint16_t src_port,
+                         FAR const void *dst_addr, uint16_t dst_port);
+#endif
+
 #endif /* __INCLUDE_NUTTX_NET_NETDEV_H */
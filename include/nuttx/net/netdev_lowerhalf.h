@@ -72,6 +72,25 @@
 #define NETPKT_BUFLEN   CONFIG_IOB_BUFSIZE
 #define NETPKT_BUFNUM   CONFIG_IOB_NBUFFERS
 
+/* Offload features of a lower half, see the features field of
+ * struct netdev_lowerhalf_s.
+ */
+
+#define NETDEV_F_TSO4     (1 << 0) /* Segments TCP/IPv4 packets by itself */
+#define NETDEV_F_GRO      (1 << 1) /* Received TCP segments may be coalesced */
+#define NETDEV_F_BUSYPOLL (1 << 2) /* receive() may be called by busy polling
+                                    * sockets at any time */
+
+/* The most RX/TX queue pairs of a device, each one served by its own
+ * thread bound to the CPU of the same index.
+ */
+
+#ifdef CONFIG_NETDEV_RSS
+#  define NETDEV_MAX_QUEUES CONFIG_SMP_NCPUS
+#else
+#  define NETDEV_MAX_QUEUES 1
+#endif
+
 /****************************************************************************
  * Public Types
  ****************************************************************************/
@@ -119,6 +138,27 @@ struct netdev_lowerhalf_s
 
   atomic_int quota[NETPKT_TYPENUM];
 
+  /* Offload features (NETDEV_F_*) and, with NETDEV_F_TSO4, the biggest
+   * packet that the driver is able to segment (0 for no limit).  Set them
+   * before registering the device.
+   */
+
+  uint8_t  features;
+  uint16_t gso_maxsize;
+
+  /* With NETDEV_NAPI, the most packets received from the driver in one
+   * poll before the other devices get their turn (0 for the default).
+   */
+
+  uint16_t napi_weight;
+
+  /* The number of RX/TX queue pairs (0 or 1 for a single one), at most
+   * NETDEV_MAX_QUEUES.  With more than one, transmit_queue and
+   * receive_queue are used instead of transmit and receive.
+   */
+
+  uint8_t  nqueues;
+
   /* The structure used by net stack.
    * Note: Do not change its fields unless you know what you are doing.
    *
@@ -141,6 +181,10 @@ struct netdev_ops_s
 
   /* transmit - Try to send a packet, non-blocking, own the netpkt and
    *            need to call netpkt_free to free it sometime later.
+   *            With NETDEV_F_TSO4, if netdev.d_gsosize is not zero, the
+   *            packet is a TCP/IPv4 one to be sent as segments carrying
+   *            d_gsosize bytes of payload each, and its TCP checksum
+   *            field holds the checksum of the pseudo header only.
    *   Returned Value:
    *     OK for successfully sent the packet, driver can take pkt to its
    *       own queue and return OK (remember to free it later).
@@ -172,6 +216,28 @@ struct netdev_ops_s
   /* reclaim - try to reclaim packets sent by netdev. */
 
   CODE void (*reclaim)(FAR struct netdev_lowerhalf_s *dev);
+
+  /* rxint - Mask (enable false) or unmask the RX interrupt, optional.
+   *         With NETDEV_NAPI, the interrupt is masked when
+   *         netdev_lower_rxready() schedules the poll of the device and
+   *         unmasked once receive() has returned NULL.  Called with the
+   *         interrupts disabled, possibly from the interrupt handler.
+   *         The driver has to call netdev_lower_rxready() again if
+   *         packets have arrived before the interrupt was unmasked.
+   */
+
+  CODE void (*rxint)(FAR struct netdev_lowerhalf_s *dev, bool enable);
+
+  /* transmit_queue/receive_queue - Same as transmit/receive, through the
+   *         given queue of a device having several (see nqueues).  The TX
+   *         queue is selected by the RSS hash of the flow, receive_queue
+   *         is called by the thread of the queue only.
+   */
+
+  CODE int (*transmit_queue)(FAR struct netdev_lowerhalf_s *dev,
+                             FAR netpkt_t *pkt, int queue);
+  CODE FAR netpkt_t *(*receive_queue)(FAR struct netdev_lowerhalf_s *dev,
+                                      int queue);
 };
 
 /* This structure is a set of wireless handlers, leave unsupported operations
@@ -295,6 +361,22 @@ void netdev_lower_carrier_off(FAR struct netdev_lowerhalf_s *dev);
 
 void netdev_lower_rxready(FAR struct netdev_lowerhalf_s *dev);
 
+/****************************************************************************
+ * Name: netdev_lower_rxready_queue
+ *
+ * Description:
+ *   Notifies the networking layer about an RX packet is ready to read from
+ *   the given queue of a device having several.
+ *
+ * Input Parameters:
+ *   dev   - The lower half device driver structure
+ *   queue - The queue having packets
+ *
+ ****************************************************************************/
+
+void netdev_lower_rxready_queue(FAR struct netdev_lowerhalf_s *dev,
+                                int queue);
+
 /****************************************************************************
  * Name: netdev_lower_txdone
  *
@@ -428,6 +428,44 @@ struct stackinfo_s
                                          /* from the stack.                  */
 };
 
+/* struct lockstat_held_s ***************************************************/
+
+/* Used by the lock contention profiler to time how long a lock is held */
+
+#ifdef CONFIG_SCHED_LOCKSTAT
+struct lockstat_held_s
+{
+  FAR const void *lock;                  /* Lock that is held               */
+  FAR void       *site;                  /* Caller that took the lock       */
+  clock_t         start;                 /* Time the lock was taken         */
+  bool            contended;             /* The lock was busy when tried    */
+};
+#endif
+
+/* struct schedstat_s *******************************************************/
+
+/* Exact run time and log2 latency histograms, kept per task and per CPU.
+ * Histogram bucket 0 counts samples below 1us, bucket n samples in
+ * [2^(n-1), 2^n) us and the last bucket everything longer.
+ */
+
+#ifdef CONFIG_SCHED_SCHEDSTAT
+struct schedstat_s
+{
+  clock_t  run_start;                    /* Time when switched in           */
+  clock_t  run_time;                     /* Total time on the CPU           */
+  clock_t  ready_start;                  /* Time when made ready-to-run     */
+  bool     woken;                        /* Ready since a wakeup            */
+  uint32_t nswitch;                      /* Number of times switched in     */
+
+  /* Histograms of wakeup to running, ready to running and time on the CPU */
+
+  uint32_t wakeup[CONFIG_SCHED_SCHEDSTAT_NBUCKETS];
+  uint32_t wait[CONFIG_SCHED_SCHEDSTAT_NBUCKETS];
+  uint32_t slice[CONFIG_SCHED_SCHEDSTAT_NBUCKETS];
+};
+#endif
+
 /* struct task_join_s *******************************************************/
 
 /* Used to save task join information */
@@ -713,6 +751,19 @@ struct tcb_s
   void   *crit_max_caller;               /* Caller of max critical section  */
 #endif
 
+  /* Scheduler latency statistics *******************************************/
+
+#ifdef CONFIG_SCHED_SCHEDSTAT
+  struct schedstat_s schedstat;          /* Run time and latency histograms */
+#endif
+
+  /* Lock contention profiler support ***************************************/
+
+#ifdef CONFIG_SCHED_LOCKSTAT
+  FAR void *lockstat_site;               /* Caller of the last wait         */
+  struct lockstat_held_s lockstat_held[CONFIG_SCHED_LOCKSTAT_NHELD];
+#endif
+
   /* State save areas *******************************************************/
 
   /* The form and content of these fields are platform-specific.            */
@@ -124,7 +124,8 @@ typedef union spinlock_u spinlock_t;
 #endif
 
 #if !defined(__SP_UNLOCK_FUNCTION) && (defined(CONFIG_TICKET_SPINLOCK) || \
-     defined(CONFIG_SCHED_INSTRUMENTATION_SPINLOCKS))
+     defined(CONFIG_SCHED_INSTRUMENTATION_SPINLOCKS) || \
+     defined(CONFIG_SCHED_LOCKSTAT))
 #  define __SP_UNLOCK_FUNCTION 1
 #endif
 
@@ -144,6 +145,18 @@ void sched_note_spinlock_unlock(FAR volatile spinlock_t *spinlock);
 #  define sched_note_spinlock_unlock(spinlock)
 #endif
 
+#ifdef CONFIG_SCHED_LOCKSTAT
+void nxsched_lockstat_spin_lock(FAR volatile spinlock_t *spinlock);
+void nxsched_lockstat_spin_locked(FAR volatile spinlock_t *spinlock);
+void nxsched_lockstat_spin_abort(FAR volatile spinlock_t *spinlock);
+void nxsched_lockstat_spin_unlock(FAR volatile spinlock_t *spinlock);
+#else
+#  define nxsched_lockstat_spin_lock(spinlock)
+#  define nxsched_lockstat_spin_locked(spinlock)
+#  define nxsched_lockstat_spin_abort(spinlock)
+#  define nxsched_lockstat_spin_unlock(spinlock)
+#endif
+
 /****************************************************************************
  * Public Data Types
  ****************************************************************************/
@@ -287,6 +300,7 @@ static inline_function void spin_lock(FAR volatile spinlock_t *lock)
   /* Notify that we are waiting for a spinlock */
 
   sched_note_spinlock_lock(lock);
+  nxsched_lockstat_spin_lock(lock);
 
   /* Lock without trace note */
 
@@ -295,6 +309,7 @@ static inline_function void spin_lock(FAR volatile spinlock_t *lock)
   /* Notify that we have the spinlock */
 
   sched_note_spinlock_locked(lock);
+  nxsched_lockstat_spin_locked(lock);
 }
 #endif /* CONFIG_SPINLOCK */
 
@@ -384,6 +399,7 @@ static inline_function bool spin_trylock(FAR volatile spinlock_t *lock)
   /* Notify that we are waiting for a spinlock */
 
   sched_note_spinlock_lock(lock);
+  nxsched_lockstat_spin_lock(lock);
 
   /* Try lock without trace note */
 
@@ -393,12 +409,14 @@ static inline_function bool spin_trylock(FAR volatile spinlock_t *lock)
       /* Notify that we have the spinlock */
 
       sched_note_spinlock_locked(lock);
+      nxsched_lockstat_spin_locked(lock);
     }
   else
     {
       /* Notify that we abort for a spinlock */
 
       sched_note_spinlock_abort(lock);
+      nxsched_lockstat_spin_abort(lock);
     }
 
   return locked;
@@ -468,6 +486,7 @@ static inline_function void spin_unlock(FAR volatile spinlock_t *lock)
   /* Notify that we are unlocking the spinlock */
 
   sched_note_spinlock_unlock(lock);
+  nxsched_lockstat_spin_unlock(lock);
 }
 #  else
 #    define spin_unlock(l)  do { *(l) = SP_UNLOCKED; } while (0)
@@ -594,6 +613,7 @@ irqstate_t spin_lock_irqsave(FAR volatile spinlock_t *lock)
   /* Notify that we are waiting for a spinlock */
 
   sched_note_spinlock_lock(lock);
+  nxsched_lockstat_spin_lock(lock);
 
   /* Lock without trace note */
 
@@ -602,6 +622,7 @@ irqstate_t spin_lock_irqsave(FAR volatile spinlock_t *lock)
   /* Notify that we have the spinlock */
 
   sched_note_spinlock_locked(lock);
+  nxsched_lockstat_spin_locked(lock);
 
   return flags;
 }
@@ -760,6 +781,7 @@ void spin_unlock_irqrestore(FAR volatile spinlock_t *lock,
   /* Notify that we are unlocking the spinlock */
 
   sched_note_spinlock_unlock(lock);
+  nxsched_lockstat_spin_unlock(lock);
 }
 #else
 #  define spin_unlock_irqrestore(l, f) ((void)(l), up_irq_restore(f))
@@ -1128,6 +1128,33 @@ struct sensor_ustate_s
   uint64_t generation;         /* The recent generation of circular buffer */
 };
 
+/* This structure is the header of the ring returned by mmap() on a sensor
+ * topic.  The elements follow the header at offset and are overwritten in
+ * a circle, so subscribers can use them in place without taking any lock:
+ *
+ * 1. Take a consistent snapshot: read wseq, then seq and head, then wseq
+ *    again.  Retry unless both reads of wseq are equal to seq.
+ * 2. Element number n, with seq - nbuffer <= n < seq, is stored at index
+ *    (head + nbuffer - (seq - n)) % nbuffer.
+ * 3. After using an element, read wseq again.  If wseq - n > nbuffer the
+ *    element was being overwritten and must be dropped.
+ *
+ * All counters wrap around and must be compared by their difference.  The
+ * reads above must be ordered with a read barrier on SMP systems.  poll()
+ * reports POLLIN once per batch of elements published since the previous
+ * poll() of the same file.
+ */
+
+struct sensor_ring_s
+{
+  uint32_t esize;              /* The element size of the ring */
+  uint32_t nbuffer;            /* The number of elements the ring holds */
+  uint32_t offset;             /* The offset of the elements from the header */
+  volatile uint32_t head;      /* The index the next element is written to */
+  volatile uint32_t wseq;      /* The number of elements started to write */
+  volatile uint32_t seq;       /* The number of elements published */
+};
+
 /* This structure describes the register info for the user sensor */
 
 #ifdef CONFIG_USENSOR
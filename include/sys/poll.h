@@ -155,6 +155,9 @@ int ppoll(FAR struct pollfd *fds, nfds_t nfds,
           FAR const sigset_t *sigmask);
 
 int poll_fdsetup(int fd, FAR struct pollfd *fds, bool setup);
+#ifdef CONFIG_NET_BUSY_POLL
+bool poll_fdbusypoll(FAR struct pollfd *fds, FAR sem_t *sem);
+#endif
 void poll_default_cb(FAR struct pollfd *fds);
 void poll_notify(FAR struct pollfd **afds, int nfds, pollevent_t eventset);
 
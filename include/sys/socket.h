@@ -30,6 +30,7 @@
 #include <sys/types.h>
 #include <sys/uio.h>
 #include <stdint.h>
+#include <time.h>
 
 /****************************************************************************
  * Pre-processor Definitions
@@ -136,9 +137,13 @@
 #define MSG_ERRQUEUE     0x002000 /* Fetch message from error queue.  */
 #define MSG_NOSIGNAL     0x004000 /* Do not generate SIGPIPE.  */
 #define MSG_MORE         0x008000 /* Sender will send more.  */
+#define MSG_WAITFORONE   0x010000 /* Wait for the first message only.  */
 #define MSG_CMSG_CLOEXEC 0x100000 /* Set close_on_exit for file
                                    * descriptor received through SCM_RIGHTS.
                                    */
+#define MSG_ZEROCOPY     0x200000 /* Send the user buffer in place, see
+                                   * SO_ZEROCOPY.
+                                   */
 
 /* Protocol levels supported by get/setsockopt(): */
 
@@ -220,6 +225,21 @@
 #define SO_PEERCRED     18 /* Return the credentials of the peer process
                             * connected to this socket.
                             */
+#define SO_REUSEPORT    19 /* Allow several sockets to bind the same local
+                            * address and port (get/set).
+                            * arg: pointer to integer containing a boolean
+                            * value
+                            */
+#define SO_ZEROCOPY     20 /* Allow MSG_ZEROCOPY sends, completions are read
+                            * with MSG_ERRQUEUE (get/set).
+                            * arg: pointer to integer containing a boolean
+                            * value
+                            */
+#define SO_BUSY_POLL    21 /* Poll the device for the given time before
+                            * blocking in recv() or poll() (get/set).
+                            * arg: pointer to integer containing the time in
+                            * microseconds
+                            */
 
 /* The options are unsupported but included for compatibility
  * and portability
@@ -370,6 +390,14 @@ struct msghdr
   unsigned int msg_flags;
 };
 
+/* Message vector entry of sendmmsg()/recvmmsg() */
+
+struct mmsghdr
+{
+  struct msghdr msg_hdr;        /* Message header */
+  unsigned int msg_len;         /* Number of bytes transmitted */
+};
+
 struct cmsghdr
 {
   unsigned long cmsg_len;       /* Data byte count, including hdr */
@@ -457,6 +485,11 @@ int getpeername(int sockfd, FAR struct sockaddr *addr,
 ssize_t recvmsg(int sockfd, FAR struct msghdr *msg, int flags);
 ssize_t sendmsg(int sockfd, FAR struct msghdr *msg, int flags);
 
+int recvmmsg(int sockfd, FAR struct mmsghdr *msgvec, unsigned int vlen,
+             int flags, FAR struct timespec *timeout);
+int sendmmsg(int sockfd, FAR struct mmsghdr *msgvec, unsigned int vlen,
+             int flags);
+
 #if CONFIG_FORTIFY_SOURCE > 0
 fortify_function(send) ssize_t send(int sockfd, FAR const void *buf,
                                     size_t len, int flags)
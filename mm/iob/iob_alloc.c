@@ -361,6 +361,7 @@ FAR struct iob_s *iob_alloc_dynamic(uint16_t size)
       iob->io_free    = iob_free_dynamic; /* Customer free callback */
       iob->io_data    = (FAR uint8_t *)ROUNDUP((uintptr_t)(iob + 1),
                                                CONFIG_IOB_ALIGNMENT);
+      iob->io_freearg = iob->io_data;
     }
 
   return iob;
@@ -391,6 +392,28 @@ FAR struct iob_s *iob_alloc_dynamic(uint16_t size)
 
 FAR struct iob_s *iob_alloc_with_data(FAR void *data, uint16_t size,
                                       iob_free_cb_t free_cb)
+{
+  return iob_alloc_with_arg(data, size, free_cb, data);
+}
+
+/****************************************************************************
+ * Name: iob_alloc_with_arg
+ *
+ * Description:
+ *   Like iob_alloc_with_data(), but free_cb is called with arg instead of
+ *   the data pointer, so that the caller can find the state owning each
+ *   I/O buffer directly.
+ *
+ * Input Parameters:
+ *   data    - The external payload, see iob_alloc_with_data()
+ *   size    - The size of the data parameter
+ *   free_cb - Called with arg when the iob is freed
+ *   arg     - The argument passed to free_cb
+ *
+ ****************************************************************************/
+
+FAR struct iob_s *iob_alloc_with_arg(FAR void *data, uint16_t size,
+                                     iob_free_cb_t free_cb, FAR void *arg)
 {
   FAR struct iob_s *iob;
 
@@ -405,6 +428,7 @@ FAR struct iob_s *iob_alloc_with_data(FAR void *data, uint16_t size,
       iob->io_bufsize = size;    /* Total length of the iob buffer */
       iob->io_pktlen  = 0;       /* Total length of the packet */
       iob->io_free    = free_cb; /* Customer free callback */
+      iob->io_freearg = arg;     /* Argument of the callback */
       iob->io_data    = data;
     }
 
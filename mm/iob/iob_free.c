@@ -123,7 +123,7 @@ FAR struct iob_s *iob_free(FAR struct iob_s *iob)
 #ifdef CONFIG_IOB_ALLOC
   if (iob->io_free != NULL)
     {
-      iob->io_free(iob->io_data);
+      iob->io_free(iob->io_freearg);
       kmm_free(iob);
       return next;
     }
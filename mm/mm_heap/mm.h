@@ -47,6 +47,23 @@
 
 /* Configuration ************************************************************/
 
+#ifndef CONFIG_MM_HEAP_PIDSTATS
+#  define CONFIG_MM_HEAP_PIDSTATS 0
+#endif
+
+#if CONFIG_MM_BACKTRACE >= 0 && CONFIG_MM_HEAP_PIDSTATS > 0
+#  define MM_HEAP_PIDSTATS 1
+#endif
+
+/* The allocation profiler only covers heaps that live in the same address
+ * space as procfs.
+ */
+
+#if defined(CONFIG_MM_HEAPPROF) && CONFIG_MM_BACKTRACE > 0 && \
+    (defined(CONFIG_BUILD_FLAT) || defined(__KERNEL__))
+#  define MM_HEAPPROF 1
+#endif
+
 /* Chunk Header Definitions *************************************************/
 
 /* These definitions define the characteristics of the allocator:
@@ -217,6 +234,17 @@ struct mm_delaynode_s
   FAR struct mm_delaynode_s *flink;
 };
 
+/* Memory held by one pid, kept up to date by malloc and free */
+
+#ifdef MM_HEAP_PIDSTATS
+struct mm_pidstat_s
+{
+  pid_t  pid;                               /* Owner of the chunks */
+  size_t aordblks;                          /* Number of chunks, 0 if unused */
+  size_t uordblks;                          /* Total size of the chunks */
+};
+#endif
+
 /* This describes one heap (possibly with multiple regions) */
 
 struct mm_heap_s
@@ -237,6 +265,11 @@ struct mm_heap_s
 
   size_t mm_curused;
 
+  /* The number of allocated (including the guard nodes) and free chunks */
+
+  size_t mm_nalloc;
+  size_t mm_nfree;
+
   /* The first and last allocated nodes of each region */
 
   FAR struct mm_allocnode_s *mm_heapstart[CONFIG_MM_REGIONS];
@@ -271,6 +304,15 @@ struct mm_heap_s
 #if defined(CONFIG_FS_PROCFS) && !defined(CONFIG_FS_PROCFS_EXCLUDE_MEMINFO)
   struct procfs_meminfo_entry_s mm_procfs;
 #endif
+
+  /* Per-pid usage, hashed by pid.  If it ever overflows, per-pid queries
+   * fall back to walking the heap.
+   */
+
+#ifdef MM_HEAP_PIDSTATS
+  bool mm_pidstat_overflow;
+  struct mm_pidstat_s mm_pidstat[CONFIG_MM_HEAP_PIDSTATS];
+#endif
 };
 
 /* This describes the callback for mm_foreach */
@@ -301,6 +343,25 @@ void mm_foreach(FAR struct mm_heap_s *heap, mm_node_handler_t handler,
 
 void mm_delayfree(FAR struct mm_heap_s *heap, FAR void *mem, bool delay);
 
+/* Functions contained in mm_mallinfo.c *************************************/
+
+#ifdef MM_HEAP_PIDSTATS
+void mm_pidstat_update(FAR struct mm_heap_s *heap, pid_t pid,
+                       ssize_t size, int count);
+#else
+#  define mm_pidstat_update(heap, pid, size, count)
+#endif
+
+/* Functions contained in mm_heapprof.c *************************************/
+
+#ifdef MM_HEAPPROF
+void mm_heapprof_alloc(FAR struct mm_allocnode_s *node);
+void mm_heapprof_free(FAR struct mm_allocnode_s *node);
+#else
+#  define mm_heapprof_alloc(node)
+#  define mm_heapprof_free(node)
+#endif
+
 /****************************************************************************
  * Inline Functions
  ****************************************************************************/
@@ -351,6 +412,25 @@ static inline_function void mm_addfreechunk(FAR struct mm_heap_s *heap,
 
       next->blink = node;
     }
+
+  heap->mm_nfree++;
+}
+
+static inline_function void mm_delfreechunk(FAR struct mm_heap_s *heap,
+                                            FAR struct mm_freenode_s *node)
+{
+  /* Remove the node.  There must be a predecessor, but there may not be a
+   * successor node.
+   */
+
+  DEBUGASSERT(node->blink);
+  node->blink->flink = node->flink;
+  if (node->flink)
+    {
+      node->flink->blink = node->blink;
+    }
+
+  heap->mm_nfree--;
 }
 
 #endif /* __MM_MM_HEAP_MM_H */
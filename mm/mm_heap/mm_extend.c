@@ -105,12 +105,29 @@ void mm_extend(FAR struct mm_heap_s *heap, FAR void *mem, size_t size,
   newnode       = (FAR struct mm_allocnode_s *)
                   (blockend - MM_SIZEOF_ALLOCNODE);
   newnode->size = MM_SIZEOF_ALLOCNODE | MM_ALLOC_BIT;
+  MM_ADD_BACKTRACE(heap, newnode);
 
   heap->mm_heapend[region] = newnode;
 
-  /* Finally, increase the total heap size accordingly */
+  /* Finally, increase the total heap size accordingly.  Until it is freed
+   * below, the old terminal node is an allocated chunk of the block size
+   * and the new terminal node is one more allocated chunk.
+   */
 
   heap->mm_heapsize += size;
+  heap->mm_curused  += size;
+  heap->mm_nalloc++;
+  mm_pidstat_update(heap, oldnode->pid, size - MM_SIZEOF_ALLOCNODE, 0);
+  mm_pidstat_update(heap, _SCHED_GETTID(), MM_SIZEOF_ALLOCNODE, 1);
+
+#ifdef MM_HEAPPROF
+  /* Terminal nodes are not profiled, don't let the profiler match the old
+   * one against an allocation site when it is freed.
+   */
+
+  oldnode->backtrace[0] = NULL;
+#endif
+
   mm_unlock(heap);
 
   /* Finally "free" the new block of memory where the old terminal node was
@@ -0,0 +1,870 @@
+/****************************************************************************
+ * mm/mm_heap/mm_heapprof.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/param.h>
+#include <sys/stat.h>
+#include <inttypes.h>
+#include <stdlib.h>
+#include <fcntl.h>
+#include <string.h>
+#include <assert.h>
+#include <debug.h>
+#include <errno.h>
+#include <sched.h>
+
+#include <nuttx/allsyms.h>
+#include <nuttx/kmalloc.h>
+#include <nuttx/spinlock.h>
+#include <nuttx/symtab.h>
+#include <nuttx/fs/fs.h>
+#include <nuttx/fs/procfs.h>
+
+#include "mm_heap/mm.h"
+
+#ifdef MM_HEAPPROF
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define HEAPPROF_NSITES    CONFIG_MM_HEAPPROF_NSITES
+
+/* An allocation whose call stack does not hash into one of the next
+ * HEAPPROF_MAXPROBE slots is counted as dropped, so that a full table does
+ * not slow down every malloc().
+ */
+
+#define HEAPPROF_MAXPROBE  8
+
+/* Number of sites reported by default */
+
+#define HEAPPROF_NREPORT   32
+
+/* Determines the size of an intermediate buffer that must be large enough
+ * to handle the longest line generated by this logic.
+ */
+
+#define HEAPPROF_LINELEN   96
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* One allocation call stack and what the sampled allocations made from it
+ * still hold.
+ */
+
+struct heapprof_site_s
+{
+  uint32_t hash;                          /* Hash of the frames */
+  uint16_t depth;                         /* Number of frames, 0 = free */
+  uint32_t count;                         /* Chunks still allocated */
+  uint32_t nalloc;                        /* Total allocations */
+  uint32_t nfree;                         /* Total frees */
+  uint32_t markcount;                     /* count when marked */
+  size_t   size;                          /* Bytes still allocated */
+  size_t   marksize;                      /* size when marked */
+  FAR void *stack[CONFIG_MM_BACKTRACE];   /* Frames, innermost first */
+};
+
+struct heapprof_s
+{
+  spinlock_t    lock;                     /* Protects everything below */
+  bool          running;                  /* Allocations are sampled */
+  bool          marked;                   /* A mark was taken */
+  unsigned int  period;                   /* Sample every period'th */
+  unsigned long seqstart;                 /* First seqno of this session */
+  uint32_t      nsamples;                 /* Sampled allocations */
+  uint32_t      ndropped;                 /* Lost to a full table */
+  uint32_t      nostack;                  /* No backtrace available */
+  struct heapprof_site_s sites[HEAPPROF_NSITES];
+};
+
+#if !defined(CONFIG_DISABLE_MOUNTPOINT) && defined(CONFIG_FS_PROCFS)
+
+/* Report ordering, selected with "sort <key>" */
+
+enum heapprof_sort_e
+{
+  HEAPPROF_SORT_SIZE = 0,                 /* Bytes still allocated */
+  HEAPPROF_SORT_NALLOC,                   /* Allocation churn */
+  HEAPPROF_SORT_DELTA                     /* Bytes gained since the mark */
+};
+
+/* This structure describes one open "file" */
+
+struct heapprof_file_s
+{
+  struct procfs_file_s base;              /* Base open file structure */
+  FAR struct heapprof_site_s *snap;       /* Sorted copy of the sites */
+  size_t   nsnap;                         /* Number of entries in snap[] */
+  FAR char *buffer;                       /* User provided buffer */
+  size_t   remaining;                     /* Number of available characters */
+  size_t   ncopied;                       /* Number of characters in buffer */
+  off_t    offset;                        /* Current file offset */
+  char     line[HEAPPROF_LINELEN];        /* Buffer for formatted output */
+};
+#endif
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+#if !defined(CONFIG_DISABLE_MOUNTPOINT) && defined(CONFIG_FS_PROCFS)
+
+/* File system methods */
+
+static int     heapprof_open(FAR struct file *filep,
+                             FAR const char *relpath,
+                             int oflags, mode_t mode);
+static int     heapprof_close(FAR struct file *filep);
+static ssize_t heapprof_read(FAR struct file *filep, FAR char *buffer,
+                             size_t buflen);
+static ssize_t heapprof_write(FAR struct file *filep,
+                              FAR const char *buffer, size_t buflen);
+static int     heapprof_dup(FAR const struct file *oldp,
+                            FAR struct file *newp);
+static int     heapprof_stat(FAR const char *relpath, FAR struct stat *buf);
+#endif
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static struct heapprof_s g_heapprof =
+{
+  .period = CONFIG_MM_HEAPPROF_PERIOD,
+};
+
+#if !defined(CONFIG_DISABLE_MOUNTPOINT) && defined(CONFIG_FS_PROCFS)
+static enum heapprof_sort_e g_heapprof_sort = HEAPPROF_SORT_SIZE;
+static size_t g_heapprof_nreport = HEAPPROF_NREPORT;
+#endif
+
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+#if !defined(CONFIG_DISABLE_MOUNTPOINT) && defined(CONFIG_FS_PROCFS)
+
+/* See fs_mount.c -- this structure is explicitly extern'ed there.
+ * We use the old-fashioned kind of initializers so that this will compile
+ * with any compiler.
+ */
+
+const struct procfs_operations g_heapprof_operations =
+{
+  heapprof_open,        /* open */
+  heapprof_close,       /* close */
+  heapprof_read,        /* read */
+  heapprof_write,       /* write */
+  NULL,                 /* poll */
+
+  heapprof_dup,         /* dup */
+
+  NULL,                 /* opendir */
+  NULL,                 /* closedir */
+  NULL,                 /* readdir */
+  NULL,                 /* rewinddir */
+
+  heapprof_stat         /* stat */
+};
+#endif
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: heapprof_hash
+ *
+ * Description:
+ *   FNV-1a hash of the return addresses of one call stack.
+ *
+ ****************************************************************************/
+
+static uint32_t heapprof_hash(FAR void * const *stack, int depth)
+{
+  uint32_t hash = 2166136261u;
+  uintptr_t value;
+  size_t n;
+  int i;
+
+  for (i = 0; i < depth; i++)
+    {
+      value = (uintptr_t)stack[i];
+      for (n = 0; n < sizeof(uintptr_t); n++)
+        {
+          hash ^= (uint8_t)(value >> (n * 8));
+          hash *= 16777619u;
+        }
+    }
+
+  return hash;
+}
+
+/****************************************************************************
+ * Name: heapprof_depth
+ ****************************************************************************/
+
+static int heapprof_depth(FAR struct mm_allocnode_s *node)
+{
+  int depth;
+
+  for (depth = 0; depth < CONFIG_MM_BACKTRACE; depth++)
+    {
+      if (node->backtrace[depth] == NULL)
+        {
+          break;
+        }
+    }
+
+  return depth;
+}
+
+/****************************************************************************
+ * Name: heapprof_sampled
+ *
+ * Description:
+ *   Whether the chunk is one of the sampled allocations of the current
+ *   session.  This is derived from the sequence number of the chunk, so
+ *   that free() reaches the same decision as malloc() did without any
+ *   extra state in the chunk header.
+ *
+ ****************************************************************************/
+
+static bool heapprof_sampled(FAR struct mm_allocnode_s *node)
+{
+  unsigned long seq = node->seqno - g_heapprof.seqstart;
+
+  return g_heapprof.running && (long)seq >= 0 &&
+         seq % g_heapprof.period == 0;
+}
+
+/****************************************************************************
+ * Name: heapprof_find
+ *
+ * Description:
+ *   Look up the site of a call stack, optionally claiming a free slot for
+ *   it.  Must be called with g_heapprof.lock held.
+ *
+ ****************************************************************************/
+
+static FAR struct heapprof_site_s *
+heapprof_find(FAR struct mm_allocnode_s *node, int depth, bool create)
+{
+  FAR struct heapprof_site_s *site;
+  uint32_t hash = heapprof_hash(node->backtrace, depth);
+  int probe;
+
+  for (probe = 0; probe < HEAPPROF_MAXPROBE; probe++)
+    {
+      site = &g_heapprof.sites[(hash + probe) % HEAPPROF_NSITES];
+      if (site->depth == 0)
+        {
+          if (!create)
+            {
+              break;
+            }
+
+          site->hash  = hash;
+          site->depth = depth;
+          memcpy(site->stack, node->backtrace, depth * sizeof(FAR void *));
+          return site;
+        }
+      else if (site->hash == hash && site->depth == depth &&
+               memcmp(site->stack, node->backtrace,
+                      depth * sizeof(FAR void *)) == 0)
+        {
+          return site;
+        }
+    }
+
+  return NULL;
+}
+
+#if !defined(CONFIG_DISABLE_MOUNTPOINT) && defined(CONFIG_FS_PROCFS)
+
+/****************************************************************************
+ * Name: heapprof_reset
+ *
+ * Description:
+ *   Start a new session.  Chunks sampled by a previous session are older
+ *   than seqstart and are ignored when they are freed.
+ *
+ ****************************************************************************/
+
+static void heapprof_reset(bool running, unsigned int period)
+{
+  irqstate_t flags;
+
+  flags = spin_lock_irqsave(&g_heapprof.lock);
+  g_heapprof.running  = running;
+  g_heapprof.marked   = false;
+  g_heapprof.period   = period;
+  g_heapprof.seqstart = g_mm_seqno;
+  g_heapprof.nsamples = 0;
+  g_heapprof.ndropped = 0;
+  g_heapprof.nostack  = 0;
+  memset(g_heapprof.sites, 0, sizeof(g_heapprof.sites));
+  spin_unlock_irqrestore(&g_heapprof.lock, flags);
+}
+
+/****************************************************************************
+ * Name: heapprof_mark
+ *
+ * Description:
+ *   Remember what every site holds now, later reports show the difference.
+ *
+ ****************************************************************************/
+
+static void heapprof_mark(void)
+{
+  irqstate_t flags;
+  int i;
+
+  flags = spin_lock_irqsave(&g_heapprof.lock);
+  for (i = 0; i < HEAPPROF_NSITES; i++)
+    {
+      g_heapprof.sites[i].markcount = g_heapprof.sites[i].count;
+      g_heapprof.sites[i].marksize  = g_heapprof.sites[i].size;
+    }
+
+  g_heapprof.marked = true;
+  spin_unlock_irqrestore(&g_heapprof.lock, flags);
+}
+
+/****************************************************************************
+ * Name: heapprof_compare
+ *
+ * Description:
+ *   qsort() comparison, largest first by the selected key.
+ *
+ ****************************************************************************/
+
+static int heapprof_compare(FAR const void *a, FAR const void *b)
+{
+  FAR const struct heapprof_site_s *sa = a;
+  FAR const struct heapprof_site_s *sb = b;
+  ssize_t ka;
+  ssize_t kb;
+
+  switch (g_heapprof_sort)
+    {
+      case HEAPPROF_SORT_NALLOC:
+        ka = sa->nalloc;
+        kb = sb->nalloc;
+        break;
+
+      case HEAPPROF_SORT_DELTA:
+        ka = (ssize_t)(sa->size - sa->marksize);
+        kb = (ssize_t)(sb->size - sb->marksize);
+        break;
+
+      default:
+        ka = sa->size;
+        kb = sb->size;
+        break;
+    }
+
+  return ka > kb ? -1 : ka < kb ? 1 : 0;
+}
+
+/****************************************************************************
+ * Name: heapprof_snapshot
+ ****************************************************************************/
+
+static int heapprof_snapshot(FAR struct heapprof_file_s *priv)
+{
+  FAR struct heapprof_site_s *snap;
+  irqstate_t flags;
+  size_t nsnap = 0;
+  int i;
+
+  snap = kmm_malloc(sizeof(g_heapprof.sites));
+  if (snap == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  flags = spin_lock_irqsave(&g_heapprof.lock);
+  for (i = 0; i < HEAPPROF_NSITES; i++)
+    {
+      if (g_heapprof.sites[i].depth != 0)
+        {
+          snap[nsnap++] = g_heapprof.sites[i];
+        }
+    }
+
+  spin_unlock_irqrestore(&g_heapprof.lock, flags);
+
+  qsort(snap, nsnap, sizeof(struct heapprof_site_s), heapprof_compare);
+
+  priv->snap  = snap;
+  priv->nsnap = MIN(nsnap, g_heapprof_nreport);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: heapprof_copy
+ ****************************************************************************/
+
+static bool heapprof_copy(FAR struct heapprof_file_s *priv, size_t len)
+{
+  size_t copysize;
+
+  copysize = procfs_memcpy(priv->line, len, priv->buffer,
+                           priv->remaining, &priv->offset);
+
+  priv->ncopied   += copysize;
+  priv->buffer    += copysize;
+  priv->remaining -= copysize;
+
+  return priv->remaining > 0;
+}
+
+/****************************************************************************
+ * Name: heapprof_frame
+ *
+ * Description:
+ *   Format one frame, by symbol name when the symbol table is available.
+ *
+ ****************************************************************************/
+
+static size_t heapprof_frame(FAR struct heapprof_file_s *priv,
+                             FAR void *addr)
+{
+#ifdef CONFIG_ALLSYMS
+  FAR const struct symtab_s *symbol;
+  size_t symbolsize;
+
+  symbol = allsyms_findbyvalue(addr, &symbolsize);
+  if (symbol != NULL)
+    {
+      return procfs_snprintf(priv->line, HEAPPROF_LINELEN,
+                             "    %s+%#zx\n", symbol->sym_name,
+                             (size_t)((uintptr_t)addr -
+                                      (uintptr_t)symbol->sym_value));
+    }
+#endif
+
+  return procfs_snprintf(priv->line, HEAPPROF_LINELEN, "    %p\n", addr);
+}
+
+/****************************************************************************
+ * Name: heapprof_open
+ ****************************************************************************/
+
+static int heapprof_open(FAR struct file *filep, FAR const char *relpath,
+                         int oflags, mode_t mode)
+{
+  FAR struct heapprof_file_s *priv;
+  int ret;
+
+  finfo("Open '%s'\n", relpath);
+
+  /* Allocate a container to hold the file attributes */
+
+  priv = kmm_zalloc(sizeof(struct heapprof_file_s));
+  if (priv == NULL)
+    {
+      ferr("ERROR: Failed to allocate file attributes\n");
+      return -ENOMEM;
+    }
+
+  if ((oflags & O_RDONLY) != 0)
+    {
+      ret = heapprof_snapshot(priv);
+      if (ret < 0)
+        {
+          kmm_free(priv);
+          return ret;
+        }
+    }
+
+  /* Save the attributes as the open-specific state in filep->f_priv */
+
+  filep->f_priv = priv;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: heapprof_close
+ ****************************************************************************/
+
+static int heapprof_close(FAR struct file *filep)
+{
+  FAR struct heapprof_file_s *priv;
+
+  /* Recover our private data from the struct file instance */
+
+  priv = filep->f_priv;
+  DEBUGASSERT(priv);
+
+  /* Release the snapshot and the file attributes structure */
+
+  kmm_free(priv->snap);
+  kmm_free(priv);
+  filep->f_priv = NULL;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: heapprof_read
+ *
+ * Description:
+ *   Print the top sites, each as one line of counters followed by its call
+ *   stack, innermost frame first:
+ *
+ *     SIZE COUNT NALLOC NFREE DSIZE DCOUNT
+ *
+ *   DSIZE and DCOUNT are the change since the last "mark", or since the
+ *   start of the session if no mark was taken.  With a sampling period
+ *   above one, all counters only cover the sampled allocations.
+ *
+ ****************************************************************************/
+
+static ssize_t heapprof_read(FAR struct file *filep, FAR char *buffer,
+                             size_t buflen)
+{
+  FAR struct heapprof_file_s *priv;
+  size_t linesize;
+  size_t i;
+  int j;
+
+  finfo("buffer=%p buflen=%d\n", buffer, (int)buflen);
+
+  /* Recover our private data from the struct file instance */
+
+  priv = filep->f_priv;
+  DEBUGASSERT(priv);
+
+  /* Save the file offset and the user buffer information */
+
+  priv->offset    = filep->f_pos;
+  priv->buffer    = buffer;
+  priv->remaining = buflen;
+  priv->ncopied   = 0;
+
+  linesize = procfs_snprintf(priv->line, HEAPPROF_LINELEN,
+                             "# %s period %u samples %" PRIu32
+                             " dropped %" PRIu32 " nostack %" PRIu32
+                             "%s\n",
+                             g_heapprof.running ? "running" : "stopped",
+                             g_heapprof.period, g_heapprof.nsamples,
+                             g_heapprof.ndropped, g_heapprof.nostack,
+                             g_heapprof.marked ? " marked" : "");
+  if (!heapprof_copy(priv, linesize))
+    {
+      goto out;
+    }
+
+  linesize = procfs_snprintf(priv->line, HEAPPROF_LINELEN,
+                             "%10s %8s %8s %8s %11s %8s\n", "SIZE",
+                             "COUNT", "NALLOC", "NFREE", "DSIZE",
+                             "DCOUNT");
+  if (!heapprof_copy(priv, linesize))
+    {
+      goto out;
+    }
+
+  for (i = 0; i < priv->nsnap; i++)
+    {
+      FAR struct heapprof_site_s *site = &priv->snap[i];
+
+      linesize = procfs_snprintf(priv->line, HEAPPROF_LINELEN,
+                                 "%10zu %8" PRIu32 " %8" PRIu32
+                                 " %8" PRIu32 " %+11zd %+8" PRId32 "\n",
+                                 site->size, site->count, site->nalloc,
+                                 site->nfree,
+                                 (ssize_t)(site->size - site->marksize),
+                                 (int32_t)(site->count - site->markcount));
+      if (!heapprof_copy(priv, linesize))
+        {
+          goto out;
+        }
+
+      for (j = 0; j < site->depth; j++)
+        {
+          linesize = heapprof_frame(priv, site->stack[j]);
+          if (!heapprof_copy(priv, linesize))
+            {
+              goto out;
+            }
+        }
+    }
+
+out:
+
+  /* Update the file position */
+
+  filep->f_pos += priv->ncopied;
+  return priv->ncopied;
+}
+
+/****************************************************************************
+ * Name: heapprof_write
+ *
+ * Description:
+ *   Control the profiler:
+ *
+ *     start [period] - Begin a new session, sampling every period'th
+ *                      allocation
+ *     stop           - Stop sampling, keep the collected sites
+ *     reset          - Discard the collected sites and counters
+ *     mark           - Report the change from now on
+ *     sort <key>     - Order the report by "size", "nalloc" or "delta"
+ *     top <n>        - Number of sites in the report
+ *
+ ****************************************************************************/
+
+static ssize_t heapprof_write(FAR struct file *filep,
+                              FAR const char *buffer, size_t buflen)
+{
+  char cmd[32];
+  size_t len;
+
+  len = MIN(buflen, sizeof(cmd) - 1);
+  memcpy(cmd, buffer, len);
+  cmd[len] = '\0';
+
+  if (strncmp(cmd, "start", 5) == 0)
+    {
+      unsigned long period = strtoul(cmd + 5, NULL, 0);
+
+      heapprof_reset(true, period > 0 ? period : g_heapprof.period);
+    }
+  else if (strncmp(cmd, "stop", 4) == 0)
+    {
+      g_heapprof.running = false;
+    }
+  else if (strncmp(cmd, "reset", 5) == 0)
+    {
+      heapprof_reset(g_heapprof.running, g_heapprof.period);
+    }
+  else if (strncmp(cmd, "mark", 4) == 0)
+    {
+      heapprof_mark();
+    }
+  else if (strncmp(cmd, "sort size", 9) == 0)
+    {
+      g_heapprof_sort = HEAPPROF_SORT_SIZE;
+    }
+  else if (strncmp(cmd, "sort nalloc", 11) == 0)
+    {
+      g_heapprof_sort = HEAPPROF_SORT_NALLOC;
+    }
+  else if (strncmp(cmd, "sort delta", 10) == 0)
+    {
+      g_heapprof_sort = HEAPPROF_SORT_DELTA;
+    }
+  else if (strncmp(cmd, "top", 3) == 0)
+    {
+      unsigned long nreport = strtoul(cmd + 3, NULL, 0);
+
+      if (nreport == 0)
+        {
+          return -EINVAL;
+        }
+
+      g_heapprof_nreport = nreport;
+    }
+  else
+    {
+      return -EINVAL;
+    }
+
+  return buflen;
+}
+
+/****************************************************************************
+ * Name: heapprof_dup
+ *
+ * Description:
+ *   Duplicate open file data in the new file structure.
+ *
+ ****************************************************************************/
+
+static int heapprof_dup(FAR const struct file *oldp, FAR struct file *newp)
+{
+  FAR struct heapprof_file_s *oldpriv;
+  FAR struct heapprof_file_s *newpriv;
+
+  finfo("Dup %p->%p\n", oldp, newp);
+
+  /* Recover our private data from the old struct file instance */
+
+  oldpriv = oldp->f_priv;
+  DEBUGASSERT(oldpriv);
+
+  /* Allocate a new container to hold the task and attribute selection */
+
+  newpriv = kmm_malloc(sizeof(struct heapprof_file_s));
+  if (newpriv == NULL)
+    {
+      ferr("ERROR: Failed to allocate file attributes\n");
+      return -ENOMEM;
+    }
+
+  /* The copy the file attributes from the old attributes to the new */
+
+  memcpy(newpriv, oldpriv, sizeof(struct heapprof_file_s));
+
+  if (oldpriv->snap != NULL)
+    {
+      newpriv->snap = kmm_malloc(sizeof(g_heapprof.sites));
+      if (newpriv->snap == NULL)
+        {
+          kmm_free(newpriv);
+          return -ENOMEM;
+        }
+
+      memcpy(newpriv->snap, oldpriv->snap,
+             oldpriv->nsnap * sizeof(struct heapprof_site_s));
+    }
+
+  /* Save the new attributes in the new file structure */
+
+  newp->f_priv = newpriv;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: heapprof_stat
+ *
+ * Description: Return information about a file or directory
+ *
+ ****************************************************************************/
+
+static int heapprof_stat(FAR const char *relpath, FAR struct stat *buf)
+{
+  memset(buf, 0, sizeof(struct stat));
+  buf->st_mode = S_IFREG | S_IROTH | S_IRGRP | S_IRUSR | S_IWUSR;
+  return OK;
+}
+#endif /* !CONFIG_DISABLE_MOUNTPOINT && CONFIG_FS_PROCFS */
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: mm_heapprof_alloc
+ *
+ * Description:
+ *   Account a chunk just handed out by the heap, after MM_ADD_BACKTRACE()
+ *   gave it a sequence number.  If the chunk is sampled and no backtrace
+ *   was recorded for memdump, one is taken here.
+ *
+ ****************************************************************************/
+
+void mm_heapprof_alloc(FAR struct mm_allocnode_s *node)
+{
+  FAR struct heapprof_site_s *site;
+  irqstate_t flags;
+  int depth;
+
+  if (!heapprof_sampled(node))
+    {
+      return;
+    }
+
+  if (node->backtrace[0] == NULL)
+    {
+      depth = sched_backtrace(node->pid, node->backtrace,
+                              CONFIG_MM_BACKTRACE,
+                              CONFIG_MM_BACKTRACE_SKIP + 1);
+      if (depth < CONFIG_MM_BACKTRACE)
+        {
+          node->backtrace[MAX(depth, 0)] = NULL;
+        }
+    }
+
+  depth = heapprof_depth(node);
+  flags = spin_lock_irqsave(&g_heapprof.lock);
+  g_heapprof.nsamples++;
+
+  if (depth == 0)
+    {
+      g_heapprof.nostack++;
+    }
+  else if ((site = heapprof_find(node, depth, true)) == NULL)
+    {
+      g_heapprof.ndropped++;
+    }
+  else
+    {
+      site->count++;
+      site->nalloc++;
+      site->size += MM_SIZEOF_NODE(node);
+    }
+
+  spin_unlock_irqrestore(&g_heapprof.lock, flags);
+}
+
+/****************************************************************************
+ * Name: mm_heapprof_free
+ *
+ * Description:
+ *   Account a chunk about to be released or resized, while its header
+ *   still describes the allocation.  A sampled chunk whose site was
+ *   dropped at allocation time cannot be found here either, so the
+ *   counters of the sites stay exact.
+ *
+ ****************************************************************************/
+
+void mm_heapprof_free(FAR struct mm_allocnode_s *node)
+{
+  FAR struct heapprof_site_s *site;
+  irqstate_t flags;
+  int depth;
+
+  if (!heapprof_sampled(node))
+    {
+      return;
+    }
+
+  depth = heapprof_depth(node);
+  if (depth == 0)
+    {
+      return;
+    }
+
+  flags = spin_lock_irqsave(&g_heapprof.lock);
+  site  = heapprof_find(node, depth, false);
+  if (site != NULL && site->count > 0)
+    {
+      site->count--;
+      site->nfree++;
+      site->size -= MIN(site->size, MM_SIZEOF_NODE(node));
+    }
+
+  spin_unlock_irqrestore(&g_heapprof.lock, flags);
+}
+
+#endif /* MM_HEAPPROF */
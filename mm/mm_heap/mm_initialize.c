@@ -69,7 +69,18 @@ static FAR void *mempool_memalign(FAR void *arg, size_t alignment,
     {
       node = (FAR struct mm_allocnode_s *)
       ((uintptr_t)ret - MM_SIZEOF_ALLOCNODE);
+
+#ifdef MM_HEAP_PIDSTATS
+      DEBUGVERIFY(mm_lock(arg));
+      mm_pidstat_update(arg, node->pid, -(ssize_t)MM_SIZEOF_NODE(node), -1);
+      mm_pidstat_update(arg, PID_MM_MEMPOOL, MM_SIZEOF_NODE(node), 1);
+#endif
+
       node->pid = PID_MM_MEMPOOL;
+
+#ifdef MM_HEAP_PIDSTATS
+      mm_unlock(arg);
+#endif
     }
 
   return ret;
@@ -206,6 +217,8 @@ void mm_addregion(FAR struct mm_heap_s *heap, FAR void *heapstart,
 
   mm_addfreechunk(heap, node);
   heap->mm_curused += 2 * MM_SIZEOF_ALLOCNODE;
+  heap->mm_nalloc  += 2;
+  mm_pidstat_update(heap, _SCHED_GETTID(), 2 * MM_SIZEOF_ALLOCNODE, 2);
   sched_note_heap(NOTE_HEAP_ADD, heap, heapstart, heapsize,
                   heap->mm_curused);
   mm_unlock(heap);
@@ -47,44 +47,90 @@ struct mm_mallinfo_handler_s
  * Private Functions
  ****************************************************************************/
 
-static void mallinfo_handler(FAR struct mm_allocnode_s *node, FAR void *arg)
+#ifdef MM_HEAP_PIDSTATS
+static inline size_t mm_pidstat_hash(pid_t pid)
 {
-  FAR struct mallinfo *info = arg;
-  size_t nodesize = MM_SIZEOF_NODE(node);
+  return (size_t)(unsigned int)pid % CONFIG_MM_HEAP_PIDSTATS;
+}
 
-  minfo("node=%p size=%zu preceding=%u (%c)\n",
-        node, nodesize, (unsigned int)node->preceding,
-        MM_NODE_IS_ALLOC(node) ? 'A' : 'F');
+/****************************************************************************
+ * Name: mm_pidstat_find
+ *
+ * Description:
+ *   Return the slot holding pid, or the empty slot where it would be
+ *   inserted, or NULL if pid is not present and the table is full.
+ *
+ ****************************************************************************/
 
-  /* Check if the node corresponds to an allocated memory chunk */
+static FAR struct mm_pidstat_s *mm_pidstat_find(FAR struct mm_heap_s *heap,
+                                                pid_t pid)
+{
+  size_t ndx = mm_pidstat_hash(pid);
+  size_t i;
 
-  if (MM_NODE_IS_ALLOC(node))
+  for (i = 0; i < CONFIG_MM_HEAP_PIDSTATS; i++)
     {
-      DEBUGASSERT(nodesize >= MM_SIZEOF_ALLOCNODE);
-      info->aordblks++;
-      info->uordblks += nodesize;
+      FAR struct mm_pidstat_s *stat = &heap->mm_pidstat[ndx];
+
+      if (stat->aordblks == 0 || stat->pid == pid)
+        {
+          return stat;
+        }
+
+      if (++ndx >= CONFIG_MM_HEAP_PIDSTATS)
+        {
+          ndx = 0;
+        }
     }
-  else
+
+  return NULL;
+}
+
+/****************************************************************************
+ * Name: mm_pidstat_remove
+ *
+ * Description:
+ *   Empty a slot, moving back the entries that follow it so that linear
+ *   probing still finds them.
+ *
+ ****************************************************************************/
+
+static void mm_pidstat_remove(FAR struct mm_heap_s *heap, size_t hole)
+{
+  FAR struct mm_pidstat_s *table = heap->mm_pidstat;
+  size_t next = hole;
+  size_t home;
+  size_t i;
+
+  for (i = 1; i < CONFIG_MM_HEAP_PIDSTATS; i++)
     {
-      FAR struct mm_freenode_s *fnode = (FAR void *)node;
-
-      DEBUGASSERT(nodesize >= MM_MIN_CHUNK);
-      DEBUGASSERT(fnode->blink->flink == fnode);
-      DEBUGASSERT(MM_SIZEOF_NODE(fnode->blink) <= nodesize);
-      DEBUGASSERT(fnode->flink == NULL ||
-                  fnode->flink->blink == fnode);
-      DEBUGASSERT(fnode->flink == NULL ||
-                  MM_SIZEOF_NODE(fnode->flink) == 0 ||
-                  MM_SIZEOF_NODE(fnode->flink) >= nodesize);
-
-      info->ordblks++;
-      info->fordblks += nodesize;
-      if (node->size > (size_t)info->mxordblk)
+      if (++next >= CONFIG_MM_HEAP_PIDSTATS)
         {
-          info->mxordblk = nodesize;
+          next = 0;
+        }
+
+      if (table[next].aordblks == 0)
+        {
+          break;
+        }
+
+      /* Move the entry unless its home slot lies cyclically within
+       * (hole, next], in which case it is still reachable.
+       */
+
+      home = mm_pidstat_hash(table[next].pid);
+      if (hole <= next ? (home <= hole || home > next) :
+                         (home <= hole && home > next))
+        {
+          table[hole] = table[next];
+          hole = next;
         }
     }
+
+  table[hole].aordblks = 0;
+  table[hole].uordblks = 0;
 }
+#endif
 
 static void mallinfo_task_handler(FAR struct mm_allocnode_s *node,
                                   FAR void *arg)
@@ -117,12 +163,50 @@ static void mallinfo_task_handler(FAR struct mm_allocnode_s *node,
  * Public Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: mm_pidstat_update
+ *
+ * Description:
+ *   Account size bytes in count chunks (either may be negative) to pid.
+ *   Must be called with the heap lock held.
+ *
+ ****************************************************************************/
+
+#ifdef MM_HEAP_PIDSTATS
+void mm_pidstat_update(FAR struct mm_heap_s *heap, pid_t pid,
+                       ssize_t size, int count)
+{
+  FAR struct mm_pidstat_s *stat = mm_pidstat_find(heap, pid);
+
+  if (stat == NULL || (stat->aordblks == 0 && count <= 0))
+    {
+      /* No room for a new pid, or releasing memory never accounted */
+
+      heap->mm_pidstat_overflow = true;
+      return;
+    }
+
+  stat->pid       = pid;
+  stat->aordblks += count;
+  stat->uordblks += size;
+
+  if (stat->aordblks == 0)
+    {
+      mm_pidstat_remove(heap, stat - heap->mm_pidstat);
+    }
+}
+#endif
+
 /****************************************************************************
  * Name: mm_mallinfo
  *
  * Description:
  *   mallinfo returns a copy of updated current heap information.
  *
+ *   The counters are maintained by malloc and free, so this does not walk
+ *   the heap.  Only the size bins of the free list are visited to find the
+ *   largest free chunk.
+ *
  ****************************************************************************/
 
 struct mallinfo mm_mallinfo(FAR struct mm_heap_s *heap)
@@ -133,11 +217,20 @@ struct mallinfo mm_mallinfo(FAR struct mm_heap_s *heap)
 #endif
 
   memset(&info, 0, sizeof(info));
-  mm_foreach(heap, mallinfo_handler, &info);
-  info.arena = heap->mm_heapsize;
-  info.arena += sizeof(struct mm_heap_s);
-  info.uordblks += sizeof(struct mm_heap_s);
-  info.usmblks = heap->mm_maxused + sizeof(struct mm_heap_s);
+  if (mm_lock(heap) < 0)
+    {
+      return info;
+    }
+
+  info.arena    = heap->mm_heapsize + sizeof(struct mm_heap_s);
+  info.ordblks  = heap->mm_nfree;
+  info.aordblks = heap->mm_nalloc;
+  info.mxordblk = mm_heapfree_largest(heap);
+  info.uordblks = heap->mm_curused;
+  info.usmblks  = heap->mm_maxused + sizeof(struct mm_heap_s);
+  mm_unlock(heap);
+
+  info.fordblks = info.arena - info.uordblks;
 
 #ifdef CONFIG_MM_HEAP_MEMPOOL
   poolinfo = mempool_multiple_mallinfo(heap->mm_mpool);
@@ -173,6 +266,30 @@ struct mallinfo_task mm_mallinfo_task(FAR struct mm_heap_s *heap,
   info = mempool_multiple_info_task(heap->mm_mpool, task);
 #endif
 
+#ifdef MM_HEAP_PIDSTATS
+  /* Usage of one pid over its whole lifetime is kept up to date */
+
+  if (task->pid >= PID_MM_MEMPOOL && task->seqmin == 0 &&
+      task->seqmax == ULONG_MAX && mm_lock(heap) >= 0)
+    {
+      if (!heap->mm_pidstat_overflow)
+        {
+          FAR struct mm_pidstat_s *stat = mm_pidstat_find(heap, task->pid);
+
+          if (stat != NULL && stat->aordblks != 0)
+            {
+              info.aordblks += stat->aordblks;
+              info.uordblks += stat->uordblks;
+            }
+
+          mm_unlock(heap);
+          return info;
+        }
+
+      mm_unlock(heap);
+    }
+#endif
+
   handle.task = task;
   handle.info = &info;
   mm_foreach(heap, mallinfo_task_handler, &handle);
@@ -204,13 +321,30 @@ size_t mm_heapfree(FAR struct mm_heap_s *heap)
 size_t mm_heapfree_largest(FAR struct mm_heap_s *heap)
 {
   FAR struct mm_freenode_s *node;
-  for (node = heap->mm_nodelist[MM_NNODES - 1].blink; node;
-       node = node->blink)
+  int ndx;
+
+  /* The last bin holds every chunk of MM_MAX_CHUNK and above, sorted by
+   * size, and ends the free list.
+   */
+
+  for (node = heap->mm_nodelist[MM_NNODES - 1].flink; node && node->flink;
+       node = node->flink);
+
+  if (node != NULL)
+    {
+      return MM_SIZEOF_NODE(node);
+    }
+
+  /* Any other bin ends right before the head of the next one, so its
+   * largest chunk is found without visiting the others.
+   */
+
+  for (ndx = MM_NNODES - 1; ndx > 0; ndx--)
     {
-      size_t nodesize = MM_SIZEOF_NODE(node);
-      if (nodesize != 0)
+      node = heap->mm_nodelist[ndx].blink;
+      if (MM_SIZEOF_NODE(node) != 0)
         {
-          return nodesize;
+          return MM_SIZEOF_NODE(node);
         }
     }
 
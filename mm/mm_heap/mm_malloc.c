@@ -244,16 +244,9 @@ FAR void *mm_malloc(FAR struct mm_heap_s *heap, size_t size)
       FAR struct mm_freenode_s *next;
       size_t remaining;
 
-      /* Remove the node.  There must be a predecessor, but there may not be
-       * a successor node.
-       */
+      /* Remove the node from the free list */
 
-      DEBUGASSERT(node->blink);
-      node->blink->flink = node->flink;
-      if (node->flink)
-        {
-          node->flink->blink = node->blink;
-        }
+      mm_delfreechunk(heap, node);
 
       /* Get a pointer to the next node in physical memory */
 
@@ -314,6 +307,9 @@ FAR void *mm_malloc(FAR struct mm_heap_s *heap, size_t size)
           heap->mm_maxused = heap->mm_curused;
         }
 
+      heap->mm_nalloc++;
+      mm_pidstat_update(heap, _SCHED_GETTID(), nodesize, 1);
+
       /* Handle the case of an exact size match */
 
       node->size |= MM_ALLOC_BIT;
@@ -333,6 +329,7 @@ FAR void *mm_malloc(FAR struct mm_heap_s *heap, size_t size)
   if (ret)
     {
       MM_ADD_BACKTRACE(heap, node);
+      mm_heapprof_alloc((FAR struct mm_allocnode_s *)node);
       ret = kasan_unpoison(ret, nodesize - MM_ALLOCNODE_OVERHEAD);
 #ifdef CONFIG_MM_FILL_ALLOCATIONS
       memset(ret, MM_ALLOC_MAGIC, alignsize - MM_ALLOCNODE_OVERHEAD);
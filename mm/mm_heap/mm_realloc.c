@@ -144,22 +144,36 @@ FAR void *mm_realloc(FAR struct mm_heap_s *heap, FAR void *oldmem,
   oldsize = MM_SIZEOF_NODE(oldnode);
   if (newsize <= oldsize)
     {
+      /* The profiler must see the size the chunk was allocated with */
+
+      mm_heapprof_free(oldnode);
+
       /* Handle the special case where we are not going to change the size
        * of the allocation.
        */
 
       if (newsize < oldsize)
         {
-          heap->mm_curused += newsize - oldsize;
+          /* mm_shrinkchunk() keeps the chunk whole if the tail is too
+           * small to be freed, so account the size it really ended up with
+           */
+
           mm_shrinkchunk(heap, oldnode, newsize);
+          heap->mm_curused -= oldsize - MM_SIZEOF_NODE(oldnode);
           kasan_poison((FAR char *)oldnode + MM_SIZEOF_NODE(oldnode) +
                        sizeof(mmsize_t), oldsize - MM_SIZEOF_NODE(oldnode));
         }
 
+      /* MM_ADD_BACKTRACE() below hands the chunk over to the caller */
+
+      mm_pidstat_update(heap, oldnode->pid, -(ssize_t)oldsize, -1);
+      mm_pidstat_update(heap, _SCHED_GETTID(), MM_SIZEOF_NODE(oldnode), 1);
+
       /* Then return the original address */
 
       mm_unlock(heap);
       MM_ADD_BACKTRACE(heap, oldnode);
+      mm_heapprof_alloc(oldnode);
 
       return oldmem;
     }
@@ -193,6 +207,9 @@ FAR void *mm_realloc(FAR struct mm_heap_s *heap, FAR void *oldmem,
       size_t takeprev;
       size_t takenext;
 
+      mm_pidstat_update(heap, oldnode->pid, -(ssize_t)oldsize, -1);
+      mm_heapprof_free(oldnode);
+
       /* Check if we can extend into the previous chunk and if the
        * previous chunk is smaller than the next chunk.
        */
@@ -252,16 +269,9 @@ FAR void *mm_realloc(FAR struct mm_heap_s *heap, FAR void *oldmem,
         {
           FAR struct mm_allocnode_s *newnode;
 
-          /* Remove the previous node.  There must be a predecessor, but
-           * there may not be a successor node.
-           */
+          /* Remove the previous node from the free list */
 
-          DEBUGASSERT(prev && prev->blink);
-          prev->blink->flink = prev->flink;
-          if (prev->flink)
-            {
-              prev->flink->blink = prev->blink;
-            }
+          mm_delfreechunk(heap, prev);
 
           /* Make sure the new previous node has enough space */
 
@@ -326,16 +336,9 @@ FAR void *mm_realloc(FAR struct mm_heap_s *heap, FAR void *oldmem,
           andbeyond = (FAR struct mm_allocnode_s *)
                       ((FAR char *)next + nextsize);
 
-          /* Remove the next node.  There must be a predecessor, but there
-           * may not be a successor node.
-           */
+          /* Remove the next node from the free list */
 
-          DEBUGASSERT(next->blink);
-          next->blink->flink = next->flink;
-          if (next->flink)
-            {
-              next->flink->blink = next->blink;
-            }
+          mm_delfreechunk(heap, next);
 
           /* Make sure the new next node has enough space */
 
@@ -383,12 +386,16 @@ FAR void *mm_realloc(FAR struct mm_heap_s *heap, FAR void *oldmem,
           heap->mm_maxused = heap->mm_curused;
         }
 
+      mm_pidstat_update(heap, _SCHED_GETTID(), MM_SIZEOF_NODE(oldnode), 1);
+
       sched_note_heap(NOTE_HEAP_FREE, heap, oldmem, oldsize,
                       heap->mm_curused - newsize);
       sched_note_heap(NOTE_HEAP_ALLOC, heap, newmem, newsize,
                       heap->mm_curused);
       mm_unlock(heap);
       MM_ADD_BACKTRACE(heap, (FAR char *)newmem - MM_SIZEOF_ALLOCNODE);
+      mm_heapprof_alloc((FAR struct mm_allocnode_s *)
+                        ((FAR char *)newmem - MM_SIZEOF_ALLOCNODE));
 
       newmem = kasan_unpoison(newmem, MM_SIZEOF_NODE(oldnode) -
                               MM_ALLOCNODE_OVERHEAD);
@@ -163,8 +163,12 @@ struct arp_entry_s
 {
   in_addr_t                at_ipaddr;   /* IP address */
   struct ether_addr        at_ethaddr;  /* Hardware address */
+  uint16_t                 at_next;     /* Next in hash chain, index + 1 */
   clock_t                  at_time;     /* Time of last usage */
   FAR struct net_driver_s *at_dev;      /* The device driver structure */
+#if defined(CONFIG_NET_ARP_SEND) && CONFIG_NET_ARP_REFRESH > 0
+  bool                     at_refresh;  /* A refresh request was sent */
+#endif
 };
 
 /****************************************************************************
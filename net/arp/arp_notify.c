@@ -34,6 +34,7 @@
 
 #include <nuttx/irq.h>
 #include <nuttx/net/net.h>
+#include <nuttx/net/netstats.h>
 
 #include "arp/arp.h"
 
@@ -81,6 +82,9 @@ void arp_wait_setup(in_addr_t ipaddr, FAR struct arp_notify_s *notify)
   flags             = enter_critical_section();
   notify->nt_flink  = g_arp_waiters;
   g_arp_waiters     = notify;
+#ifdef CONFIG_NET_STATISTICS
+  g_netstats.ipv4.arppending++;
+#endif
   leave_critical_section(flags);
 }
 
@@ -127,6 +131,9 @@ int arp_wait_cancel(FAR struct arp_notify_s *notify)
           g_arp_waiters = notify->nt_flink;
         }
 
+#ifdef CONFIG_NET_STATISTICS
+      g_netstats.ipv4.arppending--;
+#endif
       ret = OK;
     }
 
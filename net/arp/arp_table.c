@@ -60,6 +60,7 @@
 #include <nuttx/net/net.h>
 #include <nuttx/net/netdev.h>
 #include <nuttx/net/ip.h>
+#include <nuttx/net/netstats.h>
 
 #include "netdev/netdev.h"
 #include "netlink/netlink.h"
@@ -73,6 +74,14 @@
 
 #define ARP_MAXAGE_TICK SEC2TICK(10 * CONFIG_NET_ARP_MAXAGE)
 
+#if defined(CONFIG_NET_ARP_SEND) && CONFIG_NET_ARP_REFRESH > 0
+#  define ARP_REFRESH_TICK SEC2TICK(CONFIG_NET_ARP_REFRESH)
+#endif
+
+/* Two entries per hash chain on average when the table is full */
+
+#define ARP_NHASH ((CONFIG_NET_ARPTAB_SIZE + 1) / 2)
+
 /****************************************************************************
  * Private Types
  ****************************************************************************/
@@ -91,6 +100,12 @@ struct arp_table_info_s
 
 static struct arp_entry_s g_arptable[CONFIG_NET_ARPTAB_SIZE];
 
+/* The first entry of each hash chain as its index plus one, zero if the
+ * chain is empty.  The entries are chained by at_next the same way.
+ */
+
+static uint16_t g_arphash[ARP_NHASH];
+
 static const struct ether_addr g_zero_ethaddr =
 {
   {
@@ -148,6 +163,47 @@ static int arp_match(FAR struct net_driver_s *dev, FAR void *arg)
   return 1;
 }
 
+/****************************************************************************
+ * Name: arp_hash
+ *
+ * Description:
+ *   Return the head of the hash chain of an IP address.
+ *
+ ****************************************************************************/
+
+static FAR uint16_t *arp_hash(in_addr_t ipaddr)
+{
+  uint32_t key = ipaddr ^ (ipaddr >> 16);
+
+  return &g_arphash[(key ^ (key >> 8)) % ARP_NHASH];
+}
+
+/****************************************************************************
+ * Name: arp_hash_remove
+ *
+ * Description:
+ *   Remove an entry from the hash chain of its IP address, if it is there.
+ *
+ ****************************************************************************/
+
+static void arp_hash_remove(FAR struct arp_entry_s *tabptr)
+{
+  FAR uint16_t *next = arp_hash(tabptr->at_ipaddr);
+  uint16_t index = tabptr - g_arptable + 1;
+
+  while (*next != 0)
+    {
+      if (*next == index)
+        {
+          *next = tabptr->at_next;
+          tabptr->at_next = 0;
+          break;
+        }
+
+      next = &g_arptable[*next - 1].at_next;
+    }
+}
+
 /****************************************************************************
  * Name: arp_return_old_entry
  *
@@ -197,13 +253,13 @@ static FAR struct arp_entry_s *arp_lookup(in_addr_t ipaddr,
                                           FAR struct net_driver_s *dev)
 {
   FAR struct arp_entry_s *tabptr;
-  int i;
+  uint16_t index;
 
   /* Check if the IPv4 address is already in the ARP table. */
 
-  for (i = 0; i < CONFIG_NET_ARPTAB_SIZE; ++i)
+  for (index = *arp_hash(ipaddr); index != 0; index = tabptr->at_next)
     {
-      tabptr = &g_arptable[i];
+      tabptr = &g_arptable[index - 1];
       if (tabptr->at_dev == dev &&
           net_ipv4addr_cmp(ipaddr, tabptr->at_ipaddr) &&
           clock_systime_ticks() - tabptr->at_time <= ARP_MAXAGE_TICK)
@@ -276,41 +332,45 @@ static void arp_get_arpreq(FAR struct arpreq *output,
 int arp_update(FAR struct net_driver_s *dev, in_addr_t ipaddr,
                FAR const uint8_t *ethaddr)
 {
-  FAR struct arp_entry_s *tabptr = &g_arptable[0];
+  FAR struct arp_entry_s *tabptr = NULL;
+  FAR uint16_t *hash = arp_hash(ipaddr);
 #ifdef CONFIG_NETLINK_ROUTE
   struct arpreq arp_notify;
-  bool found = false;
   bool new_entry;
 #endif
+  bool found = false;
+  uint16_t index;
   int i;
 
-  /* Walk through the ARP mapping table and try to find an entry to
-   * update. If none is found, the IP -> MAC address mapping is
-   * inserted in the ARP table.
-   */
+  /* Look in the hash chain of the IP address for an entry to update. */
 
-  for (i = 0; i < CONFIG_NET_ARPTAB_SIZE; ++i)
+  for (index = *hash; index != 0; index = tabptr->at_next)
     {
       /* Check if the source IP address of the incoming packet matches
        * the IP address in this ARP table entry.
        */
 
-      if (g_arptable[i].at_dev == dev &&
-          g_arptable[i].at_ipaddr != 0 &&
-          net_ipv4addr_cmp(ipaddr, g_arptable[i].at_ipaddr))
+      tabptr = &g_arptable[index - 1];
+      if (tabptr->at_dev == dev &&
+          tabptr->at_ipaddr != 0 &&
+          net_ipv4addr_cmp(ipaddr, tabptr->at_ipaddr))
         {
           /* An old entry found, break. */
 
-          tabptr = &g_arptable[i];
-#ifdef CONFIG_NETLINK_ROUTE
           found = true;
-#endif
           break;
         }
-      else
-        {
-          /* Record the oldest entry. */
+    }
+
+  /* If none is found, the IP -> MAC address mapping is inserted in the
+   * ARP table in place of the oldest entry.
+   */
 
+  if (!found)
+    {
+      tabptr = &g_arptable[0];
+      for (i = 1; i < CONFIG_NET_ARPTAB_SIZE; ++i)
+        {
           tabptr = arp_return_old_entry(tabptr, &g_arptable[i]);
         }
     }
@@ -339,10 +399,20 @@ int arp_update(FAR struct net_driver_s *dev, in_addr_t ipaddr,
    * information.
    */
 
+  if (!found)
+    {
+      arp_hash_remove(tabptr);
+      tabptr->at_next = *hash;
+      *hash = tabptr - g_arptable + 1;
+    }
+
   tabptr->at_ipaddr = ipaddr;
   memcpy(tabptr->at_ethaddr.ether_addr_octet, ethaddr, ETHER_ADDR_LEN);
   tabptr->at_dev = dev;
   tabptr->at_time = clock_systime_ticks();
+#ifdef ARP_REFRESH_TICK
+  tabptr->at_refresh = false;
+#endif
 
   /* Notify the new entry */
 
@@ -426,9 +496,30 @@ int arp_find(in_addr_t ipaddr, FAR uint8_t *ethaddr,
       if (memcmp(&tabptr->at_ethaddr, &g_zero_ethaddr,
                  sizeof(tabptr->at_ethaddr)) == 0)
         {
+#ifdef CONFIG_NET_STATISTICS
+          g_netstats.ipv4.arpmiss++;
+#endif
           return -ENETUNREACH;
         }
 
+#ifdef CONFIG_NET_STATISTICS
+      g_netstats.ipv4.arphit++;
+#endif
+
+#ifdef ARP_REFRESH_TICK
+      /* Ask for the address again in the background if the entry is
+       * about to expire, so that it is replaced before it does.
+       */
+
+      if (!tabptr->at_refresh &&
+          clock_systime_ticks() - tabptr->at_time + ARP_REFRESH_TICK >
+          ARP_MAXAGE_TICK)
+        {
+          tabptr->at_refresh = true;
+          arp_send_async(ipaddr, NULL);
+        }
+#endif
+
       /* Yes.. return the Ethernet MAC address if the caller has provided a
        * non-NULL address in 'ethaddr'.
        */
@@ -460,6 +551,9 @@ int arp_find(in_addr_t ipaddr, FAR uint8_t *ethaddr,
 
   /* Not found */
 
+#ifdef CONFIG_NET_STATISTICS
+  g_netstats.ipv4.arpmiss++;
+#endif
   return -ENOENT;
 }
 
@@ -498,6 +592,7 @@ int arp_delete(in_addr_t ipaddr, FAR struct net_driver_s *dev)
 
       /* Yes.. Set the IP address to zero to "delete" it */
 
+      arp_hash_remove(tabptr);
       tabptr->at_ipaddr = 0;
       return OK;
     }
@@ -527,6 +622,7 @@ void arp_cleanup(FAR struct net_driver_s *dev)
     {
       if (dev == g_arptable[i].at_dev)
         {
+          arp_hash_remove(&g_arptable[i]);
           memset(&g_arptable[i], 0, sizeof(g_arptable[i]));
         }
     }
@@ -103,6 +103,12 @@
  *                        up by the listen() command. (TCP only)
  *                   OUT: Not used
  *
+ *   TCP_BACKLOG_EXCL IN: Not used; always zero
+ *                   OUT: Set by poll logic once the new connection has
+ *                        woken up an EPOLLEXCLUSIVE waiter, the other
+ *                        exclusive waiters ignore TCP_BACKLOG then.
+ *                        (TCP only)
+ *
  *   TCP_CLOSE        IN: The remote host has closed the connection, thus the
  *                        connection has gone away. (TCP only)
  *                   OUT: The socket layer signals that it wants to close the
@@ -164,7 +170,7 @@
  *                   OUT: Not used
  */
 
-/* Bits 0-9: Connection specific event bits */
+/* Bits 0-11: Connection specific event bits */
 
 #define TCP_ACKDATA        (1 << 0)
 #define TCP_NEWDATA        (1 << 1)
@@ -192,8 +198,7 @@
 #define TCP_CONNECTED      (1 << 8)
 #define TCP_TIMEDOUT       (1 << 9)
 #define TCP_WAITALL        (1 << 10)
-
-/* Bits 10-11: Unused, available */
+#define TCP_BACKLOG_EXCL   (1 << 11)
 
 /* Bit 12: Device specific event bits */
 
@@ -59,6 +59,9 @@ int devif_iob_send(FAR struct net_driver_s *dev, FAR struct iob_s *iob,
                    unsigned int len, unsigned int offset,
                    unsigned int target_offset)
 {
+#ifndef CONFIG_NET_IPFRAG
+  unsigned int pktsize;
+#endif
   int ret;
 
   if (dev == NULL)
@@ -74,7 +77,19 @@ int devif_iob_send(FAR struct net_driver_s *dev, FAR struct iob_s *iob,
     }
 
 #ifndef CONFIG_NET_IPFRAG
-  if (len > NETDEV_PKTSIZE(dev) - NET_LL_HDRLEN(dev) - target_offset)
+  /* A TCP packet that the driver will segment (d_gsosize set by the
+   * caller) may be as big as d_gsomax instead of the MTU.
+   */
+
+  pktsize = NETDEV_PKTSIZE(dev);
+#ifdef CONFIG_NETDEV_GSO
+  if (dev->d_gsosize > 0 && dev->d_gsomax > pktsize)
+    {
+      pktsize = dev->d_gsomax;
+    }
+#endif
+
+  if (len > pktsize - NET_LL_HDRLEN(dev) - target_offset)
     {
       ret = -EMSGSIZE;
       goto errout;
@@ -91,6 +106,17 @@ int devif_iob_send(FAR struct net_driver_s *dev, FAR struct iob_s *iob,
 
   /* Clone the iob to target device buffer */
 
+#ifdef CONFIG_NET_CHKSUM_COPY
+  ret = chksum_iob_clone(iob, len, offset, dev->d_iob, target_offset,
+                         &dev->d_sndsum);
+  if (ret != OK)
+    {
+      netdev_iob_release(dev);
+      goto errout;
+    }
+
+  dev->d_sndsumlen = len;
+#else
   ret = iob_clone_partial(iob, len, offset, dev->d_iob,
                           target_offset, false, false);
   if (ret != OK)
@@ -98,6 +124,7 @@ int devif_iob_send(FAR struct net_driver_s *dev, FAR struct iob_s *iob,
       netdev_iob_release(dev);
       goto errout;
     }
+#endif
 
   dev->d_sndlen = len;
 
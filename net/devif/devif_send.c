@@ -106,6 +106,27 @@ int devif_send(FAR struct net_driver_s *dev, FAR const void *buf,
 
   iob_update_pktlen(dev->d_iob, offset < 0 ? 0 : offset, false);
 
+#ifdef CONFIG_NET_CHKSUM_COPY
+  /* Sum the data while copying it, the transport checksum then only has
+   * to add the header.  A negative offset reaches into the link layer
+   * header, nothing to sum there.
+   */
+
+  if (offset >= 0)
+    {
+      ret = chksum_iob_copyin(dev->d_iob, buf, len, offset, &dev->d_sndsum);
+      if (ret < 0)
+        {
+          netdev_iob_release(dev);
+          goto errout;
+        }
+
+      dev->d_sndlen    = len;
+      dev->d_sndsumlen = len;
+      return dev->d_sndlen;
+    }
+#endif
+
   ret = iob_trycopyin(dev->d_iob, buf, len, offset, false);
   if (ret != len)
     {
@@ -85,6 +85,7 @@
 #include <sys/ioctl.h>
 #include <stdint.h>
 #include <debug.h>
+#include <errno.h>
 #include <string.h>
 
 #include <netinet/in.h>
@@ -237,6 +238,24 @@ static int ipv4_in(FAR struct net_driver_s *dev)
       goto drop;
     }
 
+#ifdef CONFIG_NET_IPFORWARD_FLOWTABLE
+  /* Forward the packets of established flows with the decision cached
+   * from the full path.
+   */
+
+  ret = ipv4_flow_forward(dev, ipv4);
+  if (ret >= 0)
+    {
+      goto done;
+    }
+  else if (ret != -ENOENT)
+    {
+      goto drop;
+    }
+
+  ret = OK;
+#endif
+
 #ifdef CONFIG_NET_NAT44
   /* Try NAT inbound, rule matching will be performed in NAT module. */
 
@@ -35,6 +35,7 @@
 
 #include <nuttx/irq.h>
 #include <nuttx/net/net.h>
+#include <nuttx/net/netstats.h>
 
 #include "icmpv6/icmpv6.h"
 
@@ -95,6 +96,9 @@ void icmpv6_wait_setup(const net_ipv6addr_t ipaddr,
   flags             = enter_critical_section();
   notify->nt_flink  = g_icmpv6_waiters;
   g_icmpv6_waiters  = notify;
+#ifdef CONFIG_NET_STATISTICS
+  g_netstats.ipv6.nbpending++;
+#endif
   leave_critical_section(flags);
 }
 
@@ -142,6 +146,9 @@ int icmpv6_wait_cancel(FAR struct icmpv6_notify_s *notify)
           g_icmpv6_waiters = notify->nt_flink;
         }
 
+#ifdef CONFIG_NET_STATISTICS
+      g_netstats.ipv6.nbpending--;
+#endif
       ret = OK;
     }
 
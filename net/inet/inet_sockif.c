@@ -825,6 +825,11 @@ static int inet_getsockopt(FAR struct socket *psock, int level, int option,
         return tcp_getsockopt(psock, option, value, value_len);
 #endif
 
+#ifdef CONFIG_NET_UDPPROTO_OPTIONS
+      case IPPROTO_UDP:
+        return udp_getsockopt(psock, option, value, value_len);
+#endif
+
 #ifdef CONFIG_NET_IPv4
       case IPPROTO_IP:/* IPv4 protocol socket options (see include/netinet/in.h) */
         return ipv4_getsockopt(psock, option, value, value_len);
@@ -1409,6 +1414,7 @@ static int inet_connect(FAR struct socket *psock,
               conn->flags |= _UDP_FLAG_CONNECTMODE;
             }
 
+          udp_conn_rehash(conn);
           return ret;
         }
 #endif /* CONFIG_NET_UDP */
@@ -27,6 +27,7 @@
 #include <nuttx/config.h>
 
 #include <debug.h>
+#include <errno.h>
 
 #include <nuttx/kmalloc.h>
 #include <nuttx/net/icmpv6.h>
@@ -37,6 +38,7 @@
 #include "icmp/icmp.h"
 #include "icmpv6/icmpv6.h"
 #include "ipfilter/ipfilter.h"
+#include "ipforward/ipforward.h"
 #include "utils/utils.h"
 
 #ifdef CONFIG_NET_IPFILTER
@@ -65,6 +67,8 @@
 #define IPv6_L4HDR(ipv6, proto) \
   ((FAR void *)(net_ipv6_payload((FAR struct ipv6_hdr_s *)(ipv6), &(proto))))
 
+#define SWAP_PTR(a,b) do { FAR void *t = (a); (a) = (b); (b) = t; } while (0)
+
 /****************************************************************************
  * Private Data
  ****************************************************************************/
@@ -76,10 +80,96 @@ static sq_queue_t g_ipv4_filters[IPFILTER_CHAIN_MAX];
 static sq_queue_t g_ipv6_filters[IPFILTER_CHAIN_MAX];
 #endif
 
+#ifdef CONFIG_NET_IPFILTER_COMPILE
+/* The compiled chains, NULL if a chain is evaluated linearly */
+
+#  ifdef CONFIG_NET_IPv4
+static FAR struct ipfilter_prog_s *g_ipv4_progs[IPFILTER_CHAIN_MAX];
+#  endif
+#  ifdef CONFIG_NET_IPv6
+static FAR struct ipfilter_prog_s *g_ipv6_progs[IPFILTER_CHAIN_MAX];
+#  endif
+#endif
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: ipfilter_chain
+ *
+ * Description:
+ *   Get the filter entries of a chain.
+ *
+ * Input Parameters:
+ *   family - The address family of the filter entries
+ *   chain  - The chain of the filter entries
+ *   prog   - Receives the location of the compiled chain if not NULL
+ *
+ * Returned Value:
+ *   The queue of filter entries, NULL if the family is not supported.
+ *
+ ****************************************************************************/
+
+static FAR sq_queue_t *ipfilter_chain(sa_family_t family,
+                                      enum ipfilter_chain_e chain,
+                                      FAR struct ipfilter_prog_s ***prog)
+{
+#ifdef CONFIG_NET_IPv4
+  if (family == PF_INET)
+    {
+#ifdef CONFIG_NET_IPFILTER_COMPILE
+      if (prog != NULL)
+        {
+          *prog = &g_ipv4_progs[chain];
+        }
+#endif
+
+      return &g_ipv4_filters[chain];
+    }
+#endif
+
+#ifdef CONFIG_NET_IPv6
+  if (family == PF_INET6)
+    {
+#ifdef CONFIG_NET_IPFILTER_COMPILE
+      if (prog != NULL)
+        {
+          *prog = &g_ipv6_progs[chain];
+        }
+#endif
+
+      return &g_ipv6_filters[chain];
+    }
+#endif
+
+  return NULL;
+}
+
+/****************************************************************************
+ * Name: ipfilter_uncompile
+ *
+ * Description:
+ *   Return a chain to the linear evaluation before its entries change.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_IPFILTER_COMPILE
+static void ipfilter_uncompile(sa_family_t family,
+                               enum ipfilter_chain_e chain)
+{
+  FAR struct ipfilter_prog_s **prog;
+
+  if (ipfilter_chain(family, chain, &prog) != NULL && *prog != NULL)
+    {
+      ipfilter_prog_free(*prog);
+      *prog = NULL;
+    }
+}
+#else
+#  define ipfilter_uncompile(family, chain)
+#endif
+
 /****************************************************************************
  * Name: ipfilter_match_device
  *
@@ -188,11 +278,97 @@ static bool ipfilter_match_proto(FAR const struct ipfilter_entry_s *entry,
     }
 }
 
+/****************************************************************************
+ * Name: ipv4_filter_lookup / ipv6_filter_lookup
+ *
+ * Description:
+ *   Find the first filter entry in the specified chain that matches the
+ *   packet.
+ *
+ * Input Parameters:
+ *   indev     - The network device that the packet comes from
+ *   outdev    - The network device that the packet goes to
+ *   ipv4/ipv6 - The IPv4/IPv6 header
+ *   l4hdr     - The transport header
+ *   proto     - The transport protocol (IPv6 only)
+ *   chain     - The chain to match the filter entries
+ *
+ * Returned Value:
+ *   The matched filter entry, NULL if no entry matches.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_IPv4
+static FAR struct ipv4_filter_entry_s *
+ipv4_filter_lookup(FAR const struct net_driver_s *indev,
+                   FAR const struct net_driver_s *outdev,
+                   FAR const struct ipv4_hdr_s *ipv4,
+                   FAR const void *l4hdr, enum ipfilter_chain_e chain)
+{
+  FAR struct ipv4_filter_entry_s *filter;
+  FAR sq_entry_t *entry;
+
+#ifdef CONFIG_NET_IPFILTER_COMPILE
+  if (g_ipv4_progs[chain] != NULL)
+    {
+      return (FAR struct ipv4_filter_entry_s *)
+             ipfilter_prog_eval(g_ipv4_progs[chain], indev, outdev, ipv4,
+                                l4hdr, ipv4->proto);
+    }
+#endif
+
+  sq_for_every(&g_ipv4_filters[chain], entry)
+    {
+      filter = (FAR struct ipv4_filter_entry_s *)entry;
+      if (ipv4_filter_match_entry(filter, indev, outdev, ipv4, l4hdr))
+        {
+          return filter;
+        }
+    }
+
+  return NULL;
+}
+#endif
+
+#ifdef CONFIG_NET_IPv6
+static FAR struct ipv6_filter_entry_s *
+ipv6_filter_lookup(FAR const struct net_driver_s *indev,
+                   FAR const struct net_driver_s *outdev,
+                   FAR const struct ipv6_hdr_s *ipv6,
+                   FAR const void *l4hdr, uint8_t proto,
+                   enum ipfilter_chain_e chain)
+{
+  FAR struct ipv6_filter_entry_s *filter;
+  FAR sq_entry_t *entry;
+
+#ifdef CONFIG_NET_IPFILTER_COMPILE
+  if (g_ipv6_progs[chain] != NULL)
+    {
+      return (FAR struct ipv6_filter_entry_s *)
+             ipfilter_prog_eval(g_ipv6_progs[chain], indev, outdev, ipv6,
+                                l4hdr, proto);
+    }
+#endif
+
+  sq_for_every(&g_ipv6_filters[chain], entry)
+    {
+      filter = (FAR struct ipv6_filter_entry_s *)entry;
+      if (ipv6_filter_match_entry(filter, indev, outdev, ipv6, l4hdr, proto))
+        {
+          return filter;
+        }
+    }
+
+  return NULL;
+}
+#endif
+
 /****************************************************************************
  * Name: ipv4_filter_match / ipv6_filter_match
  *
  * Description:
- *   Match the input packet with the filter entries in the specified chain.
+ *   Match the input packet with the filter entries in the specified chain,
+ *   and account it to the hit counters of the matched entry.
  *
  * Input Parameters:
  *   indev     - The network device that the packet comes from
@@ -213,12 +389,7 @@ static int ipv4_filter_match(FAR const struct net_driver_s *indev,
                              FAR const struct ipv4_hdr_s *ipv4,
                              enum ipfilter_chain_e chain)
 {
-  FAR const struct ipv4_filter_entry_s *filter;
-  FAR const sq_queue_t *queue = &g_ipv4_filters[chain];
-  FAR const sq_entry_t *entry;
-  FAR const void *l4hdr;
-  in_addr_t ipaddr;
-  bool matched;
+  FAR struct ipv4_filter_entry_s *filter;
 
   /* Handle unexpected status, return ACCEPT to indicate doing nothing. */
 
@@ -227,53 +398,22 @@ static int ipv4_filter_match(FAR const struct net_driver_s *indev,
       return IPFILTER_TARGET_ACCEPT;
     }
 
-  l4hdr = IPv4_L4HDR(ipv4);
-
-  sq_for_every(queue, entry)
+  filter = ipv4_filter_lookup(indev, outdev, ipv4, IPv4_L4HDR(ipv4), chain);
+  if (filter == NULL)
     {
-      filter = (FAR struct ipv4_filter_entry_s *)entry;
-
-      /* Match device */
+      /* Normally there should be a default rule in chain, won't reach
+       * here.
+       */
 
-      if (!ipfilter_match_device(&filter->common, indev, outdev))
-        {
-          continue;
-        }
-
-      /* Match addresses */
-
-      ipaddr  = net_ip4addr_conv32(ipv4->srcipaddr);
-      matched = net_ipv4addr_maskcmp(filter->sip, ipaddr, filter->smsk)
-                ^ filter->common.inv_srcip;
-      if (!matched)
-        {
-          continue;
-        }
-
-      ipaddr  = net_ip4addr_conv32(ipv4->destipaddr);
-      matched = net_ipv4addr_maskcmp(filter->dip, ipaddr, filter->dmsk)
-                ^ filter->common.inv_dstip;
-      if (!matched)
-        {
-          continue;
-        }
-
-      /* Match protocol */
-
-      if (!ipfilter_match_proto(&filter->common, l4hdr, ipv4->proto))
-        {
-          continue;
-        }
-
-      /* Return the target action if matched. */
-
-      return filter->common.target;
+      ninfo("No filter matched, maybe uninitialized.\n");
+      return IPFILTER_TARGET_ACCEPT;
     }
 
-  /* Normally there should be a default rule in chain, won't reach here. */
+  /* Return the target action of the matched entry. */
 
-  ninfo("No filter matched, maybe uninitialized.\n");
-  return IPFILTER_TARGET_ACCEPT;
+  filter->common.pcnt++;
+  filter->common.bcnt += (ipv4->len[0] << 8) + ipv4->len[1];
+  return filter->common.target;
 }
 #endif
 
@@ -283,12 +423,9 @@ static int ipv6_filter_match(FAR const struct net_driver_s *indev,
                              FAR const struct ipv6_hdr_s *ipv6,
                              enum ipfilter_chain_e chain)
 {
-  FAR const struct ipv6_filter_entry_s *filter;
-  FAR const sq_queue_t *queue = &g_ipv6_filters[chain];
-  FAR const sq_entry_t *entry;
+  FAR struct ipv6_filter_entry_s *filter;
   FAR const void *l4hdr;
   uint8_t proto;
-  bool matched;
 
   /* Handle unexpected status, return ACCEPT to indicate doing nothing. */
 
@@ -297,59 +434,129 @@ static int ipv6_filter_match(FAR const struct net_driver_s *indev,
       return IPFILTER_TARGET_ACCEPT;
     }
 
-  l4hdr = IPv6_L4HDR(ipv6, proto);
-
-  sq_for_every(queue, entry)
+  l4hdr  = IPv6_L4HDR(ipv6, proto);
+  filter = ipv6_filter_lookup(indev, outdev, ipv6, l4hdr, proto, chain);
+  if (filter == NULL)
     {
-      filter = (FAR struct ipv6_filter_entry_s *)entry;
+      /* Normally there should be a default rule in chain, won't reach
+       * here.
+       */
 
-      /* Match device */
+      ninfo("No filter matched, maybe uninitialized.\n");
+      return IPFILTER_TARGET_ACCEPT;
+    }
 
-      if (!ipfilter_match_device(&filter->common, indev, outdev))
-        {
-          continue;
-        }
+  /* Return the target action of the matched entry. */
 
-      /* Match addresses */
+  filter->common.pcnt++;
+  filter->common.bcnt += (ipv6->len[0] << 8) + ipv6->len[1] + IPv6_HDRLEN;
+  return filter->common.target;
+}
+#endif
 
-      matched = net_ipv6addr_maskcmp(filter->sip, ipv6->srcipaddr,
-                                     filter->smsk)
-                ^ filter->common.inv_srcip;
-      if (!matched)
-        {
-          continue;
-        }
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
 
-      matched = net_ipv6addr_maskcmp(filter->dip, ipv6->destipaddr,
-                                     filter->dmsk)
-                ^ filter->common.inv_dstip;
-      if (!matched)
-        {
-          continue;
-        }
+/****************************************************************************
+ * Name: ipv4_filter_match_entry / ipv6_filter_match_entry
+ *
+ * Description:
+ *   Match a packet with a single filter entry.
+ *
+ * Input Parameters:
+ *   filter    - The filter entry to match
+ *   indev     - The network device that the packet comes from
+ *   outdev    - The network device that the packet goes to
+ *   ipv4/ipv6 - The IPv4/IPv6 header
+ *   l4hdr     - The transport header
+ *   proto     - The transport protocol (IPv6 only)
+ *
+ * Returned Value:
+ *   true  - The packet is matched
+ *   false - The packet is not matched
+ *
+ ****************************************************************************/
 
-      /* Match protocol */
+#ifdef CONFIG_NET_IPv4
+bool ipv4_filter_match_entry(FAR const struct ipv4_filter_entry_s *filter,
+                             FAR const struct net_driver_s *indev,
+                             FAR const struct net_driver_s *outdev,
+                             FAR const struct ipv4_hdr_s *ipv4,
+                             FAR const void *l4hdr)
+{
+  in_addr_t ipaddr;
+  bool matched;
 
-      if (!ipfilter_match_proto(&filter->common, l4hdr, proto))
-        {
-          continue;
-        }
+  /* Match device */
+
+  if (!ipfilter_match_device(&filter->common, indev, outdev))
+    {
+      return false;
+    }
+
+  /* Match addresses */
 
-      /* Return the target action if matched. */
+  ipaddr  = net_ip4addr_conv32(ipv4->srcipaddr);
+  matched = net_ipv4addr_maskcmp(filter->sip, ipaddr, filter->smsk)
+            ^ filter->common.inv_srcip;
+  if (!matched)
+    {
+      return false;
+    }
 
-      return filter->common.target;
+  ipaddr  = net_ip4addr_conv32(ipv4->destipaddr);
+  matched = net_ipv4addr_maskcmp(filter->dip, ipaddr, filter->dmsk)
+            ^ filter->common.inv_dstip;
+  if (!matched)
+    {
+      return false;
     }
 
-  /* Normally there should be a default rule in chain, won't reach here. */
+  /* Match protocol */
 
-  ninfo("No filter matched, maybe uninitialized.\n");
-  return IPFILTER_TARGET_ACCEPT;
+  return ipfilter_match_proto(&filter->common, l4hdr, ipv4->proto);
 }
 #endif
 
-/****************************************************************************
- * Public Functions
- ****************************************************************************/
+#ifdef CONFIG_NET_IPv6
+bool ipv6_filter_match_entry(FAR const struct ipv6_filter_entry_s *filter,
+                             FAR const struct net_driver_s *indev,
+                             FAR const struct net_driver_s *outdev,
+                             FAR const struct ipv6_hdr_s *ipv6,
+                             FAR const void *l4hdr, uint8_t proto)
+{
+  bool matched;
+
+  /* Match device */
+
+  if (!ipfilter_match_device(&filter->common, indev, outdev))
+    {
+      return false;
+    }
+
+  /* Match addresses */
+
+  matched = net_ipv6addr_maskcmp(filter->sip, ipv6->srcipaddr, filter->smsk)
+            ^ filter->common.inv_srcip;
+  if (!matched)
+    {
+      return false;
+    }
+
+  matched = net_ipv6addr_maskcmp(filter->dip, ipv6->destipaddr,
+                                 filter->dmsk)
+            ^ filter->common.inv_dstip;
+  if (!matched)
+    {
+      return false;
+    }
+
+  /* Match protocol */
+
+  return ipfilter_match_proto(&filter->common, l4hdr, proto);
+}
+#endif
 
 /****************************************************************************
  * Name: ipfilter_cfg_alloc
@@ -407,10 +614,13 @@ FAR struct ipfilter_entry_s *ipfilter_cfg_alloc(sa_family_t family)
 void ipfilter_cfg_add(FAR struct ipfilter_entry_s *entry,
                       sa_family_t family, enum ipfilter_chain_e chain)
 {
+  ipfilter_uncompile(family, chain);
+
 #ifdef CONFIG_NET_IPv4
   if (family == PF_INET)
     {
       sq_addlast((FAR sq_entry_t *)entry, &g_ipv4_filters[chain]);
+      ipfwd_flow_flush();
     }
 #endif
 
@@ -440,6 +650,8 @@ void ipfilter_cfg_add(FAR struct ipfilter_entry_s *entry,
 
 void ipfilter_cfg_clear(sa_family_t family, enum ipfilter_chain_e chain)
 {
+  ipfilter_uncompile(family, chain);
+
 #ifdef CONFIG_NET_IPv4
   if (family == PF_INET)
     {
@@ -448,6 +660,8 @@ void ipfilter_cfg_clear(sa_family_t family, enum ipfilter_chain_e chain)
         {
           kmm_free(sq_remfirst(queue));
         }
+
+      ipfwd_flow_flush();
     }
 #endif
 
@@ -463,6 +677,102 @@ void ipfilter_cfg_clear(sa_family_t family, enum ipfilter_chain_e chain)
 #endif
 }
 
+/****************************************************************************
+ * Name: ipfilter_cfg_commit
+ *
+ * Description:
+ *   Called once all filter configuration entries of a chain are added.  If
+ *   CONFIG_NET_IPFILTER_COMPILE is enabled, the chain is compiled and the
+ *   result replaces the linear evaluation of the chain.  Adding or clearing
+ *   entries afterwards returns to the linear evaluation until the next
+ *   commit.
+ *
+ * Input Parameters:
+ *   family - The address family of the filter entries
+ *   chain  - The chain that was configured
+ *
+ * Returned Value:
+ *   OK on success; -ENOMEM if the chain could not be compiled, the chain
+ *   is still evaluated linearly in that case.
+ *
+ ****************************************************************************/
+
+int ipfilter_cfg_commit(sa_family_t family, enum ipfilter_chain_e chain)
+{
+#ifdef CONFIG_NET_IPFILTER_COMPILE
+  FAR struct ipfilter_prog_s **prog;
+  FAR struct ipfilter_prog_s *newprog;
+  FAR sq_queue_t *queue;
+
+  queue = ipfilter_chain(family, chain, &prog);
+  if (queue == NULL)
+    {
+      return OK;
+    }
+
+  /* The new chain is complete before it replaces the old one, a packet is
+   * either matched against the old or the new chain.
+   */
+
+  newprog = ipfilter_compile(queue, family);
+  if (newprog == NULL)
+    {
+      nwarn("WARNING: Failed to compile chain %d\n", chain);
+      ipfilter_uncompile(family, chain);
+      return -ENOMEM;
+    }
+
+  SWAP_PTR(*prog, newprog);
+  if (newprog != NULL)
+    {
+      ipfilter_prog_free(newprog);
+    }
+#endif
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: ipfilter_cfg_foreach
+ *
+ * Description:
+ *   Call handler for every filter configuration entry of the chain, in the
+ *   order they are matched.  The traversal stops if handler returns non-
+ *   zero.
+ *
+ * Input Parameters:
+ *   family  - The address family of the filter entries
+ *   chain   - The chain to traverse
+ *   handler - The function to call for every entry
+ *   arg     - The argument passed to handler
+ *
+ * Returned Value:
+ *   The last value returned by handler, zero if the chain is empty.
+ *
+ ****************************************************************************/
+
+int ipfilter_cfg_foreach(sa_family_t family, enum ipfilter_chain_e chain,
+                         ipfilter_callback_t handler, FAR void *arg)
+{
+  FAR sq_queue_t *queue = ipfilter_chain(family, chain, NULL);
+  FAR sq_entry_t *entry;
+  int ret = 0;
+
+  if (queue != NULL)
+    {
+      sq_for_every(queue, entry)
+        {
+          ret = handler((FAR struct ipfilter_entry_s *)entry, arg);
+          if (ret != 0)
+            {
+              break;
+            }
+        }
+    }
+
+  return ret;
+}
+
 /****************************************************************************
  * Name: ipv4_filter_in / ipv6_filter_in
  *
@@ -33,6 +33,7 @@
 
 #include <nuttx/compiler.h>
 #include <nuttx/net/ip.h>
+#include <nuttx/queue.h>
 
 #ifdef CONFIG_NET_IPFILTER
 
@@ -97,6 +98,17 @@ struct ipfilter_entry_s
   uint8_t inv_sport  : 1; /* Inverse source port */
   uint8_t inv_dport  : 1; /* Inverse destination port */
   uint8_t inv_icmp   : 1; /* Inverse ICMP type */
+
+  /* Position of the entry in the configuration it was converted from,
+   * entries that failed to convert leave gaps.
+   */
+
+  uint16_t index;
+
+  /* Hit counters, the packets and bytes accepted by the entry */
+
+  uint64_t pcnt;
+  uint64_t bcnt;
 };
 
 struct ipv4_filter_entry_s
@@ -123,6 +135,15 @@ struct ipv6_filter_entry_s
   net_ipv6addr_t dmsk;
 };
 
+/* Callback from ipfilter_cfg_foreach() */
+
+typedef CODE int (*ipfilter_callback_t)(FAR struct ipfilter_entry_s *entry,
+                                        FAR void *arg);
+
+/* A chain compiled by ipfilter_compile(), opaque outside the compiler */
+
+struct ipfilter_prog_s;
+
 /****************************************************************************
  * Public Function Prototypes
  ****************************************************************************/
@@ -182,6 +203,150 @@ void ipfilter_cfg_add(FAR struct ipfilter_entry_s *entry,
 
 void ipfilter_cfg_clear(sa_family_t family, enum ipfilter_chain_e chain);
 
+/****************************************************************************
+ * Name: ipfilter_cfg_commit
+ *
+ * Description:
+ *   Called once all filter configuration entries of a chain are added.  If
+ *   CONFIG_NET_IPFILTER_COMPILE is enabled, the chain is compiled and the
+ *   result replaces the linear evaluation of the chain.  Adding or clearing
+ *   entries afterwards returns to the linear evaluation until the next
+ *   commit.
+ *
+ * Input Parameters:
+ *   family - The address family of the filter entries
+ *   chain  - The chain that was configured
+ *
+ * Returned Value:
+ *   OK on success; -ENOMEM if the chain could not be compiled, the chain
+ *   is still evaluated linearly in that case.
+ *
+ ****************************************************************************/
+
+int ipfilter_cfg_commit(sa_family_t family, enum ipfilter_chain_e chain);
+
+/****************************************************************************
+ * Name: ipfilter_cfg_foreach
+ *
+ * Description:
+ *   Call handler for every filter configuration entry of the chain, in the
+ *   order they are matched.  The traversal stops if handler returns non-
+ *   zero.
+ *
+ * Input Parameters:
+ *   family  - The address family of the filter entries
+ *   chain   - The chain to traverse
+ *   handler - The function to call for every entry
+ *   arg     - The argument passed to handler
+ *
+ * Returned Value:
+ *   The last value returned by handler, zero if the chain is empty.
+ *
+ ****************************************************************************/
+
+int ipfilter_cfg_foreach(sa_family_t family, enum ipfilter_chain_e chain,
+                         ipfilter_callback_t handler, FAR void *arg);
+
+/****************************************************************************
+ * Name: ipv4_filter_match_entry / ipv6_filter_match_entry
+ *
+ * Description:
+ *   Match a packet with a single filter entry.
+ *
+ * Input Parameters:
+ *   filter    - The filter entry to match
+ *   indev     - The network device that the packet comes from
+ *   outdev    - The network device that the packet goes to
+ *   ipv4/ipv6 - The IPv4/IPv6 header
+ *   l4hdr     - The transport header
+ *   proto     - The transport protocol (IPv6 only)
+ *
+ * Returned Value:
+ *   true  - The packet is matched
+ *   false - The packet is not matched
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_IPv4
+bool ipv4_filter_match_entry(FAR const struct ipv4_filter_entry_s *filter,
+                             FAR const struct net_driver_s *indev,
+                             FAR const struct net_driver_s *outdev,
+                             FAR const struct ipv4_hdr_s *ipv4,
+                             FAR const void *l4hdr);
+#endif
+#ifdef CONFIG_NET_IPv6
+bool ipv6_filter_match_entry(FAR const struct ipv6_filter_entry_s *filter,
+                             FAR const struct net_driver_s *indev,
+                             FAR const struct net_driver_s *outdev,
+                             FAR const struct ipv6_hdr_s *ipv6,
+                             FAR const void *l4hdr, uint8_t proto);
+#endif
+
+#ifdef CONFIG_NET_IPFILTER_COMPILE
+
+/****************************************************************************
+ * Name: ipfilter_compile
+ *
+ * Description:
+ *   Compile a chain of filter entries.  The entries are dispatched on the
+ *   transport protocol, and runs of consecutive entries with the same
+ *   target that only differ in one exact address or port are folded into
+ *   a hash set.
+ *
+ * Input Parameters:
+ *   queue  - The filter entries of the chain
+ *   family - The address family of the filter entries
+ *
+ * Returned Value:
+ *   The compiled chain, NULL if there is not enough memory.
+ *
+ * Assumptions:
+ *   The entries are not modified or freed while the compiled chain is
+ *   used.
+ *
+ ****************************************************************************/
+
+FAR struct ipfilter_prog_s *ipfilter_compile(FAR const sq_queue_t *queue,
+                                             sa_family_t family);
+
+/****************************************************************************
+ * Name: ipfilter_prog_free
+ *
+ * Description:
+ *   Free a chain compiled by ipfilter_compile().
+ *
+ ****************************************************************************/
+
+void ipfilter_prog_free(FAR struct ipfilter_prog_s *prog);
+
+/****************************************************************************
+ * Name: ipfilter_prog_eval
+ *
+ * Description:
+ *   Find the first filter entry of a compiled chain that matches a packet.
+ *
+ * Input Parameters:
+ *   prog   - The compiled chain
+ *   indev  - The network device that the packet comes from
+ *   outdev - The network device that the packet goes to
+ *   iphdr  - The IPv4 or IPv6 header, matching the family of prog
+ *   l4hdr  - The transport header
+ *   proto  - The transport protocol
+ *
+ * Returned Value:
+ *   The matched filter entry, NULL if no entry matches.
+ *
+ ****************************************************************************/
+
+FAR struct ipfilter_entry_s *
+ipfilter_prog_eval(FAR const struct ipfilter_prog_s *prog,
+                   FAR const struct net_driver_s *indev,
+                   FAR const struct net_driver_s *outdev,
+                   FAR const void *iphdr, FAR const void *l4hdr,
+                   uint8_t proto);
+
+#endif /* CONFIG_NET_IPFILTER_COMPILE */
+
 /****************************************************************************
  * Name: ipv4_filter_in / ipv6_filter_in
  *
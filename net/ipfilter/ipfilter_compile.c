@@ -0,0 +1,890 @@
+/****************************************************************************
+ * net/ipfilter/ipfilter_compile.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <errno.h>
+#include <stdint.h>
+#include <string.h>
+
+#include <nuttx/kmalloc.h>
+#include <nuttx/net/udp.h>
+
+#include "ipfilter/ipfilter.h"
+
+#ifdef CONFIG_NET_IPFILTER_COMPILE
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* The entries of a chain are first dispatched on the transport protocol,
+ * an entry is only evaluated for the protocols it may match.
+ */
+
+#define IPFILTER_CLASS_TCP    0
+#define IPFILTER_CLASS_UDP    1
+#define IPFILTER_CLASS_ICMP   2
+#define IPFILTER_CLASS_OTHER  3
+#define IPFILTER_CLASS_MAX    4
+
+/* The field that the entries of a hash set differ in */
+
+#define IPFILTER_KEY_NONE     0
+#define IPFILTER_KEY_DSTIP    1
+#define IPFILTER_KEY_SRCIP    2
+#define IPFILTER_KEY_DPORT    3
+#define IPFILTER_KEY_SPORT    4
+#define IPFILTER_KEY_MAX      5
+
+/* The largest hash set, the elements are indexed by 16 bits */
+
+#define IPFILTER_SET_MAXRULES UINT16_MAX
+#define IPFILTER_SET_MAXHASH  32768
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* The value of a hash set key */
+
+union ipfilter_key_u
+{
+#ifdef CONFIG_NET_IPv4
+  in_addr_t      ipv4;
+#endif
+#ifdef CONFIG_NET_IPv6
+  net_ipv6addr_t ipv6;
+#endif
+  uint16_t       port;
+  uint32_t       word[4];
+};
+
+/* A copy of an entry of either family */
+
+union ipfilter_copy_u
+{
+#ifdef CONFIG_NET_IPv4
+  struct ipv4_filter_entry_s ipv4;
+#endif
+#ifdef CONFIG_NET_IPv6
+  struct ipv6_filter_entry_s ipv6;
+#endif
+};
+
+/* An element of a hash set */
+
+struct ipfilter_elem_s
+{
+  FAR struct ipfilter_entry_s *entry; /* The entry of the element */
+  uint16_t next;                      /* Index + 1 of the next element in
+                                       * the bucket, 0 at the end */
+};
+
+/* A run of entries folded into a hash set */
+
+struct ipfilter_set_s
+{
+  FAR struct ipfilter_set_s *flink;   /* All sets of a compiled chain */
+  FAR struct ipfilter_entry_s *first; /* The first entry of the run */
+  FAR uint16_t *buckets;              /* Index + 1 of the first element */
+  uint16_t nrules;                    /* Entries of the run */
+  uint16_t mask;                      /* Number of buckets - 1 */
+  uint8_t  key;                       /* IPFILTER_KEY_* */
+  struct ipfilter_elem_s elems[1];    /* The elements, then the buckets */
+};
+
+/* One step of a compiled chain: a single entry or a hash set */
+
+struct ipfilter_insn_s
+{
+  FAR struct ipfilter_entry_s *entry;
+  FAR struct ipfilter_set_s *set;
+};
+
+struct ipfilter_prog_s
+{
+  FAR struct ipfilter_set_s *sets;    /* All sets, shared between classes */
+  sa_family_t family;
+  uint16_t start[IPFILTER_CLASS_MAX + 1]; /* First step of each class */
+  struct ipfilter_insn_s insn[1];
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: ipfilter_class
+ *
+ * Description:
+ *   Get the protocol class of a transport protocol.
+ *
+ ****************************************************************************/
+
+static int ipfilter_class(sa_family_t family, uint8_t proto)
+{
+  switch (proto)
+    {
+      case IP_PROTO_TCP:
+        return IPFILTER_CLASS_TCP;
+
+      case IP_PROTO_UDP:
+        return IPFILTER_CLASS_UDP;
+
+      case IP_PROTO_ICMP:
+        return family == PF_INET ? IPFILTER_CLASS_ICMP :
+                                   IPFILTER_CLASS_OTHER;
+
+      case IP_PROTO_ICMP6:
+        return family == PF_INET6 ? IPFILTER_CLASS_ICMP :
+                                    IPFILTER_CLASS_OTHER;
+
+      default:
+        return IPFILTER_CLASS_OTHER;
+    }
+}
+
+/****************************************************************************
+ * Name: ipfilter_class_match
+ *
+ * Description:
+ *   Check whether an entry may match the packets of a protocol class.
+ *
+ ****************************************************************************/
+
+static bool ipfilter_class_match(FAR const struct ipfilter_entry_s *entry,
+                                 sa_family_t family, int cls)
+{
+  if (entry->proto == 0)
+    {
+      return true;
+    }
+
+  if (cls == IPFILTER_CLASS_OTHER)
+    {
+      return entry->inv_proto ||
+             ipfilter_class(family, entry->proto) == IPFILTER_CLASS_OTHER;
+    }
+
+  return (ipfilter_class(family, entry->proto) == cls) ^ entry->inv_proto;
+}
+
+/****************************************************************************
+ * Name: ipfilter_entry_key
+ *
+ * Description:
+ *   Get the key of an entry, the unused bytes of the key are zero.
+ *
+ ****************************************************************************/
+
+static void ipfilter_entry_key(FAR const struct ipfilter_entry_s *entry,
+                               sa_family_t family, uint8_t key,
+                               FAR union ipfilter_key_u *value)
+{
+  memset(value, 0, sizeof(*value));
+
+  switch (key)
+    {
+      case IPFILTER_KEY_DSTIP:
+      case IPFILTER_KEY_SRCIP:
+#ifdef CONFIG_NET_IPv4
+        if (family == PF_INET)
+          {
+            FAR const struct ipv4_filter_entry_s *filter =
+              (FAR const struct ipv4_filter_entry_s *)entry;
+
+            value->ipv4 = key == IPFILTER_KEY_DSTIP ? filter->dip :
+                                                      filter->sip;
+          }
+#endif
+
+#ifdef CONFIG_NET_IPv6
+        if (family == PF_INET6)
+          {
+            FAR const struct ipv6_filter_entry_s *filter =
+              (FAR const struct ipv6_filter_entry_s *)entry;
+
+            net_ipv6addr_copy(value->ipv6, key == IPFILTER_KEY_DSTIP ?
+                                           filter->dip : filter->sip);
+          }
+#endif
+        break;
+
+      case IPFILTER_KEY_DPORT:
+        value->port = entry->match.tcpudp.dports[0];
+        break;
+
+      case IPFILTER_KEY_SPORT:
+        value->port = entry->match.tcpudp.sports[0];
+        break;
+    }
+}
+
+/****************************************************************************
+ * Name: ipfilter_packet_key
+ *
+ * Description:
+ *   Get the key of a packet, the unused bytes of the key are zero.
+ *
+ ****************************************************************************/
+
+static void ipfilter_packet_key(FAR const void *iphdr, FAR const void *l4hdr,
+                                sa_family_t family, uint8_t key,
+                                FAR union ipfilter_key_u *value)
+{
+  FAR const struct udp_hdr_s *udp = l4hdr;
+
+  memset(value, 0, sizeof(*value));
+
+  switch (key)
+    {
+      case IPFILTER_KEY_DSTIP:
+      case IPFILTER_KEY_SRCIP:
+#ifdef CONFIG_NET_IPv4
+        if (family == PF_INET)
+          {
+            FAR const struct ipv4_hdr_s *ipv4 = iphdr;
+            FAR const uint16_t *addr = key == IPFILTER_KEY_DSTIP ?
+                                       ipv4->destipaddr : ipv4->srcipaddr;
+
+            value->ipv4 = net_ip4addr_conv32(addr);
+          }
+#endif
+
+#ifdef CONFIG_NET_IPv6
+        if (family == PF_INET6)
+          {
+            FAR const struct ipv6_hdr_s *ipv6 = iphdr;
+
+            net_ipv6addr_copy(value->ipv6, key == IPFILTER_KEY_DSTIP ?
+                                           ipv6->destipaddr :
+                                           ipv6->srcipaddr);
+          }
+#endif
+        break;
+
+      /* Ports in TCP & UDP headers have same offset. */
+
+      case IPFILTER_KEY_DPORT:
+        value->port = NTOHS(udp->destport);
+        break;
+
+      case IPFILTER_KEY_SPORT:
+        value->port = NTOHS(udp->srcport);
+        break;
+    }
+}
+
+/****************************************************************************
+ * Name: ipfilter_hash
+ *
+ * Description:
+ *   Hash a key, all words are mixed so that addresses that only differ in
+ *   a few bits do not collide.
+ *
+ ****************************************************************************/
+
+static uint32_t ipfilter_hash(FAR const union ipfilter_key_u *value)
+{
+  uint32_t hash = value->word[0] ^ value->word[1] ^
+                  value->word[2] ^ value->word[3];
+
+  hash ^= hash >> 16;
+  hash *= 0x7feb352d;
+  hash ^= hash >> 15;
+  hash *= 0x846ca68b;
+  hash ^= hash >> 16;
+  return hash;
+}
+
+/****************************************************************************
+ * Name: ipfilter_keyable
+ *
+ * Description:
+ *   Check whether an entry of a protocol class only matches a single value
+ *   of key, so that it can be put into a hash set.
+ *
+ ****************************************************************************/
+
+static bool ipfilter_keyable(FAR const struct ipfilter_entry_s *entry,
+                             sa_family_t family, int cls, uint8_t key)
+{
+  switch (key)
+    {
+      case IPFILTER_KEY_DSTIP:
+      case IPFILTER_KEY_SRCIP:
+        if (key == IPFILTER_KEY_DSTIP ? entry->inv_dstip : entry->inv_srcip)
+          {
+            return false;
+          }
+
+#ifdef CONFIG_NET_IPv4
+        if (family == PF_INET)
+          {
+            FAR const struct ipv4_filter_entry_s *filter =
+              (FAR const struct ipv4_filter_entry_s *)entry;
+
+            return (key == IPFILTER_KEY_DSTIP ? filter->dmsk :
+                                                filter->smsk) == UINT32_MAX;
+          }
+#endif
+
+#ifdef CONFIG_NET_IPv6
+        if (family == PF_INET6)
+          {
+            FAR const struct ipv6_filter_entry_s *filter =
+              (FAR const struct ipv6_filter_entry_s *)entry;
+            FAR const uint16_t *mask = key == IPFILTER_KEY_DSTIP ?
+                                       filter->dmsk : filter->smsk;
+            int i;
+
+            for (i = 0; i < 8; i++)
+              {
+                if (mask[i] != 0xffff)
+                  {
+                    return false;
+                  }
+              }
+
+            return true;
+          }
+#endif
+
+        return false;
+
+      case IPFILTER_KEY_DPORT:
+      case IPFILTER_KEY_SPORT:
+
+        /* The ports are only matched if the protocol is matched and not
+         * inversed, see ipfilter_match_proto().
+         */
+
+        if ((cls != IPFILTER_CLASS_TCP && cls != IPFILTER_CLASS_UDP) ||
+            entry->proto == 0 || entry->inv_proto || !entry->match_tcpudp)
+          {
+            return false;
+          }
+
+        if (key == IPFILTER_KEY_DPORT)
+          {
+            return !entry->inv_dport && entry->match.tcpudp.dports[0] ==
+                                        entry->match.tcpudp.dports[1];
+          }
+
+        return !entry->inv_sport && entry->match.tcpudp.sports[0] ==
+                                    entry->match.tcpudp.sports[1];
+
+      default:
+        return false;
+    }
+}
+
+/****************************************************************************
+ * Name: ipfilter_canonical
+ *
+ * Description:
+ *   Copy an entry without its link, position, hit counters, the bits of the
+ *   addresses that are not matched and the field of key.  Two entries that
+ *   have the same canonical copy only differ in the value of key.
+ *
+ ****************************************************************************/
+
+static size_t ipfilter_canonical(FAR const struct ipfilter_entry_s *entry,
+                                 sa_family_t family, uint8_t key,
+                                 FAR void *copy)
+{
+  FAR struct ipfilter_entry_s *common = copy;
+  size_t size = 0;
+
+#ifdef CONFIG_NET_IPv4
+  if (family == PF_INET)
+    {
+      FAR struct ipv4_filter_entry_s *filter = copy;
+
+      size = sizeof(*filter);
+      memcpy(filter, entry, size);
+      filter->sip &= filter->smsk;
+      filter->dip &= filter->dmsk;
+
+      if (key == IPFILTER_KEY_DSTIP)
+        {
+          filter->dip = 0;
+        }
+      else if (key == IPFILTER_KEY_SRCIP)
+        {
+          filter->sip = 0;
+        }
+    }
+#endif
+
+#ifdef CONFIG_NET_IPv6
+  if (family == PF_INET6)
+    {
+      FAR struct ipv6_filter_entry_s *filter = copy;
+      int i;
+
+      size = sizeof(*filter);
+      memcpy(filter, entry, size);
+      for (i = 0; i < 8; i++)
+        {
+          filter->sip[i] &= filter->smsk[i];
+          filter->dip[i] &= filter->dmsk[i];
+        }
+
+      if (key == IPFILTER_KEY_DSTIP)
+        {
+          memset(filter->dip, 0, sizeof(filter->dip));
+        }
+      else if (key == IPFILTER_KEY_SRCIP)
+        {
+          memset(filter->sip, 0, sizeof(filter->sip));
+        }
+    }
+#endif
+
+  common->flink = NULL;
+  common->index = 0;
+  common->pcnt  = 0;
+  common->bcnt  = 0;
+
+  if (key == IPFILTER_KEY_DPORT)
+    {
+      common->match.tcpudp.dports[0] = 0;
+      common->match.tcpudp.dports[1] = 0;
+    }
+  else if (key == IPFILTER_KEY_SPORT)
+    {
+      common->match.tcpudp.sports[0] = 0;
+      common->match.tcpudp.sports[1] = 0;
+    }
+
+  return size;
+}
+
+/****************************************************************************
+ * Name: ipfilter_same_set
+ *
+ * Description:
+ *   Check whether two entries only differ in the value of key.  The
+ *   entries are allocated zeroed, so the padding compares equal.
+ *
+ ****************************************************************************/
+
+static bool ipfilter_same_set(FAR const struct ipfilter_entry_s *a,
+                              FAR const struct ipfilter_entry_s *b,
+                              sa_family_t family, uint8_t key)
+{
+  union ipfilter_copy_u ca;
+  union ipfilter_copy_u cb;
+  size_t size;
+
+  memset(&ca, 0, sizeof(ca));
+  memset(&cb, 0, sizeof(cb));
+
+  size = ipfilter_canonical(a, family, key, &ca);
+  ipfilter_canonical(b, family, key, &cb);
+  return memcmp(&ca, &cb, size) == 0;
+}
+
+/****************************************************************************
+ * Name: ipfilter_set_lookup
+ *
+ * Description:
+ *   Find the entry of a hash set with a key value.
+ *
+ ****************************************************************************/
+
+static FAR struct ipfilter_entry_s *
+ipfilter_set_lookup(FAR const struct ipfilter_set_s *set, sa_family_t family,
+                    FAR const union ipfilter_key_u *value)
+{
+  FAR const struct ipfilter_elem_s *elem;
+  union ipfilter_key_u ekey;
+  uint16_t index;
+
+  index = set->buckets[ipfilter_hash(value) & set->mask];
+  while (index != 0)
+    {
+      elem = &set->elems[index - 1];
+      ipfilter_entry_key(elem->entry, family, set->key, &ekey);
+      if (memcmp(&ekey, value, sizeof(ekey)) == 0)
+        {
+          return elem->entry;
+        }
+
+      index = elem->next;
+    }
+
+  return NULL;
+}
+
+/****************************************************************************
+ * Name: ipfilter_set_build
+ *
+ * Description:
+ *   Fold a run of entries into a hash set.  A set built for another
+ *   protocol class from the same run is shared.
+ *
+ ****************************************************************************/
+
+static FAR struct ipfilter_set_s *
+ipfilter_set_build(FAR struct ipfilter_prog_s *prog,
+                   FAR struct ipfilter_entry_s **rules, int nrules,
+                   uint8_t key)
+{
+  FAR struct ipfilter_set_s *set;
+  union ipfilter_key_u value;
+  uint32_t nbuckets = 1;
+  uint16_t nelems = 0;
+  uint32_t hash;
+  int i;
+
+  for (set = prog->sets; set != NULL; set = set->flink)
+    {
+      if (set->first == rules[0] && set->nrules == nrules &&
+          set->key == key)
+        {
+          return set;
+        }
+    }
+
+  while (nbuckets < 2 * nrules && nbuckets < IPFILTER_SET_MAXHASH)
+    {
+      nbuckets <<= 1;
+    }
+
+  set = kmm_zalloc(sizeof(*set) + sizeof(set->elems[0]) * (nrules - 1) +
+                   sizeof(set->buckets[0]) * nbuckets);
+  if (set == NULL)
+    {
+      return NULL;
+    }
+
+  set->first   = rules[0];
+  set->buckets = (FAR uint16_t *)&set->elems[nrules];
+  set->nrules  = nrules;
+  set->mask    = nbuckets - 1;
+  set->key     = key;
+
+  for (i = 0; i < nrules; i++)
+    {
+      /* Only the first entry with a value can match, like in the chain. */
+
+      ipfilter_entry_key(rules[i], prog->family, key, &value);
+      if (ipfilter_set_lookup(set, prog->family, &value) != NULL)
+        {
+          continue;
+        }
+
+      hash = ipfilter_hash(&value) & set->mask;
+      set->elems[nelems].entry = rules[i];
+      set->elems[nelems].next  = set->buckets[hash];
+      set->buckets[hash]       = ++nelems;
+    }
+
+  set->flink = prog->sets;
+  prog->sets = set;
+  return set;
+}
+
+/****************************************************************************
+ * Name: ipfilter_compile_class
+ *
+ * Description:
+ *   Compile the entries of a chain that may match a protocol class.  Only
+ *   count the steps if prog is NULL.
+ *
+ * Returned Value:
+ *   The number of steps after the class, -ENOMEM if a set could not be
+ *   allocated.
+ *
+ ****************************************************************************/
+
+static int ipfilter_compile_class(FAR struct ipfilter_prog_s *prog,
+                                  FAR const sq_queue_t *queue,
+                                  FAR struct ipfilter_entry_s **rules,
+                                  sa_family_t family, int cls, int ninsn)
+{
+  FAR sq_entry_t *entry;
+  uint8_t bestkey;
+  uint8_t key;
+  int nrules = 0;
+  int bestlen;
+  int i;
+  int j;
+
+  sq_for_every(queue, entry)
+    {
+      if (ipfilter_class_match((FAR struct ipfilter_entry_s *)entry,
+                               family, cls))
+        {
+          rules[nrules++] = (FAR struct ipfilter_entry_s *)entry;
+        }
+    }
+
+  for (i = 0; i < nrules; i += bestlen)
+    {
+      /* Find the key with the longest run of entries from rules[i] */
+
+      bestkey = IPFILTER_KEY_NONE;
+      bestlen = 1;
+
+      for (key = IPFILTER_KEY_NONE + 1; key < IPFILTER_KEY_MAX; key++)
+        {
+          if (!ipfilter_keyable(rules[i], family, cls, key))
+            {
+              continue;
+            }
+
+          for (j = i + 1; j < nrules && j - i < IPFILTER_SET_MAXRULES; j++)
+            {
+              if (!ipfilter_keyable(rules[j], family, cls, key) ||
+                  !ipfilter_same_set(rules[i], rules[j], family, key))
+                {
+                  break;
+                }
+            }
+
+          if (j - i > bestlen)
+            {
+              bestkey = key;
+              bestlen = j - i;
+            }
+        }
+
+      if (bestlen < CONFIG_NET_IPFILTER_SETMIN)
+        {
+          bestkey = IPFILTER_KEY_NONE;
+          bestlen = 1;
+        }
+
+      if (prog != NULL)
+        {
+          prog->insn[ninsn].entry = rules[i];
+          if (bestkey != IPFILTER_KEY_NONE)
+            {
+              prog->insn[ninsn].set = ipfilter_set_build(prog, &rules[i],
+                                                         bestlen, bestkey);
+              if (prog->insn[ninsn].set == NULL)
+                {
+                  return -ENOMEM;
+                }
+            }
+        }
+
+      ninsn++;
+    }
+
+  return ninsn;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: ipfilter_compile
+ *
+ * Description:
+ *   Compile a chain of filter entries.  The entries are dispatched on the
+ *   transport protocol, and runs of consecutive entries with the same
+ *   target that only differ in one exact address or port are folded into
+ *   a hash set.
+ *
+ * Input Parameters:
+ *   queue  - The filter entries of the chain
+ *   family - The address family of the filter entries
+ *
+ * Returned Value:
+ *   The compiled chain, NULL if there is not enough memory.
+ *
+ * Assumptions:
+ *   The entries are not modified or freed while the compiled chain is
+ *   used.
+ *
+ ****************************************************************************/
+
+FAR struct ipfilter_prog_s *ipfilter_compile(FAR const sq_queue_t *queue,
+                                             sa_family_t family)
+{
+  FAR struct ipfilter_entry_s **rules;
+  FAR struct ipfilter_prog_s *prog = NULL;
+  FAR sq_entry_t *entry;
+  int nrules = 0;
+  int ninsn = 0;
+  int cls;
+
+  sq_for_every(queue, entry)
+    {
+      nrules++;
+    }
+
+  rules = kmm_malloc(sizeof(*rules) * (nrules + 1));
+  if (rules == NULL)
+    {
+      return NULL;
+    }
+
+  /* Count the steps first, the compiled chain is a single allocation
+   * besides its sets.
+   */
+
+  for (cls = 0; cls < IPFILTER_CLASS_MAX; cls++)
+    {
+      ninsn = ipfilter_compile_class(NULL, queue, rules, family, cls,
+                                     ninsn);
+    }
+
+  if (ninsn > UINT16_MAX)
+    {
+      goto out;
+    }
+
+  prog = kmm_zalloc(sizeof(*prog) + sizeof(prog->insn[0]) * ninsn);
+  if (prog == NULL)
+    {
+      goto out;
+    }
+
+  prog->family = family;
+
+  for (ninsn = 0, cls = 0; cls < IPFILTER_CLASS_MAX; cls++)
+    {
+      prog->start[cls] = ninsn;
+      ninsn = ipfilter_compile_class(prog, queue, rules, family, cls,
+                                     ninsn);
+      if (ninsn < 0)
+        {
+          ipfilter_prog_free(prog);
+          prog = NULL;
+          goto out;
+        }
+    }
+
+  prog->start[IPFILTER_CLASS_MAX] = ninsn;
+
+out:
+  kmm_free(rules);
+  return prog;
+}
+
+/****************************************************************************
+ * Name: ipfilter_prog_free
+ *
+ * Description:
+ *   Free a chain compiled by ipfilter_compile().
+ *
+ ****************************************************************************/
+
+void ipfilter_prog_free(FAR struct ipfilter_prog_s *prog)
+{
+  FAR struct ipfilter_set_s *set;
+
+  while ((set = prog->sets) != NULL)
+    {
+      prog->sets = set->flink;
+      kmm_free(set);
+    }
+
+  kmm_free(prog);
+}
+
+/****************************************************************************
+ * Name: ipfilter_prog_eval
+ *
+ * Description:
+ *   Find the first filter entry of a compiled chain that matches a packet.
+ *
+ * Input Parameters:
+ *   prog   - The compiled chain
+ *   indev  - The network device that the packet comes from
+ *   outdev - The network device that the packet goes to
+ *   iphdr  - The IPv4 or IPv6 header, matching the family of prog
+ *   l4hdr  - The transport header
+ *   proto  - The transport protocol
+ *
+ * Returned Value:
+ *   The matched filter entry, NULL if no entry matches.
+ *
+ ****************************************************************************/
+
+FAR struct ipfilter_entry_s *
+ipfilter_prog_eval(FAR const struct ipfilter_prog_s *prog,
+                   FAR const struct net_driver_s *indev,
+                   FAR const struct net_driver_s *outdev,
+                   FAR const void *iphdr, FAR const void *l4hdr,
+                   uint8_t proto)
+{
+  FAR const struct ipfilter_insn_s *insn;
+  FAR struct ipfilter_entry_s *entry;
+  union ipfilter_key_u value;
+  int cls = ipfilter_class(prog->family, proto);
+  int i;
+
+  for (i = prog->start[cls]; i < prog->start[cls + 1]; i++)
+    {
+      insn  = &prog->insn[i];
+      entry = insn->entry;
+
+      /* A set can only match with the entry that has the key value of
+       * the packet, all entries of the set have the same other fields.
+       */
+
+      if (insn->set != NULL)
+        {
+          ipfilter_packet_key(iphdr, l4hdr, prog->family, insn->set->key,
+                              &value);
+          entry = ipfilter_set_lookup(insn->set, prog->family, &value);
+          if (entry == NULL)
+            {
+              continue;
+            }
+        }
+
+#ifdef CONFIG_NET_IPv4
+      if (prog->family == PF_INET &&
+          ipv4_filter_match_entry((FAR struct ipv4_filter_entry_s *)entry,
+                                  indev, outdev, iphdr, l4hdr))
+        {
+          return entry;
+        }
+#endif
+
+#ifdef CONFIG_NET_IPv6
+      if (prog->family == PF_INET6 &&
+          ipv6_filter_match_entry((FAR struct ipv6_filter_entry_s *)entry,
+                                  indev, outdev, iphdr, l4hdr, proto))
+        {
+          return entry;
+        }
+#endif
+    }
+
+  return NULL;
+}
+
+#endif /* CONFIG_NET_IPFILTER_COMPILE */
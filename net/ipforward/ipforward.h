@@ -368,5 +368,78 @@ void ipv4_dropstats(FAR struct ipv4_hdr_s *ipv4);
 #  define ipv4_dropstats(ipv4)
 #endif
 
+/****************************************************************************
+ * Name: ipv4_flow_forward
+ *
+ * Description:
+ *   This function is called from ipv4_input before NAT for every packet
+ *   that is not a fragment.  If the packet belongs to an established TCP
+ *   or UDP flow, it is forwarded with the decision cached from the full
+ *   path: the forwarding device, the NAT rewrites and the TTL decrement.
+ *
+ * Input Parameters:
+ *   dev   - The device on which the packet was received and which contains
+ *           the IPv4 packet.
+ *   ipv4  - A convenience pointer to the IPv4 header in within the IPv4
+ *           packet
+ *
+ * Returned Value:
+ *   Zero is returned if the packet was forwarded; -ENOENT is returned if
+ *   the packet must take the full path.  Any other negated errno value
+ *   means that the packet must be dropped.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_IPFORWARD_FLOWTABLE
+int ipv4_flow_forward(FAR struct net_driver_s *dev,
+                      FAR struct ipv4_hdr_s *ipv4);
+#endif
+
+/****************************************************************************
+ * Name: ipv4_flow_learn
+ *
+ * Description:
+ *   Cache the decision of the full path for the packet that just missed
+ *   in ipv4_flow_forward().  Called by ipv4_forward once the packet is
+ *   ready to be sent on fwddev.
+ *
+ * Input Parameters:
+ *   dev    - The device on which the packet was received
+ *   fwddev - The device on which the packet is forwarded
+ *   ipv4   - A pointer to the IPv4 header, after NAT and the TTL decrement
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_IPFORWARD_FLOWTABLE
+void ipv4_flow_learn(FAR struct net_driver_s *dev,
+                     FAR struct net_driver_s *fwddev,
+                     FAR const struct ipv4_hdr_s *ipv4);
+#else
+#  define ipv4_flow_learn(dev, fwddev, ipv4)
+#endif
+
 #endif /* CONFIG_NET_IPFORWARD */
+
+/****************************************************************************
+ * Name: ipfwd_flow_flush
+ *
+ * Description:
+ *   Forget all the flows cached by ipv4_flow_forward().  This must be
+ *   called whenever the result of the full path may change: routes, filter
+ *   rules, NAT mappings, device addresses or devices.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_IPFORWARD_FLOWTABLE
+void ipfwd_flow_flush(void);
+#else
+#  define ipfwd_flow_flush()
+#endif
+
 #endif /* __NET_IPFORWARD_IPFORWARD_H */
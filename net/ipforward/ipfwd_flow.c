@@ -0,0 +1,470 @@
+/****************************************************************************
+ * net/ipforward/ipfwd_flow.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <string.h>
+#include <assert.h>
+#include <debug.h>
+#include <errno.h>
+
+#include <netinet/in.h>
+
+#include <nuttx/clock.h>
+#include <nuttx/net/ip.h>
+#include <nuttx/net/tcp.h>
+#include <nuttx/net/udp.h>
+#include <nuttx/net/netdev.h>
+#include <nuttx/net/netstats.h>
+
+#include "netdev/netdev.h"
+#include "utils/utils.h"
+#include "ipforward/ipforward.h"
+
+#ifdef CONFIG_NET_IPFORWARD_FLOWTABLE
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define FLOW_TIMEOUT SEC2TICK(CONFIG_NET_IPFORWARD_FLOW_TIMEOUT)
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* The 5-tuple of a packet as it is received, before any NAT */
+
+struct ipv4_flowkey_s
+{
+  FAR struct net_driver_s *dev;    /* Receiving device, NULL if unused */
+  in_addr_t                srcip;  /* Source address */
+  in_addr_t                dstip;  /* Destination address */
+  uint16_t                 sport;  /* Source port (network order) */
+  uint16_t                 dport;  /* Destination port (network order) */
+  uint8_t                  proto;  /* IP_PROTO_TCP or IP_PROTO_UDP */
+};
+
+/* A cached forwarding decision: the outgoing device and the 5-tuple after
+ * the NAT rewrites of the full path.
+ */
+
+struct ipv4_flow_s
+{
+  struct ipv4_flowkey_s    key;    /* The tuple as received */
+  FAR struct net_driver_s *fwddev; /* The forwarding device */
+  clock_t                  expire; /* The full path must run again here */
+  in_addr_t                srcip;  /* Source address as forwarded */
+  in_addr_t                dstip;  /* Destination address as forwarded */
+  uint16_t                 sport;  /* Source port as forwarded */
+  uint16_t                 dport;  /* Destination port as forwarded */
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* The flow table, direct mapped: a new flow replaces the one in its slot */
+
+static struct ipv4_flow_s g_ipv4_flows[CONFIG_NET_IPFORWARD_FLOWS];
+
+/* The key of the packet that missed the flow table and is now taking the
+ * full path.  It is only valid while the network is locked.
+ */
+
+static struct ipv4_flowkey_s g_ipv4_pending;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: ipv4_flow_slot
+ *
+ * Description:
+ *   Return the slot of the flow table used by key.
+ *
+ ****************************************************************************/
+
+static FAR struct ipv4_flow_s *
+ipv4_flow_slot(FAR const struct ipv4_flowkey_s *key)
+{
+  uint32_t hash;
+
+  hash  = key->srcip ^ (key->dstip * 0x9e3779b1u) ^ key->proto;
+  hash ^= ((uint32_t)key->sport << 16 | key->dport) * 0x85ebca6bu;
+  hash ^= (uint32_t)(uintptr_t)key->dev;
+  hash ^= hash >> 16;
+  hash *= 0x7feb352du;
+  hash ^= hash >> 15;
+
+  return &g_ipv4_flows[hash % CONFIG_NET_IPFORWARD_FLOWS];
+}
+
+/****************************************************************************
+ * Name: ipv4_flow_keycmp
+ *
+ * Description:
+ *   Return true if the two keys are the same.
+ *
+ ****************************************************************************/
+
+static inline bool ipv4_flow_keycmp(FAR const struct ipv4_flowkey_s *key1,
+                                    FAR const struct ipv4_flowkey_s *key2)
+{
+  return key1->dev == key2->dev && key1->srcip == key2->srcip &&
+         key1->dstip == key2->dstip && key1->sport == key2->sport &&
+         key1->dport == key2->dport && key1->proto == key2->proto;
+}
+
+/****************************************************************************
+ * Name: ipv4_flow_key
+ *
+ * Description:
+ *   Build the flow key of a received packet.
+ *
+ * Returned Value:
+ *   OK if the packet may use the flow table; -ENOENT if it must take the
+ *   full path; -ESHUTDOWN if it ends a TCP connection, in which case its
+ *   flow must be forgotten.
+ *
+ ****************************************************************************/
+
+static int ipv4_flow_key(FAR struct net_driver_s *dev,
+                         FAR struct ipv4_hdr_s *ipv4,
+                         FAR struct ipv4_flowkey_s *key)
+{
+  FAR struct tcp_hdr_s *tcp;
+  in_addr_t dstip;
+
+  /* Only unicast TCP and UDP without IP options are cached */
+
+  if (ipv4->vhl != 0x45)
+    {
+      return -ENOENT;
+    }
+
+  dstip = net_ip4addr_conv32(ipv4->destipaddr);
+  if (IN_MULTICAST(NTOHL(dstip)) ||
+      net_ipv4addr_cmp(dstip, INADDR_BROADCAST) ||
+      (net_ipv4addr_maskcmp(dstip, dev->d_ipaddr, dev->d_netmask) &&
+       net_ipv4addr_broadcast(dstip, dev->d_netmask)))
+    {
+      return -ENOENT;
+    }
+
+  switch (ipv4->proto)
+    {
+#ifdef CONFIG_NET_TCP
+      case IP_PROTO_TCP:
+        if (dev->d_len < IPv4_HDRLEN + TCP_HDRLEN)
+          {
+            return -ENOENT;
+          }
+        break;
+#endif
+
+#ifdef CONFIG_NET_UDP
+      case IP_PROTO_UDP:
+        if (dev->d_len < IPv4_HDRLEN + UDP_HDRLEN)
+          {
+            return -ENOENT;
+          }
+        break;
+#endif
+
+      default:
+        return -ENOENT;
+    }
+
+  /* The ports are at the same place in the TCP and UDP headers */
+
+  tcp        = (FAR struct tcp_hdr_s *)(ipv4 + 1);
+  key->dev   = dev;
+  key->srcip = net_ip4addr_conv32(ipv4->srcipaddr);
+  key->dstip = dstip;
+  key->sport = tcp->srcport;
+  key->dport = tcp->destport;
+  key->proto = ipv4->proto;
+
+  /* Connection setup and teardown always take the full path */
+
+  if (ipv4->proto == IP_PROTO_TCP &&
+      (tcp->flags & (TCP_SYN | TCP_FIN | TCP_RST)) != 0)
+    {
+      return -ESHUTDOWN;
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: ipv4_flow_rewrite
+ *
+ * Description:
+ *   Decrement the TTL and apply the NAT rewrites of flow to the packet,
+ *   adjusting the checksums incrementally.
+ *
+ ****************************************************************************/
+
+static void ipv4_flow_rewrite(FAR struct ipv4_flow_s *flow,
+                              FAR struct ipv4_hdr_s *ipv4)
+{
+  FAR struct tcp_hdr_s *tcp = (FAR struct tcp_hdr_s *)(ipv4 + 1);
+  FAR uint16_t *ttlproto = (FAR uint16_t *)&ipv4->ttl;
+  FAR uint16_t *l4chksum = NULL;
+  uint16_t oldval = *ttlproto;
+
+  ipv4->ttl--;
+  net_chksum_adjust(&ipv4->ipchksum, &oldval, 2, ttlproto, 2);
+
+  if (flow->srcip == flow->key.srcip && flow->dstip == flow->key.dstip &&
+      flow->sport == flow->key.sport && flow->dport == flow->key.dport)
+    {
+      return;
+    }
+
+  if (ipv4->proto == IP_PROTO_TCP)
+    {
+      l4chksum = &tcp->tcpchksum;
+    }
+  else if (((FAR struct udp_hdr_s *)tcp)->udpchksum != 0)
+    {
+      l4chksum = &((FAR struct udp_hdr_s *)tcp)->udpchksum;
+    }
+
+  if (flow->srcip != flow->key.srcip)
+    {
+      if (l4chksum != NULL)
+        {
+          net_chksum_adjust(l4chksum, ipv4->srcipaddr, 4,
+                            (FAR uint16_t *)&flow->srcip, 4);
+        }
+
+      net_chksum_adjust(&ipv4->ipchksum, ipv4->srcipaddr, 4,
+                        (FAR uint16_t *)&flow->srcip, 4);
+      net_ipv4addr_hdrcopy(ipv4->srcipaddr, &flow->srcip);
+    }
+
+  if (flow->dstip != flow->key.dstip)
+    {
+      if (l4chksum != NULL)
+        {
+          net_chksum_adjust(l4chksum, ipv4->destipaddr, 4,
+                            (FAR uint16_t *)&flow->dstip, 4);
+        }
+
+      net_chksum_adjust(&ipv4->ipchksum, ipv4->destipaddr, 4,
+                        (FAR uint16_t *)&flow->dstip, 4);
+      net_ipv4addr_hdrcopy(ipv4->destipaddr, &flow->dstip);
+    }
+
+  /* Both ports are rewritten at once, dport follows sport in the flow */
+
+  if (l4chksum != NULL)
+    {
+      net_chksum_adjust(l4chksum, &tcp->srcport, 4, &flow->sport, 4);
+    }
+
+  tcp->srcport  = flow->sport;
+  tcp->destport = flow->dport;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: ipv4_flow_forward
+ *
+ * Description:
+ *   Look up a received packet in the flow table and, if it belongs to an
+ *   established flow, forward it with the cached decision of the full
+ *   path.
+ *
+ * Input Parameters:
+ *   dev   - The device on which the packet was received
+ *   ipv4  - A pointer to the IPv4 header of the packet, before NAT
+ *
+ * Returned Value:
+ *   OK if the packet was forwarded; -ENOENT if it must take the full path;
+ *   any other negated errno value if the packet must be dropped.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+int ipv4_flow_forward(FAR struct net_driver_s *dev,
+                      FAR struct ipv4_hdr_s *ipv4)
+{
+  FAR struct ipv4_flow_s *flow;
+  FAR struct forward_s *fwd;
+  struct ipv4_flowkey_s key;
+  int ret;
+
+  g_ipv4_pending.dev = NULL;
+
+  ret = ipv4_flow_key(dev, ipv4, &key);
+  if (ret == -ENOENT)
+    {
+      return ret;
+    }
+
+  flow = ipv4_flow_slot(&key);
+  if (!ipv4_flow_keycmp(&flow->key, &key))
+    {
+      goto miss;
+    }
+
+  if (ret < 0 || clock_compare(flow->expire, clock_systime_ticks()))
+    {
+      flow->key.dev = NULL;
+      goto miss;
+    }
+
+  /* Leave whatever the full path reports to it: a device that went down,
+   * an expired TTL, a packet too big to be forwarded.
+   */
+
+  if (!IFF_IS_UP(flow->fwddev->d_flags) || ipv4->ttl <= 1 ||
+      (NET_LL_HDRLEN(flow->fwddev) + dev->d_len >
+       NETDEV_PKTSIZE(flow->fwddev)
+#ifdef CONFIG_NET_IPFRAG
+       && (ipv4->ipoffset[0] & (IP_FLAG_DONTFRAG >> 8))
+#endif
+      ))
+    {
+      return -ENOENT;
+    }
+
+  fwd = ipfwd_alloc();
+  if (fwd == NULL)
+    {
+      return -ENOENT;
+    }
+
+  fwd->f_dev    = flow->fwddev;
+#ifdef CONFIG_NET_IPv6
+  fwd->f_domain = PF_INET;
+#endif
+  fwd->f_iob    = dev->d_iob;
+
+  ipv4_flow_rewrite(flow, ipv4);
+
+  ret = ipfwd_forward(fwd);
+  if (ret < 0)
+    {
+      nwarn("WARNING: ipfwd_forward failed: %d\n", ret);
+      ipfwd_free(fwd);
+      return ret;
+    }
+
+  netdev_iob_clear(dev);
+
+#ifdef CONFIG_NET_STATISTICS
+  g_netstats.ipv4.flowhit++;
+#endif
+
+  return OK;
+
+miss:
+#ifdef CONFIG_NET_STATISTICS
+  g_netstats.ipv4.flowmiss++;
+#endif
+
+  /* Let ipv4_flow_learn() cache the result of the full path */
+
+  if (ret == OK)
+    {
+      g_ipv4_pending = key;
+    }
+
+  return -ENOENT;
+}
+
+/****************************************************************************
+ * Name: ipv4_flow_learn
+ *
+ * Description:
+ *   Cache the forwarding decision of the full path for the packet that
+ *   just missed the flow table.
+ *
+ * Input Parameters:
+ *   dev    - The device on which the packet was received
+ *   fwddev - The device on which the packet is forwarded
+ *   ipv4   - A pointer to the IPv4 header of the packet, after NAT and the
+ *            TTL decrement
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+void ipv4_flow_learn(FAR struct net_driver_s *dev,
+                     FAR struct net_driver_s *fwddev,
+                     FAR const struct ipv4_hdr_s *ipv4)
+{
+  FAR const struct tcp_hdr_s *tcp;
+  FAR struct ipv4_flow_s *flow;
+
+  if (g_ipv4_pending.dev != dev)
+    {
+      return;
+    }
+
+  tcp          = (FAR const struct tcp_hdr_s *)(ipv4 + 1);
+  flow         = ipv4_flow_slot(&g_ipv4_pending);
+  flow->key    = g_ipv4_pending;
+  flow->fwddev = fwddev;
+  flow->expire = clock_systime_ticks() + FLOW_TIMEOUT;
+  flow->srcip  = net_ip4addr_conv32(ipv4->srcipaddr);
+  flow->dstip  = net_ip4addr_conv32(ipv4->destipaddr);
+  flow->sport  = tcp->srcport;
+  flow->dport  = tcp->destport;
+
+  g_ipv4_pending.dev = NULL;
+}
+
+/****************************************************************************
+ * Name: ipfwd_flow_flush
+ *
+ * Description:
+ *   Forget all the cached flows.  Called when a route, a filter rule, a
+ *   NAT mapping or a device address changes.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+void ipfwd_flow_flush(void)
+{
+  memset(g_ipv4_flows, 0, sizeof(g_ipv4_flows));
+  g_ipv4_pending.dev = NULL;
+}
+
+#endif /* CONFIG_NET_IPFORWARD_FLOWTABLE */
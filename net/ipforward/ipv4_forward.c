@@ -321,6 +321,10 @@ static int ipv4_dev_forward(FAR struct net_driver_s *dev,
     }
 #endif
 
+  /* The packet is ready to go, let the flow table remember how */
+
+  ipv4_flow_learn(dev, fwddev, ipv4);
+
   /* Then set up to forward the packet according to the protocol. */
 
   ret = ipfwd_forward(fwd);
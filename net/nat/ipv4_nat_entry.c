@@ -34,6 +34,7 @@
 #include <nuttx/kmalloc.h>
 #include <nuttx/nuttx.h>
 
+#include "ipforward/ipforward.h"
 #include "nat/nat.h"
 #include "netlink/netlink.h"
 
@@ -186,6 +187,9 @@ static void ipv4_nat_entry_delete(FAR ipv4_nat_entry_t *entry)
   netlink_conntrack_notify(IPCTNL_MSG_CT_DELETE, PF_INET, entry);
 #endif
 
+  /* The flow table may still hold the rewrites of this entry */
+
+  ipfwd_flow_flush();
   kmm_free(entry);
 }
 
@@ -31,6 +31,7 @@
 #include "icmp/icmp.h"
 #include "icmpv6/icmpv6.h"
 #include "inet/inet.h"
+#include "ipforward/ipforward.h"
 #include "nat/nat.h"
 #include "tcp/tcp.h"
 #include "udp/udp.h"
@@ -118,6 +119,7 @@ int nat_enable(FAR struct net_driver_s *dev)
     }
 
   IFF_SET_NAT(dev->d_flags);
+  ipfwd_flow_flush();
 
   net_unlock();
   return OK;
@@ -159,6 +161,7 @@ int nat_disable(FAR struct net_driver_s *dev)
 #endif
 
   IFF_CLR_NAT(dev->d_flags);
+  ipfwd_flow_flush();
 
   net_unlock();
   return OK;
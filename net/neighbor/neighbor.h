@@ -38,6 +38,20 @@
 
 #ifdef CONFIG_NET_IPv6
 
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Two entries per hash chain on average when the table is full */
+
+#define NEIGHBOR_NHASH ((CONFIG_NET_IPv6_NCONF_ENTRIES + 1) / 2)
+
+/* Return the head of the hash chain of an IPv6 address */
+
+#define neighbor_hash(ipaddr) \
+  (&g_neighbor_hash[((ipaddr)[5] ^ (ipaddr)[6] ^ (ipaddr)[7]) % \
+                    NEIGHBOR_NHASH])
+
 /****************************************************************************
  * Public Data
  ****************************************************************************/
@@ -48,6 +62,16 @@
 
 extern struct neighbor_entry_s g_neighbors[CONFIG_NET_IPv6_NCONF_ENTRIES];
 
+/* The Neighbor table entries chained by the hash of their IPv6 address.
+ * g_neighbor_hash holds the index plus one of the first entry of each
+ * chain and g_neighbor_next that of the entry following each entry, zero
+ * ending the chain.  The links are kept out of struct neighbor_entry_s as
+ * it is also the record returned by netlink.
+ */
+
+extern uint16_t g_neighbor_hash[NEIGHBOR_NHASH];
+extern uint16_t g_neighbor_next[CONFIG_NET_IPv6_NCONF_ENTRIES];
+
 /****************************************************************************
  * Public Function Prototypes
  ****************************************************************************/
@@ -41,6 +41,36 @@
 #include "netlink/netlink.h"
 #include "neighbor/neighbor.h"
 
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: neighbor_hash_remove
+ *
+ * Description:
+ *   Remove an entry from the hash chain of its IPv6 address, if it is
+ *   there.
+ *
+ ****************************************************************************/
+
+static void neighbor_hash_remove(int ndx)
+{
+  FAR uint16_t *next = neighbor_hash(g_neighbors[ndx].ne_ipaddr);
+
+  while (*next != 0)
+    {
+      if (*next == ndx + 1)
+        {
+          *next = g_neighbor_next[ndx];
+          g_neighbor_next[ndx] = 0;
+          break;
+        }
+
+      next = &g_neighbor_next[*next - 1];
+    }
+}
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -65,6 +95,7 @@
 void neighbor_add(FAR struct net_driver_s *dev, FAR net_ipv6addr_t ipaddr,
                   FAR uint8_t *addr)
 {
+  FAR uint16_t *hash = neighbor_hash(ipaddr);
   uint8_t lltype;
   clock_t oldest_time;
   int     oldest_ndx;
@@ -74,17 +105,11 @@ void neighbor_add(FAR struct net_driver_s *dev, FAR net_ipv6addr_t ipaddr,
 
   DEBUGASSERT(dev != NULL && addr != NULL);
 
-  /* Find the matching entry, first unused entry, or the oldest used entry.
-   * The unused entry will have ne_time == 0 and should generate the oldest
-   * time.  REVISIT:  Could this fail on clock wraparound?  A more explicit
-   * check might be to compare ne_ipaddr with the IPv6 unspecified address.
-   */
+  /* Find the matching entry in the hash chain of the address */
 
-  oldest_time = g_neighbors[0].ne_time;
-  oldest_ndx  = 0;
-  lltype      = dev->d_lltype;
+  lltype = dev->d_lltype;
 
-  for (i = 0; i < CONFIG_NET_IPv6_NCONF_ENTRIES; ++i)
+  for (i = *hash - 1; i >= 0; i = g_neighbor_next[i] - 1)
     {
       if (g_neighbors[i].ne_addr.na_lltype == lltype &&
           net_ipv6addr_cmp(g_neighbors[i].ne_ipaddr, ipaddr))
@@ -93,12 +118,33 @@ void neighbor_add(FAR struct net_driver_s *dev, FAR net_ipv6addr_t ipaddr,
           found = true;
           break;
         }
+    }
+
+  /* Else find the first unused entry, or the oldest used entry.  The
+   * unused entry will have ne_time == 0 and should generate the oldest
+   * time.  REVISIT:  Could this fail on clock wraparound?  A more explicit
+   * check might be to compare ne_ipaddr with the IPv6 unspecified address.
+   */
+
+  if (!found)
+    {
+      oldest_time = g_neighbors[0].ne_time;
+      oldest_ndx  = 0;
 
-      if ((int)(g_neighbors[i].ne_time - oldest_time) < 0)
+      for (i = 1; i < CONFIG_NET_IPv6_NCONF_ENTRIES; ++i)
         {
-          oldest_ndx = i;
-          oldest_time = g_neighbors[i].ne_time;
+          if ((int)(g_neighbors[i].ne_time - oldest_time) < 0)
+            {
+              oldest_ndx = i;
+              oldest_time = g_neighbors[i].ne_time;
+            }
         }
+
+      /* Move the entry to the hash chain of its new address */
+
+      neighbor_hash_remove(oldest_ndx);
+      g_neighbor_next[oldest_ndx] = *hash;
+      *hash = oldest_ndx + 1;
     }
 
   /* When overwite old entry, need to notify RTM_DELNEIGH */
@@ -53,11 +53,12 @@
 
 FAR struct neighbor_entry_s *neighbor_findentry(const net_ipv6addr_t ipaddr)
 {
-  int i;
+  uint16_t index;
 
-  for (i = 0; i < CONFIG_NET_IPv6_NCONF_ENTRIES; ++i)
+  for (index = *neighbor_hash(ipaddr); index != 0;
+       index = g_neighbor_next[index - 1])
     {
-      FAR struct neighbor_entry_s *neighbor = &g_neighbors[i];
+      FAR struct neighbor_entry_s *neighbor = &g_neighbors[index - 1];
 
       if (net_ipv6addr_cmp(neighbor->ne_ipaddr, ipaddr))
         {
@@ -38,6 +38,11 @@
 
 struct neighbor_entry_s g_neighbors[CONFIG_NET_IPv6_NCONF_ENTRIES];
 
+/* The hash chains of the Neighbor table */
+
+uint16_t g_neighbor_hash[NEIGHBOR_NHASH];
+uint16_t g_neighbor_next[CONFIG_NET_IPv6_NCONF_ENTRIES];
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
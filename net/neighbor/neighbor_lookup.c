@@ -32,6 +32,7 @@
 
 #include <nuttx/net/ip.h>
 #include <nuttx/net/neighbor.h>
+#include <nuttx/net/netstats.h>
 
 #include "netdev/netdev.h"
 #include "neighbor/neighbor.h"
@@ -132,6 +133,10 @@ int neighbor_lookup(FAR const net_ipv6addr_t ipaddr,
           memcpy(laddr, &neighbor->ne_addr, sizeof(*laddr));
         }
 
+#ifdef CONFIG_NET_STATISTICS
+      g_netstats.ipv6.nbhit++;
+#endif
+
       /* Return success in any case meaning that a valid link layer
        * address mapping is available for the IPv6 address.
        */
@@ -154,5 +159,9 @@ int neighbor_lookup(FAR const net_ipv6addr_t ipaddr,
 
   /* Not found */
 
+#ifdef CONFIG_NET_STATISTICS
+  g_netstats.ipv6.nbmiss++;
+#endif
+
   return -ENOENT;
 }
@@ -89,6 +89,10 @@ struct net_driver_s; /* Forward reference */
 typedef int (*netdev_callback_t)(FAR struct net_driver_s *dev,
                                  FAR void *arg);
 
+/* Tells netdev_busypoll() to stop */
+
+typedef bool (*netdev_busypoll_ready_t)(FAR void *arg);
+
 /****************************************************************************
  * Public Function Prototypes
  ****************************************************************************/
@@ -533,6 +537,29 @@ void netdev_notify_recvcpu(FAR struct net_driver_s *dev,
                            FAR const void *dst_addr, uint16_t dst_port);
 #endif
 
+/****************************************************************************
+ * Name: netdev_busypoll
+ *
+ * Description:
+ *   Receive from the device (all of the devices if NULL) in the context of
+ *   the caller, until ready(arg) returns true or usec microseconds have
+ *   elapsed.  netdev_busypoll_sem() is ready once the semaphore passed as
+ *   arg has been posted.
+ *
+ * Returned Value:
+ *   True if ready() returned true.
+ *
+ * Assumptions:
+ *   The caller has locked the network, it is unlocked between two polls.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_BUSY_POLL
+bool netdev_busypoll(FAR struct net_driver_s *dev, unsigned int usec,
+                     netdev_busypoll_ready_t ready, FAR void *arg);
+bool netdev_busypoll_sem(FAR void *arg);
+#endif
+
 #undef EXTERN
 #ifdef __cplusplus
 }
@@ -0,0 +1,148 @@
+/****************************************************************************
+ * net/netdev/netdev_busypoll.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include <nuttx/clock.h>
+#include <nuttx/semaphore.h>
+#include <nuttx/net/net.h>
+#include <nuttx/net/netdev.h>
+
+#include "netdev/netdev.h"
+#include "utils/utils.h"
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: netdev_busypoll_dev
+ *
+ * Description:
+ *   Receive from one device, if it is up and supports busy polling.
+ *
+ ****************************************************************************/
+
+static int netdev_busypoll_dev(FAR struct net_driver_s *dev, FAR void *arg)
+{
+  if (dev->d_busypoll != NULL && IFF_IS_UP(dev->d_flags))
+    {
+      dev->d_busypoll(dev, CONFIG_NET_BUSY_POLL_BUDGET);
+    }
+
+  return 0;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: netdev_busypoll
+ *
+ * Description:
+ *   Receive from the device in the context of the caller until ready()
+ *   returns true or usec microseconds have elapsed.  The network is
+ *   unlocked between two polls.
+ *
+ * Input Parameters:
+ *   dev   - The device to poll, all of the devices if NULL
+ *   usec  - The busy poll time of the socket
+ *   ready - Tells if the caller has something to do
+ *   arg   - The argument of ready()
+ *
+ * Returned Value:
+ *   True if ready() returned true.
+ *
+ * Assumptions:
+ *   The caller has locked the network.
+ *
+ ****************************************************************************/
+
+bool netdev_busypoll(FAR struct net_driver_s *dev, unsigned int usec,
+                     netdev_busypoll_ready_t ready, FAR void *arg)
+{
+  unsigned long freq = perf_getfreq();
+  clock_t start = perf_gettime();
+  clock_t limit;
+
+  if (usec == 0)
+    {
+      return false;
+    }
+
+  limit = (clock_t)((uint64_t)usec * freq / USEC_PER_SEC);
+
+  for (; ; )
+    {
+      if (dev == NULL)
+        {
+          netdev_foreach(netdev_busypoll_dev, NULL);
+        }
+      else if (netdev_verify(dev))
+        {
+          netdev_busypoll_dev(dev, NULL);
+        }
+      else
+        {
+          return false;
+        }
+
+      if (ready(arg))
+        {
+          return true;
+        }
+
+      if (perf_gettime() - start >= limit)
+        {
+          return false;
+        }
+
+      /* Let the other threads have the network */
+
+      net_unlock();
+      net_lock();
+    }
+}
+
+/****************************************************************************
+ * Name: netdev_busypoll_sem
+ *
+ * Description:
+ *   A ready() function for netdev_busypoll(): true once the semaphore the
+ *   caller is about to wait on has been posted.
+ *
+ ****************************************************************************/
+
+bool netdev_busypoll_sem(FAR void *arg)
+{
+  int semcount;
+
+  return nxsem_get_value(arg, &semcount) == OK && semcount > 0;
+}
@@ -83,6 +83,13 @@ int netdev_iob_prepare(FAR struct net_driver_s *dev, bool throttled,
 
   dev->d_buf = NETLLBUF;
 
+#ifdef CONFIG_NET_CHKSUM_COPY
+  dev->d_sndsumlen = 0;
+#endif
+#ifdef CONFIG_NETDEV_GSO
+  dev->d_gsosize = 0;
+#endif
+
   return OK;
 }
 
@@ -167,6 +174,13 @@ void netdev_iob_clear(FAR struct net_driver_s *dev)
   dev->d_iob = NULL;
   dev->d_buf = NULL;
   dev->d_len = 0;
+
+#ifdef CONFIG_NET_CHKSUM_COPY
+  dev->d_sndsumlen = 0;
+#endif
+#ifdef CONFIG_NETDEV_GSO
+  dev->d_gsosize = 0;
+#endif
 }
 
 /****************************************************************************
@@ -191,6 +205,13 @@ void netdev_iob_release(FAR struct net_driver_s *dev)
     }
 
   dev->d_buf = NULL;
+
+#ifdef CONFIG_NET_CHKSUM_COPY
+  dev->d_sndsumlen = 0;
+#endif
+#ifdef CONFIG_NETDEV_GSO
+  dev->d_gsosize = 0;
+#endif
 }
 
 /****************************************************************************
@@ -83,6 +83,7 @@
 #include "devif/devif.h"
 #include "igmp/igmp.h"
 #include "icmpv6/icmpv6.h"
+#include "ipforward/ipforward.h"
 #include "route/route.h"
 #include "netlink/netlink.h"
 #include "utils/utils.h"
@@ -343,6 +344,10 @@ static void ioctl_set_ipv4addr(FAR in_addr_t *outaddr,
 {
   FAR const struct sockaddr_in *src = (FAR const struct sockaddr_in *)inaddr;
   *outaddr = src->sin_addr.s_addr;
+
+  /* The forwarding decisions may depend on the old address */
+
+  ipfwd_flow_flush();
 }
 #endif
 
@@ -1124,6 +1129,7 @@ static int netdev_ifr_ioctl(FAR struct socket *psock, int cmd,
             netlink_device_notify_ipaddr(dev, RTM_DELADDR, AF_INET,
                          &dev->d_ipaddr, net_ipv4_mask2pref(dev->d_netmask));
             dev->d_ipaddr = 0;
+            ipfwd_flow_flush();
           }
 #endif
 
@@ -1962,6 +1968,10 @@ int netdev_ifup(FAR struct net_driver_s *dev)
 
               dev->d_flags |= IFF_UP;
 
+              /* Its network may now be preferred to a route */
+
+              ipfwd_flow_flush();
+
               /* Update the driver status */
 
               netlink_device_notify(dev);
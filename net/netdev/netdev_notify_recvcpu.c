@@ -390,6 +390,33 @@ static uint32_t compute_hash(hashcal_algo_e hash_algo,
  * Public Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: netdev_rss_hash
+ *
+ * Description:
+ *   Calculate the Toeplitz RSS hash of a flow, the one that the RSS
+ *   hardware calculates with the same key.
+ *
+ * Input Parameters:
+ *   domain   - The layer 3 protocol, PF_INET/PF_INET6
+ *   src_addr - The source address
+ *   src_port - The source port
+ *   dst_addr - The destination address
+ *   dst_port - The destination port
+ *
+ * Returned Value:
+ *  The hash value
+ *
+ ****************************************************************************/
+
+uint32_t netdev_rss_hash(uint8_t domain,
+                         FAR const void *src_addr, uint16_t src_port,
+                         FAR const void *dst_addr, uint16_t dst_port)
+{
+  return compute_hash(HASHCAL_ALGO_TOEPLITZ, HASHCAL_TYPE_4TUPLE, domain,
+                      src_addr, src_port, dst_addr, dst_port);
+}
+
 /****************************************************************************
  * Name: netdev_notify_recvcpu
  *
@@ -417,11 +444,8 @@ void netdev_notify_recvcpu(FAR struct net_driver_s *dev,
 {
   if (dev != NULL && dev->d_ioctl != NULL)
     {
-      uint32_t hash = compute_hash(HASHCAL_ALGO_CRC32,
-                                   HASHCAL_TYPE_4TUPLE,
-                                   domain,
-                                   src_addr, src_port,
-                                   dst_addr, dst_port);
+      uint32_t hash = netdev_rss_hash(domain, src_addr, src_port,
+                                      dst_addr, dst_port);
       struct netdev_rss_s arg;
       int ret;
 
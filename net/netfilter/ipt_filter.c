@@ -47,6 +47,19 @@
                             (1 << NF_INET_FORWARD)  | \
                             (1 << NF_INET_LOCAL_OUT))
 
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* The iptables entries of a chain, walked along the ipfilter entries */
+
+struct filter_counters_s
+{
+  FAR uint8_t *entry;
+  FAR uint8_t *end;
+  uint16_t     index; /* Position of entry in the chain */
+};
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
@@ -352,6 +365,79 @@ skip_match:
 }
 #endif
 
+/****************************************************************************
+ * Name: fill_counters
+ *
+ * Description:
+ *   Copy the hit counters of an ipfilter entry into the iptables entry it
+ *   was converted from.  The entries of a chain are converted in order, so
+ *   the iptables entries are walked along the ipfilter entries, skipping
+ *   those that could not be converted.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_IPv4
+static int fill_ipv4counters(FAR struct ipfilter_entry_s *filter,
+                             FAR void *arg)
+{
+  FAR struct filter_counters_s *cnt = arg;
+  FAR struct ipt_entry *entry;
+
+  for (; ; )
+    {
+      entry = (FAR struct ipt_entry *)cnt->entry;
+      if (cnt->entry >= cnt->end || entry->next_offset == 0)
+        {
+          return 1;
+        }
+
+      if (cnt->index++ == filter->index)
+        {
+          break;
+        }
+
+      cnt->entry += entry->next_offset;
+    }
+
+  entry->counters.pcnt = filter->pcnt;
+  entry->counters.bcnt = filter->bcnt;
+
+  cnt->entry += entry->next_offset;
+  return 0;
+}
+#endif
+
+#ifdef CONFIG_NET_IPv6
+static int fill_ipv6counters(FAR struct ipfilter_entry_s *filter,
+                             FAR void *arg)
+{
+  FAR struct filter_counters_s *cnt = arg;
+  FAR struct ip6t_entry *entry;
+
+  for (; ; )
+    {
+      entry = (FAR struct ip6t_entry *)cnt->entry;
+      if (cnt->entry >= cnt->end || entry->next_offset == 0)
+        {
+          return 1;
+        }
+
+      if (cnt->index++ == filter->index)
+        {
+          break;
+        }
+
+      cnt->entry += entry->next_offset;
+    }
+
+  entry->counters.pcnt = filter->pcnt;
+  entry->counters.bcnt = filter->bcnt;
+
+  cnt->entry += entry->next_offset;
+  return 0;
+}
+#endif
+
 /****************************************************************************
  * Name: adjust_filter
  *
@@ -370,6 +456,7 @@ static void adjust_ipv4filter(FAR const struct ipt_replace *repl)
   FAR const uint8_t *head;
   enum ipfilter_chain_e chain;
   enum nf_inet_hooks hook;
+  uint16_t index;
   size_t size;
 
   for (hook = NF_INET_LOCAL_IN; hook <= NF_INET_LOCAL_OUT; hook++)
@@ -388,18 +475,26 @@ static void adjust_ipv4filter(FAR const struct ipt_replace *repl)
 
       size++;
 
+      index = 0;
       ipt_entry_for_every(entry, head, size)
         {
           FAR struct ipv4_filter_entry_s *filter = convert_ipv4entry(entry);
           if (filter != NULL)
             {
+              filter->common.index = index;
               ipfilter_cfg_add(&filter->common, PF_INET, chain);
             }
           else
             {
               nwarn("WARNING: Failed to convert entry!\n");
             }
+
+          index++;
         }
+
+      /* Compile the chain once it is complete. */
+
+      ipfilter_cfg_commit(PF_INET, chain);
     }
 }
 #endif
@@ -411,6 +506,7 @@ static void adjust_ipv6filter(FAR const struct ip6t_replace *repl)
   FAR const uint8_t *head;
   enum ipfilter_chain_e chain;
   enum nf_inet_hooks hook;
+  uint16_t index;
   size_t size;
 
   for (hook = NF_INET_LOCAL_IN; hook <= NF_INET_LOCAL_OUT; hook++)
@@ -429,18 +525,26 @@ static void adjust_ipv6filter(FAR const struct ip6t_replace *repl)
 
       size++;
 
+      index = 0;
       ip6t_entry_for_every(entry, head, size)
         {
           FAR struct ipv6_filter_entry_s *filter = convert_ipv6entry(entry);
           if (filter != NULL)
             {
+              filter->common.index = index;
               ipfilter_cfg_add(&filter->common, PF_INET6, chain);
             }
           else
             {
               nwarn("WARNING: Failed to convert entry!\n");
             }
+
+          index++;
         }
+
+      /* Compile the chain once it is complete. */
+
+      ipfilter_cfg_commit(PF_INET6, chain);
     }
 }
 #endif
@@ -599,3 +703,54 @@ int ip6t_filter_apply(FAR const struct ip6t_replace *repl)
   return OK;
 }
 #endif
+
+/****************************************************************************
+ * Name: ipt_filter_counters
+ *
+ * Description:
+ *   Fill the hit counters of the filter rules into a copy of the entries
+ *   of the filter table.
+ *
+ * Input Parameters:
+ *   repl    - The config of the filter table.
+ *   entries - The copy of the entries of repl to fill.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_IPv4
+void ipt_filter_counters(FAR const struct ipt_replace *repl,
+                         FAR struct ipt_entry *entries)
+{
+  struct filter_counters_s cnt;
+  enum nf_inet_hooks hook;
+
+  for (hook = NF_INET_LOCAL_IN; hook <= NF_INET_LOCAL_OUT; hook++)
+    {
+      cnt.entry = (FAR uint8_t *)entries + repl->hook_entry[hook];
+      cnt.end   = (FAR uint8_t *)entries + repl->underflow[hook] + 1;
+      cnt.index = 0;
+
+      ipfilter_cfg_foreach(PF_INET, convert_chain(hook),
+                           fill_ipv4counters, &cnt);
+    }
+}
+#endif
+
+#ifdef CONFIG_NET_IPv6
+void ip6t_filter_counters(FAR const struct ip6t_replace *repl,
+                          FAR struct ip6t_entry *entries)
+{
+  struct filter_counters_s cnt;
+  enum nf_inet_hooks hook;
+
+  for (hook = NF_INET_LOCAL_IN; hook <= NF_INET_LOCAL_OUT; hook++)
+    {
+      cnt.entry = (FAR uint8_t *)entries + repl->hook_entry[hook];
+      cnt.end   = (FAR uint8_t *)entries + repl->underflow[hook] + 1;
+      cnt.index = 0;
+
+      ipfilter_cfg_foreach(PF_INET6, convert_chain(hook),
+                           fill_ipv6counters, &cnt);
+    }
+}
+#endif
@@ -47,7 +47,7 @@
  ****************************************************************************/
 
 /* Structure to store all info we need, including table data and
- * init/apply functions.
+ * init/apply/counters functions.
  */
 
 struct ipt_table_s
@@ -55,6 +55,8 @@ struct ipt_table_s
   FAR struct ipt_replace *repl;
   FAR struct ipt_replace *(*init_func)(void);
   FAR int (*apply_func)(FAR const struct ipt_replace *);
+  CODE void (*counters_func)(FAR const struct ipt_replace *,
+                             FAR struct ipt_entry *);
 };
 
 /* Following structs represent the layout of an entry with standard/error
@@ -85,7 +87,7 @@ static struct ipt_table_s g_tables[] =
   {NULL, ipt_nat_init, ipt_nat_apply},
 #endif
 #ifdef CONFIG_NET_IPFILTER
-  {NULL, ipt_filter_init, ipt_filter_apply},
+  {NULL, ipt_filter_init, ipt_filter_apply, ipt_filter_counters},
 #endif
 };
 
@@ -200,6 +202,7 @@ static int get_info(FAR struct ipt_getinfo *get, FAR socklen_t *len)
 
 static int get_entries(FAR struct ipt_get_entries *get, FAR socklen_t *len)
 {
+  FAR struct ipt_table_s *table;
   FAR struct ipt_replace *repl;
 
   if (*len < sizeof(*get) || *len != sizeof(*get) + get->size)
@@ -207,12 +210,13 @@ static int get_entries(FAR struct ipt_get_entries *get, FAR socklen_t *len)
       return -EINVAL;
     }
 
-  repl = ipt_table_repl(get->name);
-  if (repl == NULL)
+  table = ipt_table(get->name);
+  if (table == NULL || table->repl == NULL)
     {
       return -ENOENT;
     }
 
+  repl = table->repl;
   if (get->size != repl->size)
     {
       return -EAGAIN;
@@ -220,6 +224,13 @@ static int get_entries(FAR struct ipt_get_entries *get, FAR socklen_t *len)
 
   memcpy(get->entrytable, repl->entries, get->size);
 
+  /* The counters are kept by the tables, not in the saved entries. */
+
+  if (table->counters_func != NULL)
+    {
+      table->counters_func(repl, get->entrytable);
+    }
+
   return OK;
 }
 
@@ -163,5 +163,29 @@ int ip6t_filter_apply(FAR const struct ip6t_replace *repl);
 #  endif
 #endif
 
+/****************************************************************************
+ * Name: ipt_filter_counters
+ *
+ * Description:
+ *   Fill the hit counters of the filter rules into a copy of the entries
+ *   of the filter table.
+ *
+ * Input Parameters:
+ *   repl    - The config of the filter table.
+ *   entries - The copy of the entries of repl to fill.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_IPFILTER
+#  ifdef CONFIG_NET_IPv4
+void ipt_filter_counters(FAR const struct ipt_replace *repl,
+                         FAR struct ipt_entry *entries);
+#  endif
+#  ifdef CONFIG_NET_IPv6
+void ip6t_filter_counters(FAR const struct ip6t_replace *repl,
+                          FAR struct ip6t_entry *entries);
+#  endif
+#endif
+
 #endif /* CONFIG_NET_IPTABLES */
 #endif /* __NET_NETFILTER_IPTABLES_H */
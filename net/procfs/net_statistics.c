@@ -54,8 +54,15 @@ static int netprocfs_dropped(FAR struct netprocfs_file_s *netfile);
 #ifdef CONFIG_NET_IPv4
 static int netprocfs_ipv4_dropped(FAR struct netprocfs_file_s *netfile);
 #endif /* CONFIG_NET_IPv4 */
+#ifdef CONFIG_NET_IPFORWARD_FLOWTABLE
+static int netprocfs_ipv4_flows(FAR struct netprocfs_file_s *netfile);
+#endif /* CONFIG_NET_IPFORWARD_FLOWTABLE */
+#ifdef CONFIG_NET_ARP
+static int netprocfs_arp(FAR struct netprocfs_file_s *netfile);
+#endif /* CONFIG_NET_ARP */
 #ifdef CONFIG_NET_IPv6
 static int netprocfs_ipv6_dropped(FAR struct netprocfs_file_s *netfile);
+static int netprocfs_neighbor(FAR struct netprocfs_file_s *netfile);
 #endif /* CONFIG_NET_IPv4 */
 static int netprocfs_checksum(FAR struct netprocfs_file_s *netfile);
 #ifdef CONFIG_NET_TCP
@@ -84,8 +91,17 @@ static const linegen_t g_stat_linegen[] =
   netprocfs_ipv4_dropped,
 #endif /* CONFIG_NET_IPv4 */
 
+#ifdef CONFIG_NET_IPFORWARD_FLOWTABLE
+  netprocfs_ipv4_flows,
+#endif /* CONFIG_NET_IPFORWARD_FLOWTABLE */
+
+#ifdef CONFIG_NET_ARP
+  netprocfs_arp,
+#endif /* CONFIG_NET_ARP */
+
 #ifdef CONFIG_NET_IPv6
   netprocfs_ipv6_dropped,
+  netprocfs_neighbor,
 #endif /* CONFIG_NET_IPv4 */
 
   netprocfs_checksum,
@@ -236,6 +252,33 @@ static int netprocfs_ipv4_dropped(FAR struct netprocfs_file_s *netfile)
 }
 #endif /* CONFIG_NET_STATISTICS && CONFIG_NET_IPv4 */
 
+/****************************************************************************
+ * Name: netprocfs_ipv4_flows
+ ****************************************************************************/
+
+#if defined(CONFIG_NET_STATISTICS) && defined(CONFIG_NET_IPFORWARD_FLOWTABLE)
+static int netprocfs_ipv4_flows(FAR struct netprocfs_file_s *netfile)
+{
+  return snprintf(netfile->line, NET_LINELEN,
+                  "  IPv4 Flows  Hit: %04x   Miss: %04x\n",
+                  g_netstats.ipv4.flowhit, g_netstats.ipv4.flowmiss);
+}
+#endif /* CONFIG_NET_STATISTICS && CONFIG_NET_IPFORWARD_FLOWTABLE */
+
+/****************************************************************************
+ * Name: netprocfs_arp
+ ****************************************************************************/
+
+#if defined(CONFIG_NET_STATISTICS) && defined(CONFIG_NET_ARP)
+static int netprocfs_arp(FAR struct netprocfs_file_s *netfile)
+{
+  return snprintf(netfile->line, NET_LINELEN,
+                  "  ARP         Hit: %04x   Miss: %04x   Pend: %04x\n",
+                  g_netstats.ipv4.arphit, g_netstats.ipv4.arpmiss,
+                  g_netstats.ipv4.arppending);
+}
+#endif /* CONFIG_NET_STATISTICS && CONFIG_NET_ARP */
+
 /****************************************************************************
  * Name: netprocfs_ipv6_dropped
  ****************************************************************************/
@@ -249,6 +292,20 @@ static int netprocfs_ipv6_dropped(FAR struct netprocfs_file_s *netfile)
 }
 #endif /* CONFIG_NET_STATISTICS && CONFIG_NET_IPv6 */
 
+/****************************************************************************
+ * Name: netprocfs_neighbor
+ ****************************************************************************/
+
+#if defined(CONFIG_NET_STATISTICS) && defined(CONFIG_NET_IPv6)
+static int netprocfs_neighbor(FAR struct netprocfs_file_s *netfile)
+{
+  return snprintf(netfile->line, NET_LINELEN,
+                  "  Neighbor    Hit: %04x   Miss: %04x   Pend: %04x\n",
+                  g_netstats.ipv6.nbhit, g_netstats.ipv6.nbmiss,
+                  g_netstats.ipv6.nbpending);
+}
+#endif /* CONFIG_NET_STATISTICS && CONFIG_NET_IPv6 */
+
 /****************************************************************************
  * Name: netprocfs_checksum
  ****************************************************************************/
@@ -46,9 +46,9 @@
 #ifdef NET_TCP_HAVE_STACK
 
 #ifdef CONFIG_NET_IPv6
-#  define TCP_LINELEN 180
+#  define TCP_LINELEN 186
 #else
-#  define TCP_LINELEN 120
+#  define TCP_LINELEN 126
 #endif
 
 /****************************************************************************
@@ -62,6 +62,9 @@ static ssize_t netprocfs_tcpstats(FAR struct netprocfs_file_s *priv,
   int addrlen = (domain == PF_INET) ?
                 INET_ADDRSTRLEN : INET6_ADDRSTRLEN;
   FAR struct tcp_conn_s *conn = NULL;
+#if CONFIG_NET_TCP_TIMEWAIT_RECORDS > 0
+  FAR struct tcp_timewait_s *tw = NULL;
+#endif
   char remote[INET6_ADDRSTRLEN];
   char local[INET6_ADDRSTRLEN];
   int len = 0;
@@ -102,7 +105,8 @@ static ssize_t netprocfs_tcpstats(FAR struct netprocfs_file_s *priv,
 #if CONFIG_NET_SEND_BUFSIZE > 0
                       " %6" PRIu32
 #endif
-                      " %6u",
+                      " %6u"
+                      " %5zu",
                       priv->offset++,
                       conn->tcpstateflags,
                       conn->sconn.s_flags,
@@ -113,7 +117,8 @@ static ssize_t netprocfs_tcpstats(FAR struct netprocfs_file_s *priv,
 #if CONFIG_NET_SEND_BUFSIZE > 0
                       tcp_wrbuffer_inqueue_size(conn),
 #endif
-                      (conn->readahead) ? conn->readahead->io_pktlen : 0);
+                      (conn->readahead) ? conn->readahead->io_pktlen : 0,
+                      tcp_conn_memsize(conn));
 
       len += snprintf(buffer + len, buflen - len,
                       " %*s:%-6" PRIu16 " %*s:%-6" PRIu16 "\n",
@@ -125,6 +130,65 @@ static ssize_t netprocfs_tcpstats(FAR struct netprocfs_file_s *priv,
                       ntohs(conn->rport));
     }
 
+#if CONFIG_NET_TCP_TIMEWAIT_RECORDS > 0
+  /* The connections released in TIME_WAIT follow */
+
+  while (conn == NULL && (tw = tcp_timewait_next(tw)) != NULL)
+    {
+      sclock_t left = tw->expire - clock_systime_ticks();
+
+#if defined(CONFIG_NET_IPv4) && defined(CONFIG_NET_IPv6)
+      if (tw->domain != domain)
+        {
+          continue;
+        }
+#endif
+
+      if (++(*skip) <= priv->offset)
+        {
+          continue;
+        }
+
+      if (buflen - len < TCP_LINELEN)
+        {
+          break;
+        }
+
+      laddr = net_ip_binding_laddr(&tw->u, domain);
+      raddr = net_ip_binding_raddr(&tw->u, domain);
+
+      len += snprintf(buffer + len, buflen - len,
+                      "    %2" PRIu8
+                      ": %02" PRIx8
+                      " %3" PRIx8 " %3" PRIu8
+                      " %3u"
+                      " %4" PRIu32
+                      " %3" PRIu8
+#if CONFIG_NET_SEND_BUFSIZE > 0
+                      " %6" PRIu32
+#endif
+                      " %6u"
+                      " %5zu",
+                      priv->offset++,
+                      TCP_TIME_WAIT, 0, 0,
+                      left > 0 ? (unsigned int)TICK2HSEC(left) : 0,
+                      (uint32_t)0, 0,
+#if CONFIG_NET_SEND_BUFSIZE > 0
+                      (uint32_t)0,
+#endif
+                      0, sizeof(struct tcp_timewait_s));
+
+      len += snprintf(buffer + len, buflen - len,
+                      " %*s:%-6" PRIu16 " %*s:%-6" PRIu16 "\n",
+                      (domain == PF_INET6) ? addrlen / 2 : addrlen,
+                      inet_ntop(domain, laddr, local, addrlen),
+                      ntohs(tw->lport),
+                      (domain == PF_INET6) ? addrlen / 2 : addrlen,
+                      inet_ntop(domain, raddr, remote, addrlen),
+                      ntohs(tw->rport));
+    }
+#endif
+
   net_unlock();
 
   return len;
@@ -160,7 +224,11 @@ ssize_t netprocfs_read_tcpstats(FAR struct netprocfs_file_s *priv,
 
   net_lock();
 
-  if (tcp_nextconn(NULL) != NULL)
+  if (tcp_nextconn(NULL) != NULL
+#if CONFIG_NET_TCP_TIMEWAIT_RECORDS > 0
+      || tcp_timewait_next(NULL) != NULL
+#endif
+     )
     {
       if (priv->offset == 0)
         {
@@ -169,7 +237,8 @@ ssize_t netprocfs_read_tcpstats(FAR struct netprocfs_file_s *priv,
 #if CONFIG_NET_SEND_BUFSIZE > 0
                                           "txsz   "
 #endif
-                                          "rxsz "
+                                          "rxsz   "
+                                          "mem "
                                           "%-*s "
                                           "%-*s\n"
                                           ,
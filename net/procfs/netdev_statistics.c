@@ -80,6 +80,11 @@ static int netprocfs_rxpackets(FAR struct netprocfs_file_s *netfile);
 static int netprocfs_txstatistics_header(
     FAR struct netprocfs_file_s *netfile);
 static int netprocfs_txstatistics(FAR struct netprocfs_file_s *netfile);
+#ifdef CONFIG_NETDEV_NAPI
+static int netprocfs_pollstatistics_header(
+    FAR struct netprocfs_file_s *netfile);
+static int netprocfs_pollstatistics(FAR struct netprocfs_file_s *netfile);
+#endif
 static int netprocfs_errors(FAR struct netprocfs_file_s *netfile);
 #endif /* CONFIG_NETDEV_STATISTICS */
 
@@ -116,6 +121,10 @@ static const linegen_t g_netstat_linegen[] =
   netprocfs_rxpackets,
   netprocfs_txstatistics_header,
   netprocfs_txstatistics,
+#ifdef CONFIG_NETDEV_NAPI
+  netprocfs_pollstatistics_header,
+  netprocfs_pollstatistics,
+#endif
   netprocfs_errors
 #endif /* CONFIG_NETDEV_STATISTICS */
 };
@@ -558,6 +567,44 @@ static int netprocfs_txstatistics(FAR struct netprocfs_file_s *netfile)
 }
 #endif /* CONFIG_NETDEV_STATISTICS */
 
+/****************************************************************************
+ * Name: netprocfs_pollstatistics_header
+ ****************************************************************************/
+
+#if defined(CONFIG_NETDEV_STATISTICS) && defined(CONFIG_NETDEV_NAPI)
+static int netprocfs_pollstatistics_header(
+    FAR struct netprocfs_file_s *netfile)
+{
+  DEBUGASSERT(netfile != NULL);
+
+  return snprintf(netfile->line, NET_LINELEN,
+                 "\tPOLL: %-8s %-8s %-8s\n",
+                 "Polls", "Squeezed", "IRQs");
+}
+#endif /* CONFIG_NETDEV_STATISTICS && CONFIG_NETDEV_NAPI */
+
+/****************************************************************************
+ * Name: netprocfs_pollstatistics
+ ****************************************************************************/
+
+#if defined(CONFIG_NETDEV_STATISTICS) && defined(CONFIG_NETDEV_NAPI)
+static int netprocfs_pollstatistics(FAR struct netprocfs_file_s *netfile)
+{
+  FAR struct netdev_statistics_s *stats;
+  FAR struct net_driver_s *dev;
+
+  DEBUGASSERT(netfile != NULL && netfile->dev != NULL);
+  dev = netfile->dev;
+  stats = &dev->d_statistics;
+
+  return snprintf(netfile->line, NET_LINELEN,
+                  "\t      %08lx %08lx %08lx\n",
+                  (unsigned long)stats->rx_polls,
+                  (unsigned long)stats->rx_squeezed,
+                  (unsigned long)stats->rx_irqs);
+}
+#endif /* CONFIG_NETDEV_STATISTICS && CONFIG_NETDEV_NAPI */
+
 /****************************************************************************
  * Name: netprocfs_errors
  ****************************************************************************/
@@ -0,0 +1,155 @@
+/****************************************************************************
+ * net/route/lpmroute.h
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+#ifndef __NET_ROUTE_LPMROUTE_H
+#define __NET_ROUTE_LPMROUTE_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <nuttx/net/netdev.h>
+
+#include "route/route.h"
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* The trie indexes the in-memory routing tables only */
+
+#if defined(CONFIG_ROUTE_LPM_TRIE) && defined(CONFIG_ROUTE_IPv4_RAMROUTE)
+#  define HAVE_ROUTE_IPv4_LPM 1
+#endif
+
+#if defined(CONFIG_ROUTE_LPM_TRIE) && defined(CONFIG_ROUTE_IPv6_RAMROUTE)
+#  define HAVE_ROUTE_IPv6_LPM 1
+#endif
+
+#if defined(HAVE_ROUTE_IPv4_LPM) || defined(HAVE_ROUTE_IPv6_LPM)
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: net_init_lpmroute
+ *
+ * Description:
+ *   Initialize the longest prefix match tries of the routing tables
+ *
+ * Assumptions:
+ *   Called early in initialization so that no special protection is needed.
+ *
+ ****************************************************************************/
+
+void net_init_lpmroute(void);
+
+/****************************************************************************
+ * Name: net_addlpm_ipv4 and net_addlpm_ipv6
+ *
+ * Description:
+ *   Index a new entry of the in-memory routing table.  Routes with the same
+ *   target and netmask are kept in the order they were added, the first
+ *   one is preferred.
+ *
+ * Input Parameters:
+ *   route - The routing table entry, allocated by net_allocroute_ipvN()
+ *
+ * Returned Value:
+ *   OK on success; -EINVAL if the netmask is not a prefix; -ENOMEM if
+ *   there is no free node.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+#ifdef HAVE_ROUTE_IPv4_LPM
+int net_addlpm_ipv4(FAR struct net_route_ipv4_s *route);
+#endif
+
+#ifdef HAVE_ROUTE_IPv6_LPM
+int net_addlpm_ipv6(FAR struct net_route_ipv6_s *route);
+#endif
+
+/****************************************************************************
+ * Name: net_dellpm_ipv4 and net_dellpm_ipv6
+ *
+ * Description:
+ *   Remove an entry of the in-memory routing table from the trie before it
+ *   is freed.
+ *
+ * Input Parameters:
+ *   route - The routing table entry added by net_addlpm_ipvN()
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+#ifdef HAVE_ROUTE_IPv4_LPM
+void net_dellpm_ipv4(FAR struct net_route_ipv4_s *route);
+#endif
+
+#ifdef HAVE_ROUTE_IPv6_LPM
+void net_dellpm_ipv6(FAR struct net_route_ipv6_s *route);
+#endif
+
+/****************************************************************************
+ * Name: net_matchlpm_ipv4 and net_matchlpm_ipv6
+ *
+ * Description:
+ *   Find the route with the longest prefix that matches target.  The trie
+ *   is read without the network lock: the lookup is only repeated with the
+ *   lock held if a route was added or deleted meanwhile.
+ *
+ * Input Parameters:
+ *   target    - The address to look up
+ *   prefixlen - Only match prefixes longer than this
+ *   dev       - If not NULL, the router must be on the network of dev
+ *   route     - Receives a copy of the matching routing table entry
+ *
+ * Returned Value:
+ *   The prefix length of the matching route; -ENOENT if there is none.
+ *
+ ****************************************************************************/
+
+#ifdef HAVE_ROUTE_IPv4_LPM
+int net_matchlpm_ipv4(in_addr_t target, int prefixlen,
+                      FAR struct net_driver_s *dev,
+                      FAR struct net_route_ipv4_s *route);
+#endif
+
+#ifdef HAVE_ROUTE_IPv6_LPM
+int net_matchlpm_ipv6(FAR const net_ipv6addr_t target, int prefixlen,
+                      FAR struct net_driver_s *dev,
+                      FAR struct net_route_ipv6_s *route);
+#endif
+
+#endif /* HAVE_ROUTE_IPv4_LPM || HAVE_ROUTE_IPv6_LPM */
+#endif /* __NET_ROUTE_LPMROUTE_H */
@@ -33,8 +33,10 @@
 #include <debug.h>
 
 #include <nuttx/fs/fs.h>
+#include <nuttx/net/net.h>
 #include <nuttx/net/ip.h>
 
+#include "ipforward/ipforward.h"
 #include "netlink/netlink.h"
 #include "route/fileroute.h"
 #include "route/route.h"
@@ -88,6 +90,12 @@ int net_addroute_ipv4(in_addr_t target, in_addr_t netmask, in_addr_t router)
 
   net_closeroute_ipv4(&fshandle);
 
+#ifdef CONFIG_NET_IPFORWARD_FLOWTABLE
+  net_lock();
+  ipfwd_flow_flush();
+  net_unlock();
+#endif
+
   netlink_route_notify(&route, RTM_NEWROUTE, AF_INET);
   return nwritten >= 0 ? 0 : (int)nwritten;
 }
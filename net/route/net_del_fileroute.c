@@ -36,8 +36,10 @@
 #include <arpa/inet.h>
 
 #include <nuttx/fs/fs.h>
+#include <nuttx/net/net.h>
 #include <nuttx/net/ip.h>
 
+#include "ipforward/ipforward.h"
 #include "netlink/netlink.h"
 #include "route/fileroute.h"
 #include "route/cacheroute.h"
@@ -256,6 +258,12 @@ int net_delroute_ipv4(in_addr_t target, in_addr_t netmask)
   net_flushcache_ipv4();
 #endif
 
+#ifdef CONFIG_NET_IPFORWARD_FLOWTABLE
+  net_lock();
+  ipfwd_flow_flush();
+  net_unlock();
+#endif
+
   /* Loop, copying each entry, to the previous entry thus removing the entry
    * to be deleted.
    */
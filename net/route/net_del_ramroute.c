@@ -34,8 +34,10 @@
 #include <arpa/inet.h>
 #include <nuttx/net/ip.h>
 
+#include "ipforward/ipforward.h"
 #include "netlink/netlink.h"
 #include "route/ramroute.h"
+#include "route/lpmroute.h"
 #include "route/route.h"
 
 #if defined(CONFIG_ROUTE_IPv4_RAMROUTE) || defined(CONFIG_ROUTE_IPv6_RAMROUTE)
@@ -102,6 +104,10 @@ static int net_del_ipv4route(FAR struct net_route_ipv4_s *route,
     {
       /* They match.. Remove the entry from the routing table */
 
+#ifdef HAVE_ROUTE_IPv4_LPM
+      net_dellpm_ipv4(route);
+#endif
+
       if (match->prev)
         {
           ramroute_ipv4_remafter(
@@ -113,6 +119,8 @@ static int net_del_ipv4route(FAR struct net_route_ipv4_s *route,
           ramroute_ipv4_remfirst(&g_ipv4_routes);
         }
 
+      ipfwd_flow_flush();
+
       netlink_route_notify(route, RTM_DELROUTE, AF_INET);
 
       /* And free the routing table entry by adding it to the free list */
@@ -160,6 +168,10 @@ static int net_del_ipv6route(FAR struct net_route_ipv6_s *route,
     {
       /* They match.. Remove the entry from the routing table */
 
+#ifdef HAVE_ROUTE_IPv6_LPM
+      net_dellpm_ipv6(route);
+#endif
+
       if (match->prev)
         {
           ramroute_ipv6_remafter(
@@ -0,0 +1,830 @@
+/****************************************************************************
+ * net/route/net_lpmroute.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/param.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <nuttx/spinlock.h>
+#include <nuttx/net/net.h>
+#include <nuttx/net/netdev.h>
+
+#include "route/ramroute.h"
+#include "route/lpmroute.h"
+#include "route/route.h"
+#include "utils/utils.h"
+
+#if defined(HAVE_ROUTE_IPv4_LPM) || defined(HAVE_ROUTE_IPv6_LPM)
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#ifdef HAVE_ROUTE_IPv6_LPM
+#  define LPM_KEYLEN      16
+#else
+#  define LPM_KEYLEN      4
+#endif
+
+/* A trie of N prefixes needs at most N - 1 more nodes to join them */
+
+#define LPM_IPv4_NODES    (2 * CONFIG_ROUTE_MAX_IPv4_RAMROUTES)
+#define LPM_IPv6_NODES    (2 * CONFIG_ROUTE_MAX_IPv6_RAMROUTES)
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* A node of the path-compressed binary trie.  The children hold longer
+ * prefixes, selected by the bit that follows the prefix of the node.  A
+ * node without routes only joins two longer prefixes.
+ */
+
+struct lpm_node_s
+{
+  FAR struct lpm_node_s *volatile child[2]; /* Longer prefixes */
+  FAR void *volatile routes;                /* Routes of the prefix or NULL */
+  uint8_t plen;                             /* Prefix length in bits */
+  uint8_t key[LPM_KEYLEN];                  /* Prefix in network order */
+};
+
+struct lpm_trie_s
+{
+  FAR struct lpm_node_s *volatile root;     /* The shortest prefix */
+  FAR struct lpm_node_s *free;              /* Free nodes, by child[0] */
+  volatile uint32_t seq;                    /* Odd while the trie changes */
+};
+
+/* Select one of the routes of a matching prefix during a lookup */
+
+typedef CODE bool (*lpm_match_t)(FAR void *routes, FAR void *arg);
+
+#ifdef HAVE_ROUTE_IPv4_LPM
+struct lpm_ipv4_match_s
+{
+  FAR struct net_driver_s *dev;             /* The router must be on dev */
+  FAR struct net_route_ipv4_s *route;       /* Receives the route */
+};
+#endif
+
+#ifdef HAVE_ROUTE_IPv6_LPM
+struct lpm_ipv6_match_s
+{
+  FAR struct net_driver_s *dev;             /* The router must be on dev */
+  FAR struct net_route_ipv6_s *route;       /* Receives the route */
+};
+#endif
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+#ifdef HAVE_ROUTE_IPv4_LPM
+static struct lpm_trie_s g_ipv4_lpm;
+static struct lpm_node_s g_ipv4_lpmnodes[LPM_IPv4_NODES];
+#endif
+
+#ifdef HAVE_ROUTE_IPv6_LPM
+static struct lpm_trie_s g_ipv6_lpm;
+static struct lpm_node_s g_ipv6_lpmnodes[LPM_IPv6_NODES];
+#endif
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: lpm_bit
+ *
+ * Description:
+ *   Return bit number n of a key, counted from the most significant bit.
+ *
+ ****************************************************************************/
+
+static inline int lpm_bit(FAR const uint8_t *key, unsigned int n)
+{
+  return (key[n >> 3] >> (7 - (n & 7))) & 1;
+}
+
+/****************************************************************************
+ * Name: lpm_common
+ *
+ * Description:
+ *   Return the number of leading bits that two keys have in common, up to
+ *   maxlen.
+ *
+ ****************************************************************************/
+
+static unsigned int lpm_common(FAR const uint8_t *a, FAR const uint8_t *b,
+                               unsigned int maxlen)
+{
+  unsigned int len;
+  uint8_t diff;
+
+  for (len = 0; len < maxlen; len += 8)
+    {
+      diff = a[len >> 3] ^ b[len >> 3];
+      if (diff != 0)
+        {
+          while ((diff & 0x80) == 0)
+            {
+              diff <<= 1;
+              len++;
+            }
+
+          break;
+        }
+    }
+
+  return MIN(len, maxlen);
+}
+
+/****************************************************************************
+ * Name: lpm_alloc/lpm_free
+ *
+ * Description:
+ *   Take a node of the trie from its free list and set its prefix, or give
+ *   it back.
+ *
+ ****************************************************************************/
+
+static FAR struct lpm_node_s *lpm_alloc(FAR struct lpm_trie_s *trie,
+                                        FAR const uint8_t *key,
+                                        unsigned int plen)
+{
+  FAR struct lpm_node_s *node = trie->free;
+
+  if (node != NULL)
+    {
+      trie->free     = node->child[0];
+      node->child[0] = NULL;
+      node->child[1] = NULL;
+      node->routes   = NULL;
+      node->plen     = plen;
+
+      memset(node->key, 0, LPM_KEYLEN);
+      memcpy(node->key, key, (plen + 7) >> 3);
+      if ((plen & 7) != 0)
+        {
+          node->key[plen >> 3] &= 0xff << (8 - (plen & 7));
+        }
+    }
+
+  return node;
+}
+
+static void lpm_free(FAR struct lpm_trie_s *trie,
+                     FAR struct lpm_node_s *node)
+{
+  node->child[0] = trie->free;
+  trie->free     = node;
+}
+
+/****************************************************************************
+ * Name: lpm_init
+ *
+ * Description:
+ *   Put all the nodes of a trie on its free list.
+ *
+ ****************************************************************************/
+
+static void lpm_init(FAR struct lpm_trie_s *trie,
+                     FAR struct lpm_node_s *nodes, int nnodes)
+{
+  int i;
+
+  trie->root = NULL;
+  trie->free = NULL;
+  trie->seq  = 0;
+
+  for (i = 0; i < nnodes; i++)
+    {
+      lpm_free(trie, &nodes[i]);
+    }
+}
+
+/****************************************************************************
+ * Name: lpm_write_begin/lpm_write_end
+ *
+ * Description:
+ *   Bracket a change of the trie.  The lookups that overlap with it see a
+ *   different sequence number and are repeated.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+static inline void lpm_write_begin(FAR struct lpm_trie_s *trie)
+{
+  trie->seq++;
+  SP_DMB();
+}
+
+static inline void lpm_write_end(FAR struct lpm_trie_s *trie)
+{
+  SP_DMB();
+  trie->seq++;
+}
+
+/****************************************************************************
+ * Name: lpm_insert
+ *
+ * Description:
+ *   Return the node of a prefix, inserting it if the trie does not hold it
+ *   yet.  NULL is returned if there are not enough free nodes.
+ *
+ ****************************************************************************/
+
+static FAR struct lpm_node_s *lpm_insert(FAR struct lpm_trie_s *trie,
+                                         FAR const uint8_t *key,
+                                         unsigned int plen)
+{
+  FAR struct lpm_node_s *volatile *slot = &trie->root;
+  FAR struct lpm_node_s *newnode;
+  FAR struct lpm_node_s *glue;
+  FAR struct lpm_node_s *node;
+  unsigned int matchlen = 0;
+
+  /* Walk down while the prefix of the node covers the new one */
+
+  while ((node = *slot) != NULL)
+    {
+      matchlen = lpm_common(node->key, key, MIN(node->plen, plen));
+      if (matchlen != node->plen || node->plen == plen)
+        {
+          break;
+        }
+
+      slot = &node->child[lpm_bit(key, node->plen)];
+    }
+
+  if (node != NULL && node->plen == plen && matchlen == plen)
+    {
+      /* The prefix is in the trie already */
+
+      return node;
+    }
+
+  newnode = lpm_alloc(trie, key, plen);
+  if (newnode == NULL)
+    {
+      return NULL;
+    }
+
+  if (node == NULL)
+    {
+      *slot = newnode;
+    }
+  else if (matchlen == plen)
+    {
+      /* The new prefix covers the node: put it above the node */
+
+      newnode->child[lpm_bit(node->key, plen)] = node;
+      *slot = newnode;
+    }
+  else
+    {
+      /* The prefixes differ after matchlen bits: join them */
+
+      glue = lpm_alloc(trie, key, matchlen);
+      if (glue == NULL)
+        {
+          lpm_free(trie, newnode);
+          return NULL;
+        }
+
+      glue->child[lpm_bit(key, matchlen)]       = newnode;
+      glue->child[lpm_bit(node->key, matchlen)] = node;
+      *slot = glue;
+    }
+
+  return newnode;
+}
+
+/****************************************************************************
+ * Name: lpm_remove
+ *
+ * Description:
+ *   Remove a node whose last route was deleted, and its parent if the
+ *   parent only joined it to another prefix.
+ *
+ ****************************************************************************/
+
+static void lpm_remove(FAR struct lpm_trie_s *trie,
+                       FAR struct lpm_node_s *node)
+{
+  FAR struct lpm_node_s *volatile *slot = &trie->root;
+  FAR struct lpm_node_s *volatile *pslot = NULL;
+  FAR struct lpm_node_s *parent = NULL;
+
+  while (*slot != node)
+    {
+      if (*slot == NULL)
+        {
+          return;
+        }
+
+      parent = *slot;
+      pslot  = slot;
+      slot   = &parent->child[lpm_bit(node->key, parent->plen)];
+    }
+
+  if (node->child[0] != NULL && node->child[1] != NULL)
+    {
+      /* The node still joins two longer prefixes */
+
+      return;
+    }
+
+  if (node->child[0] != NULL || node->child[1] != NULL)
+    {
+      *slot = node->child[0] != NULL ? node->child[0] : node->child[1];
+      lpm_free(trie, node);
+      return;
+    }
+
+  *slot = NULL;
+  lpm_free(trie, node);
+
+  if (parent != NULL && parent->routes == NULL)
+    {
+      *pslot = parent->child[0] != NULL ?
+               parent->child[0] : parent->child[1];
+      lpm_free(trie, parent);
+    }
+}
+
+/****************************************************************************
+ * Name: lpm_lookup
+ *
+ * Description:
+ *   Walk down the prefixes that match key, from the shortest, and let match
+ *   select a route of those longer than prefixlen.  Return the length of
+ *   the last prefix selected, or -ENOENT.
+ *
+ ****************************************************************************/
+
+static int lpm_lookup(FAR struct lpm_trie_s *trie, FAR const uint8_t *key,
+                      int maxbits, int prefixlen, lpm_match_t match,
+                      FAR void *arg)
+{
+  FAR struct lpm_node_s *node = trie->root;
+  FAR void *routes;
+  int best = -ENOENT;
+  int plen = -1;
+
+  /* The prefix lengths grow on the way down, so that the walk ends even if
+   * the trie is changed under it.
+   */
+
+  while (node != NULL && node->plen > plen && node->plen <= maxbits)
+    {
+      plen = node->plen;
+      if (lpm_common(node->key, key, plen) != plen)
+        {
+          break;
+        }
+
+      routes = node->routes;
+      if (routes != NULL && plen > prefixlen && match(routes, arg))
+        {
+          best = plen;
+        }
+
+      if (plen == maxbits)
+        {
+          break;
+        }
+
+      node = node->child[lpm_bit(key, plen)];
+    }
+
+  return best;
+}
+
+/****************************************************************************
+ * Name: lpm_read
+ *
+ * Description:
+ *   Look up key without the network lock.  If the trie was changed during
+ *   the lookup, look it up again with the network locked.
+ *
+ ****************************************************************************/
+
+static int lpm_read(FAR struct lpm_trie_s *trie, FAR const uint8_t *key,
+                    int maxbits, int prefixlen, lpm_match_t match,
+                    FAR void *arg)
+{
+  uint32_t seq = trie->seq;
+  int ret;
+
+  SP_DMB();
+  if ((seq & 1) == 0)
+    {
+      ret = lpm_lookup(trie, key, maxbits, prefixlen, match, arg);
+      SP_DMB();
+      if (trie->seq == seq)
+        {
+          return ret;
+        }
+    }
+
+  net_lock();
+  ret = lpm_lookup(trie, key, maxbits, prefixlen, match, arg);
+  net_unlock();
+  return ret;
+}
+
+/****************************************************************************
+ * Name: lpm_ipv4_match/lpm_ipv6_match
+ *
+ * Description:
+ *   Copy the first route of a prefix whose router is on the network of the
+ *   device, if a device is given.  The number of routes walked is bounded
+ *   in case the list is changed while it is read.
+ *
+ ****************************************************************************/
+
+#ifdef HAVE_ROUTE_IPv4_LPM
+static bool lpm_ipv4_match(FAR void *routes, FAR void *arg)
+{
+  FAR struct net_route_ipv4_entry_s *entry = routes;
+  FAR struct lpm_ipv4_match_s *match = arg;
+  int n;
+
+  for (n = 0; entry != NULL && n < CONFIG_ROUTE_MAX_IPv4_RAMROUTES; n++)
+    {
+      if (match->dev == NULL ||
+          net_ipv4addr_maskcmp(entry->entry.router, match->dev->d_ipaddr,
+                               match->dev->d_netmask))
+        {
+          memcpy(match->route, &entry->entry,
+                 sizeof(struct net_route_ipv4_s));
+          return true;
+        }
+
+      entry = entry->lpmnext;
+    }
+
+  return false;
+}
+#endif
+
+#ifdef HAVE_ROUTE_IPv6_LPM
+static bool lpm_ipv6_match(FAR void *routes, FAR void *arg)
+{
+  FAR struct net_route_ipv6_entry_s *entry = routes;
+  FAR struct lpm_ipv6_match_s *match = arg;
+  int n;
+
+  for (n = 0; entry != NULL && n < CONFIG_ROUTE_MAX_IPv6_RAMROUTES; n++)
+    {
+      if (match->dev == NULL ||
+          NETDEV_V6ADDR_ONLINK(match->dev, entry->entry.router))
+        {
+          memcpy(match->route, &entry->entry,
+                 sizeof(struct net_route_ipv6_s));
+          return true;
+        }
+
+      entry = entry->lpmnext;
+    }
+
+  return false;
+}
+#endif
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: net_init_lpmroute
+ *
+ * Description:
+ *   Initialize the longest prefix match tries of the routing tables
+ *
+ * Assumptions:
+ *   Called early in initialization so that no special protection is needed.
+ *
+ ****************************************************************************/
+
+void net_init_lpmroute(void)
+{
+#ifdef HAVE_ROUTE_IPv4_LPM
+  lpm_init(&g_ipv4_lpm, g_ipv4_lpmnodes, LPM_IPv4_NODES);
+#endif
+
+#ifdef HAVE_ROUTE_IPv6_LPM
+  lpm_init(&g_ipv6_lpm, g_ipv6_lpmnodes, LPM_IPv6_NODES);
+#endif
+}
+
+/****************************************************************************
+ * Name: net_addlpm_ipv4 and net_addlpm_ipv6
+ *
+ * Description:
+ *   Index a new entry of the in-memory routing table.  Routes with the same
+ *   target and netmask are kept in the order they were added, the first
+ *   one is preferred.
+ *
+ * Input Parameters:
+ *   route - The routing table entry, allocated by net_allocroute_ipvN()
+ *
+ * Returned Value:
+ *   OK on success; -EINVAL if the netmask is not a prefix; -ENOMEM if
+ *   there is no free node.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+#ifdef HAVE_ROUTE_IPv4_LPM
+int net_addlpm_ipv4(FAR struct net_route_ipv4_s *route)
+{
+  FAR struct net_route_ipv4_entry_s *entry =
+    (FAR struct net_route_ipv4_entry_s *)route;
+  FAR struct net_route_ipv4_entry_s *last;
+  FAR struct lpm_node_s *node;
+  uint32_t hostmask = NTOHL(route->netmask);
+  in_addr_t key;
+
+  /* The trie holds prefixes: the ones of the mask must be contiguous */
+
+  if ((~hostmask & (~hostmask + 1)) != 0)
+    {
+      return -EINVAL;
+    }
+
+  key = route->target & route->netmask;
+  entry->lpmnext = NULL;
+
+  lpm_write_begin(&g_ipv4_lpm);
+  node = lpm_insert(&g_ipv4_lpm, (FAR const uint8_t *)&key,
+                    net_ipv4_mask2pref(route->netmask));
+  if (node != NULL)
+    {
+      if (node->routes == NULL)
+        {
+          node->routes = entry;
+        }
+      else
+        {
+          for (last = node->routes; last->lpmnext != NULL;
+               last = last->lpmnext)
+            {
+            }
+
+          last->lpmnext = entry;
+        }
+    }
+
+  lpm_write_end(&g_ipv4_lpm);
+  return node != NULL ? OK : -ENOMEM;
+}
+#endif
+
+#ifdef HAVE_ROUTE_IPv6_LPM
+int net_addlpm_ipv6(FAR struct net_route_ipv6_s *route)
+{
+  FAR struct net_route_ipv6_entry_s *entry =
+    (FAR struct net_route_ipv6_entry_s *)route;
+  FAR struct net_route_ipv6_entry_s *last;
+  FAR struct lpm_node_s *node;
+  net_ipv6addr_t mask;
+  net_ipv6addr_t key;
+  uint8_t plen;
+  int i;
+
+  /* The trie holds prefixes: the ones of the mask must be contiguous */
+
+  plen = net_ipv6_mask2pref(route->netmask);
+  net_ipv6_pref2mask(mask, plen);
+  if (!net_ipv6addr_cmp(mask, route->netmask))
+    {
+      return -EINVAL;
+    }
+
+  for (i = 0; i < 8; i++)
+    {
+      key[i] = route->target[i] & route->netmask[i];
+    }
+
+  entry->lpmnext = NULL;
+
+  lpm_write_begin(&g_ipv6_lpm);
+  node = lpm_insert(&g_ipv6_lpm, (FAR const uint8_t *)key, plen);
+  if (node != NULL)
+    {
+      if (node->routes == NULL)
+        {
+          node->routes = entry;
+        }
+      else
+        {
+          for (last = node->routes; last->lpmnext != NULL;
+               last = last->lpmnext)
+            {
+            }
+
+          last->lpmnext = entry;
+        }
+    }
+
+  lpm_write_end(&g_ipv6_lpm);
+  return node != NULL ? OK : -ENOMEM;
+}
+#endif
+
+/****************************************************************************
+ * Name: net_dellpm_ipv4 and net_dellpm_ipv6
+ *
+ * Description:
+ *   Remove an entry of the in-memory routing table from the trie before it
+ *   is freed.
+ *
+ * Input Parameters:
+ *   route - The routing table entry added by net_addlpm_ipvN()
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+#ifdef HAVE_ROUTE_IPv4_LPM
+void net_dellpm_ipv4(FAR struct net_route_ipv4_s *route)
+{
+  FAR struct net_route_ipv4_entry_s *entry =
+    (FAR struct net_route_ipv4_entry_s *)route;
+  FAR struct net_route_ipv4_entry_s *volatile *prev;
+  FAR struct lpm_node_s *node = g_ipv4_lpm.root;
+  in_addr_t key = route->target & route->netmask;
+  int plen = net_ipv4_mask2pref(route->netmask);
+
+  /* Find the node of the prefix */
+
+  while (node != NULL && node->plen < plen)
+    {
+      node = node->child[lpm_bit((FAR const uint8_t *)&key, node->plen)];
+    }
+
+  if (node == NULL || node->plen != plen ||
+      lpm_common(node->key, (FAR const uint8_t *)&key, plen) != plen)
+    {
+      return;
+    }
+
+  lpm_write_begin(&g_ipv4_lpm);
+
+  for (prev = (FAR struct net_route_ipv4_entry_s *volatile *)&node->routes;
+       *prev != NULL; prev = &(*prev)->lpmnext)
+    {
+      if (*prev == entry)
+        {
+          *prev = entry->lpmnext;
+          break;
+        }
+    }
+
+  if (node->routes == NULL)
+    {
+      lpm_remove(&g_ipv4_lpm, node);
+    }
+
+  lpm_write_end(&g_ipv4_lpm);
+}
+#endif
+
+#ifdef HAVE_ROUTE_IPv6_LPM
+void net_dellpm_ipv6(FAR struct net_route_ipv6_s *route)
+{
+  FAR struct net_route_ipv6_entry_s *entry =
+    (FAR struct net_route_ipv6_entry_s *)route;
+  FAR struct net_route_ipv6_entry_s *volatile *prev;
+  FAR struct lpm_node_s *node = g_ipv6_lpm.root;
+  net_ipv6addr_t key;
+  int plen = net_ipv6_mask2pref(route->netmask);
+  int i;
+
+  for (i = 0; i < 8; i++)
+    {
+      key[i] = route->target[i] & route->netmask[i];
+    }
+
+  /* Find the node of the prefix */
+
+  while (node != NULL && node->plen < plen)
+    {
+      node = node->child[lpm_bit((FAR const uint8_t *)key, node->plen)];
+    }
+
+  if (node == NULL || node->plen != plen ||
+      lpm_common(node->key, (FAR const uint8_t *)key, plen) != plen)
+    {
+      return;
+    }
+
+  lpm_write_begin(&g_ipv6_lpm);
+
+  for (prev = (FAR struct net_route_ipv6_entry_s *volatile *)&node->routes;
+       *prev != NULL; prev = &(*prev)->lpmnext)
+    {
+      if (*prev == entry)
+        {
+          *prev = entry->lpmnext;
+          break;
+        }
+    }
+
+  if (node->routes == NULL)
+    {
+      lpm_remove(&g_ipv6_lpm, node);
+    }
+
+  lpm_write_end(&g_ipv6_lpm);
+}
+#endif
+
+/****************************************************************************
+ * Name: net_matchlpm_ipv4 and net_matchlpm_ipv6
+ *
+ * Description:
+ *   Find the route with the longest prefix that matches target.  The trie
+ *   is read without the network lock: the lookup is only repeated with the
+ *   lock held if a route was added or deleted meanwhile.
+ *
+ * Input Parameters:
+ *   target    - The address to look up
+ *   prefixlen - Only match prefixes longer than this
+ *   dev       - If not NULL, the router must be on the network of dev
+ *   route     - Receives a copy of the matching routing table entry
+ *
+ * Returned Value:
+ *   The prefix length of the matching route; -ENOENT if there is none.
+ *
+ ****************************************************************************/
+
+#ifdef HAVE_ROUTE_IPv4_LPM
+int net_matchlpm_ipv4(in_addr_t target, int prefixlen,
+                      FAR struct net_driver_s *dev,
+                      FAR struct net_route_ipv4_s *route)
+{
+  struct lpm_ipv4_match_s match;
+
+  match.dev   = dev;
+  match.route = route;
+
+  return lpm_read(&g_ipv4_lpm, (FAR const uint8_t *)&target, 32,
+                  prefixlen, lpm_ipv4_match, &match);
+}
+#endif
+
+#ifdef HAVE_ROUTE_IPv6_LPM
+int net_matchlpm_ipv6(FAR const net_ipv6addr_t target, int prefixlen,
+                      FAR struct net_driver_s *dev,
+                      FAR struct net_route_ipv6_s *route)
+{
+  struct lpm_ipv6_match_s match;
+
+  match.dev   = dev;
+  match.route = route;
+
+  return lpm_read(&g_ipv6_lpm, (FAR const uint8_t *)target, 128,
+                  prefixlen, lpm_ipv6_match, &match);
+}
+#endif
+
+#endif /* HAVE_ROUTE_IPv4_LPM || HAVE_ROUTE_IPv6_LPM */
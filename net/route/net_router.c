@@ -36,6 +36,7 @@
 
 #include "devif/devif.h"
 #include "route/cacheroute.h"
+#include "route/lpmroute.h"
 #include "route/route.h"
 #include "utils/utils.h"
 
@@ -61,7 +62,7 @@
  * Private Types
  ****************************************************************************/
 
-#ifdef CONFIG_NET_IPv4
+#if defined(CONFIG_NET_IPv4) && !defined(HAVE_ROUTE_IPv4_LPM)
 struct route_ipv4_match_s
 {
   in_addr_t target;              /* Target IPv4 address on remote network */
@@ -81,7 +82,7 @@ struct route_ipv4_match_s
 };
 #endif
 
-#ifdef CONFIG_NET_IPv6
+#if defined(CONFIG_NET_IPv6) && !defined(HAVE_ROUTE_IPv6_LPM)
 struct route_ipv6_match_s
 {
   net_ipv6addr_t target;         /* Target IPv6 address on remote network */
@@ -120,7 +121,7 @@ struct route_ipv6_match_s
  *
  ****************************************************************************/
 
-#ifdef CONFIG_NET_IPv4
+#if defined(CONFIG_NET_IPv4) && !defined(HAVE_ROUTE_IPv4_LPM)
 static int net_ipv4_match(FAR struct net_route_ipv4_s *route, FAR void *arg)
 {
   FAR struct route_ipv4_match_s *match =
@@ -160,7 +161,7 @@ static int net_ipv4_match(FAR struct net_route_ipv4_s *route, FAR void *arg)
 
   return 0;
 }
-#endif /* CONFIG_NET_IPv4 */
+#endif /* CONFIG_NET_IPv4 && !HAVE_ROUTE_IPv4_LPM */
 
 /****************************************************************************
  * Name: net_ipv6_match
@@ -177,7 +178,7 @@ static int net_ipv4_match(FAR struct net_route_ipv4_s *route, FAR void *arg)
  *
  ****************************************************************************/
 
-#ifdef CONFIG_NET_IPv6
+#if defined(CONFIG_NET_IPv6) && !defined(HAVE_ROUTE_IPv6_LPM)
 static int net_ipv6_match(FAR struct net_route_ipv6_s *route, FAR void *arg)
 {
   FAR struct route_ipv6_match_s *match =
@@ -217,7 +218,7 @@ static int net_ipv6_match(FAR struct net_route_ipv6_s *route, FAR void *arg)
 
   return 0;
 }
-#endif /* CONFIG_NET_IPv6 */
+#endif /* CONFIG_NET_IPv6 && !HAVE_ROUTE_IPv6_LPM */
 
 /****************************************************************************
  * Public Functions
@@ -247,8 +248,12 @@ static int net_ipv6_match(FAR struct net_route_ipv6_s *route, FAR void *arg)
 int net_ipv4_router(in_addr_t target, FAR in_addr_t *router,
                     int8_t prefixlen)
 {
+#ifdef HAVE_ROUTE_IPv4_LPM
+  struct net_route_ipv4_s route;
+#else
   struct route_ipv4_match_s match;
   int ret;
+#endif
 
   /* Just early return for long prefix, maybe already got exact match. */
 
@@ -264,6 +269,17 @@ int net_ipv4_router(in_addr_t target, FAR in_addr_t *router,
       return -ENOENT;
     }
 
+#ifdef HAVE_ROUTE_IPv4_LPM
+  /* Look up the longest matching prefix in the trie */
+
+  if (net_matchlpm_ipv4(target, prefixlen, NULL, &route) < 0)
+    {
+      return -ENOENT;
+    }
+
+  net_ipv4addr_copy(*router, route.router);
+  return OK;
+#else
   /* Set up the comparison structure */
 
   memset(&match, 0, sizeof(struct route_ipv4_match_s));
@@ -314,6 +330,7 @@ int net_ipv4_router(in_addr_t target, FAR in_addr_t *router,
 
   net_ipv4addr_copy(*router, match.IPv4_ROUTER);
   return OK;
+#endif /* HAVE_ROUTE_IPv4_LPM */
 }
 #endif /* CONFIG_NET_IPv4 */
 
@@ -341,8 +358,12 @@ int net_ipv4_router(in_addr_t target, FAR in_addr_t *router,
 int net_ipv6_router(const net_ipv6addr_t target, net_ipv6addr_t router,
                     int16_t prefixlen)
 {
+#ifdef HAVE_ROUTE_IPv6_LPM
+  struct net_route_ipv6_s route;
+#else
   struct route_ipv6_match_s match;
   int ret;
+#endif
 
   /* Just early return for long prefix, maybe already got exact match. */
 
@@ -358,6 +379,17 @@ int net_ipv6_router(const net_ipv6addr_t target, net_ipv6addr_t router,
       return -ENOENT;
     }
 
+#ifdef HAVE_ROUTE_IPv6_LPM
+  /* Look up the longest matching prefix in the trie */
+
+  if (net_matchlpm_ipv6(target, prefixlen, NULL, &route) < 0)
+    {
+      return -ENOENT;
+    }
+
+  net_ipv6addr_copy(router, route.router);
+  return OK;
+#else
   /* Set up the comparison structure */
 
   memset(&match, 0, sizeof(struct route_ipv6_match_s));
@@ -408,6 +440,7 @@ int net_ipv6_router(const net_ipv6addr_t target, net_ipv6addr_t router,
 
   net_ipv6addr_copy(router, match.IPv6_ROUTER);
   return OK;
+#endif /* HAVE_ROUTE_IPv6_LPM */
 }
 #endif /* CONFIG_NET_IPv6 */
 
@@ -35,6 +35,7 @@
 
 #include "netdev/netdev.h"
 #include "route/cacheroute.h"
+#include "route/lpmroute.h"
 #include "route/route.h"
 #include "utils/utils.h"
 
@@ -60,7 +61,7 @@
  * Private Types
  ****************************************************************************/
 
-#ifdef CONFIG_NET_IPv4
+#if defined(CONFIG_NET_IPv4) && !defined(HAVE_ROUTE_IPv4_LPM)
 struct route_ipv4_devmatch_s
 {
   FAR struct net_driver_s *dev;  /* The route must use this device */
@@ -81,7 +82,7 @@ struct route_ipv4_devmatch_s
 };
 #endif
 
-#ifdef CONFIG_NET_IPv6
+#if defined(CONFIG_NET_IPv6) && !defined(HAVE_ROUTE_IPv6_LPM)
 struct route_ipv6_devmatch_s
 {
   FAR struct net_driver_s *dev;  /* The route must use this device */
@@ -121,7 +122,7 @@ struct route_ipv6_devmatch_s
  *
  ****************************************************************************/
 
-#ifdef CONFIG_NET_IPv4
+#if defined(CONFIG_NET_IPv4) && !defined(HAVE_ROUTE_IPv4_LPM)
 static int net_ipv4_devmatch(FAR struct net_route_ipv4_s *route,
                              FAR void *arg)
 {
@@ -167,7 +168,7 @@ static int net_ipv4_devmatch(FAR struct net_route_ipv4_s *route,
 
   return 0;
 }
-#endif /* CONFIG_NET_IPv4 */
+#endif /* CONFIG_NET_IPv4 && !HAVE_ROUTE_IPv4_LPM */
 
 /****************************************************************************
  * Name: net_ipv6_devmatch
@@ -184,7 +185,7 @@ static int net_ipv4_devmatch(FAR struct net_route_ipv4_s *route,
  *
  ****************************************************************************/
 
-#ifdef CONFIG_NET_IPv6
+#if defined(CONFIG_NET_IPv6) && !defined(HAVE_ROUTE_IPv6_LPM)
 static int net_ipv6_devmatch(FAR struct net_route_ipv6_s *route,
                              FAR void *arg)
 {
@@ -230,7 +231,7 @@ static int net_ipv6_devmatch(FAR struct net_route_ipv6_s *route,
 
   return 0;
 }
-#endif /* CONFIG_NET_IPv6 */
+#endif /* CONFIG_NET_IPv6 && !HAVE_ROUTE_IPv6_LPM */
 
 /****************************************************************************
  * Public Functions
@@ -261,6 +262,22 @@ static int net_ipv6_devmatch(FAR struct net_route_ipv6_s *route,
 void netdev_ipv4_router(FAR struct net_driver_s *dev, in_addr_t target,
                         FAR in_addr_t *router)
 {
+#ifdef HAVE_ROUTE_IPv4_LPM
+  struct net_route_ipv4_s route;
+
+  /* Look up the longest matching prefix with a router on this device,
+   * fallback to the default router of the device.
+   */
+
+  if (net_matchlpm_ipv4(target, -1, dev, &route) >= 0)
+    {
+      net_ipv4addr_copy(*router, route.router);
+    }
+  else
+    {
+      net_ipv4addr_copy(*router, dev->d_draddr);
+    }
+#else
   struct route_ipv4_devmatch_s match;
   int ret;
 
@@ -319,6 +336,7 @@ void netdev_ipv4_router(FAR struct net_driver_s *dev, in_addr_t target,
 
       net_ipv4addr_copy(*router, dev->d_draddr);
     }
+#endif /* HAVE_ROUTE_IPv4_LPM */
 }
 #endif
 
@@ -348,6 +366,22 @@ void netdev_ipv6_router(FAR struct net_driver_s *dev,
                         FAR const net_ipv6addr_t target,
                         FAR net_ipv6addr_t router)
 {
+#ifdef HAVE_ROUTE_IPv6_LPM
+  struct net_route_ipv6_s route;
+
+  /* Look up the longest matching prefix with a router on this device,
+   * fallback to the default router of the device.
+   */
+
+  if (net_matchlpm_ipv6(target, -1, dev, &route) >= 0)
+    {
+      net_ipv6addr_copy(router, route.router);
+    }
+  else
+    {
+      net_ipv6addr_copy(router, dev->d_ipv6draddr);
+    }
+#else
   struct route_ipv6_devmatch_s match;
   int ret;
 
@@ -404,6 +438,7 @@ void netdev_ipv6_router(FAR struct net_driver_s *dev,
 
       net_ipv6addr_copy(router, dev->d_ipv6draddr);
     }
+#endif /* HAVE_ROUTE_IPv6_LPM */
 }
 #endif
 
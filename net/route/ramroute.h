@@ -68,6 +68,9 @@ struct net_route_ipv4_entry_s
 {
   struct net_route_ipv4_s entry;
   FAR struct net_route_ipv4_entry_s *flink;
+#ifdef CONFIG_ROUTE_LPM_TRIE
+  FAR struct net_route_ipv4_entry_s *volatile lpmnext; /* Same prefix */
+#endif
 };
 
 /* This structure describes the head of a routing table list */
@@ -86,6 +89,9 @@ struct net_route_ipv6_entry_s
 {
   struct net_route_ipv6_s entry;
   FAR struct net_route_ipv6_entry_s *flink;
+#ifdef CONFIG_ROUTE_LPM_TRIE
+  FAR struct net_route_ipv6_entry_s *volatile lpmnext; /* Same prefix */
+#endif
 };
 
 /* This structure describes the head of a routing table list */
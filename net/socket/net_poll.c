@@ -31,6 +31,10 @@
 
 #include <nuttx/net/net.h>
 
+#include "netdev/netdev.h"
+#include "inet/inet.h"
+#include "tcp/tcp.h"
+#include "udp/udp.h"
 #include "socket/socket.h"
 
 /****************************************************************************
@@ -69,3 +73,109 @@ int psock_poll(FAR struct socket *psock, FAR struct pollfd *fds, bool setup)
 
   return psock->s_sockif->si_poll(psock, fds, setup);
 }
+
+/****************************************************************************
+ * Name: psock_busypoll_proto
+ *
+ * Description:
+ *   Return the transport protocol a busy poll would use for the socket.
+ *   Only sockets of the inet socket interface carry a tcp_conn_s or
+ *   udp_conn_s; ICMP, usrsock and the other address families do not.
+ *
+ * Input Parameters:
+ *   psock - An instance of the internal socket structure.
+ *
+ * Returned Value:
+ *   IPPROTO_TCP or IPPROTO_UDP, or zero if the socket cannot busy poll.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_BUSY_POLL
+int psock_busypoll_proto(FAR struct socket *psock)
+{
+#ifdef HAVE_INET_SOCKETS
+  if ((psock->s_domain != PF_INET && psock->s_domain != PF_INET6) ||
+      psock->s_sockif != inet_sockif(psock->s_domain, psock->s_type,
+                                     psock->s_proto))
+    {
+      return 0;
+    }
+
+#ifdef NET_TCP_HAVE_STACK
+  if (psock->s_type == SOCK_STREAM ||
+      (psock->s_type == SOCK_CTRL &&
+      (psock->s_proto == 0 || psock->s_proto == IPPROTO_TCP)))
+    {
+      return IPPROTO_TCP;
+    }
+#endif
+
+#ifdef NET_UDP_HAVE_STACK
+  if (psock->s_type == SOCK_DGRAM ||
+      (psock->s_type == SOCK_CTRL &&
+      (psock->s_proto == 0 || psock->s_proto == IPPROTO_UDP)))
+    {
+      return IPPROTO_UDP;
+    }
+#endif
+#endif /* HAVE_INET_SOCKETS */
+
+  return 0;
+}
+
+/****************************************************************************
+ * Name: psock_busypoll
+ *
+ * Description:
+ *   Receive from the network device of a TCP or UDP socket for its
+ *   SO_BUSY_POLL time, or until the semaphore of the poll() call has been
+ *   posted.  poll() and epoll_wait() call this once before they sleep.
+ *
+ * Input Parameters:
+ *   psock - An instance of the internal socket structure.
+ *   sem   - The semaphore posted when an event is reported.
+ *
+ * Returned Value:
+ *   True if the socket has a busy poll time and the device was polled.
+ *
+ ****************************************************************************/
+
+bool psock_busypoll(FAR struct socket *psock, FAR sem_t *sem)
+{
+  FAR struct socket_conn_s *conn = psock->s_conn;
+  FAR struct net_driver_s *dev;
+  int proto;
+
+  proto = psock_busypoll_proto(psock);
+  if (proto == 0 || conn == NULL || conn->s_busypoll == 0 ||
+      netdev_busypoll_sem(sem))
+    {
+      return false;
+    }
+
+  net_lock();
+
+#ifdef NET_TCP_HAVE_STACK
+  if (proto == IPPROTO_TCP)
+    {
+      dev = ((FAR struct tcp_conn_s *)conn)->dev;
+    }
+  else
+#endif
+#ifdef NET_UDP_HAVE_STACK
+  if (proto == IPPROTO_UDP)
+    {
+      dev = udp_find_laddr_device((FAR struct udp_conn_s *)conn);
+    }
+  else
+#endif
+    {
+      net_unlock();
+      return false;
+    }
+
+  netdev_busypoll(dev, conn->s_busypoll, netdev_busypoll_sem, sem);
+  net_unlock();
+  return true;
+}
+#endif
@@ -0,0 +1,514 @@
+/****************************************************************************
+ * net/socket/net_zerocopy.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+#ifdef CONFIG_NET_ZEROCOPY
+
+#include <sys/param.h>
+#include <stdint.h>
+#include <string.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <netinet/in.h>
+
+#include <nuttx/kmalloc.h>
+#include <nuttx/queue.h>
+#include <nuttx/spinlock.h>
+#include <nuttx/mm/iob.h>
+#include <nuttx/net/net.h>
+
+#include "socket/socket.h"
+#include "utils/utils.h"
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* One MSG_ZEROCOPY send.  The record is on g_zerocopy_active while the
+ * stack holds IOBs referring to the user buffer, then on the s_zcdone
+ * queue of its connection until the completion is read from the error
+ * queue.
+ */
+
+struct zerocopy_s
+{
+  dq_entry_t                   node;    /* Link in g_zerocopy_active */
+  sq_entry_t                   flink;   /* Link in conn->s_zcdone */
+  FAR struct socket_conn_s    *conn;    /* NULL once the socket is freed */
+  FAR const uint8_t           *buf;     /* The user buffer */
+  size_t                       len;     /* Length of the user buffer */
+  uint32_t                     id;      /* Notification id of the send */
+  uint16_t                     niob;    /* IOBs still referring to buf */
+  bool                         sending; /* The send call is in progress */
+  bool                         copied;  /* The data was copied */
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static dq_queue_t g_zerocopy_active;
+static spinlock_t g_zerocopy_lock = SP_UNLOCKED;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: zerocopy_complete
+ *
+ * Description:
+ *   Move a record whose data is no longer referenced by the stack to the
+ *   error queue of its connection, or free it if the socket is gone.
+ *
+ * Returned Value:
+ *   The record if the caller must free it, NULL otherwise.
+ *
+ * Assumptions:
+ *   g_zerocopy_lock is held.
+ *
+ ****************************************************************************/
+
+static FAR struct zerocopy_s *zerocopy_complete(FAR struct zerocopy_s *zc)
+{
+  dq_rem(&zc->node, &g_zerocopy_active);
+
+  if (zc->conn == NULL)
+    {
+      return zc;
+    }
+
+  sq_addlast(&zc->flink, &zc->conn->s_zcdone);
+  return NULL;
+}
+
+/****************************************************************************
+ * Name: zerocopy_free
+ *
+ * Description:
+ *   The io_free callback of the IOBs wrapping a user buffer, called with
+ *   the record of the send that allocated the IOB.  This may be called
+ *   from the interrupt handler of the network driver.
+ *
+ ****************************************************************************/
+
+static void zerocopy_free(FAR void *arg)
+{
+  FAR struct zerocopy_s *zc = arg;
+  FAR struct zerocopy_s *release = NULL;
+  irqstate_t flags;
+
+  flags = spin_lock_irqsave(&g_zerocopy_lock);
+
+  DEBUGASSERT(zc->niob > 0);
+  if (--zc->niob == 0 && !zc->sending)
+    {
+      release = zerocopy_complete(zc);
+    }
+
+  spin_unlock_irqrestore(&g_zerocopy_lock, flags);
+
+  if (release != NULL)
+    {
+      kmm_free(release);
+    }
+}
+
+/****************************************************************************
+ * Name: zerocopy_discard
+ *
+ * Description:
+ *   The io_free callback of IOBs that were never handed to the stack.
+ *
+ ****************************************************************************/
+
+static void zerocopy_discard(FAR void *arg)
+{
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: zerocopy_begin
+ *
+ * Description:
+ *   Start a send.  If MSG_ZEROCOPY is requested on a socket with
+ *   SO_ZEROCOPY enabled, a record is allocated and the send is assigned
+ *   the next notification id.  Sends shorter than
+ *   CONFIG_NET_ZEROCOPY_THRESHOLD are still copied, their completion is
+ *   reported with SO_EE_CODE_ZEROCOPY_COPIED.
+ *
+ * Input Parameters:
+ *   conn  - The connection of the socket
+ *   buf   - The user buffer
+ *   len   - The length of the user buffer
+ *   flags - The send flags
+ *   zc    - Receives the record, NULL if this is a normal send
+ *
+ * Returned Value:
+ *   OK on success; -ENOBUFS if no record could be allocated.
+ *
+ ****************************************************************************/
+
+int zerocopy_begin(FAR struct socket_conn_s *conn, FAR const void *buf,
+                   size_t len, int flags, FAR struct zerocopy_s **zc)
+{
+  FAR struct zerocopy_s *rec;
+  irqstate_t irqflags;
+
+  *zc = NULL;
+
+  if ((flags & MSG_ZEROCOPY) == 0 || len == 0 ||
+      !_SO_GETOPT(conn->s_options, SO_ZEROCOPY))
+    {
+      return OK;
+    }
+
+  rec = kmm_zalloc(sizeof(struct zerocopy_s));
+  if (rec == NULL)
+    {
+      return -ENOBUFS;
+    }
+
+  rec->conn    = conn;
+  rec->buf     = buf;
+  rec->len     = len;
+  rec->sending = true;
+  rec->copied  = len < CONFIG_NET_ZEROCOPY_THRESHOLD;
+
+  irqflags = spin_lock_irqsave(&g_zerocopy_lock);
+  rec->id  = conn->s_zcnext++;
+  dq_addlast(&rec->node, &g_zerocopy_active);
+  spin_unlock_irqrestore(&g_zerocopy_lock, irqflags);
+
+  *zc = rec;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: zerocopy_iob_append
+ *
+ * Description:
+ *   Wrap part of the user buffer into IOBs and add them to the end of the
+ *   packet in *iob.  If the packet is still empty, its head IOB is replaced
+ *   instead.  Either all of the data is added or none.
+ *
+ * Input Parameters:
+ *   zc  - The record returned by zerocopy_begin(), may be NULL
+ *   iob - The packet to extend
+ *   buf - The data, inside the buffer passed to zerocopy_begin()
+ *   len - The length of the data
+ *
+ * Returned Value:
+ *   len on success; -ENOSYS if the data must be copied, because this is
+ *   not a zero copy send or it is too short; -ENOMEM if the IOBs could not
+ *   be allocated, the rest of the send is then copied too.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+ssize_t zerocopy_iob_append(FAR struct zerocopy_s *zc,
+                            FAR struct iob_s **iob,
+                            FAR const void *buf, size_t len)
+{
+  FAR const uint8_t *ptr = buf;
+  FAR struct iob_s *head = NULL;
+  FAR struct iob_s *tail = NULL;
+  FAR struct iob_s *next;
+  irqstate_t flags;
+  uint16_t niob = 0;
+  size_t remain;
+
+  if (zc == NULL || zc->copied)
+    {
+      return -ENOSYS;
+    }
+
+  DEBUGASSERT(ptr >= zc->buf && ptr + len <= zc->buf + zc->len);
+
+  for (remain = len; remain > 0; remain -= next->io_len)
+    {
+      next = iob_alloc_with_arg((FAR void *)ptr, MIN(remain, UINT16_MAX),
+                                zerocopy_free, zc);
+      if (next == NULL)
+        {
+          for (next = head; next != NULL; next = next->io_flink)
+            {
+              next->io_free = zerocopy_discard;
+            }
+
+          if (head != NULL)
+            {
+              iob_free_chain(head);
+            }
+
+          zc->copied = true;
+          return -ENOMEM;
+        }
+
+      next->io_len = next->io_bufsize;
+      ptr         += next->io_len;
+      niob++;
+
+      if (tail == NULL)
+        {
+          head = next;
+        }
+      else
+        {
+          tail->io_flink = next;
+        }
+
+      tail = next;
+    }
+
+  flags = spin_lock_irqsave(&g_zerocopy_lock);
+  zc->niob += niob;
+  spin_unlock_irqrestore(&g_zerocopy_lock, flags);
+
+  if ((*iob)->io_pktlen == 0)
+    {
+      /* Nothing in the packet yet, drop the empty IOB */
+
+      iob_free_chain(*iob);
+      head->io_pktlen = len;
+      *iob = head;
+    }
+  else
+    {
+      next = *iob;
+      while (next->io_flink != NULL)
+        {
+          next = next->io_flink;
+        }
+
+      next->io_flink    = head;
+      (*iob)->io_pktlen += len;
+    }
+
+  return len;
+}
+
+/****************************************************************************
+ * Name: zerocopy_end
+ *
+ * Description:
+ *   Finish the send started by zerocopy_begin().  The completion is
+ *   reported once the stack released all of the IOBs referring to the
+ *   user buffer, immediately if the data was copied.  If nothing was sent
+ *   and no later send took a notification id, the id is reused.
+ *
+ * Input Parameters:
+ *   zc   - The record returned by zerocopy_begin(), may be NULL
+ *   sent - The return value of the send
+ *
+ ****************************************************************************/
+
+void zerocopy_end(FAR struct zerocopy_s *zc, ssize_t sent)
+{
+  FAR struct zerocopy_s *release = NULL;
+  irqstate_t flags;
+
+  if (zc == NULL)
+    {
+      return;
+    }
+
+  flags = spin_lock_irqsave(&g_zerocopy_lock);
+
+  zc->sending = false;
+  if (sent <= 0 && zc->niob == 0 && zc->conn != NULL &&
+      zc->conn->s_zcnext == zc->id + 1)
+    {
+      zc->conn->s_zcnext--;
+      dq_rem(&zc->node, &g_zerocopy_active);
+      release = zc;
+    }
+  else if (zc->niob == 0)
+    {
+      release = zerocopy_complete(zc);
+    }
+
+  spin_unlock_irqrestore(&g_zerocopy_lock, flags);
+
+  if (release != NULL)
+    {
+      kmm_free(release);
+    }
+}
+
+/****************************************************************************
+ * Name: zerocopy_release
+ *
+ * Description:
+ *   Detach the sends of a connection that is being freed.  Pending
+ *   completions are dropped, the records of data still held by a network
+ *   device are freed when the device releases it.
+ *
+ * Input Parameters:
+ *   conn - The connection being freed
+ *
+ ****************************************************************************/
+
+void zerocopy_release(FAR struct socket_conn_s *conn)
+{
+  FAR struct zerocopy_s *zc;
+  FAR dq_entry_t *entry;
+  FAR sq_entry_t *flink;
+  sq_queue_t done;
+  irqstate_t flags;
+
+  flags = spin_lock_irqsave(&g_zerocopy_lock);
+
+  for (entry = dq_peek(&g_zerocopy_active); entry; entry = dq_next(entry))
+    {
+      zc = (FAR struct zerocopy_s *)entry;
+      if (zc->conn == conn)
+        {
+          zc->conn = NULL;
+        }
+    }
+
+  sq_move(&conn->s_zcdone, &done);
+  spin_unlock_irqrestore(&g_zerocopy_lock, flags);
+
+  while ((flink = sq_remfirst(&done)) != NULL)
+    {
+      kmm_free(container_of(flink, struct zerocopy_s, flink));
+    }
+}
+
+/****************************************************************************
+ * Name: zerocopy_recverr
+ *
+ * Description:
+ *   Implement recvmsg(MSG_ERRQUEUE): return the completions of consecutive
+ *   MSG_ZEROCOPY sends as one struct sock_extended_err control message,
+ *   with the first and the last notification id in ee_info and ee_data.
+ *
+ * Input Parameters:
+ *   psock - The socket
+ *   msg   - The message, only the control buffer is used
+ *
+ * Returned Value:
+ *   0 on success; -EAGAIN if no completion is pending.
+ *
+ ****************************************************************************/
+
+ssize_t zerocopy_recverr(FAR struct socket *psock, FAR struct msghdr *msg)
+{
+  FAR struct socket_conn_s *conn = psock->s_conn;
+  struct sock_extended_err serr;
+  FAR struct zerocopy_s *first;
+  FAR struct zerocopy_s *zc;
+  FAR sq_entry_t *entry;
+  unsigned long controllen;
+  FAR void *control;
+  sq_queue_t done;
+  irqstate_t flags;
+  int level;
+  int type;
+
+  sq_init(&done);
+  memset(&serr, 0, sizeof(serr));
+
+  flags = spin_lock_irqsave(&g_zerocopy_lock);
+
+  entry = sq_remfirst(&conn->s_zcdone);
+  if (entry == NULL)
+    {
+      spin_unlock_irqrestore(&g_zerocopy_lock, flags);
+      return -EAGAIN;
+    }
+
+  first = container_of(entry, struct zerocopy_s, flink);
+  sq_addlast(entry, &done);
+
+  serr.ee_origin = SO_EE_ORIGIN_ZEROCOPY;
+  serr.ee_info   = first->id;
+  serr.ee_data   = first->id;
+  serr.ee_code   = first->copied ? SO_EE_CODE_ZEROCOPY_COPIED : 0;
+
+  /* Merge the following sends while their ids are consecutive */
+
+  while ((entry = sq_peek(&conn->s_zcdone)) != NULL)
+    {
+      zc = container_of(entry, struct zerocopy_s, flink);
+      if (zc->id != serr.ee_data + 1)
+        {
+          break;
+        }
+
+      if (zc->copied)
+        {
+          serr.ee_code = SO_EE_CODE_ZEROCOPY_COPIED;
+        }
+
+      serr.ee_data = zc->id;
+      sq_remfirst(&conn->s_zcdone);
+      sq_addlast(entry, &done);
+    }
+
+  spin_unlock_irqrestore(&g_zerocopy_lock, flags);
+
+  while ((entry = sq_remfirst(&done)) != NULL)
+    {
+      kmm_free(container_of(entry, struct zerocopy_s, flink));
+    }
+
+#ifdef CONFIG_NET_IPv6
+  if (psock->s_domain == PF_INET6)
+    {
+      level = SOL_IPV6;
+      type  = IPV6_RECVERR;
+    }
+  else
+#endif
+    {
+      level = SOL_IP;
+      type  = IP_RECVERR;
+    }
+
+  control    = msg->msg_control;
+  controllen = msg->msg_controllen;
+
+  msg->msg_flags = MSG_ERRQUEUE;
+  if (cmsg_append(msg, level, type, &serr, sizeof(serr)) == NULL)
+    {
+      msg->msg_flags |= MSG_CTRUNC;
+    }
+
+  msg->msg_control    = control;
+  msg->msg_controllen = controllen - msg->msg_controllen;
+  return 0;
+}
+
+#endif /* CONFIG_NET_ZEROCOPY */
@@ -76,6 +76,25 @@ ssize_t psock_recvmsg(FAR struct socket *psock, FAR struct msghdr *msg,
   FAR void *msg_control;
   int ret;
 
+#ifdef CONFIG_NET_ZEROCOPY
+  /* The error queue only holds MSG_ZEROCOPY completions, no data */
+
+  if ((flags & MSG_ERRQUEUE) != 0)
+    {
+      if (msg == NULL)
+        {
+          return -EINVAL;
+        }
+
+      if (psock == NULL || psock->s_conn == NULL)
+        {
+          return -EBADF;
+        }
+
+      return zerocopy_recverr(psock, msg);
+    }
+#endif
+
   /* Verify that non-NULL pointers were passed */
 
   if (msg == NULL || msg->msg_iov == NULL || msg->msg_iov->iov_base == NULL)
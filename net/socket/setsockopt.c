@@ -137,6 +137,12 @@ static int psock_socketlevel_option(FAR struct socket *psock, int option,
                            * periodic transmission of probes */
       case SO_OOBINLINE:  /* Leaves received out-of-band data inline */
       case SO_REUSEADDR:  /* Allow reuse of local addresses */
+#ifdef CONFIG_NET_TCP_REUSEPORT
+      case SO_REUSEPORT:  /* Allow sharing of local addresses and ports */
+#endif
+#ifdef CONFIG_NET_ZEROCOPY
+      case SO_ZEROCOPY:   /* Allow MSG_ZEROCOPY sends */
+#endif
 #ifdef CONFIG_NET_TIMESTAMP
       case SO_TIMESTAMP:  /* Generates a timestamp for each incoming packet */
 #endif
@@ -222,6 +228,41 @@ static int psock_socketlevel_option(FAR struct socket *psock, int option,
         }
 #endif
 
+#ifdef CONFIG_NET_BUSY_POLL
+      case SO_BUSY_POLL:  /* Busy poll time before blocking */
+        {
+          int usec;
+
+          /* Only inet TCP and UDP sockets know their network device */
+
+          if (psock_busypoll_proto(psock) == 0)
+            {
+              return -ENOPROTOOPT;
+            }
+
+          if (value_len != sizeof(int))
+            {
+              return -EINVAL;
+            }
+
+          usec = *(FAR int *)value;
+          if (usec < 0)
+            {
+              return -EINVAL;
+            }
+
+          /* Limited by the system-wide maximum */
+
+          if (usec > CONFIG_NET_BUSY_POLL_MAX)
+            {
+              usec = CONFIG_NET_BUSY_POLL_MAX;
+            }
+
+          conn->s_busypoll = usec;
+          break;
+        }
+#endif
+
       /* There options are only valid when used with getopt */
 
       case SO_ACCEPTCONN: /* Reports whether socket listening is enabled */
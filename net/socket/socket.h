@@ -66,10 +66,13 @@
 #define _SO_TYPE         _SO_BIT(SO_TYPE)
 #define _SO_TIMESTAMP    _SO_BIT(SO_TIMESTAMP)
 #define _SO_BINDTODEVICE _SO_BIT(SO_BINDTODEVICE)
+#define _SO_REUSEPORT    _SO_BIT(SO_REUSEPORT)
+#define _SO_ZEROCOPY     _SO_BIT(SO_ZEROCOPY)
+#define _SO_BUSY_POLL    _SO_BIT(SO_BUSY_POLL)
 
 /* This is the largest option value.  REVISIT: belongs in sys/socket.h */
 
-#define _SO_MAXOPT       (18)
+#define _SO_MAXOPT       (21)
 
 /* Macros to set, test, clear options */
 
@@ -182,6 +185,67 @@ net_sockif(sa_family_t family, int type, int protocol);
 int net_timeo(clock_t start_time, socktimeo_t timeo);
 #endif
 
+/****************************************************************************
+ * Name: psock_busypoll_proto
+ *
+ * Description:
+ *   Return the transport protocol a busy poll would use for the socket.
+ *
+ * Input Parameters:
+ *   psock - An instance of the internal socket structure.
+ *
+ * Returned Value:
+ *   IPPROTO_TCP or IPPROTO_UDP, or zero if the socket cannot busy poll.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_BUSY_POLL
+int psock_busypoll_proto(FAR struct socket *psock);
+#endif
+
+#ifdef CONFIG_NET_ZEROCOPY
+/****************************************************************************
+ * Name: zerocopy_begin, zerocopy_iob_append and zerocopy_end
+ *
+ * Description:
+ *   Send the user buffer of a MSG_ZEROCOPY send in place.  See
+ *   net/socket/net_zerocopy.c.
+ *
+ ****************************************************************************/
+
+struct zerocopy_s;  /* Forward reference */
+
+int zerocopy_begin(FAR struct socket_conn_s *conn, FAR const void *buf,
+                   size_t len, int flags, FAR struct zerocopy_s **zc);
+ssize_t zerocopy_iob_append(FAR struct zerocopy_s *zc,
+                            FAR struct iob_s **iob,
+                            FAR const void *buf, size_t len);
+void zerocopy_end(FAR struct zerocopy_s *zc, ssize_t sent);
+
+/****************************************************************************
+ * Name: zerocopy_release
+ *
+ * Description:
+ *   Detach the MSG_ZEROCOPY sends of a connection that is being freed.
+ *
+ ****************************************************************************/
+
+void zerocopy_release(FAR struct socket_conn_s *conn);
+
+/****************************************************************************
+ * Name: zerocopy_recverr
+ *
+ * Description:
+ *   Read the next completion of MSG_ZEROCOPY sends from the error queue.
+ *
+ * Returned Value:
+ *   0 on success; -EAGAIN if no completion is pending.
+ *
+ ****************************************************************************/
+
+ssize_t zerocopy_recverr(FAR struct socket *psock, FAR struct msghdr *msg);
+#endif
+
 #undef EXTERN
 #if defined(__cplusplus)
 }
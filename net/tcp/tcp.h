@@ -76,6 +76,10 @@
 #if defined(CONFIG_NET_TCP_FAST_RETRANSMIT) && !defined(CONFIG_NET_TCP_CC_NEWRENO)
 #  define TCP_WBNACK(wrb)            ((wrb)->wb_nack)
 #endif
+#ifdef CONFIG_NET_TCP_RACK
+#  define TCP_WBXMIT(wrb)            ((wrb)->wb_xmit)
+#  define TCP_WBSACKED(wrb)          ((wrb)->wb_sacked)
+#endif
 #  define TCP_WBIOB(wrb)             ((wrb)->wb_iob)
 #  define TCP_WBCOPYOUT(wrb,dest,n)  (iob_copyout(dest,(wrb)->wb_iob,(n),0))
 #  define TCP_WBCOPYIN(wrb,src,n,off) \
@@ -109,6 +113,7 @@
 #define TCP_WSCALE            0x01U /* Window Scale option enabled */
 #define TCP_SACK              0x02U /* Selective ACKs enabled */
 #define TCP_CLOSE_ARRANGED    0x04U /* Connection is arranged to be freed */
+#define TCP_TSTAMP            0x20U /* Timestamps option enabled */
 
 #ifdef CONFIG_NET_TCP_CC_NEWRENO
 /* The TCP flags for congestion control */
@@ -116,6 +121,35 @@
 #define TCP_INFR              0x08U /* The flag in Fast Recovery */
 #define TCP_INFT              0x10U /* The flag in Fast Transmitted */
 
+/* The congestion control of the sockets that do not select one */
+
+#if defined(CONFIG_NET_TCP_CC_DEFAULT_CUBIC)
+#  define TCP_CC_DEFAULT      (&g_tcp_cc_cubic)
+#elif defined(CONFIG_NET_TCP_CC_DEFAULT_BBR)
+#  define TCP_CC_DEFAULT      (&g_tcp_cc_bbr)
+#else
+#  define TCP_CC_DEFAULT      (&g_tcp_cc_newreno)
+#endif
+#endif
+
+#ifdef CONFIG_NET_TCP_RACK
+/* The TCP flags for RACK-TLP */
+
+#define TCP_RACK_EXPIRED      0x0040U /* The RACK timer expired */
+#define TCP_TLP_ARMED         0x0080U /* The RACK timer is a loss probe */
+#define TCP_TLP_INFLIGHT      0x0100U /* A loss probe is outstanding */
+#endif
+
+/* The options sent in every segment of a connection, they are part of
+ * tcpip_hdrsize().  The Timestamps option is padded with two NOPs.
+ */
+
+#ifdef CONFIG_NET_TCP_TIMESTAMPS
+#  define TCP_OPT_TS_SPACE    12
+#  define TCP_OPTLEN(conn)    (((conn)->flags & TCP_TSTAMP) != 0 ? \
+                               TCP_OPT_TS_SPACE : 0)
+#else
+#  define TCP_OPTLEN(conn)    0
 #endif
 
 /* The Max Range count of TCP Selective ACKs */
@@ -180,6 +214,157 @@ struct tcp_sack_s
   uint32_t right;   /* Right edge of the SACK */
 };
 
+#ifdef CONFIG_NET_TCP_OUT_OF_ORDER
+/* Out-of-order pool, also the source of the SACK blocks we send.  Most
+ * connections never see a hole, so the pool is allocated on the first
+ * out-of-order segment and released again once the hole is filled.
+ */
+
+struct tcp_ofo_s
+{
+  uint8_t nofosegs;       /* Number of out-of-order segments */
+  struct tcp_ofoseg_s ofosegs[TCP_SACK_RANGES_MAX];
+};
+
+#  define TCP_NOFOSEGS(conn)  ((conn)->ofo != NULL ? \
+                               (conn)->ofo->nofosegs : 0)
+#endif
+
+#ifdef CONFIG_NET_TCP_KEEPALIVE
+/* Keep-alive state, allocated by the first keep-alive socket option.  The
+ * times are in deciseconds.  A connection without it uses the defaults
+ * below and does not send probes.
+ */
+
+struct tcp_keepalive_s
+{
+  uint32_t keeptimer;     /* KeepAlive timer (dsec) */
+  uint32_t keepidle;      /* Elapsed idle time before first probe sent (dsec) */
+  uint32_t keepintvl;     /* Interval between probes (dsec) */
+  bool     enabled;       /* True: KeepAlive enabled; false: disabled */
+  uint8_t  keepcnt;       /* Number of retries before the socket is closed */
+  uint8_t  keepretries;   /* Number of retries attempted */
+};
+
+#  define TCP_KEEPIDLE_DEFAULT  (2 * DSEC_PER_HOUR)
+#  define TCP_KEEPINTVL_DEFAULT (2 * DSEC_PER_SEC)
+#  define TCP_KEEPCNT_DEFAULT   3
+
+#  define TCP_KEEPALIVE(conn) ((conn)->ka != NULL && (conn)->ka->enabled)
+#endif
+
+#if CONFIG_NET_TCP_TIMEWAIT_RECORDS > 0
+/* What is left of a connection that was released in TIME_WAIT: enough to
+ * re-ACK a retransmitted FIN and to tell a new SYN from an old duplicate
+ * (RFC 793, RFC 1122 4.2.2.13).
+ */
+
+struct tcp_timewait_s
+{
+  sq_entry_t         hnode;  /* Hash chain */
+  dq_entry_t         anode;  /* Age list, oldest first */
+  union ip_binding_u u;      /* IP address binding */
+  clock_t            expire; /* End of TIME_WAIT (ticks) */
+  uint32_t           rcvseq; /* Next sequence number expected */
+  uint32_t           sndseq; /* Sequence number after our FIN */
+  uint16_t           lport;  /* Local port, network byte order */
+  uint16_t           rport;  /* Remote port, network byte order */
+#if defined(CONFIG_NET_IPv4) && defined(CONFIG_NET_IPv6)
+  uint8_t            domain; /* IP domain: PF_INET or PF_INET6 */
+#endif
+};
+#endif
+
+#ifdef CONFIG_NET_TCP_CC_NEWRENO
+/* A congestion control algorithm.  tcp_cc.c keeps the duplicate ACK and
+ * fast recovery logic common to all of them, the algorithm decides how the
+ * congestion window grows and how it is reduced on a loss.
+ */
+
+struct tcp_conn_s;
+struct tcp_cc_ops_s
+{
+  FAR const char *name;   /* Name used by TCP_CONGESTION */
+
+  /* Reset the private state of the algorithm, optional */
+
+  CODE void (*init)(FAR struct tcp_conn_s *conn);
+
+  /* Every ACK of new data, also in fast recovery, optional */
+
+  CODE void (*ack)(FAR struct tcp_conn_s *conn, uint32_t ackno,
+                   uint32_t acked);
+
+  /* Grow cwnd on an ACK of new data out of fast recovery */
+
+  CODE void (*cong_avoid)(FAR struct tcp_conn_s *conn, uint32_t acked);
+
+  /* Set ssthresh and cwnd on entering fast recovery or on a retransmission
+   * timeout.  Leaving fast recovery restores cwnd to ssthresh.
+   */
+
+  CODE void (*loss)(FAR struct tcp_conn_s *conn, bool timeout);
+};
+
+#ifdef CONFIG_NET_TCP_CC_CUBIC
+/* CUBIC (RFC 8312) state, windows in segments */
+
+struct tcp_cubic_s
+{
+  clock_t  epoch_start;   /* Start of the current epoch, 0 if none */
+  uint32_t last_max_cwnd; /* Window before the last reduction */
+  uint32_t origin_point;  /* Origin of the cubic function */
+  uint32_t k;             /* Time to reach origin_point (1/1024 sec) */
+  uint32_t cnt;           /* Segments to ACK per segment of growth */
+  uint32_t cwnd_cnt;      /* Bytes ACKed towards the next growth */
+  uint32_t ack_cnt;       /* Bytes ACKed for the Reno estimate */
+  uint32_t tcp_cwnd;      /* Reno-friendly window estimate */
+};
+#endif
+
+#ifdef CONFIG_NET_TCP_CC_BBR
+/* BBRv1 state */
+
+struct tcp_bbr_s
+{
+  uint8_t  mode;             /* STARTUP, DRAIN, PROBE_BW or PROBE_RTT */
+  uint8_t  cycle_idx;        /* Phase of the PROBE_BW gain cycle */
+  uint8_t  full_bw_cnt;      /* Rounds without bandwidth growth */
+  bool     full_bw_reached;  /* The pipe was found full in STARTUP */
+  bool     app_limited;      /* The current round is application limited */
+  uint16_t pacing_gain;      /* Gains in units of 1/256 */
+  uint16_t cwnd_gain;
+  uint32_t btl_bw;           /* Bottleneck bandwidth estimate (bytes/sec) */
+  uint32_t btl_bw_round;     /* Round in which btl_bw was sampled */
+  uint32_t full_bw;          /* btl_bw at the last growth in STARTUP */
+  uint32_t min_rtt;          /* Round trip propagation estimate (usec) */
+  clock_t  min_rtt_stamp;    /* When min_rtt was sampled */
+  clock_t  probe_rtt_done;   /* End of PROBE_RTT, 0 if not scheduled */
+  uint32_t probe_rtt_round;  /* PROBE_RTT lasts at least until this round */
+  uint32_t round_count;      /* Number of round trips */
+  uint32_t round_seq;        /* The round ends when this sequence is ACKed */
+  uint32_t round_stamp;      /* Start of the current round (usec) */
+  uint32_t round_delivered;  /* Bytes ACKed in the current round */
+  uint32_t cycle_stamp;      /* Start of the current gain phase (usec) */
+  uint32_t prior_cwnd;       /* cwnd to restore after PROBE_RTT */
+};
+#endif
+
+#if defined(CONFIG_NET_TCP_CC_CUBIC) || defined(CONFIG_NET_TCP_CC_BBR)
+#  define TCP_CC_HAVE_PRIV 1
+
+union tcp_cc_priv_u
+{
+#ifdef CONFIG_NET_TCP_CC_CUBIC
+  struct tcp_cubic_s cubic;
+#endif
+#ifdef CONFIG_NET_TCP_CC_BBR
+  struct tcp_bbr_s   bbr;
+#endif
+};
+#endif
+#endif /* CONFIG_NET_TCP_CC_NEWRENO */
+
 struct tcp_conn_s
 {
   /* Common prologue of all connection structures. */
@@ -246,6 +431,14 @@ struct tcp_conn_s
 #ifdef CONFIG_NET_TCPPROTO_OPTIONS
   uint16_t user_mss;      /* Configured maximum segment size for the
                            * connection */
+#endif
+#ifdef CONFIG_NET_TCP_FINE_RTT
+  uint32_t srtt;          /* Smoothed round-trip time (usec), 0 until the
+                           * first sample */
+  uint32_t rttvar;        /* Round-trip time variation (usec) */
+#endif
+#ifdef CONFIG_NET_TCP_TIMESTAMPS
+  uint32_t ts_recent;     /* The last timestamp received from the peer */
 #endif
   uint32_t rcv_adv;       /* The right edge of the recv window advertized */
 #ifdef CONFIG_NET_TCP_CC_NEWRENO
@@ -256,6 +449,32 @@ struct tcp_conn_s
   uint32_t cwnd;          /* The Congestion window */
   uint32_t max_cwnd;      /* The Congestion window maximum value */
   uint32_t ssthresh;      /* The Slow start threshold */
+
+  FAR const struct tcp_cc_ops_s *cc; /* Congestion control algorithm */
+#ifdef TCP_CC_HAVE_PRIV
+  union tcp_cc_priv_u ccpriv; /* Private state of the algorithm */
+#endif
+#endif
+#ifdef CONFIG_NET_TCP_PACING
+  uint32_t pacing_rate;   /* Set by the congestion control (bytes/sec),
+                           * zero if not paced */
+  uint32_t pacing_next;   /* Earliest time of the next send (usec) */
+
+  /* Resumes the sends held by pacing */
+
+  struct work_s pacing_work;
+#endif
+#ifdef CONFIG_NET_TCP_RACK
+  uint32_t rack_xmit;     /* Send time of the most recently sent segment
+                           * that was delivered (usec) */
+  uint32_t rack_end;      /* End sequence number of that segment */
+  uint32_t rack_rtt;      /* Round-trip time of that segment (usec) */
+  uint32_t rack_min_rtt;  /* Minimum round-trip time (usec) */
+  uint32_t tlp_end;       /* sndseq_max when the loss probe was sent */
+
+  /* Reordering timer and tail loss probe timer */
+
+  struct work_s rack_work;
 #endif
 #ifdef CONFIG_NET_TCP_WINDOW_SCALE
   uint32_t snd_wnd;       /* Sequence and acknowledgement numbers of last
@@ -303,14 +522,9 @@ struct tcp_conn_s
   FAR struct iob_s *readahead;   /* Read-ahead buffering */
 
 #ifdef CONFIG_NET_TCP_OUT_OF_ORDER
+  /* Out-of-order pool, NULL while the data arrives in order */
 
-  /* Number of out-of-order segments */
-
-  uint8_t nofosegs;
-
-  /* This defines a out of order segment block. */
-
-  struct tcp_ofoseg_s ofosegs[TCP_SACK_RANGES_MAX];
+  FAR struct tcp_ofo_s *ofo;
 #endif
 
 #ifdef CONFIG_NET_TCP_WRITE_BUFFERS
@@ -348,16 +562,9 @@ struct tcp_conn_s
 #endif
 
 #ifdef CONFIG_NET_TCP_KEEPALIVE
-  /* There fields manage TCP/IP keep-alive.  All times are in units of the
-   * system clock tick.
-   */
+  /* TCP/IP keep-alive, NULL until a keep-alive option is set */
 
-  uint32_t   keeptimer;   /* KeepAlive timer (dsec) */
-  uint32_t   keepidle;    /* Elapsed idle time before first probe sent (dsec) */
-  uint32_t   keepintvl;   /* Interval between probes (dsec) */
-  bool       keepalive;   /* True: KeepAlive enabled; false: disabled */
-  uint8_t    keepcnt;     /* Number of retries before the socket is closed */
-  uint8_t    keepretries; /* Number of retries attempted */
+  FAR struct tcp_keepalive_s *ka;
 #endif
 
 #if defined(CONFIG_NET_SENDFILE) && defined(CONFIG_NET_TCP_WRITE_BUFFERS)
@@ -417,6 +624,10 @@ struct tcp_wrbuffer_s
                             * segment sent */
 #if defined(CONFIG_NET_TCP_FAST_RETRANSMIT) && !defined(CONFIG_NET_TCP_CC_NEWRENO)
   uint8_t    wb_nack;      /* The number of ack count */
+#endif
+#ifdef CONFIG_NET_TCP_RACK
+  bool       wb_sacked;    /* All of the segment was selectively ACKed */
+  uint32_t   wb_xmit;      /* Time of the last transmission (usec) */
 #endif
   struct iob_s *wb_iob;    /* Head of the I/O buffer chain */
 };
@@ -459,6 +670,18 @@ extern "C"
 {
 #endif
 
+#ifdef CONFIG_NET_TCP_CC_NEWRENO
+/* The congestion control algorithms */
+
+extern const struct tcp_cc_ops_s g_tcp_cc_newreno;
+#ifdef CONFIG_NET_TCP_CC_CUBIC
+extern const struct tcp_cc_ops_s g_tcp_cc_cubic;
+#endif
+#ifdef CONFIG_NET_TCP_CC_BBR
+extern const struct tcp_cc_ops_s g_tcp_cc_bbr;
+#endif
+#endif
+
 /****************************************************************************
  * Public Function Prototypes
  ****************************************************************************/
@@ -508,6 +731,94 @@ void tcp_free_rx_buffers(FAR struct tcp_conn_s *conn);
 
 void tcp_free(FAR struct tcp_conn_s *conn);
 
+/****************************************************************************
+ * Name: tcp_conn_memsize
+ *
+ * Description:
+ *   Return the RAM held by a connection structure and its extensions, the
+ *   data buffers not included.
+ *
+ ****************************************************************************/
+
+size_t tcp_conn_memsize(FAR struct tcp_conn_s *conn);
+
+/****************************************************************************
+ * Name: tcp_timewait_initialize
+ *
+ * Description:
+ *   Initialize the TIME_WAIT records.  Called once from tcp_initialize().
+ *
+ ****************************************************************************/
+
+#if CONFIG_NET_TCP_TIMEWAIT_RECORDS > 0
+void tcp_timewait_initialize(void);
+#endif
+
+/****************************************************************************
+ * Name: tcp_timewait_add
+ *
+ * Description:
+ *   Keep a TIME_WAIT record for a connection that is being released in the
+ *   TIME_WAIT state, recycling the oldest record if all of them are in use.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+#if CONFIG_NET_TCP_TIMEWAIT_RECORDS > 0
+void tcp_timewait_add(FAR struct tcp_conn_s *conn);
+#endif
+
+/****************************************************************************
+ * Name: tcp_timewait_input
+ *
+ * Description:
+ *   Handle a segment that matches no connection against the TIME_WAIT
+ *   records.  A retransmitted FIN, or any other segment of the old
+ *   connection, is answered with an ACK.  A SYN beyond the old receive
+ *   sequence ends the record so that a listener may accept it.
+ *
+ * Input Parameters:
+ *   dev    - The device driver structure containing the received packet
+ *   tcp    - The TCP header of the received packet
+ *   domain - IP domain (PF_INET or PF_INET6)
+ *
+ * Returned Value:
+ *   True if the segment was handled, dev->d_len then holds the reply, if
+ *   any.  False if it should go through the normal processing.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+#if CONFIG_NET_TCP_TIMEWAIT_RECORDS > 0
+bool tcp_timewait_input(FAR struct net_driver_s *dev,
+                        FAR struct tcp_hdr_s *tcp, uint8_t domain);
+#endif
+
+/****************************************************************************
+ * Name: tcp_timewait_next
+ *
+ * Description:
+ *   Traverse the list of live TIME_WAIT records, oldest first.
+ *
+ * Input Parameters:
+ *   tw - The last record returned, NULL to get the first one
+ *
+ * Returned Value:
+ *   The next record, NULL at the end of the list.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+#if CONFIG_NET_TCP_TIMEWAIT_RECORDS > 0
+FAR struct tcp_timewait_s *tcp_timewait_next(FAR struct tcp_timewait_s *tw);
+#endif
+
 /****************************************************************************
  * Name: tcp_active
  *
@@ -1054,7 +1365,10 @@ void tcp_stop_timer(FAR struct tcp_conn_s *conn);
  * Name: tcp_findlistener
  *
  * Description:
- *   Return the connection listener for connections on this port (if any)
+ *   Return the connection listener for connections on this port (if any).
+ *   If several listeners share the port with SO_REUSEPORT, the remote
+ *   address in uaddr and rport select one of them; rport is zero when any
+ *   of them will do.
  *
  * Assumptions:
  *   The network is locked
@@ -1063,11 +1377,11 @@ void tcp_stop_timer(FAR struct tcp_conn_s *conn);
 
 #if defined(CONFIG_NET_IPv4) && defined(CONFIG_NET_IPv6)
 FAR struct tcp_conn_s *tcp_findlistener(FAR union ip_binding_u *uaddr,
-                                        uint16_t portno,
+                                        uint16_t portno, uint16_t rport,
                                         uint8_t domain);
 #else
 FAR struct tcp_conn_s *tcp_findlistener(FAR union ip_binding_u *uaddr,
-                                        uint16_t portno);
+                                        uint16_t portno, uint16_t rport);
 #endif
 
 /****************************************************************************
@@ -1196,6 +1510,28 @@ ssize_t tcp_sendfile(FAR struct socket *psock, FAR struct file *infile,
 
 void tcp_reset(FAR struct net_driver_s *dev, FAR struct tcp_conn_s *conn);
 
+/****************************************************************************
+ * Name: tcp_ack
+ *
+ * Description:
+ *   Reply to the received segment with a bare ACK carrying the given
+ *   sequence numbers, without a connection.
+ *
+ * Input Parameters:
+ *   dev    - The device driver structure to use in the send operation
+ *   seqno  - The sequence number of the ACK
+ *   ackno  - The acknowledgement number of the ACK
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   Called from network stack logic with the network stack locked
+ *
+ ****************************************************************************/
+
+void tcp_ack(FAR struct net_driver_s *dev, uint32_t seqno, uint32_t ackno);
+
 /****************************************************************************
  * Name: tcp_rx_mss
  *
@@ -2327,6 +2663,285 @@ void tcp_cc_update(FAR struct tcp_conn_s *conn, FAR struct tcp_hdr_s *tcp);
  ****************************************************************************/
 
 void tcp_cc_recv_ack(FAR struct tcp_conn_s *conn, FAR struct tcp_hdr_s *tcp);
+
+/****************************************************************************
+ * Name: tcp_cc_timeout
+ *
+ * Description:
+ *   Reduce the congestion window after a retransmission timeout.
+ *
+ * Input Parameters:
+ *   conn   - The TCP connection of interest
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+void tcp_cc_timeout(FAR struct tcp_conn_s *conn);
+
+/****************************************************************************
+ * Name: tcp_cc_select
+ *
+ * Description:
+ *   Select the congestion control algorithm of a connection by name
+ *   (TCP_CONGESTION).  An established connection keeps its window and
+ *   continues with the new algorithm.
+ *
+ * Input Parameters:
+ *   conn   - The TCP connection of interest
+ *   name   - Name of the algorithm
+ *
+ * Returned Value:
+ *   OK on success, -ENOENT if there is no such algorithm.
+ *
+ ****************************************************************************/
+
+int tcp_cc_select(FAR struct tcp_conn_s *conn, FAR const char *name);
+
+/****************************************************************************
+ * Name: tcp_cc_slow_start
+ *
+ * Description:
+ *   Slow start (RFC 5681) for the algorithms: grow cwnd by the number of
+ *   bytes ACKed, at most one MSS per ACK.
+ *
+ ****************************************************************************/
+
+void tcp_cc_slow_start(FAR struct tcp_conn_s *conn, uint32_t acked);
+
+/****************************************************************************
+ * Name: tcp_cc_time_us
+ *
+ * Description:
+ *   Return a microsecond time stamp for the rate and delay measurements of
+ *   the algorithms.  It wraps around, compare with signed differences.
+ *
+ ****************************************************************************/
+
+uint32_t tcp_cc_time_us(void);
+#endif
+
+#ifdef CONFIG_NET_TCP_PACING
+/****************************************************************************
+ * Name: tcp_pacing_check
+ *
+ * Description:
+ *   Check whether the pacing rate of the connection allows to send now.
+ *   If not, arrange for the connection to be polled again when it does.
+ *
+ * Input Parameters:
+ *   conn   - The TCP connection of interest
+ *
+ * Returned Value:
+ *   True if the data can be sent now.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+bool tcp_pacing_check(FAR struct tcp_conn_s *conn);
+
+/****************************************************************************
+ * Name: tcp_pacing_sent
+ *
+ * Description:
+ *   Account len bytes just sent against the pacing rate.
+ *
+ * Input Parameters:
+ *   conn   - The TCP connection of interest
+ *   len    - Number of bytes sent
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+void tcp_pacing_sent(FAR struct tcp_conn_s *conn, uint32_t len);
+
+/****************************************************************************
+ * Name: tcp_pacing_stop
+ *
+ * Description:
+ *   Cancel the pending pacing wakeup of a connection.
+ *
+ ****************************************************************************/
+
+void tcp_pacing_stop(FAR struct tcp_conn_s *conn);
+#endif
+
+#ifdef CONFIG_NET_TCP_FINE_RTT
+/****************************************************************************
+ * Name: tcp_rtt_sample
+ *
+ * Description:
+ *   Update the smoothed round-trip time and its variation with a new
+ *   measurement, and derive the retransmission time-out from them
+ *   (RFC 6298).
+ *
+ * Input Parameters:
+ *   conn   - The TCP connection of interest
+ *   rtt    - The round-trip time measured (usec)
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+void tcp_rtt_sample(FAR struct tcp_conn_s *conn, uint32_t rtt);
+#endif
+
+#ifdef CONFIG_NET_TCP_TIMESTAMPS
+/****************************************************************************
+ * Name: tcp_ts_now
+ *
+ * Description:
+ *   Return the current value of the timestamp clock (msec).
+ *
+ ****************************************************************************/
+
+uint32_t tcp_ts_now(void);
+
+/****************************************************************************
+ * Name: tcp_ts_option
+ *
+ * Description:
+ *   Write the Timestamps option, padded to TCP_OPT_TS_SPACE bytes, for a
+ *   segment sent on a connection.
+ *
+ * Input Parameters:
+ *   conn   - The TCP connection of interest
+ *   opt    - Where to write the option
+ *
+ * Returned Value:
+ *   The number of bytes written.
+ *
+ ****************************************************************************/
+
+int tcp_ts_option(FAR struct tcp_conn_s *conn, FAR uint8_t *opt);
+
+/****************************************************************************
+ * Name: tcp_ts_input
+ *
+ * Description:
+ *   Process the Timestamps option of an incoming segment: reject old
+ *   duplicates (PAWS) and remember the timestamp to echo.
+ *
+ * Input Parameters:
+ *   conn   - The TCP connection of interest
+ *   tcp    - The TCP header of the incoming segment
+ *   tsecr  - Returns the echoed timestamp, 0 if there is none
+ *
+ * Returned Value:
+ *   False if the segment must be dropped.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+bool tcp_ts_input(FAR struct tcp_conn_s *conn, FAR struct tcp_hdr_s *tcp,
+                  FAR uint32_t *tsecr);
+#endif
+
+#ifdef CONFIG_NET_TCP_RACK
+/****************************************************************************
+ * Name: tcp_rack_delivered
+ *
+ * Description:
+ *   Update the RACK state with a write buffer that was delivered, either
+ *   cumulatively or selectively ACKed.
+ *
+ * Input Parameters:
+ *   conn   - The TCP connection of interest
+ *   wrb    - The write buffer delivered
+ *   now    - The current time (usec)
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+void tcp_rack_delivered(FAR struct tcp_conn_s *conn,
+                        FAR struct tcp_wrbuffer_s *wrb, uint32_t now);
+
+/****************************************************************************
+ * Name: tcp_rack_lost
+ *
+ * Description:
+ *   Check whether an un-ACKed write buffer is lost: a segment sent after
+ *   it was delivered and the reordering window has passed.
+ *
+ * Input Parameters:
+ *   conn   - The TCP connection of interest
+ *   wrb    - The write buffer to check
+ *   now    - The current time (usec)
+ *   wait   - If the write buffer is not lost yet but may be, lowered to
+ *            the time left until it is (usec)
+ *
+ * Returned Value:
+ *   True if the write buffer should be retransmitted.
+ *
+ ****************************************************************************/
+
+bool tcp_rack_lost(FAR struct tcp_conn_s *conn,
+                   FAR struct tcp_wrbuffer_s *wrb, uint32_t now,
+                   FAR uint32_t *wait);
+
+/****************************************************************************
+ * Name: tcp_rack_arm
+ *
+ * Description:
+ *   Start the reordering timer or, if tlp is true, the tail loss probe
+ *   timer.  On expiry TCP_RACK_EXPIRED is set and the connection polled.
+ *
+ * Input Parameters:
+ *   conn   - The TCP connection of interest
+ *   delay  - The delay of the timer (usec)
+ *   tlp    - True for the tail loss probe timer
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+void tcp_rack_arm(FAR struct tcp_conn_s *conn, uint32_t delay, bool tlp);
+
+/****************************************************************************
+ * Name: tcp_rack_pto
+ *
+ * Description:
+ *   Return the probe time-out of the connection (usec).
+ *
+ ****************************************************************************/
+
+uint32_t tcp_rack_pto(FAR struct tcp_conn_s *conn);
+
+/****************************************************************************
+ * Name: tcp_rack_stop
+ *
+ * Description:
+ *   Cancel the RACK timer of a connection.
+ *
+ ****************************************************************************/
+
+void tcp_rack_stop(FAR struct tcp_conn_s *conn);
 #endif
 
 #ifdef __cplusplus
@@ -47,6 +47,7 @@
 
 struct accept_s
 {
+  FAR struct accept_s   *acpt_flink;      /* Next thread waiting in accept() */
   sem_t                  acpt_sem;        /* Wait for driver event */
   FAR struct sockaddr   *acpt_addr;       /* Return connection address */
   FAR socklen_t         *acpt_addrlen;    /* Return length of address */
@@ -130,6 +131,47 @@ static inline void accept_tcpsender(FAR struct tcp_conn_s *listener,
     }
 }
 
+/****************************************************************************
+ * Name: accept_dequeue
+ *
+ * Description:
+ *   Remove a thread that gave up waiting from the accept() waiters of the
+ *   listener, if a connection was not given to it already.
+ *
+ * Input Parameters:
+ *   listener The connection structure of the listener
+ *   pstate   The accept state of the waiting thread
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   The network is locked
+ *
+ ****************************************************************************/
+
+static void accept_dequeue(FAR struct tcp_conn_s *listener,
+                           FAR struct accept_s *pstate)
+{
+  FAR struct accept_s **prev =
+    (FAR struct accept_s **)&listener->accept_private;
+
+  while (*prev != NULL && *prev != pstate)
+    {
+      prev = &(*prev)->acpt_flink;
+    }
+
+  if (*prev != NULL)
+    {
+      *prev = pstate->acpt_flink;
+    }
+
+  if (listener->accept_private == NULL)
+    {
+      listener->accept = NULL;
+    }
+}
+
 /****************************************************************************
  * Name: accept_eventhandler
  *
@@ -170,14 +212,20 @@ static int accept_eventhandler(FAR struct tcp_conn_s *listener,
 
       DEBUGASSERT(conn->crefs == 1);
 
-      /* Wake-up the waiting caller thread */
+      /* Wake-up the waiting caller thread, only the first one: the others
+       * wait for the next connections.
+       */
 
       nxsem_post(&pstate->acpt_sem);
 
-      /* Stop any further callbacks */
+      /* Stop further callbacks when no thread is left waiting */
+
+      listener->accept_private = pstate->acpt_flink;
+      if (pstate->acpt_flink == NULL)
+        {
+          listener->accept     = NULL;
+        }
 
-      listener->accept_private = NULL;
-      listener->accept         = NULL;
       ret                      = OK;
     }
 
@@ -216,6 +264,7 @@ int psock_tcp_accept(FAR struct socket *psock, FAR struct sockaddr *addr,
                      FAR socklen_t *addrlen, FAR void **newconn)
 {
   FAR struct tcp_conn_s *conn;
+  FAR struct accept_s *last;
   struct accept_s state;
   int ret;
 
@@ -255,6 +304,7 @@ int psock_tcp_accept(FAR struct socket *psock, FAR struct sockaddr *addr,
        * ready.
        */
 
+      state.acpt_flink      = NULL;
       state.acpt_addr       = addr;
       state.acpt_addrlen    = addrlen;
       state.acpt_newconn    = NULL;
@@ -262,10 +312,26 @@ int psock_tcp_accept(FAR struct socket *psock, FAR struct sockaddr *addr,
 
       nxsem_init(&state.acpt_sem, 0, 0);
 
-      /* Set up the callback in the connection */
+      /* Set up the callback in the connection, or queue behind the threads
+       * already waiting in accept() on this socket.  Each new connection
+       * wakes up only the first waiter.
+       */
 
-      conn->accept_private  = (FAR void *)&state;
-      conn->accept          = accept_eventhandler;
+      last = conn->accept_private;
+      if (last == NULL)
+        {
+          conn->accept_private = (FAR void *)&state;
+          conn->accept         = accept_eventhandler;
+        }
+      else
+        {
+          while (last->acpt_flink != NULL)
+            {
+              last = last->acpt_flink;
+            }
+
+          last->acpt_flink = &state;
+        }
 
       /* Wait for the send to complete or an error to occur:  NOTES:
        * net_sem_wait will also terminate if a signal is received.
@@ -275,8 +341,7 @@ int psock_tcp_accept(FAR struct socket *psock, FAR struct sockaddr *addr,
 
       /* Make sure that no further events are processed */
 
-      conn->accept_private = NULL;
-      conn->accept         = NULL;
+      accept_dequeue(conn, &state);
 
       nxsem_destroy(&state.acpt_sem);
 
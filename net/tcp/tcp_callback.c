@@ -31,6 +31,7 @@
 #include <debug.h>
 #include <assert.h>
 
+#include <nuttx/kmalloc.h>
 #include <nuttx/mm/iob.h>
 #include <nuttx/net/netconfig.h>
 #include <nuttx/net/netdev.h>
@@ -113,6 +114,7 @@ static uint16_t tcp_ofoseg_data_event(FAR struct net_driver_s *dev,
                                       FAR struct tcp_conn_s *conn,
                                       uint16_t flags)
 {
+  FAR struct tcp_ofo_s *ofo = conn->ofo;
   FAR struct tcp_ofoseg_s *seg;
   uint32_t rcvseq;
   int i = 0;
@@ -131,9 +133,9 @@ static uint16_t tcp_ofoseg_data_event(FAR struct net_driver_s *dev,
 
   /* Foreach out-of-order segments */
 
-  while (i < conn->nofosegs)
+  while (i < ofo->nofosegs)
     {
-      seg = &conn->ofosegs[i];
+      seg = &ofo->ofosegs[i];
 
       /* rcvseq -->|
        * ofoseg    |------|
@@ -189,12 +191,12 @@ static uint16_t tcp_ofoseg_data_event(FAR struct net_driver_s *dev,
 
       if (seg->data == NULL)
         {
-          for (; i < conn->nofosegs - 1; i++)
+          for (; i < ofo->nofosegs - 1; i++)
             {
-              conn->ofosegs[i] = conn->ofosegs[i + 1];
+              ofo->ofosegs[i] = ofo->ofosegs[i + 1];
             }
 
-          conn->nofosegs--;
+          ofo->nofosegs--;
 
           /* Try segments again */
 
@@ -206,6 +208,14 @@ static uint16_t tcp_ofoseg_data_event(FAR struct net_driver_s *dev,
         }
     }
 
+  /* The hole is filled, give the pool back */
+
+  if (ofo->nofosegs == 0)
+    {
+      kmm_free(ofo);
+      conn->ofo = NULL;
+    }
+
   return flags;
 }
 #endif /* CONFIG_NET_TCP_OUT_OF_ORDER */
@@ -237,9 +247,9 @@ int tcp_ofoseg_bufsize(FAR struct tcp_conn_s *conn)
   int total = 0;
   int i;
 
-  for (i = 0; i < conn->nofosegs; i++)
+  for (i = 0; i < TCP_NOFOSEGS(conn); i++)
     {
-      total += conn->ofosegs[i].data->io_pktlen;
+      total += conn->ofo->ofosegs[i].data->io_pktlen;
     }
 
   return total;
@@ -315,7 +325,7 @@ uint16_t tcp_callback(FAR struct net_driver_s *dev,
     }
 
 #ifdef CONFIG_NET_TCP_OUT_OF_ORDER
-  if ((orig & TCP_NEWDATA) != 0 && conn->nofosegs > 0)
+  if ((orig & TCP_NEWDATA) != 0 && TCP_NOFOSEGS(conn) > 0)
     {
       /* Try out-of-order pool if new data is coming */
 
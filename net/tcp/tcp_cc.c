@@ -25,7 +25,12 @@
  ****************************************************************************/
 
 #include <debug.h>
+#include <errno.h>
+#include <string.h>
 
+#include <nuttx/clock.h>
+
+#include "netdev/netdev.h"
 #include "tcp/tcp.h"
 
 /****************************************************************************
@@ -74,10 +79,105 @@
     } \
  } while(0)
 
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+static void newreno_cong_avoid(FAR struct tcp_conn_s *conn, uint32_t acked);
+static void newreno_loss(FAR struct tcp_conn_s *conn, bool timeout);
+
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+const struct tcp_cc_ops_s g_tcp_cc_newreno =
+{
+  "newreno",            /* name */
+  NULL,                 /* init */
+  NULL,                 /* ack */
+  newreno_cong_avoid,   /* cong_avoid */
+  newreno_loss          /* loss */
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static FAR const struct tcp_cc_ops_s * const g_tcp_cc_algos[] =
+{
+  &g_tcp_cc_newreno,
+#ifdef CONFIG_NET_TCP_CC_CUBIC
+  &g_tcp_cc_cubic,
+#endif
+#ifdef CONFIG_NET_TCP_CC_BBR
+  &g_tcp_cc_bbr,
+#endif
+};
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: newreno_cong_avoid
+ *
+ * Description:
+ *   Slow start and congestion avoidance of RFC 5681.
+ *
+ ****************************************************************************/
+
+static void newreno_cong_avoid(FAR struct tcp_conn_s *conn, uint32_t acked)
+{
+  uint32_t increase;
+
+  if (conn->cwnd < conn->ssthresh)
+    {
+      tcp_cc_slow_start(conn, acked);
+    }
+  else
+    {
+      /* cong avoid (RFC 5681):
+       * Grow cwnd linearly by approximately maxseg per RTT using
+       * maxseg^2 / cwnd per ACK as the increment.
+       * If cwnd > maxseg^2, fix the cwnd increment at 1 byte to
+       * avoid capping cwnd.
+       */
+
+      increase = MAX((conn->mss * conn->mss / conn->cwnd), 1);
+
+      CC_CWND_INC(conn->cwnd, increase);
+      conn->cwnd = MIN(conn->cwnd, conn->max_cwnd);
+      ninfo("update congestion avoidance cwnd to %u\n", conn->cwnd);
+    }
+}
+
+/****************************************************************************
+ * Name: newreno_loss
+ *
+ * Description:
+ *   ssthresh = max (FlightSize / 2, 2*SMSS) referring to rfc5681.  Enter
+ *   fast recovery with cwnd = ssthresh + 3*SMSS, or restart from one
+ *   segment after a retransmission timeout.
+ *
+ ****************************************************************************/
+
+static void newreno_loss(FAR struct tcp_conn_s *conn, bool timeout)
+{
+  conn->ssthresh = MAX(conn->tx_unacked / 2, 2 * conn->mss);
+
+  if (timeout)
+    {
+      /* update the max_cwnd */
+
+      conn->max_cwnd = (conn->max_cwnd + 7 * conn->cwnd) >> 3;
+      conn->cwnd     = conn->mss;
+    }
+  else
+    {
+      conn->cwnd     = conn->ssthresh + 3 * conn->mss;
+    }
+}
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -117,6 +217,11 @@ void tcp_cc_init(FAR struct tcp_conn_s *conn)
 
   conn->ssthresh = 2 * TCP_IPV4_DEFAULT_MSS;
   conn->dupacks = 0;
+
+  if (conn->cc->init != NULL)
+    {
+      conn->cc->init(conn);
+    }
 }
 
 /****************************************************************************
@@ -140,16 +245,13 @@ void tcp_cc_init(FAR struct tcp_conn_s *conn)
 
 void tcp_cc_update(FAR struct tcp_conn_s *conn, FAR struct tcp_hdr_s *tcp)
 {
-  /* After Fast retransmitted, set ssthresh to the maximum of
-   * the unacked and the 2*SMSS, and enter to Fast Recovery.
-   * ssthresh = max (FlightSize / 2, 2*SMSS) referring to rfc5681
-   * cwnd=ssthresh + 3*SMSS  referring to rfc5681
+  /* After Fast retransmitted, let the algorithm reduce ssthresh and cwnd,
+   * and enter to Fast Recovery.
    */
 
   if (conn->flags & TCP_INFT)
     {
-      conn->ssthresh = MAX(conn->tx_unacked / 2, 2 * conn->mss);
-      conn->cwnd = conn->ssthresh + 3 * conn->mss;
+      conn->cc->loss(conn, false);
 
       conn->flags &= ~TCP_INFT;
       conn->flags |= TCP_INFR;
@@ -243,6 +345,11 @@ void tcp_cc_recv_ack(FAR struct tcp_conn_s *conn, FAR struct tcp_hdr_s *tcp)
       conn->dupacks = 0;
       conn->last_ackno = ackno;
 
+      if (conn->cc->ack != NULL)
+        {
+          conn->cc->ack(conn, ackno, acked);
+        }
+
       /* When the ackno covers more than the fr_recover, exit the
        * fast recovery. Then, reset the "IN Fast Recovery" flags.
        * Also reset the congestion window to the slow start threshold.
@@ -269,34 +376,127 @@ void tcp_cc_recv_ack(FAR struct tcp_conn_s *conn, FAR struct tcp_hdr_s *tcp)
 
       if (conn->tcpstateflags >= TCP_ESTABLISHED)
         {
-          uint32_t increase;
+          conn->cc->cong_avoid(conn, acked);
+        }
+    }
+}
 
-          if (conn->cwnd < conn->ssthresh)
-            {
-              /* slow start (RFC 5681):
-               * Grow cwnd exponentially by maxseg(smss) per ACK.
-               */
+/****************************************************************************
+ * Name: tcp_cc_timeout
+ *
+ * Description:
+ *   Reduce the congestion window after a retransmission timeout.
+ *
+ * Input Parameters:
+ *   conn   - The TCP connection of interest
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
 
-              increase = acked > 0 ? MIN(acked, conn->mss) : conn->mss;
+void tcp_cc_timeout(FAR struct tcp_conn_s *conn)
+{
+  /* If conn is TCP_INFR, it should enter to slow start */
 
-              CC_CWND_INC(conn->cwnd, increase);
-              ninfo("update slow start cwnd to %u\n", conn->cwnd);
-            }
-          else
+  conn->flags &= ~TCP_INFR;
+
+  /* reset cwnd and ssthresh, refers to RFC5861. */
+
+  conn->cc->loss(conn, true);
+}
+
+/****************************************************************************
+ * Name: tcp_cc_select
+ *
+ * Description:
+ *   Select the congestion control algorithm of a connection by name
+ *   (TCP_CONGESTION).  An established connection keeps its window and
+ *   continues with the new algorithm.
+ *
+ * Input Parameters:
+ *   conn   - The TCP connection of interest
+ *   name   - Name of the algorithm
+ *
+ * Returned Value:
+ *   OK on success, -ENOENT if there is no such algorithm.
+ *
+ ****************************************************************************/
+
+int tcp_cc_select(FAR struct tcp_conn_s *conn, FAR const char *name)
+{
+  int i;
+
+  for (i = 0; i < nitems(g_tcp_cc_algos); i++)
+    {
+      if (strcmp(g_tcp_cc_algos[i]->name, name) == 0)
+        {
+          conn->cc = g_tcp_cc_algos[i];
+
+#ifdef CONFIG_NET_TCP_PACING
+          /* The pacing rate belongs to the previous algorithm, send what
+           * it holds back now.
+           */
+
+          conn->pacing_rate = 0;
+          if (!work_available(&conn->pacing_work))
             {
-              /* cong avoid (RFC 5681):
-               * Grow cwnd linearly by approximately maxseg per RTT using
-               * maxseg^2 / cwnd per ACK as the increment.
-               * If cwnd > maxseg^2, fix the cwnd increment at 1 byte to
-               * avoid capping cwnd.
-               */
+              tcp_pacing_stop(conn);
+              if (conn->dev != NULL)
+                {
+                  netdev_txnotify_dev(conn->dev);
+                }
+            }
+#endif
 
-              increase = MAX((conn->mss * conn->mss / conn->cwnd), 1);
+          /* A connection not started yet is set up by tcp_cc_init() */
 
-              CC_CWND_INC(conn->cwnd, increase);
-              conn->cwnd = MIN(conn->cwnd, conn->max_cwnd);
-              ninfo("update congestion avoidance cwnd to %u\n", conn->cwnd);
+          if (conn->tcpstateflags != TCP_ALLOCATED &&
+              conn->cc->init != NULL)
+            {
+              conn->cc->init(conn);
             }
+
+          return OK;
         }
     }
+
+  return -ENOENT;
+}
+
+/****************************************************************************
+ * Name: tcp_cc_slow_start
+ *
+ * Description:
+ *   Slow start (RFC 5681) for the algorithms: grow cwnd by the number of
+ *   bytes ACKed, at most one MSS per ACK.
+ *
+ ****************************************************************************/
+
+void tcp_cc_slow_start(FAR struct tcp_conn_s *conn, uint32_t acked)
+{
+  uint32_t increase = acked > 0 ? MIN(acked, conn->mss) : conn->mss;
+
+  CC_CWND_INC(conn->cwnd, increase);
+  ninfo("update slow start cwnd to %u\n", conn->cwnd);
+}
+
+/****************************************************************************
+ * Name: tcp_cc_time_us
+ *
+ * Description:
+ *   Return a microsecond time stamp for the rate and delay measurements of
+ *   the algorithms.  It wraps around, compare with signed differences.
+ *
+ ****************************************************************************/
+
+uint32_t tcp_cc_time_us(void)
+{
+  struct timespec ts;
+
+  clock_systime_timespec(&ts);
+  return (uint32_t)ts.tv_sec * USEC_PER_SEC + ts.tv_nsec / NSEC_PER_USEC;
 }
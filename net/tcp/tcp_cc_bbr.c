@@ -0,0 +1,425 @@
+/****************************************************************************
+ * net/tcp/tcp_cc_bbr.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <debug.h>
+#include <inttypes.h>
+#include <string.h>
+
+#include <nuttx/clock.h>
+
+#include "tcp/tcp.h"
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* BBR (v1) estimates the bottleneck bandwidth and the round trip
+ * propagation time and paces at their product instead of reacting to loss.
+ * Delivery rate is sampled once per round trip from the bytes ACKed in
+ * that round, a coarse but cheap approximation of per-packet rate samples.
+ */
+
+#define BBR_STARTUP          0
+#define BBR_DRAIN            1
+#define BBR_PROBE_BW         2
+#define BBR_PROBE_RTT        3
+
+/* Gains in units of 1/256 */
+
+#define BBR_UNIT             256
+#define BBR_HIGH_GAIN        739   /* 2/ln(2) */
+#define BBR_DRAIN_GAIN       88    /* ln(2)/2 */
+#define BBR_CWND_GAIN        512
+#define BBR_CYCLE_LEN        8
+
+#define BBR_BW_ROUNDS        10    /* Max filter window for btl_bw */
+#define BBR_FULL_BW_THRESH   320   /* 1.25: growth expected in STARTUP */
+#define BBR_FULL_BW_CNT      3     /* Rounds without growth: pipe is full */
+#define BBR_MIN_RTT_WIN      SEC2TICK(10)
+#define BBR_PROBE_RTT_TIME   MSEC2TICK(200)
+#define BBR_MIN_CWND(c)      (4 * (uint32_t)(c)->mss)
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+static void bbr_init(FAR struct tcp_conn_s *conn);
+static void bbr_ack(FAR struct tcp_conn_s *conn, uint32_t ackno,
+                    uint32_t acked);
+static void bbr_cong_avoid(FAR struct tcp_conn_s *conn, uint32_t acked);
+static void bbr_loss(FAR struct tcp_conn_s *conn, bool timeout);
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static const uint16_t g_bbr_cycle_gain[BBR_CYCLE_LEN] =
+{
+  BBR_UNIT * 5 / 4, BBR_UNIT * 3 / 4, BBR_UNIT, BBR_UNIT,
+  BBR_UNIT, BBR_UNIT, BBR_UNIT, BBR_UNIT
+};
+
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+const struct tcp_cc_ops_s g_tcp_cc_bbr =
+{
+  "bbr",                /* name */
+  bbr_init,             /* init */
+  bbr_ack,              /* ack */
+  bbr_cong_avoid,       /* cong_avoid */
+  bbr_loss              /* loss */
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: bbr_bdp
+ *
+ * Description:
+ *   Return gain times the estimated bandwidth-delay product in bytes.
+ *
+ ****************************************************************************/
+
+static uint32_t bbr_bdp(FAR struct tcp_conn_s *conn, uint16_t gain)
+{
+  FAR struct tcp_bbr_s *bbr = &conn->ccpriv.bbr;
+  uint64_t bdp;
+
+  if (bbr->btl_bw == 0 || bbr->min_rtt == UINT32_MAX)
+    {
+      /* No estimate yet, behave like slow start from the initial cwnd */
+
+      return (uint32_t)(((uint64_t)MAX(conn->cwnd, BBR_MIN_CWND(conn)) *
+                         gain) / BBR_UNIT);
+    }
+
+  bdp = (uint64_t)bbr->btl_bw * bbr->min_rtt / USEC_PER_SEC;
+  bdp = bdp * gain / BBR_UNIT;
+
+  return (uint32_t)MIN(bdp, UINT32_MAX / 2);
+}
+
+/****************************************************************************
+ * Name: bbr_set_pacing_rate
+ ****************************************************************************/
+
+static void bbr_set_pacing_rate(FAR struct tcp_conn_s *conn)
+{
+  FAR struct tcp_bbr_s *bbr = &conn->ccpriv.bbr;
+  uint64_t rate;
+
+  if (bbr->btl_bw == 0)
+    {
+      return;
+    }
+
+  rate = (uint64_t)bbr->btl_bw * bbr->pacing_gain / BBR_UNIT;
+  rate = MIN(rate, UINT32_MAX);
+
+  /* Never slow down before the pipe was found full */
+
+  if (bbr->full_bw_reached || rate > conn->pacing_rate)
+    {
+      conn->pacing_rate = (uint32_t)rate;
+    }
+}
+
+/****************************************************************************
+ * Name: bbr_enter_probe_bw
+ ****************************************************************************/
+
+static void bbr_enter_probe_bw(FAR struct tcp_bbr_s *bbr, uint32_t now)
+{
+  bbr->mode        = BBR_PROBE_BW;
+  bbr->cwnd_gain   = BBR_CWND_GAIN;
+
+  /* Start at a random phase other than the draining one */
+
+  bbr->cycle_idx   = (BBR_CYCLE_LEN - 1) - (now % (BBR_CYCLE_LEN - 1));
+  bbr->pacing_gain = g_bbr_cycle_gain[bbr->cycle_idx];
+  bbr->cycle_stamp = now;
+}
+
+/****************************************************************************
+ * Name: bbr_check_full_bw
+ *
+ * Description:
+ *   The pipe is full once the bandwidth stopped growing by 25% for three
+ *   rounds in a row.
+ *
+ ****************************************************************************/
+
+static void bbr_check_full_bw(FAR struct tcp_bbr_s *bbr)
+{
+  if (bbr->full_bw_reached || bbr->app_limited)
+    {
+      return;
+    }
+
+  if ((uint64_t)bbr->btl_bw * BBR_UNIT >=
+      (uint64_t)bbr->full_bw * BBR_FULL_BW_THRESH)
+    {
+      bbr->full_bw     = bbr->btl_bw;
+      bbr->full_bw_cnt = 0;
+      return;
+    }
+
+  bbr->full_bw_reached = ++bbr->full_bw_cnt >= BBR_FULL_BW_CNT;
+}
+
+/****************************************************************************
+ * Name: bbr_update_round
+ *
+ * Description:
+ *   Take a bandwidth and RTT sample at the end of each round trip, and run
+ *   the state machine.
+ *
+ ****************************************************************************/
+
+static void bbr_update_round(FAR struct tcp_conn_s *conn, uint32_t ackno,
+                             uint32_t now)
+{
+  FAR struct tcp_bbr_s *bbr = &conn->ccpriv.bbr;
+  clock_t ticks = clock_systime_ticks();
+  uint32_t rtt = now - bbr->round_stamp;
+  uint32_t bw;
+
+  bbr->round_count++;
+
+  if (rtt > 0)
+    {
+      bw = (uint32_t)MIN((uint64_t)bbr->round_delivered * USEC_PER_SEC /
+                         rtt, UINT32_MAX);
+
+      /* Windowed max filter, an application limited round may only raise
+       * the estimate.
+       */
+
+      if (bw >= bbr->btl_bw ||
+          (!bbr->app_limited &&
+           bbr->round_count - bbr->btl_bw_round > BBR_BW_ROUNDS))
+        {
+          bbr->btl_bw       = bw;
+          bbr->btl_bw_round = bbr->round_count;
+        }
+
+      /* Windowed min filter for the propagation delay */
+
+      if (rtt <= bbr->min_rtt ||
+          ticks - bbr->min_rtt_stamp > BBR_MIN_RTT_WIN)
+        {
+          bbr->min_rtt       = rtt;
+          bbr->min_rtt_stamp = ticks;
+        }
+    }
+
+  /* Start the next round */
+
+  bbr->round_seq       = tcp_getsequence(conn->sndseq);
+  bbr->round_stamp     = now;
+  bbr->round_delivered = 0;
+  bbr->app_limited     = TCP_SEQ_SUB(bbr->round_seq, ackno) <
+                         conn->cwnd / 2;
+
+  switch (bbr->mode)
+    {
+      case BBR_STARTUP:
+        bbr_check_full_bw(bbr);
+        if (bbr->full_bw_reached)
+          {
+            bbr->mode        = BBR_DRAIN;
+            bbr->pacing_gain = BBR_DRAIN_GAIN;
+            bbr->cwnd_gain   = BBR_HIGH_GAIN;
+          }
+        break;
+
+      case BBR_DRAIN:
+        if (TCP_SEQ_SUB(bbr->round_seq, ackno) <= bbr_bdp(conn, BBR_UNIT))
+          {
+            bbr_enter_probe_bw(bbr, now);
+          }
+        break;
+
+      case BBR_PROBE_BW:
+
+        /* Move to the next phase after about one min_rtt */
+
+        if (now - bbr->cycle_stamp > bbr->min_rtt)
+          {
+            bbr->cycle_idx   = (bbr->cycle_idx + 1) % BBR_CYCLE_LEN;
+            bbr->pacing_gain = g_bbr_cycle_gain[bbr->cycle_idx];
+            bbr->cycle_stamp = now;
+          }
+        break;
+
+      case BBR_PROBE_RTT:
+        if (bbr->probe_rtt_done != 0 &&
+            bbr->round_count >= bbr->probe_rtt_round &&
+            (sclock_t)(ticks - bbr->probe_rtt_done) >= 0)
+          {
+            bbr->min_rtt_stamp = ticks;
+            conn->cwnd         = MAX(conn->cwnd, bbr->prior_cwnd);
+
+            if (bbr->full_bw_reached)
+              {
+                bbr_enter_probe_bw(bbr, now);
+              }
+            else
+              {
+                bbr->mode        = BBR_STARTUP;
+                bbr->pacing_gain = BBR_HIGH_GAIN;
+                bbr->cwnd_gain   = BBR_HIGH_GAIN;
+              }
+          }
+        break;
+    }
+
+  /* Drain the queue for a while if min_rtt was not refreshed in the
+   * window, so that a new sample of the propagation delay can be taken.
+   */
+
+  if (bbr->mode != BBR_PROBE_RTT &&
+      ticks - bbr->min_rtt_stamp > BBR_MIN_RTT_WIN)
+    {
+      bbr->mode            = BBR_PROBE_RTT;
+      bbr->pacing_gain     = BBR_UNIT;
+      bbr->cwnd_gain       = BBR_UNIT;
+      bbr->prior_cwnd      = conn->cwnd;
+      bbr->probe_rtt_done  = ticks + BBR_PROBE_RTT_TIME;
+      bbr->probe_rtt_round = bbr->round_count + 1;
+    }
+
+  bbr_set_pacing_rate(conn);
+
+  ninfo("bbr mode %u bw %" PRIu32 " rtt %" PRIu32 "\n",
+        bbr->mode, bbr->btl_bw, bbr->min_rtt);
+}
+
+/****************************************************************************
+ * Name: bbr_init
+ ****************************************************************************/
+
+static void bbr_init(FAR struct tcp_conn_s *conn)
+{
+  FAR struct tcp_bbr_s *bbr = &conn->ccpriv.bbr;
+
+  memset(bbr, 0, sizeof(*bbr));
+
+  bbr->mode          = BBR_STARTUP;
+  bbr->pacing_gain   = BBR_HIGH_GAIN;
+  bbr->cwnd_gain     = BBR_HIGH_GAIN;
+  bbr->min_rtt       = UINT32_MAX;
+  bbr->min_rtt_stamp = clock_systime_ticks();
+  bbr->round_seq     = tcp_getsequence(conn->sndseq);
+  bbr->round_stamp   = tcp_cc_time_us();
+
+  conn->pacing_rate  = 0;
+}
+
+/****************************************************************************
+ * Name: bbr_ack
+ ****************************************************************************/
+
+static void bbr_ack(FAR struct tcp_conn_s *conn, uint32_t ackno,
+                    uint32_t acked)
+{
+  FAR struct tcp_bbr_s *bbr = &conn->ccpriv.bbr;
+
+  bbr->round_delivered += acked;
+
+  if (TCP_SEQ_GTE(ackno, bbr->round_seq))
+    {
+      bbr_update_round(conn, ackno, tcp_cc_time_us());
+    }
+}
+
+/****************************************************************************
+ * Name: bbr_cong_avoid
+ *
+ * Description:
+ *   Grow cwnd towards cwnd_gain times the BDP.  ssthresh is not used.
+ *
+ ****************************************************************************/
+
+static void bbr_cong_avoid(FAR struct tcp_conn_s *conn, uint32_t acked)
+{
+  FAR struct tcp_bbr_s *bbr = &conn->ccpriv.bbr;
+  uint32_t target;
+
+  if (bbr->mode == BBR_PROBE_RTT)
+    {
+      conn->cwnd = MIN(conn->cwnd, BBR_MIN_CWND(conn));
+      return;
+    }
+
+  target = bbr_bdp(conn, bbr->cwnd_gain) + 3 * conn->mss;
+
+  if (!bbr->full_bw_reached || conn->cwnd < target)
+    {
+      conn->cwnd = MIN(conn->cwnd + acked, MAX(target, conn->cwnd));
+    }
+  else
+    {
+      conn->cwnd = target;
+    }
+
+  conn->cwnd = MAX(conn->cwnd, BBR_MIN_CWND(conn));
+}
+
+/****************************************************************************
+ * Name: bbr_loss
+ *
+ * Description:
+ *   BBR does not treat loss as congestion.  Keep packet conservation during
+ *   recovery and restore the window when it ends.
+ *
+ ****************************************************************************/
+
+static void bbr_loss(FAR struct tcp_conn_s *conn, bool timeout)
+{
+  FAR struct tcp_bbr_s *bbr = &conn->ccpriv.bbr;
+
+  bbr->prior_cwnd = conn->cwnd;
+
+  /* The generic fast recovery code restores cwnd to ssthresh on exit */
+
+  conn->ssthresh  = MAX(conn->cwnd, BBR_MIN_CWND(conn));
+
+  if (timeout)
+    {
+      conn->cwnd = conn->mss;
+    }
+  else
+    {
+      conn->cwnd = conn->tx_unacked + conn->mss;
+    }
+}
@@ -0,0 +1,288 @@
+/****************************************************************************
+ * net/tcp/tcp_cc_cubic.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <debug.h>
+#include <inttypes.h>
+#include <string.h>
+
+#include <nuttx/clock.h>
+
+#include "tcp/tcp.h"
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* RFC 8312 constants in the fixed point form used by Linux:
+ *
+ *   beta = 0.7 = CUBIC_BETA / 1024
+ *   C    = 0.4, time in units of 1/1024 sec (CUBIC_HZ = 10 bits), so that
+ *          W(t) = C * (t - K)^3 = (CUBIC_RTT_SCALE * (t - K)^3) >> 40
+ */
+
+#define CUBIC_BETA         717
+#define CUBIC_BETA_SCALE   (8 * (1024 + CUBIC_BETA) / 3 / (1024 - CUBIC_BETA))
+#define CUBIC_HZ           10
+#define CUBIC_RTT_SCALE    410
+#define CUBIC_CUBE_FACTOR  ((UINT64_C(1) << (10 + 3 * CUBIC_HZ)) / \
+                            CUBIC_RTT_SCALE)
+
+/* Largest distance to K in the cube (256 sec): CUBIC_RTT_SCALE * offs^3
+ * stays below 2^63 and the resulting delta fits in 32 bits.
+ */
+
+#define CUBIC_MAX_OFFS     (UINT32_C(1) << 18)
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+static void cubic_init(FAR struct tcp_conn_s *conn);
+static void cubic_cong_avoid(FAR struct tcp_conn_s *conn, uint32_t acked);
+static void cubic_loss(FAR struct tcp_conn_s *conn, bool timeout);
+
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+const struct tcp_cc_ops_s g_tcp_cc_cubic =
+{
+  "cubic",              /* name */
+  cubic_init,           /* init */
+  NULL,                 /* ack */
+  cubic_cong_avoid,     /* cong_avoid */
+  cubic_loss            /* loss */
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: cubic_root
+ *
+ * Description:
+ *   Integer cube root, rounded down.
+ *
+ ****************************************************************************/
+
+static uint32_t cubic_root(uint64_t a)
+{
+  uint64_t y = 0;
+  uint64_t b;
+  int s;
+
+  for (s = 63; s >= 0; s -= 3)
+    {
+      y += y;
+      b  = 3 * y * (y + 1) + 1;
+      if ((a >> s) >= b)
+        {
+          a -= b << s;
+          y++;
+        }
+    }
+
+  return (uint32_t)y;
+}
+
+/****************************************************************************
+ * Name: cubic_update
+ *
+ * Description:
+ *   Compute how many segments must be ACKed for each segment of growth so
+ *   that the window follows the cubic function, and never grows slower
+ *   than the Reno estimate.
+ *
+ ****************************************************************************/
+
+static void cubic_update(FAR struct tcp_conn_s *conn, uint32_t acked)
+{
+  FAR struct tcp_cubic_s *ca = &conn->ccpriv.cubic;
+  uint32_t cwnd = MAX(conn->cwnd / conn->mss, 1);
+  clock_t now = clock_systime_ticks();
+  uint32_t target;
+  uint32_t delta;
+  uint64_t offs;
+  uint64_t t;
+
+  ca->ack_cnt += acked;
+
+  if (ca->epoch_start == 0)
+    {
+      /* First ACK after a loss (or ever), start a new epoch */
+
+      ca->epoch_start = now != 0 ? now : 1;
+      ca->ack_cnt     = acked;
+      ca->tcp_cwnd    = cwnd;
+
+      if (ca->last_max_cwnd <= cwnd)
+        {
+          ca->k            = 0;
+          ca->origin_point = cwnd;
+        }
+      else
+        {
+          ca->k            = cubic_root(CUBIC_CUBE_FACTOR *
+                                        (ca->last_max_cwnd - cwnd));
+          ca->origin_point = ca->last_max_cwnd;
+        }
+    }
+
+  /* Time since the epoch start in 1/1024 sec */
+
+  t = (uint64_t)TICK2MSEC(now - ca->epoch_start) * 1024 / MSEC_PER_SEC;
+
+  offs = t < ca->k ? ca->k - t : t - ca->k;
+  offs = MIN(offs, CUBIC_MAX_OFFS);
+
+  delta = (CUBIC_RTT_SCALE * offs * offs * offs) >> (10 + 3 * CUBIC_HZ);
+
+  if (t < ca->k)
+    {
+      target = ca->origin_point > delta ? ca->origin_point - delta : 1;
+    }
+  else
+    {
+      target = ca->origin_point + delta;
+    }
+
+  if (target > cwnd)
+    {
+      ca->cnt = cwnd / (target - cwnd);
+    }
+  else
+    {
+      ca->cnt = 100 * cwnd;
+    }
+
+  /* Grow at least as fast as slow start the first time */
+
+  if (ca->last_max_cwnd == 0 && ca->cnt > 20)
+    {
+      ca->cnt = 20;
+    }
+
+  /* TCP friendliness: Reno would grow by one segment every
+   * cwnd * 8 / CUBIC_BETA_SCALE segments ACKed.
+   */
+
+  delta = MAX((cwnd * CUBIC_BETA_SCALE) >> 3, 1) * conn->mss;
+  while (ca->ack_cnt > delta)
+    {
+      ca->ack_cnt -= delta;
+      ca->tcp_cwnd++;
+    }
+
+  if (ca->tcp_cwnd > cwnd)
+    {
+      ca->cnt = MIN(ca->cnt, cwnd / (ca->tcp_cwnd - cwnd));
+    }
+
+  ca->cnt = MAX(ca->cnt, 2);
+}
+
+/****************************************************************************
+ * Name: cubic_init
+ ****************************************************************************/
+
+static void cubic_init(FAR struct tcp_conn_s *conn)
+{
+  memset(&conn->ccpriv.cubic, 0, sizeof(conn->ccpriv.cubic));
+}
+
+/****************************************************************************
+ * Name: cubic_cong_avoid
+ *
+ * Description:
+ *   Slow start below ssthresh, then grow by one segment every cnt
+ *   segments ACKed.
+ *
+ ****************************************************************************/
+
+static void cubic_cong_avoid(FAR struct tcp_conn_s *conn, uint32_t acked)
+{
+  FAR struct tcp_cubic_s *ca = &conn->ccpriv.cubic;
+  uint32_t step;
+
+  if (conn->cwnd < conn->ssthresh)
+    {
+      tcp_cc_slow_start(conn, acked);
+      return;
+    }
+
+  cubic_update(conn, acked);
+
+  step = ca->cnt * conn->mss;
+  ca->cwnd_cnt += acked;
+  if (ca->cwnd_cnt >= step)
+    {
+      conn->cwnd   += ca->cwnd_cnt / step * conn->mss;
+      ca->cwnd_cnt %= step;
+      ninfo("update cubic cwnd to %" PRIu32 "\n", conn->cwnd);
+    }
+}
+
+/****************************************************************************
+ * Name: cubic_loss
+ *
+ * Description:
+ *   Multiplicative decrease by beta.  With fast convergence, a flow that
+ *   lost before reaching its previous maximum releases bandwidth faster.
+ *
+ ****************************************************************************/
+
+static void cubic_loss(FAR struct tcp_conn_s *conn, bool timeout)
+{
+  FAR struct tcp_cubic_s *ca = &conn->ccpriv.cubic;
+  uint32_t cwnd = MAX(conn->cwnd / conn->mss, 1);
+
+  ca->epoch_start = 0;
+  ca->cwnd_cnt    = 0;
+
+  if (cwnd < ca->last_max_cwnd)
+    {
+      ca->last_max_cwnd = cwnd * (1024 + CUBIC_BETA) / (2 * 1024);
+    }
+  else
+    {
+      ca->last_max_cwnd = cwnd;
+    }
+
+  conn->ssthresh = MAX((uint64_t)conn->cwnd * CUBIC_BETA / 1024,
+                       2 * conn->mss);
+
+  if (timeout)
+    {
+      conn->cwnd = conn->mss;
+    }
+  else
+    {
+      conn->cwnd = conn->ssthresh + 3 * conn->mss;
+    }
+}
@@ -71,6 +71,7 @@
 #include "icmpv6/icmpv6.h"
 #include "nat/nat.h"
 #include "netdev/netdev.h"
+#include "socket/socket.h"
 #include "utils/utils.h"
 
 /****************************************************************************
@@ -168,6 +169,84 @@ static FAR struct tcp_conn_s *
   return NULL;
 }
 
+/****************************************************************************
+ * Name: tcp_reuseport
+ *
+ * Description:
+ *   Return true if conn may bind to a local address and port that is
+ *   already in use: conn and every other unconnected socket bound to it
+ *   set SO_REUSEPORT.  Connected sockets do not conflict, their remote
+ *   address and port tell them apart.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_TCP_REUSEPORT
+static bool tcp_reuseport(FAR struct tcp_conn_s *conn, uint8_t domain,
+                          FAR const union ip_addr_u *ipaddr,
+                          uint16_t portno)
+{
+  FAR struct tcp_conn_s *other = NULL;
+
+  if (!_SO_GETOPT(conn->sconn.s_options, SO_REUSEPORT))
+    {
+      return false;
+    }
+
+  while ((other = tcp_nextconn(other)) != NULL)
+    {
+      if (other == conn || other->tcpstateflags == TCP_CLOSED ||
+          other->lport != portno || other->rport != 0
+#if defined(CONFIG_NET_IPv4) && defined(CONFIG_NET_IPv6)
+          || domain != other->domain
+#endif
+         )
+        {
+          continue;
+        }
+
+#ifdef CONFIG_NET_IPv4
+#ifdef CONFIG_NET_IPv6
+      if (domain == PF_INET)
+#endif /* CONFIG_NET_IPv6 */
+        {
+          if (!net_ipv4addr_cmp(other->u.ipv4.laddr, ipaddr->ipv4) &&
+              !net_ipv4addr_cmp(other->u.ipv4.laddr, INADDR_ANY) &&
+              !net_ipv4addr_cmp(ipaddr->ipv4, INADDR_ANY))
+            {
+              continue;
+            }
+        }
+#endif /* CONFIG_NET_IPv4 */
+
+#ifdef CONFIG_NET_IPv6
+#ifdef CONFIG_NET_IPv4
+      else
+#endif /* CONFIG_NET_IPv4 */
+        {
+          if (!net_ipv6addr_cmp(other->u.ipv6.laddr, ipaddr->ipv6) &&
+              !net_ipv6addr_cmp(other->u.ipv6.laddr, g_ipv6_unspecaddr) &&
+              !net_ipv6addr_cmp(ipaddr->ipv6, g_ipv6_unspecaddr))
+            {
+              continue;
+            }
+        }
+#endif /* CONFIG_NET_IPv6 */
+
+      /* The address is in use by this socket, it must share it too */
+
+      if (!_SO_GETOPT(other->sconn.s_options, SO_REUSEPORT))
+        {
+          return false;
+        }
+    }
+
+  return true;
+}
+#endif /* CONFIG_NET_TCP_REUSEPORT */
+
 /****************************************************************************
  * Name: tcp_ipv4_active
  *
@@ -363,6 +442,16 @@ static inline int tcp_ipv4_bind(FAR struct tcp_conn_s *conn,
   port = tcp_selectport(PF_INET,
                        (FAR const union ip_addr_u *)&addr->sin_addr.s_addr,
                        addr->sin_port);
+#ifdef CONFIG_NET_TCP_REUSEPORT
+  if (port == -EADDRINUSE && addr->sin_port != 0 &&
+      tcp_reuseport(conn, PF_INET,
+                    (FAR const union ip_addr_u *)&addr->sin_addr.s_addr,
+                    addr->sin_port))
+    {
+      port = addr->sin_port;
+    }
+#endif
+
   if (port < 0)
     {
       nerr("ERROR: tcp_selectport failed: %d\n", port);
@@ -463,6 +552,16 @@ static inline int tcp_ipv6_bind(FAR struct tcp_conn_s *conn,
   port = tcp_selectport(PF_INET6,
                 (FAR const union ip_addr_u *)addr->sin6_addr.in6_u.u6_addr16,
                 addr->sin6_port);
+#ifdef CONFIG_NET_TCP_REUSEPORT
+  if (port == -EADDRINUSE && addr->sin6_port != 0 &&
+      tcp_reuseport(conn, PF_INET6,
+                (FAR const union ip_addr_u *)addr->sin6_addr.in6_u.u6_addr16,
+                addr->sin6_port))
+    {
+      port = addr->sin6_port;
+    }
+#endif
+
   if (port < 0)
     {
       nerr("ERROR: tcp_selectport failed: %d\n", port);
@@ -661,6 +760,10 @@ void tcp_initialize(void)
       dq_addlast(&g_tcp_connections[i].sconn.node, &g_free_tcp_connections);
     }
 #endif
+
+#if CONFIG_NET_TCP_TIMEWAIT_RECORDS > 0
+  tcp_timewait_initialize();
+#endif
 }
 
 /****************************************************************************
@@ -787,10 +890,8 @@ FAR struct tcp_conn_s *tcp_alloc(uint8_t domain)
 #if defined(CONFIG_NET_IPv4) && defined(CONFIG_NET_IPv6)
       conn->domain        = domain;
 #endif
-#ifdef CONFIG_NET_TCP_KEEPALIVE
-      conn->keepidle      = 2 * DSEC_PER_HOUR;
-      conn->keepintvl     = 2 * DSEC_PER_SEC;
-      conn->keepcnt       = 3;
+#ifdef CONFIG_NET_TCP_CC_NEWRENO
+      conn->cc            = TCP_CC_DEFAULT;
 #endif
 #if CONFIG_NET_RECV_BUFSIZE > 0
       conn->rcv_bufs      = CONFIG_NET_RECV_BUFSIZE;
@@ -845,16 +946,17 @@ void tcp_free_rx_buffers(FAR struct tcp_conn_s *conn)
 #ifdef CONFIG_NET_TCP_OUT_OF_ORDER
   /* Release any out-of-order buffers */
 
-  if (conn->nofosegs > 0)
+  if (conn->ofo != NULL)
     {
       int i;
 
-      for (i = 0; i < conn->nofosegs; i++)
+      for (i = 0; i < conn->ofo->nofosegs; i++)
         {
-          iob_free_chain(conn->ofosegs[i].data);
+          iob_free_chain(conn->ofo->ofosegs[i].data);
         }
 
-      conn->nofosegs = 0;
+      kmm_free(conn->ofo);
+      conn->ofo = NULL;
     }
 #endif /* CONFIG_NET_TCP_OUT_OF_ORDER */
 }
@@ -896,10 +998,27 @@ void tcp_free(FAR struct tcp_conn_s *conn)
       return;
     }
 
+#if CONFIG_NET_TCP_TIMEWAIT_RECORDS > 0
+  /* Only a small record is kept for the rest of TIME_WAIT */
+
+  if (conn->tcpstateflags == TCP_TIME_WAIT)
+    {
+      tcp_timewait_add(conn);
+    }
+#endif
+
   /* Cancel tcp timer */
 
   tcp_stop_timer(conn);
 
+#ifdef CONFIG_NET_TCP_PACING
+  tcp_pacing_stop(conn);
+#endif
+
+#ifdef CONFIG_NET_TCP_RACK
+  tcp_rack_stop(conn);
+#endif
+
   /* Make sure monitor is stopped. */
 
   tcp_stop_monitor(conn, TCP_CLOSE);
@@ -927,6 +1046,11 @@ void tcp_free(FAR struct tcp_conn_s *conn)
 
   tcp_free_rx_buffers(conn);
 
+#ifdef CONFIG_NET_TCP_KEEPALIVE
+  kmm_free(conn->ka);
+  conn->ka = NULL;
+#endif
+
 #ifdef CONFIG_NET_TCP_WRITE_BUFFERS
   /* Release any write buffers attached to the connection */
 
@@ -942,6 +1066,12 @@ void tcp_free(FAR struct tcp_conn_s *conn)
       tcp_wrbuffer_release(wrbuffer);
     }
 
+#ifdef CONFIG_NET_ZEROCOPY
+  /* Drop the pending MSG_ZEROCOPY completions */
+
+  zerocopy_release(&conn->sconn);
+#endif
+
 #if CONFIG_NET_SEND_BUFSIZE > 0
   /* Notify the send buffer available */
 
@@ -991,6 +1121,36 @@ void tcp_free(FAR struct tcp_conn_s *conn)
   net_unlock();
 }
 
+/****************************************************************************
+ * Name: tcp_conn_memsize
+ *
+ * Description:
+ *   Return the RAM held by a connection structure and its extensions, the
+ *   data buffers not included.
+ *
+ ****************************************************************************/
+
+size_t tcp_conn_memsize(FAR struct tcp_conn_s *conn)
+{
+  size_t size = sizeof(struct tcp_conn_s);
+
+#ifdef CONFIG_NET_TCP_OUT_OF_ORDER
+  if (conn->ofo != NULL)
+    {
+      size += sizeof(struct tcp_ofo_s);
+    }
+#endif
+
+#ifdef CONFIG_NET_TCP_KEEPALIVE
+  if (conn->ka != NULL)
+    {
+      size += sizeof(struct tcp_keepalive_s);
+    }
+#endif
+
+  return size;
+}
+
 /****************************************************************************
  * Name: tcp_active
  *
@@ -1181,6 +1341,9 @@ FAR struct tcp_conn_s *tcp_alloc_accept(FAR struct net_driver_s *dev,
       conn->snd_bufs         = listener->snd_bufs;
 #endif
       conn->mss              = listener->mss;
+#ifdef CONFIG_NET_TCP_CC_NEWRENO
+      conn->cc               = listener->cc;
+#endif
 
       /* Fill in the necessary fields for the new connection. */
 
@@ -31,6 +31,7 @@
 #include <errno.h>
 #include <assert.h>
 #include <debug.h>
+#include <string.h>
 
 #include <netinet/tcp.h>
 
@@ -129,7 +130,7 @@ int tcp_getsockopt(FAR struct socket *psock, int option,
         else
           {
             FAR int *keepalive = (FAR int *)value;
-            *keepalive         = conn->keepalive;
+            *keepalive         = TCP_KEEPALIVE(conn);
             *value_len         = sizeof(int);
             ret                = OK;
           }
@@ -142,11 +143,13 @@ int tcp_getsockopt(FAR struct socket *psock, int option,
 
           if (option == TCP_KEEPIDLE)
             {
-              dsecs = conn->keepidle;
+              dsecs = conn->ka != NULL ? conn->ka->keepidle :
+                                         TCP_KEEPIDLE_DEFAULT;
             }
           else
             {
-              dsecs = conn->keepintvl;
+              dsecs = conn->ka != NULL ? conn->ka->keepintvl :
+                                         TCP_KEEPINTVL_DEFAULT;
             }
 
           if (value == NULL)
@@ -196,7 +199,8 @@ int tcp_getsockopt(FAR struct socket *psock, int option,
         else
           {
             FAR int *keepcnt = (FAR int *)value;
-            *keepcnt         = conn->keepcnt;
+            *keepcnt         = conn->ka != NULL ? conn->ka->keepcnt :
+                                                  TCP_KEEPCNT_DEFAULT;
             *value_len       = sizeof(int);
             ret              = OK;
           }
@@ -239,6 +243,14 @@ int tcp_getsockopt(FAR struct socket *psock, int option,
           }
         break;
 
+#ifdef CONFIG_NET_TCP_CC_NEWRENO
+      case TCP_CONGESTION: /* Congestion control algorithm */
+        *value_len = MIN(*value_len, TCP_CA_NAME_MAX);
+        strncpy(value, conn->cc->name, *value_len);
+        ret = OK;
+        break;
+#endif
+
       default:
         nerr("ERROR: Unrecognized TCP option: %d\n", option);
         ret = -ENOPROTOOPT;
@@ -55,6 +55,7 @@
 #include <assert.h>
 #include <debug.h>
 
+#include <nuttx/kmalloc.h>
 #include <nuttx/net/netconfig.h>
 #include <nuttx/net/netdev.h>
 #include <nuttx/net/netstats.h>
@@ -274,7 +275,7 @@ static bool tcp_snd_wnd_update(FAR struct tcp_conn_s *conn,
  *   Re-build out-of-order pool from incoming segment
  *
  * Input Parameters:
- *   conn   - The TCP connection of interest
+ *   ofo    - The out-of-order pool of the connection
  *   ofoseg - Pointer to incoming out-of-order segment
  *   start  - Index of start postion of segment pool
  *
@@ -286,16 +287,16 @@ static bool tcp_snd_wnd_update(FAR struct tcp_conn_s *conn,
  *
  ****************************************************************************/
 
-static bool tcp_rebuild_ofosegs(FAR struct tcp_conn_s *conn,
+static bool tcp_rebuild_ofosegs(FAR struct tcp_ofo_s *ofo,
                                 FAR struct tcp_ofoseg_s *ofoseg,
                                 int start)
 {
   struct tcp_ofoseg_s *seg;
   int i;
 
-  for (i = start; i < conn->nofosegs && ofoseg->data != NULL; i++)
+  for (i = start; i < ofo->nofosegs && ofoseg->data != NULL; i++)
     {
-      seg = &conn->ofosegs[i];
+      seg = &ofo->ofosegs[i];
 
       /* ofoseg    |~~~
        * segpool |---|
@@ -427,6 +428,7 @@ static void tcp_input_ofosegs(FAR struct net_driver_s *dev,
                               FAR struct tcp_conn_s *conn,
                               unsigned int iplen)
 {
+  FAR struct tcp_ofo_s *ofo = conn->ofo;
   struct tcp_ofoseg_s ofoseg;
   bool rebuild;
   int i = 0;
@@ -440,7 +442,7 @@ static void tcp_input_ofosegs(FAR struct net_driver_s *dev,
    */
 
   if (tcp_ofoseg_bufsize(conn) > CONFIG_NET_TCP_OUT_OF_ORDER_BUFSIZE &&
-      ofoseg.left >= conn->ofosegs[0].left)
+      ofoseg.left >= ofo->ofosegs[0].left)
     {
       return;
     }
@@ -464,38 +466,54 @@ static void tcp_input_ofosegs(FAR struct net_driver_s *dev,
       goto prepare;
     }
 
+  /* The first hole of the connection, allocate the pool.  If that fails
+   * the segment is dropped and the peer has to retransmit it.
+   */
+
+  if (ofo == NULL)
+    {
+      ofo = kmm_zalloc(sizeof(struct tcp_ofo_s));
+      if (ofo == NULL)
+        {
+          nerr("ERROR: Failed to allocate the out-of-order pool\n");
+          goto prepare;
+        }
+
+      conn->ofo = ofo;
+    }
+
   ofoseg.data = dev->d_iob;
 
   /* Build out-of-order pool */
 
-  rebuild = tcp_rebuild_ofosegs(conn, &ofoseg, 0);
+  rebuild = tcp_rebuild_ofosegs(ofo, &ofoseg, 0);
 
   /* Incoming segment out of order from existing pool, add to new segment */
 
-  if (!rebuild && conn->nofosegs != TCP_SACK_RANGES_MAX)
+  if (!rebuild && ofo->nofosegs != TCP_SACK_RANGES_MAX)
     {
-      conn->ofosegs[conn->nofosegs] = ofoseg;
-      conn->nofosegs++;
+      ofo->ofosegs[ofo->nofosegs] = ofoseg;
+      ofo->nofosegs++;
       rebuild = true;
     }
 
   /* Try Re-order ofosegs */
 
   if (rebuild &&
-      tcp_reorder_ofosegs(conn->nofosegs, (FAR void *)conn->ofosegs))
+      tcp_reorder_ofosegs(ofo->nofosegs, (FAR void *)ofo->ofosegs))
     {
       /* Re-build out-of-order pool after re-order */
 
-      while (i < conn->nofosegs - 1)
+      while (i < ofo->nofosegs - 1)
         {
-          if (tcp_rebuild_ofosegs(conn, &conn->ofosegs[i], i + 1))
+          if (tcp_rebuild_ofosegs(ofo, &ofo->ofosegs[i], i + 1))
             {
-              for (; i < conn->nofosegs - 1; i++)
+              for (; i < ofo->nofosegs - 1; i++)
                 {
-                  conn->ofosegs[i] = conn->ofosegs[i + 1];
+                  ofo->ofosegs[i] = ofo->ofosegs[i + 1];
                 }
 
-              conn->nofosegs--;
+              ofo->nofosegs--;
 
               i = 0;
             }
@@ -506,11 +524,11 @@ static void tcp_input_ofosegs(FAR struct net_driver_s *dev,
         }
     }
 
-  for (i = 0; i < conn->nofosegs; i++)
+  for (i = 0; i < ofo->nofosegs; i++)
     {
       ninfo("TCP OFOSEG [%d][%" PRIu32 " : %" PRIu32 " : %" PRIu32 "]\n", i,
-            conn->ofosegs[i].left, conn->ofosegs[i].right,
-            TCP_SEQ_SUB(conn->ofosegs[i].right, conn->ofosegs[i].left));
+            ofo->ofosegs[i].left, ofo->ofosegs[i].right,
+            TCP_SEQ_SUB(ofo->ofosegs[i].right, ofo->ofosegs[i].left));
     }
 
   /* Incoming data has been consumed, re-prepare device buffer to send
@@ -615,6 +633,14 @@ static void tcp_parse_option(FAR struct net_driver_s *dev,
         {
           conn->flags    |= TCP_SACK;
         }
+#endif
+#ifdef CONFIG_NET_TCP_TIMESTAMPS
+      else if (opt == TCP_OPT_TS &&
+               IPDATA(tcpiplen + 1 + i) == TCP_OPT_TS_LEN)
+        {
+          conn->ts_recent = tcp_getsequence(IPBUF(tcpiplen + 2 + i));
+          conn->flags    |= TCP_TSTAMP;
+        }
 #endif
       else
         {
@@ -634,6 +660,17 @@ static void tcp_parse_option(FAR struct net_driver_s *dev,
 
       i += IPDATA(tcpiplen + 1 + i);
     }
+
+#ifdef CONFIG_NET_TCP_TIMESTAMPS
+  /* The MSS does not account for the options, leave room for the
+   * timestamps in every segment.
+   */
+
+  if ((conn->flags & TCP_TSTAMP) != 0)
+    {
+      conn->mss -= TCP_OPT_TS_SPACE;
+    }
+#endif
 }
 
 /****************************************************************************
@@ -699,6 +736,9 @@ static void tcp_input(FAR struct net_driver_s *dev, uint8_t domain,
   uint16_t tmp16;
   uint16_t flags;
   uint16_t result;
+#ifdef CONFIG_NET_TCP_TIMESTAMPS
+  uint32_t tsecr = 0;
+#endif
   int      len;
 
 #ifdef CONFIG_NET_STATISTICS
@@ -762,6 +802,15 @@ static void tcp_input(FAR struct net_driver_s *dev, uint8_t domain,
         }
     }
 
+#if CONFIG_NET_TCP_TIMEWAIT_RECORDS > 0
+  /* Segments of a connection released in TIME_WAIT */
+
+  if (tcp_timewait_input(dev, tcp, domain))
+    {
+      return;
+    }
+#endif
+
   /* If we didn't find an active connection that expected the packet,
    * either (1) this packet is an old duplicate, or (2) this is a SYN packet
    * destined for a connection in LISTEN.  If the SYN flag isn't set,
@@ -781,6 +830,7 @@ static void tcp_input(FAR struct net_driver_s *dev, uint8_t domain,
 #  endif
         {
           net_ipv6addr_copy(&uaddr.ipv6.laddr, IPv6BUF->destipaddr);
+          net_ipv6addr_copy(&uaddr.ipv6.raddr, IPv6BUF->srcipaddr);
         }
 #endif
 
@@ -791,13 +841,16 @@ static void tcp_input(FAR struct net_driver_s *dev, uint8_t domain,
         {
           net_ipv4addr_copy(uaddr.ipv4.laddr,
                             net_ip4addr_conv32(IPv4BUF->destipaddr));
+          net_ipv4addr_copy(uaddr.ipv4.raddr,
+                            net_ip4addr_conv32(IPv4BUF->srcipaddr));
         }
 #endif
 
 #if defined(CONFIG_NET_IPv4) && defined(CONFIG_NET_IPv6)
-      if ((conn = tcp_findlistener(&uaddr, tmp16, domain)) != NULL)
+      if ((conn = tcp_findlistener(&uaddr, tmp16, tcp->srcport,
+                                   domain)) != NULL)
 #else
-      if ((conn = tcp_findlistener(&uaddr, tmp16)) != NULL)
+      if ((conn = tcp_findlistener(&uaddr, tmp16, tcp->srcport)) != NULL)
 #endif
         {
           if (!tcp_backlogavailable(conn))
@@ -893,6 +946,10 @@ reset:
 found:
   flags = 0;
 
+  /* The replies to this segment carry the options of the connection */
+
+  tcpiplen = tcpip_hdrsize(conn);
+
   /* We do a very naive form of TCP reset processing; we just accept
    * any RST and kill our connection. We should in fact check if the
    * sequence number of this reset is within our advertised window
@@ -920,6 +977,7 @@ found:
 #  endif
             {
               net_ipv6addr_copy(&uaddr.ipv6.laddr, IPv6BUF->destipaddr);
+              net_ipv6addr_copy(&uaddr.ipv6.raddr, IPv6BUF->srcipaddr);
             }
 #endif
 
@@ -930,13 +988,16 @@ found:
             {
               net_ipv4addr_copy(uaddr.ipv4.laddr,
                                 net_ip4addr_conv32(IPv4BUF->destipaddr));
+              net_ipv4addr_copy(uaddr.ipv4.raddr,
+                                net_ip4addr_conv32(IPv4BUF->srcipaddr));
             }
 #endif
 
 #if defined(CONFIG_NET_IPv4) && defined(CONFIG_NET_IPv6)
-          listener = tcp_findlistener(&uaddr, conn->lport, domain);
+          listener = tcp_findlistener(&uaddr, conn->lport, conn->rport,
+                                      domain);
 #else
-          listener = tcp_findlistener(&uaddr, conn->lport);
+          listener = tcp_findlistener(&uaddr, conn->lport, conn->rport);
 #endif
 
           /* We must free this TCP connection structure; this connection
@@ -1022,6 +1083,19 @@ found:
     }
 #endif
 
+#ifdef CONFIG_NET_TCP_TIMESTAMPS
+  /* Drop old duplicates by their timestamp (PAWS), but ACK them */
+
+  if ((conn->flags & TCP_TSTAMP) != 0 && !tcp_ts_input(conn, tcp, &tsecr))
+    {
+#ifdef CONFIG_NET_STATISTICS
+      g_netstats.tcp.drop++;
+#endif
+      tcp_send(dev, conn, TCP_ACK, tcpiplen);
+      return;
+    }
+
+#endif
   /* Check if the incoming segment acknowledges any outstanding data. If so,
    * we update the sequence number, reset the length of the outstanding
    * data, calculate RTT estimations, and reset the retransmission timer.
@@ -1059,6 +1133,17 @@ found:
 
       ackseq = tcp_getsequence(tcp->ackno);
 
+#ifdef CONFIG_NET_TCP_TIMESTAMPS
+      /* The echoed timestamp gives an RTT sample for every ACK of new
+       * data, retransmitted or not.
+       */
+
+      if (tsecr != 0 && TCP_SEQ_GT(ackseq, unackseq - conn->tx_unacked))
+        {
+          tcp_rtt_sample(conn, (tcp_ts_now() - tsecr) * USEC_PER_MSEC);
+        }
+#endif
+
       /* Check how many of the outstanding bytes have been acknowledged. For
        * most send operations, this should always be true.  However,
        * the send() API sends data ahead when it can without waiting for
@@ -1116,9 +1201,15 @@ found:
         }
 #endif
 
-      /* Do RTT estimation, unless we have done retransmissions. */
+      /* Do RTT estimation, unless we have done retransmissions.  Once a
+       * finer sample has been taken, the estimation is left to it.
+       */
 
+#ifdef CONFIG_NET_TCP_FINE_RTT
+      if (conn->nrtx == 0 && conn->srtt == 0)
+#else
       if (conn->nrtx == 0)
+#endif
         {
           signed char m;
           m = conn->rto - conn->timer;
@@ -1534,13 +1625,13 @@ found:
          * the keep alive timer.
          */
 
-        if (conn->keepalive &&
+        if (TCP_KEEPALIVE(conn) &&
             (dev->d_len > 0 || (tcp->flags & TCP_ACK) != 0))
           {
             /* Reset the "alive" timer. */
 
-            tcp_update_keeptimer(conn, conn->keepidle);
-            conn->keepretries = 0;
+            tcp_update_keeptimer(conn, conn->ka->keepidle);
+            conn->ka->keepretries = 0;
           }
 #endif
 
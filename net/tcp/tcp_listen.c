@@ -55,6 +55,7 @@
 
 #include "devif/devif.h"
 #include "inet/inet.h"
+#include "socket/socket.h"
 #include "tcp/tcp.h"
 
 /****************************************************************************
@@ -69,12 +70,154 @@ static FAR struct tcp_conn_s *tcp_listenports[CONFIG_NET_MAX_LISTENPORTS];
  * Private Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: tcp_matchlistener
+ *
+ * Description:
+ *   Return true if the listener conn accepts connections to this local
+ *   address and port.
+ *
+ ****************************************************************************/
+
+static bool tcp_matchlistener(FAR struct tcp_conn_s *conn,
+                              FAR union ip_binding_u *uaddr,
+                              uint16_t portno, uint8_t domain)
+{
+#if defined(CONFIG_NET_IPv4) && defined(CONFIG_NET_IPv6)
+  if (conn == NULL || conn->lport != portno || conn->domain != domain)
+#else
+  if (conn == NULL || conn->lport != portno)
+#endif
+    {
+      return false;
+    }
+
+#ifdef CONFIG_NET_IPv6
+#  ifdef CONFIG_NET_IPv4
+  if (domain == PF_INET6)
+#  endif
+    {
+      return net_ipv6addr_cmp(conn->u.ipv6.laddr, uaddr->ipv6.laddr) ||
+             net_ipv6addr_cmp(conn->u.ipv6.laddr, g_ipv6_unspecaddr);
+    }
+#endif
+
+#ifdef CONFIG_NET_IPv4
+#  ifdef CONFIG_NET_IPv6
+  else
+#  endif
+    {
+      return net_ipv4addr_cmp(conn->u.ipv4.laddr, uaddr->ipv4.laddr) ||
+             net_ipv4addr_cmp(conn->u.ipv4.laddr, INADDR_ANY);
+    }
+#endif
+}
+
+/****************************************************************************
+ * Name: tcp_reuseport_group
+ *
+ * Description:
+ *   Return true if the listeners conn and other may share their port:
+ *   both set SO_REUSEPORT and are bound to the same local address of the
+ *   same domain.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_TCP_REUSEPORT
+static bool tcp_reuseport_group(FAR struct tcp_conn_s *conn,
+                                FAR struct tcp_conn_s *other)
+{
+  if (!_SO_GETOPT(conn->sconn.s_options, SO_REUSEPORT) ||
+      !_SO_GETOPT(other->sconn.s_options, SO_REUSEPORT))
+    {
+      return false;
+    }
+
+#if defined(CONFIG_NET_IPv4) && defined(CONFIG_NET_IPv6)
+  if (conn->domain != other->domain)
+    {
+      return false;
+    }
+#endif
+
+#ifdef CONFIG_NET_IPv6
+#  ifdef CONFIG_NET_IPv4
+  if (conn->domain == PF_INET6)
+#  endif
+    {
+      return net_ipv6addr_cmp(conn->u.ipv6.laddr, other->u.ipv6.laddr);
+    }
+#endif
+
+#ifdef CONFIG_NET_IPv4
+#  ifdef CONFIG_NET_IPv6
+  else
+#  endif
+    {
+      return net_ipv4addr_cmp(conn->u.ipv4.laddr, other->u.ipv4.laddr);
+    }
+#endif
+}
+
+/****************************************************************************
+ * Name: tcp_reuseport_hash
+ *
+ * Description:
+ *   Hash the addresses and ports of an incoming connection to select one
+ *   of the listeners sharing its port.  The same connection always gets
+ *   the same listener while the group does not change.
+ *
+ ****************************************************************************/
+
+static uint32_t tcp_reuseport_hash(FAR union ip_binding_u *uaddr,
+                                   uint16_t lport, uint16_t rport,
+                                   uint8_t domain)
+{
+  uint32_t hash = ((uint32_t)lport << 16) | rport;
+  int i;
+
+#ifdef CONFIG_NET_IPv6
+#  ifdef CONFIG_NET_IPv4
+  if (domain == PF_INET6)
+#  endif
+    {
+      for (i = 0; i < 8; i++)
+        {
+          hash = hash * 31 + (uaddr->ipv6.laddr[i] ^ uaddr->ipv6.raddr[i]);
+        }
+    }
+#endif
+
+#ifdef CONFIG_NET_IPv4
+#  ifdef CONFIG_NET_IPv6
+  else
+#  endif
+    {
+      UNUSED(i);
+      hash ^= uaddr->ipv4.laddr * 31 + uaddr->ipv4.raddr;
+    }
+#endif
+
+  /* Mix the bits, the group is selected from the high bits */
+
+  hash ^= hash >> 16;
+  hash *= 0x85ebca6b;
+  hash ^= hash >> 13;
+  hash *= 0xc2b2ae35;
+  return hash ^ (hash >> 16);
+}
+#endif /* CONFIG_NET_TCP_REUSEPORT */
+
 /****************************************************************************
  * Name: tcp_findlistener
  *
  * Description:
  *   Return the connection listener for connections on this port (if any)
  *
+ *   If several listeners share the port with SO_REUSEPORT, the remote
+ *   address in uaddr and rport select one of them.  rport is zero when
+ *   any of them will do.
+ *
  * Assumptions:
  *   This function is called from network logic with the network locked.
  *
@@ -82,15 +225,26 @@ static FAR struct tcp_conn_s *tcp_listenports[CONFIG_NET_MAX_LISTENPORTS];
 
 #if defined(CONFIG_NET_IPv4) && defined(CONFIG_NET_IPv6)
 FAR struct tcp_conn_s *tcp_findlistener(FAR union ip_binding_u *uaddr,
-                                        uint16_t portno,
+                                        uint16_t portno, uint16_t rport,
                                         uint8_t domain)
 #else
 FAR struct tcp_conn_s *tcp_findlistener(FAR union ip_binding_u *uaddr,
-                                        uint16_t portno)
+                                        uint16_t portno, uint16_t rport)
 #endif
 {
+  FAR struct tcp_conn_s *conn = NULL;
+#ifdef CONFIG_NET_TCP_REUSEPORT
+  uint32_t nconns = 0;
+  uint32_t select;
+#endif
   int ndx;
 
+#if defined(CONFIG_NET_IPv4) && !defined(CONFIG_NET_IPv6)
+  uint8_t domain = PF_INET;
+#elif !defined(CONFIG_NET_IPv4) && defined(CONFIG_NET_IPv6)
+  uint8_t domain = PF_INET6;
+#endif
+
   /* Examine each connection structure in each slot of the listener list */
 
   for (ndx = 0; ndx < CONFIG_NET_MAX_LISTENPORTS; ndx++)
@@ -99,48 +253,53 @@ FAR struct tcp_conn_s *tcp_findlistener(FAR union ip_binding_u *uaddr,
        * local port number?
        */
 
-      FAR struct tcp_conn_s *conn = tcp_listenports[ndx];
-#if defined(CONFIG_NET_IPv4) && defined(CONFIG_NET_IPv6)
-      if (conn && conn->lport == portno && conn->domain == domain)
-#else
-      if (conn && conn->lport == portno)
-#endif
+      if (tcp_matchlistener(tcp_listenports[ndx], uaddr, portno, domain))
         {
-#ifdef CONFIG_NET_IPv6
-#  ifdef CONFIG_NET_IPv4
-          if (domain == PF_INET6)
-#  endif
-            {
-              if (net_ipv6addr_cmp(conn->u.ipv6.laddr, uaddr->ipv6.laddr) ||
-                  net_ipv6addr_cmp(conn->u.ipv6.laddr, g_ipv6_unspecaddr))
-                {
-                  /* Yes.. we found a listener on this port */
+          /* Yes.. we found a listener on this port */
 
-                  return conn;
-                }
-            }
-#endif
+          conn = tcp_listenports[ndx];
+          break;
+        }
+    }
 
-#ifdef CONFIG_NET_IPv4
-#  ifdef CONFIG_NET_IPv6
-          if (domain == PF_INET)
-#  endif
-            {
-              if (net_ipv4addr_cmp(conn->u.ipv4.laddr, uaddr->ipv4.laddr) ||
-                  net_ipv4addr_cmp(conn->u.ipv4.laddr, INADDR_ANY))
-                {
-                  /* Yes.. we found a listener on this port */
+#ifdef CONFIG_NET_TCP_REUSEPORT
+  if (conn == NULL || rport == 0 ||
+      !_SO_GETOPT(conn->sconn.s_options, SO_REUSEPORT))
+    {
+      return conn;
+    }
 
-                  return conn;
-                }
-            }
-#endif
+  /* The port is shared: count the listeners of the group, then pick the
+   * one selected by the hash of the connection.
+   */
+
+  for (; ndx < CONFIG_NET_MAX_LISTENPORTS; ndx++)
+    {
+      if (tcp_listenports[ndx] != NULL &&
+          tcp_listenports[ndx]->lport == portno &&
+          tcp_reuseport_group(conn, tcp_listenports[ndx]))
+        {
+          nconns++;
         }
     }
 
-  /* No listener for this port */
+  select = tcp_reuseport_hash(uaddr, portno, rport, domain) % nconns;
+
+  for (ndx = 0; ndx < CONFIG_NET_MAX_LISTENPORTS; ndx++)
+    {
+      if (tcp_listenports[ndx] != NULL &&
+          tcp_listenports[ndx]->lport == portno &&
+          tcp_reuseport_group(conn, tcp_listenports[ndx]) &&
+          select-- == 0)
+        {
+          return tcp_listenports[ndx];
+        }
+    }
+#else
+  UNUSED(rport);
+#endif
 
-  return NULL;
+  return conn;
 }
 
 /****************************************************************************
@@ -191,6 +350,7 @@ int tcp_unlisten(FAR struct tcp_conn_s *conn)
 
 int tcp_listen(FAR struct tcp_conn_s *conn)
 {
+  FAR struct tcp_conn_s *listener;
   int ndx;
   int ret;
 
@@ -203,10 +363,18 @@ int tcp_listen(FAR struct tcp_conn_s *conn)
   /* First, check if there is already a socket listening on this port */
 
 #if defined(CONFIG_NET_IPv4) && defined(CONFIG_NET_IPv6)
-  if (tcp_islistener(&conn->u, conn->lport, conn->domain))
+  listener = tcp_findlistener(&conn->u, conn->lport, 0, conn->domain);
 #else
-  if (tcp_islistener(&conn->u, conn->lport))
+  listener = tcp_findlistener(&conn->u, conn->lport, 0);
+#endif
+
+  if (listener != NULL
+#ifdef CONFIG_NET_TCP_REUSEPORT
+      /* Unless both share the port with SO_REUSEPORT */
+
+      && !tcp_reuseport_group(listener, conn)
 #endif
+     )
     {
       /* Yes, then we must refuse this request */
 
@@ -256,12 +424,12 @@ int tcp_listen(FAR struct tcp_conn_s *conn)
 bool tcp_islistener(FAR union ip_binding_u *uaddr, uint16_t portno,
                     uint8_t domain)
 {
-  return tcp_findlistener(uaddr, portno, domain) != NULL;
+  return tcp_findlistener(uaddr, portno, 0, domain) != NULL;
 }
 #else
 bool tcp_islistener(FAR union ip_binding_u *uaddr, uint16_t portno)
 {
-  return tcp_findlistener(uaddr, portno) != NULL;
+  return tcp_findlistener(uaddr, portno, 0) != NULL;
 }
 #endif
 
@@ -288,9 +456,9 @@ int tcp_accept_connection(FAR struct net_driver_s *dev,
    */
 
 #if defined(CONFIG_NET_IPv4) && defined(CONFIG_NET_IPv6)
-  listener = tcp_findlistener(&conn->u, portno, conn->domain);
+  listener = tcp_findlistener(&conn->u, portno, conn->rport, conn->domain);
 #else
-  listener = tcp_findlistener(&conn->u, portno);
+  listener = tcp_findlistener(&conn->u, portno, conn->rport);
 #endif
   if (listener != NULL)
     {
@@ -26,6 +26,7 @@
 
 #include <nuttx/config.h>
 
+#include <sys/epoll.h>
 #include <stdint.h>
 #include <assert.h>
 #include <poll.h>
@@ -79,10 +80,21 @@ static uint16_t tcp_poll_eventhandler(FAR struct net_driver_s *dev,
   if (info != NULL)
     {
       pollevent_t eventset = 0;
+      uint16_t backlog = flags & TCP_BACKLOG;
+
+      /* A new connection wakes up a single EPOLLEXCLUSIVE waiter of the
+       * listener, the non-exclusive waiters are all woken up.
+       */
+
+      if ((flags & TCP_BACKLOG_EXCL) != 0 &&
+          (info->fds->events & EPOLLEXCLUSIVE) != 0)
+        {
+          backlog = 0;
+        }
 
       /* Check for data or connection availability events. */
 
-      if ((flags & (TCP_NEWDATA | TCP_BACKLOG)) != 0)
+      if ((flags & TCP_NEWDATA) != 0 || backlog != 0)
         {
           eventset |= POLLIN;
         }
@@ -170,6 +182,15 @@ static uint16_t tcp_poll_eventhandler(FAR struct net_driver_s *dev,
           info->cb->flags = 0;
           info->cb->priv  = NULL;
           info->cb->event = NULL;
+
+          /* Hide the new connection from the exclusive waiters that
+           * follow.
+           */
+
+          if (backlog != 0 && (info->fds->events & EPOLLEXCLUSIVE) != 0)
+            {
+              flags |= TCP_BACKLOG_EXCL;
+            }
         }
     }
 
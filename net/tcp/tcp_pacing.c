@@ -0,0 +1,178 @@
+/****************************************************************************
+ * net/tcp/tcp_pacing.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include <nuttx/clock.h>
+#include <nuttx/wqueue.h>
+#include <nuttx/net/net.h>
+
+#include "netdev/netdev.h"
+#include "tcp/tcp.h"
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* The wakeups only have the resolution of the system tick, so up to one
+ * tick worth of data may be sent ahead of time.  The average rate is
+ * still the pacing rate.
+ */
+
+#define TCP_PACING_SLACK USEC_PER_TICK
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: tcp_pacing_expiry
+ *
+ * Description:
+ *   The pacing delay of a connection has expired, poll it again.
+ *
+ * Input Parameters:
+ *   arg - The TCP connection held by pacing
+ *
+ ****************************************************************************/
+
+static void tcp_pacing_expiry(FAR void *arg)
+{
+  FAR struct tcp_conn_s *conn = NULL;
+
+  net_lock();
+
+  while ((conn = tcp_nextconn(conn)) != NULL)
+    {
+      if (conn == arg)
+        {
+          netdev_txnotify_dev(conn->dev);
+          break;
+        }
+    }
+
+  net_unlock();
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: tcp_pacing_check
+ *
+ * Description:
+ *   Check whether the pacing rate of the connection allows to send now.
+ *   If not, arrange for the connection to be polled again when it does.
+ *
+ * Input Parameters:
+ *   conn   - The TCP connection of interest
+ *
+ * Returned Value:
+ *   True if the data can be sent now.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+bool tcp_pacing_check(FAR struct tcp_conn_s *conn)
+{
+  int32_t delay;
+
+  if (conn->pacing_rate == 0)
+    {
+      return true;
+    }
+
+  delay = (int32_t)(conn->pacing_next - tcp_cc_time_us());
+  if (delay <= TCP_PACING_SLACK)
+    {
+      return true;
+    }
+
+  if (work_available(&conn->pacing_work))
+    {
+      work_queue(LPWORK, &conn->pacing_work, tcp_pacing_expiry, conn,
+                 USEC2TICK(delay - TCP_PACING_SLACK));
+    }
+
+  return false;
+}
+
+/****************************************************************************
+ * Name: tcp_pacing_sent
+ *
+ * Description:
+ *   Account len bytes just sent against the pacing rate.
+ *
+ * Input Parameters:
+ *   conn   - The TCP connection of interest
+ *   len    - Number of bytes sent
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+void tcp_pacing_sent(FAR struct tcp_conn_s *conn, uint32_t len)
+{
+  uint32_t now;
+
+  if (conn->pacing_rate == 0)
+    {
+      return;
+    }
+
+  /* An idle connection does not save up credit for a later burst */
+
+  now = tcp_cc_time_us();
+  if ((int32_t)(now - conn->pacing_next) > 0)
+    {
+      conn->pacing_next = now;
+    }
+
+  conn->pacing_next += (uint64_t)len * USEC_PER_SEC / conn->pacing_rate;
+}
+
+/****************************************************************************
+ * Name: tcp_pacing_stop
+ *
+ * Description:
+ *   Cancel the pending pacing wakeup of a connection.
+ *
+ ****************************************************************************/
+
+void tcp_pacing_stop(FAR struct tcp_conn_s *conn)
+{
+  work_cancel(LPWORK, &conn->pacing_work);
+}
@@ -0,0 +1,301 @@
+/****************************************************************************
+ * net/tcp/tcp_rack.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <debug.h>
+#include <inttypes.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+#include <nuttx/clock.h>
+#include <nuttx/wqueue.h>
+#include <nuttx/net/net.h>
+
+#include "netdev/netdev.h"
+#include "tcp/tcp.h"
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Worst case delayed ACK time added to the probe time-out when a single
+ * segment is in flight (RFC 8985, 7.2).
+ */
+
+#define TCP_RACK_WCDELACK    (200 * USEC_PER_MSEC)
+
+/* Probe time-out before the first RTT sample */
+
+#define TCP_RACK_PTO_INIT    USEC_PER_SEC
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: tcp_rack_sent_after
+ *
+ * Description:
+ *   Check if the segment sent at time xmit and ending at seq end was sent
+ *   after the most recently delivered one.
+ *
+ ****************************************************************************/
+
+static bool tcp_rack_sent_after(FAR struct tcp_conn_s *conn,
+                                uint32_t xmit, uint32_t end)
+{
+  int32_t diff = (int32_t)(xmit - conn->rack_xmit);
+
+  return diff > 0 || (diff == 0 && TCP_SEQ_GT(end, conn->rack_end));
+}
+
+/****************************************************************************
+ * Name: tcp_rack_expiry
+ *
+ * Description:
+ *   The RACK timer of a connection expired, poll it.
+ *
+ * Input Parameters:
+ *   arg - The TCP connection
+ *
+ ****************************************************************************/
+
+static void tcp_rack_expiry(FAR void *arg)
+{
+  FAR struct tcp_conn_s *conn = NULL;
+
+  net_lock();
+
+  while ((conn = tcp_nextconn(conn)) != NULL)
+    {
+      if (conn == arg)
+        {
+          conn->flags |= TCP_RACK_EXPIRED;
+          netdev_txnotify_dev(conn->dev);
+          break;
+        }
+    }
+
+  net_unlock();
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: tcp_rack_delivered
+ *
+ * Description:
+ *   Update the RACK state with a write buffer that was delivered, either
+ *   cumulatively or selectively ACKed.
+ *
+ * Input Parameters:
+ *   conn   - The TCP connection of interest
+ *   wrb    - The write buffer delivered
+ *   now    - The current time (usec)
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+void tcp_rack_delivered(FAR struct tcp_conn_s *conn,
+                        FAR struct tcp_wrbuffer_s *wrb, uint32_t now)
+{
+  uint32_t end = TCP_WBSEQNO(wrb) + TCP_WBPKTLEN(wrb);
+  uint32_t rtt = now - TCP_WBXMIT(wrb);
+
+  /* The ACK of a retransmitted segment may be for the original
+   * transmission, it is only trusted if it took more than the minimum
+   * round-trip time since the retransmission.
+   */
+
+  if (TCP_WBNRTX(wrb) > 0 && conn->rack_min_rtt != 0 &&
+      rtt < conn->rack_min_rtt)
+    {
+      return;
+    }
+
+  if (conn->rack_min_rtt == 0 || rtt < conn->rack_min_rtt)
+    {
+      conn->rack_min_rtt = MAX(rtt, 1);
+    }
+
+  if (conn->rack_rtt == 0 ||
+      tcp_rack_sent_after(conn, TCP_WBXMIT(wrb), end))
+    {
+      conn->rack_xmit = TCP_WBXMIT(wrb);
+      conn->rack_end  = end;
+      conn->rack_rtt  = MAX(rtt, 1);
+
+      /* With timestamps the RTT is sampled from the echoed timestamp */
+
+      if ((conn->flags & TCP_TSTAMP) == 0 && TCP_WBNRTX(wrb) == 0)
+        {
+          tcp_rtt_sample(conn, rtt);
+        }
+    }
+}
+
+/****************************************************************************
+ * Name: tcp_rack_lost
+ *
+ * Description:
+ *   Check whether an un-ACKed write buffer is lost: a segment sent after
+ *   it was delivered and the reordering window has passed.
+ *
+ * Input Parameters:
+ *   conn   - The TCP connection of interest
+ *   wrb    - The write buffer to check
+ *   now    - The current time (usec)
+ *   wait   - If the write buffer is not lost yet but may be, lowered to
+ *            the time left until it is (usec)
+ *
+ * Returned Value:
+ *   True if the write buffer should be retransmitted.
+ *
+ ****************************************************************************/
+
+bool tcp_rack_lost(FAR struct tcp_conn_s *conn,
+                   FAR struct tcp_wrbuffer_s *wrb, uint32_t now,
+                   FAR uint32_t *wait)
+{
+  uint32_t end = TCP_WBSEQNO(wrb) + TCP_WBPKTLEN(wrb);
+  uint32_t reo_wnd;
+  int32_t remaining;
+
+  if (TCP_WBSACKED(wrb) || conn->rack_rtt == 0 ||
+      tcp_rack_sent_after(conn, TCP_WBXMIT(wrb), end))
+    {
+      return false;
+    }
+
+  /* Allow a quarter of the minimum RTT for reordering, but no more than
+   * the smoothed RTT (RFC 8985, 6.2).
+   */
+
+  reo_wnd = conn->rack_min_rtt / 4;
+  if (conn->srtt != 0)
+    {
+      reo_wnd = MIN(reo_wnd, conn->srtt);
+    }
+
+  remaining = (int32_t)(TCP_WBXMIT(wrb) + conn->rack_rtt + reo_wnd - now);
+  if (remaining <= 0)
+    {
+      ninfo("RACK: wrb=%p seqno=%" PRIu32 " lost\n", wrb, TCP_WBSEQNO(wrb));
+      return true;
+    }
+
+  *wait = MIN(*wait, (uint32_t)remaining);
+  return false;
+}
+
+/****************************************************************************
+ * Name: tcp_rack_arm
+ *
+ * Description:
+ *   Start the reordering timer or, if tlp is true, the tail loss probe
+ *   timer.  On expiry TCP_RACK_EXPIRED is set and the connection polled.
+ *
+ * Input Parameters:
+ *   conn   - The TCP connection of interest
+ *   delay  - The delay of the timer (usec)
+ *   tlp    - True for the tail loss probe timer
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+void tcp_rack_arm(FAR struct tcp_conn_s *conn, uint32_t delay, bool tlp)
+{
+  if (tlp)
+    {
+      conn->flags |= TCP_TLP_ARMED;
+    }
+  else
+    {
+      conn->flags &= ~TCP_TLP_ARMED;
+    }
+
+  conn->flags &= ~TCP_RACK_EXPIRED;
+
+  work_queue(LPWORK, &conn->rack_work, tcp_rack_expiry, conn,
+             USEC2TICK(delay));
+}
+
+/****************************************************************************
+ * Name: tcp_rack_pto
+ *
+ * Description:
+ *   Return the probe time-out of the connection (usec).
+ *
+ ****************************************************************************/
+
+uint32_t tcp_rack_pto(FAR struct tcp_conn_s *conn)
+{
+  uint32_t pto;
+
+  if (conn->srtt == 0)
+    {
+      return TCP_RACK_PTO_INIT;
+    }
+
+  /* PTO = 2 * SRTT, plus the delayed ACK time if the peer may be waiting
+   * for a second segment before ACKing.  Never later than the RTO.
+   */
+
+  pto = 2 * conn->srtt;
+  if (conn->tx_unacked <= conn->mss)
+    {
+      pto += TCP_RACK_WCDELACK;
+    }
+
+  return MIN(pto, (uint32_t)conn->rto * USEC_PER_HSEC);
+}
+
+/****************************************************************************
+ * Name: tcp_rack_stop
+ *
+ * Description:
+ *   Cancel the RACK timer of a connection.
+ *
+ ****************************************************************************/
+
+void tcp_rack_stop(FAR struct tcp_conn_s *conn)
+{
+  work_cancel(LPWORK, &conn->rack_work);
+  conn->flags &= ~(TCP_RACK_EXPIRED | TCP_TLP_ARMED | TCP_TLP_INFLIGHT);
+}
@@ -780,6 +780,13 @@ ssize_t psock_tcp_recvfrom(FAR struct socket *psock, FAR struct msghdr *msg,
           info.tc_sem  = &state.ir_sem;
           tls_cleanup_push(tls_get_info(), tcp_callback_cleanup, &info);
 
+#ifdef CONFIG_NET_BUSY_POLL
+          /* Receive from the device here for a while before sleeping */
+
+          netdev_busypoll(conn->dev, conn->sconn.s_busypoll,
+                          netdev_busypoll_sem, &state.ir_sem);
+#endif
+
           /* Wait for either the receive to complete or for an error/timeout
            * to occur.  net_sem_timedwait will also terminate if a signal is
            * received.
@@ -224,9 +224,9 @@ uint32_t tcp_get_recvwindow(FAR struct net_driver_s *dev,
 #ifdef CONFIG_NET_TCP_OUT_OF_ORDER
   /* Calculate the minimum desired size */
 
-  if (conn->nofosegs > 0)
+  if (TCP_NOFOSEGS(conn) > 0)
     {
-      uint32_t desire = conn->ofosegs[0].left -
+      uint32_t desire = conn->ofo->ofosegs[0].left -
                         tcp_getsequence(conn->rcvseq);
       int bufsize = tcp_ofoseg_bufsize(conn);
 
@@ -0,0 +1,97 @@
+/****************************************************************************
+ * net/tcp/tcp_rtt.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <debug.h>
+#include <inttypes.h>
+#include <stdint.h>
+
+#include <nuttx/clock.h>
+
+#include "tcp/tcp.h"
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: tcp_rtt_sample
+ *
+ * Description:
+ *   Update the smoothed round-trip time and its variation with a new
+ *   measurement, and derive the retransmission time-out from them
+ *   (RFC 6298).
+ *
+ * Input Parameters:
+ *   conn   - The TCP connection of interest
+ *   rtt    - The round-trip time measured (usec)
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+void tcp_rtt_sample(FAR struct tcp_conn_s *conn, uint32_t rtt)
+{
+  uint32_t delta;
+  uint32_t rto;
+
+  rtt = MAX(rtt, 1);
+
+  if (conn->srtt == 0)
+    {
+      /* First measurement */
+
+      conn->srtt   = rtt;
+      conn->rttvar = rtt / 2;
+    }
+  else
+    {
+      /* RTTVAR <- 3/4 RTTVAR + 1/4 |SRTT - R'|
+       * SRTT   <- 7/8 SRTT + 1/8 R'
+       */
+
+      delta        = conn->srtt > rtt ? conn->srtt - rtt : rtt - conn->srtt;
+      conn->rttvar = conn->rttvar - conn->rttvar / 4 + delta / 4;
+      conn->srtt   = conn->srtt - conn->srtt / 8 + rtt / 8;
+    }
+
+  /* RTO <- SRTT + max(G, 4 * RTTVAR), where G is the resolution of the
+   * measurement.  Rounded up to the resolution of the TCP timer.
+   */
+
+  rto = conn->srtt + MAX(USEC_PER_TICK, 4 * conn->rttvar);
+  rto = (rto + USEC_PER_HSEC - 1) / USEC_PER_HSEC;
+
+  conn->rto = MIN(MAX(rto, TCP_RTO_MIN), TCP_RTO_MAX);
+
+  ninfo("rtt %" PRIu32 " srtt %" PRIu32 " rttvar %" PRIu32 " rto %u\n",
+        rtt, conn->srtt, conn->rttvar, conn->rto);
+}
@@ -104,6 +104,95 @@ static inline FAR struct tcp_hdr_s *tcp_header(FAR struct net_driver_s *dev)
 #endif /* CONFIG_NET_IPv4 */
 }
 
+/****************************************************************************
+ * Name: tcp_reply
+ *
+ * Description:
+ *   Turn the TCP header of the received segment, already carrying the
+ *   flags and sequence numbers of the reply, into a segment back to the
+ *   sender: swap the ports, then build the IP header and the checksum.
+ *
+ * Input Parameters:
+ *   dev  - The device driver structure to use in the send operation
+ *   conn - The TCP connection, NULL if there is none
+ *   tcp  - The TCP header in the device buffer
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   Called with the network locked.
+ *
+ ****************************************************************************/
+
+static void tcp_reply(FAR struct net_driver_s *dev,
+                      FAR struct tcp_conn_s *conn,
+                      FAR struct tcp_hdr_s *tcp)
+{
+  uint16_t tmp16;
+
+  /* Swap port numbers. */
+
+  tmp16         = tcp->srcport;
+  tcp->srcport  = tcp->destport;
+  tcp->destport = tmp16;
+
+  /* Initialize the rest of the tcp header to sane values.
+   */
+
+  tcp->wnd[0] = 0;
+  tcp->wnd[1] = 0;
+  tcp->urgp[0] = 0;
+  tcp->urgp[0] = 0;
+
+  /* Update device buffer length before setup the IP header */
+
+  iob_update_pktlen(dev->d_iob, dev->d_len, false);
+
+  /* Calculate chk & build L3 header */
+
+#ifdef CONFIG_NET_IPv6
+#ifdef CONFIG_NET_IPv4
+  if (IFF_IS_IPv6(dev->d_flags))
+#endif
+    {
+      FAR struct ipv6_hdr_s *ipv6 = IPv6BUF;
+
+      ipv6_build_header(ipv6, dev->d_len - IPv6_HDRLEN,
+                        IP_PROTO_TCP,
+                        netdev_ipv6_srcaddr(dev, ipv6->destipaddr),
+                        ipv6->srcipaddr,
+                        conn ? conn->sconn.s_ttl : IP_TTL_DEFAULT,
+                        conn ? conn->sconn.s_tos : 0);
+      tcp->tcpchksum = 0;
+
+#ifdef CONFIG_NET_TCP_CHECKSUMS
+      tcp->tcpchksum = ~tcp_ipv6_chksum(dev);
+#endif
+    }
+#endif /* CONFIG_NET_IPv6 */
+
+#ifdef CONFIG_NET_IPv4
+#ifdef CONFIG_NET_IPv6
+  else
+#endif
+    {
+      FAR struct ipv4_hdr_s *ipv4 = IPv4BUF;
+
+      ipv4_build_header(IPv4BUF, dev->d_len, IP_PROTO_TCP,
+                        &dev->d_ipaddr, (FAR in_addr_t *)ipv4->srcipaddr,
+                        conn ? conn->sconn.s_ttl : IP_TTL_DEFAULT,
+                        conn ? conn->sconn.s_tos : 0, NULL);
+
+      tcp->tcpchksum = 0;
+
+#ifdef CONFIG_NET_TCP_CHECKSUMS
+      tcp->tcpchksum = ~tcp_ipv4_chksum(dev);
+#endif
+    }
+#endif /* CONFIG_NET_IPv4 */
+}
+
 /****************************************************************************
  * Name: tcp_sendcommon
  *
@@ -224,7 +313,14 @@ static void tcp_sendcommon(FAR struct net_driver_s *dev,
       tcp->tcpchksum = 0;
 
 #ifdef CONFIG_NET_TCP_CHECKSUMS
-      tcp->tcpchksum = ~tcp_ipv4_chksum(dev);
+#  ifdef CONFIG_NETDEV_GSO
+      /* The checksums of a GSO packet are set when it is segmented */
+
+      if (!NETDEV_IS_GSO(dev))
+#  endif
+        {
+          tcp->tcpchksum = ~tcp_ipv4_chksum(dev);
+        }
 #endif
 
 #ifdef CONFIG_NET_STATISTICS
@@ -297,38 +393,60 @@ void tcp_send(FAR struct net_driver_s *dev, FAR struct tcp_conn_s *conn,
   tcp->flags = flags;
   dev->d_len = len;
 
+#ifdef CONFIG_NET_TCP_TIMESTAMPS
+  /* The Timestamps option is included in len by tcpip_hdrsize() */
+
+  if ((conn->flags & TCP_TSTAMP) != 0)
+    {
+      tcp_ts_option(conn, tcp->optdata);
+    }
+#endif
+
 #ifdef CONFIG_NET_TCP_SELECTIVE_ACK
-  if ((conn->flags & TCP_SACK) && (flags == TCP_ACK) && conn->nofosegs > 0)
+  if ((conn->flags & TCP_SACK) && (flags == TCP_ACK) &&
+      TCP_NOFOSEGS(conn) > 0)
     {
-      int optlen = conn->nofosegs * sizeof(struct tcp_sack_s);
+      FAR struct tcp_ofoseg_s *ofosegs = conn->ofo->ofosegs;
+      FAR uint8_t *optdata = tcp->optdata + TCP_OPTLEN(conn);
+      int nsacks = conn->ofo->nofosegs;
+      int optlen;
       int i;
 
-      tcp->optdata[0] = TCP_OPT_NOOP;
-      tcp->optdata[1] = TCP_OPT_NOOP;
-      tcp->optdata[2] = TCP_OPT_SACK;
-      tcp->optdata[3] = TCP_OPT_SACK_PERM_LEN + optlen;
+      /* Only three blocks fit in the option space with the timestamps */
+
+      if (TCP_OPTLEN(conn) > 0 && nsacks > 3)
+        {
+          nsacks = 3;
+        }
+
+      optlen = nsacks * sizeof(struct tcp_sack_s);
+
+      optdata[0] = TCP_OPT_NOOP;
+      optdata[1] = TCP_OPT_NOOP;
+      optdata[2] = TCP_OPT_SACK;
+      optdata[3] = TCP_OPT_SACK_PERM_LEN + optlen;
 
       optlen += 4;
 
-      for (i = 0; i < conn->nofosegs; i++)
+      for (i = 0; i < nsacks; i++)
         {
           ninfo("TCP SACK [%d]"
                 "[%" PRIu32 " : %" PRIu32 " : %" PRIu32 "]\n", i,
-                conn->ofosegs[i].left, conn->ofosegs[i].right,
-                TCP_SEQ_SUB(conn->ofosegs[i].right, conn->ofosegs[i].left));
-          tcp_setsequence(&tcp->optdata[4 + i * 2 * sizeof(uint32_t)],
-                          conn->ofosegs[i].left);
-          tcp_setsequence(&tcp->optdata[4 + (i * 2 + 1) * sizeof(uint32_t)],
-                          conn->ofosegs[i].right);
+                ofosegs[i].left, ofosegs[i].right,
+                TCP_SEQ_SUB(ofosegs[i].right, ofosegs[i].left));
+          tcp_setsequence(&optdata[4 + i * 2 * sizeof(uint32_t)],
+                          ofosegs[i].left);
+          tcp_setsequence(&optdata[4 + (i * 2 + 1) * sizeof(uint32_t)],
+                          ofosegs[i].right);
         }
 
       dev->d_len += optlen;
-      tcp->tcpoffset = ((TCP_HDRLEN + optlen) / 4) << 4;
+      tcp->tcpoffset = ((TCP_HDRLEN + TCP_OPTLEN(conn) + optlen) / 4) << 4;
     }
   else
 #endif /* CONFIG_NET_TCP_SELECTIVE_ACK */
     {
-      tcp->tcpoffset = (TCP_HDRLEN / 4) << 4;
+      tcp->tcpoffset = ((TCP_HDRLEN + TCP_OPTLEN(conn)) / 4) << 4;
     }
 
   tcp_sendcommon(dev, conn, tcp);
@@ -383,7 +501,6 @@ void tcp_reset(FAR struct net_driver_s *dev, FAR struct tcp_conn_s *conn)
 {
   FAR struct tcp_hdr_s *tcp;
   uint32_t ackno;
-  uint16_t tmp16;
   uint16_t acklen = 0;
   uint8_t seqbyte;
 
@@ -467,44 +584,51 @@ void tcp_reset(FAR struct net_driver_s *dev, FAR struct tcp_conn_s *conn)
 
   tcp_setsequence(tcp->ackno, ackno);
 
-  /* Swap port numbers. */
-
-  tmp16         = tcp->srcport;
-  tcp->srcport  = tcp->destport;
-  tcp->destport = tmp16;
+  tcp_reply(dev, conn, tcp);
+}
 
-  /* Initialize the rest of the tcp header to sane values.
-   */
+/****************************************************************************
+ * Name: tcp_ack
+ *
+ * Description:
+ *   Reply to the received segment with a bare ACK carrying the given
+ *   sequence numbers, for a peer that no longer has a connection (the
+ *   TIME_WAIT records).
+ *
+ * Input Parameters:
+ *   dev    - The device driver structure to use in the send operation
+ *   seqno  - The sequence number of the ACK
+ *   ackno  - The acknowledgement number of the ACK
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   Called with the network locked.
+ *
+ ****************************************************************************/
 
-  tcp->wnd[0] = 0;
-  tcp->wnd[1] = 0;
-  tcp->urgp[0] = 0;
-  tcp->urgp[0] = 0;
+void tcp_ack(FAR struct net_driver_s *dev, uint32_t seqno, uint32_t ackno)
+{
+  FAR struct tcp_hdr_s *tcp;
 
-  /* Update device buffer length before setup the IP header */
+  if (dev->d_iob == NULL)
+    {
+      return;
+    }
 
-  iob_update_pktlen(dev->d_iob, dev->d_len, false);
+#ifdef CONFIG_NET_STATISTICS
+  g_netstats.tcp.sent++;
+#endif
 
-  /* Calculate chk & build L3 header */
+  tcp = tcp_header(dev);
 
 #ifdef CONFIG_NET_IPv6
 #ifdef CONFIG_NET_IPv4
   if (IFF_IS_IPv6(dev->d_flags))
 #endif
     {
-      FAR struct ipv6_hdr_s *ipv6 = IPv6BUF;
-
-      ipv6_build_header(ipv6, dev->d_len - IPv6_HDRLEN,
-                        IP_PROTO_TCP,
-                        netdev_ipv6_srcaddr(dev, ipv6->destipaddr),
-                        ipv6->srcipaddr,
-                        conn ? conn->sconn.s_ttl : IP_TTL_DEFAULT,
-                        conn ? conn->sconn.s_tos : 0);
-      tcp->tcpchksum = 0;
-
-#ifdef CONFIG_NET_TCP_CHECKSUMS
-      tcp->tcpchksum = ~tcp_ipv6_chksum(dev);
-#endif
+      dev->d_len = IPv6TCP_HDRLEN;
     }
 #endif /* CONFIG_NET_IPv6 */
 
@@ -513,20 +637,17 @@ void tcp_reset(FAR struct net_driver_s *dev, FAR struct tcp_conn_s *conn)
   else
 #endif
     {
-      FAR struct ipv4_hdr_s *ipv4 = IPv4BUF;
+      dev->d_len = IPv4TCP_HDRLEN;
+    }
+#endif /* CONFIG_NET_IPv4 */
 
-      ipv4_build_header(IPv4BUF, dev->d_len, IP_PROTO_TCP,
-                        &dev->d_ipaddr, (FAR in_addr_t *)ipv4->srcipaddr,
-                        conn ? conn->sconn.s_ttl : IP_TTL_DEFAULT,
-                        conn ? conn->sconn.s_tos : 0, NULL);
+  tcp->flags     = TCP_ACK;
+  tcp->tcpoffset = 5 << 4;
 
-      tcp->tcpchksum = 0;
+  tcp_setsequence(tcp->seqno, seqno);
+  tcp_setsequence(tcp->ackno, ackno);
 
-#ifdef CONFIG_NET_TCP_CHECKSUMS
-      tcp->tcpchksum = ~tcp_ipv4_chksum(dev);
-#endif
-    }
-#endif /* CONFIG_NET_IPv4 */
+  tcp_reply(dev, NULL, tcp);
 }
 
 /****************************************************************************
@@ -607,9 +728,11 @@ void tcp_synack(FAR struct net_driver_s *dev, FAR struct tcp_conn_s *conn,
 
   tcp = tcp_header(dev);
 
-  /* Set the packet length for the TCP Maximum Segment Size */
+  /* Set the packet length for the TCP Maximum Segment Size.  The options
+   * are all added below.
+   */
 
-  dev->d_len = tcpip_hdrsize(conn);
+  dev->d_len = tcpip_hdrsize(conn) - TCP_OPTLEN(conn);
 
   /* Set the packet length for the TCP Maximum Segment Size */
 
@@ -662,6 +785,15 @@ void tcp_synack(FAR struct net_driver_s *dev, FAR struct tcp_conn_s *conn,
     }
 #endif
 
+#ifdef CONFIG_NET_TCP_TIMESTAMPS
+  /* Offer the timestamps in the SYN, then send them if they were agreed */
+
+  if (tcp->flags == TCP_SYN || (conn->flags & TCP_TSTAMP) != 0)
+    {
+      optlen += tcp_ts_option(conn, &tcp->optdata[optlen]);
+    }
+#endif
+
   tcp->tcpoffset         = ((TCP_HDRLEN + optlen) / 4) << 4;
   dev->d_len            += optlen;
 
@@ -733,7 +865,7 @@ void tcp_send_txnotify(FAR struct socket *psock,
 
 uint16_t tcpip_hdrsize(FAR struct tcp_conn_s *conn)
 {
-  uint16_t hdrsize = sizeof(struct tcp_hdr_s);
+  uint16_t hdrsize = sizeof(struct tcp_hdr_s) + TCP_OPTLEN(conn);
 
   UNUSED(conn);
   return net_ip_domain_select(conn->domain,
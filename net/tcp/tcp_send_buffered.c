@@ -412,6 +412,185 @@ static int parse_sack(FAR struct tcp_conn_s *conn, FAR struct tcp_hdr_s *tcp,
 }
 #endif /* CONFIG_NET_TCP_SELECTIVE_ACK */
 
+/****************************************************************************
+ * Name: psock_rack_detect
+ *
+ * Description:
+ *   RACK loss detection (RFC 8985): mark the write buffers covered by the
+ *   SACK blocks of an incoming ACK as delivered, then retransmit those
+ *   sent before a delivered one whose reordering window has passed.
+ *   Restart the reordering timer or the loss probe timer as needed.
+ *
+ * Input Parameters:
+ *   conn   - The TCP connection of interest
+ *   tcp    - Header of the incoming ACK, NULL on timer expiry
+ *   now    - The current time (usec)
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_TCP_RACK
+static void psock_rack_detect(FAR struct tcp_conn_s *conn,
+                              FAR struct tcp_hdr_s *tcp, uint32_t now)
+{
+  struct tcp_ofoseg_s segs[TCP_SACK_RANGES_MAX];
+  FAR struct tcp_wrbuffer_s *wrb;
+  FAR sq_entry_t *entry;
+  FAR sq_entry_t *next;
+  uint32_t wait = UINT32_MAX;
+  bool lost = false;
+  int nsacks = 0;
+  int i;
+
+  if (tcp != NULL && (conn->flags & TCP_SACK) != 0 &&
+      (tcp->tcpoffset & 0xf0) > 0x50)
+    {
+      nsacks = parse_sack(conn, tcp, segs);
+    }
+
+  for (entry = sq_peek(&conn->unacked_q); entry != NULL && nsacks > 0;
+       entry = sq_next(entry))
+    {
+      wrb = (FAR struct tcp_wrbuffer_s *)entry;
+      if (TCP_WBSACKED(wrb))
+        {
+          continue;
+        }
+
+      for (i = 0; i < nsacks; i++)
+        {
+          if (TCP_SEQ_GTE(TCP_WBSEQNO(wrb), segs[i].left) &&
+              TCP_SEQ_LTE(TCP_WBSEQNO(wrb) + TCP_WBPKTLEN(wrb),
+                          segs[i].right))
+            {
+              TCP_WBSACKED(wrb) = true;
+              tcp_rack_delivered(conn, wrb, now);
+              break;
+            }
+        }
+    }
+
+  for (entry = sq_peek(&conn->unacked_q); entry != NULL; entry = next)
+    {
+      next = sq_next(entry);
+      wrb  = (FAR struct tcp_wrbuffer_s *)entry;
+
+      if (tcp_rack_lost(conn, wrb, now, &wait))
+        {
+          sq_rem(entry, &conn->unacked_q);
+          retransmit_segment(conn, wrb);
+          lost = true;
+        }
+    }
+
+  /* Reduce the window once per loss episode, as for a fast retransmit */
+
+  if (lost && (conn->flags & TCP_INFR) == 0)
+    {
+      conn->fr_recover = conn->sndseq_max;
+      conn->flags     |= TCP_INFT;
+      tcp_cc_update(conn, NULL);
+    }
+
+  if (wait != UINT32_MAX)
+    {
+      tcp_rack_arm(conn, wait, false);
+    }
+  else if (sq_empty(&conn->unacked_q))
+    {
+      tcp_rack_stop(conn);
+    }
+  else if ((conn->flags & (TCP_INFR | TCP_TLP_INFLIGHT)) == 0)
+    {
+      tcp_rack_arm(conn, tcp_rack_pto(conn), true);
+    }
+}
+
+/****************************************************************************
+ * Name: psock_tail_loss_probe
+ *
+ * Description:
+ *   The probe time-out expired without an ACK: send new data if the
+ *   window allows it, otherwise retransmit the last segment, so that the
+ *   ACK of the probe reveals the losses at the tail of the flight.
+ *
+ * Input Parameters:
+ *   conn   - The TCP connection of interest
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+static void psock_tail_loss_probe(FAR struct tcp_conn_s *conn)
+{
+  FAR sq_entry_t *entry;
+
+  conn->flags &= ~TCP_TLP_ARMED;
+
+  if ((conn->flags & (TCP_INFR | TCP_TLP_INFLIGHT)) != 0 ||
+      sq_empty(&conn->unacked_q))
+    {
+      return;
+    }
+
+  if (sq_empty(&conn->write_q) ||
+      conn->tx_unacked >= MIN(conn->snd_wnd, conn->cwnd))
+    {
+      entry = sq_remlast(&conn->unacked_q);
+      ninfo("TLP: Probe with wrb=%p\n", entry);
+      retransmit_segment(conn, (FAR void *)entry);
+    }
+
+  /* The probe itself is sent by the poll that follows */
+
+  conn->tlp_end = conn->sndseq_max;
+  conn->flags  |= TCP_TLP_INFLIGHT;
+}
+#endif /* CONFIG_NET_TCP_RACK */
+
+/****************************************************************************
+ * Name: tcp_send_maxlen
+ *
+ * Description:
+ *   Get the most data that may go out in one packet: the MSS or, if the
+ *   device takes GSO packets, a multiple of it that fits in d_gsomax.
+ *
+ * Assumptions:
+ *   The network is locked
+ *
+ ****************************************************************************/
+
+static uint32_t tcp_send_maxlen(FAR struct net_driver_s *dev,
+                                FAR struct tcp_conn_s *conn)
+{
+#ifdef CONFIG_NETDEV_GSO
+  uint32_t hdrlen = NET_LL_HDRLEN(dev) + tcpip_hdrsize(conn);
+  uint32_t maxlen;
+
+#ifdef NEED_IPDOMAIN_SUPPORT
+  if (conn->domain == PF_INET)
+#endif
+    {
+      if (dev->d_gsomax >= hdrlen + 2 * conn->mss)
+        {
+          maxlen = dev->d_gsomax - hdrlen;
+          return maxlen - maxlen % conn->mss;
+        }
+    }
+#endif
+
+  return conn->mss;
+}
+
 /****************************************************************************
  * Name: psock_send_eventhandler
  *
@@ -482,6 +661,9 @@ static uint16_t psock_send_eventhandler(FAR struct net_driver_s *dev,
       FAR sq_entry_t *entry;
       FAR sq_entry_t *next;
       uint32_t ackno;
+#ifdef CONFIG_NET_TCP_RACK
+      uint32_t now = tcp_cc_time_us();
+#endif
 
       /* Get the offset address of the TCP header */
 
@@ -543,6 +725,13 @@ static uint16_t psock_send_eventhandler(FAR struct net_driver_s *dev,
                 {
                   ninfo("ACK: wrb=%p Freeing write buffer\n", wrb);
 
+#ifdef CONFIG_NET_TCP_RACK
+                  if (!TCP_WBSACKED(wrb))
+                    {
+                      tcp_rack_delivered(conn, wrb, now);
+                    }
+#endif
+
                   /* Yes... Remove the write buffer from ACK waiting queue */
 
                   sq_rem(entry, &conn->unacked_q);
@@ -673,6 +862,18 @@ static uint16_t psock_send_eventhandler(FAR struct net_driver_s *dev,
           ninfo("ACK: wrb=%p seqno=%" PRIu32 " pktlen=%u sent=%u\n",
                 wrb, TCP_WBSEQNO(wrb), TCP_WBPKTLEN(wrb), TCP_WBSENT(wrb));
         }
+
+#ifdef CONFIG_NET_TCP_RACK
+      /* The loss probe is over once all that was sent before it is ACKed */
+
+      if ((conn->flags & TCP_TLP_INFLIGHT) != 0 &&
+          TCP_SEQ_GTE(ackno, conn->tlp_end))
+        {
+          conn->flags &= ~TCP_TLP_INFLIGHT;
+        }
+
+      psock_rack_detect(conn, tcp, now);
+#endif
     }
 
   /* Check for a loss of connection */
@@ -699,6 +900,24 @@ static uint16_t psock_send_eventhandler(FAR struct net_driver_s *dev,
       return flags;
     }
 
+#ifdef CONFIG_NET_TCP_RACK
+  /* Handle the expiry of the reordering timer or of the loss probe timer */
+
+  if ((conn->flags & TCP_RACK_EXPIRED) != 0)
+    {
+      conn->flags &= ~TCP_RACK_EXPIRED;
+
+      if ((conn->flags & TCP_TLP_ARMED) != 0)
+        {
+          psock_tail_loss_probe(conn);
+        }
+      else
+        {
+          psock_rack_detect(conn, NULL, tcp_cc_time_us());
+        }
+    }
+#endif
+
 #ifdef CONFIG_NET_TCP_FAST_RETRANSMIT
   if (rexmitno != 0)
     {
@@ -770,6 +989,10 @@ static uint16_t psock_send_eventhandler(FAR struct net_driver_s *dev,
               return flags;
             }
 
+#ifdef CONFIG_NET_TCP_RACK
+          TCP_WBXMIT(wrb) = tcp_cc_time_us();
+#endif
+
 #ifdef CONFIG_NET_TCP_CC_NEWRENO
           /* After Fast retransmitted, set ssthresh to the maximum of
            * the unacked and the 2*SMSS, and enter to Fast Recovery.
@@ -867,6 +1090,12 @@ static uint16_t psock_send_eventhandler(FAR struct net_driver_s *dev,
 
       ninfo("REXMIT: %04x\n", flags);
 
+#ifdef CONFIG_NET_TCP_RACK
+      /* Everything is sent again, no probe is needed */
+
+      tcp_rack_stop(conn);
+#endif
+
       /* If there is a partially sent write buffer at the head of the
        * write_q?  Has anything been sent from that write buffer?
        */
@@ -1032,10 +1261,19 @@ static uint16_t psock_send_eventhandler(FAR struct net_driver_s *dev,
           uint32_t remaining_snd_wnd;
           int ret;
 
+#ifdef CONFIG_NET_TCP_PACING
+          /* Hold the data until the pacing rate allows to send it */
+
+          if (!tcp_pacing_check(conn))
+            {
+              return flags;
+            }
+
+#endif
           sndlen = TCP_WBPKTLEN(wrb) - TCP_WBSENT(wrb);
-          if (sndlen > conn->mss)
+          if (sndlen > tcp_send_maxlen(dev, conn))
             {
-              sndlen = conn->mss;
+              sndlen = tcp_send_maxlen(dev, conn);
             }
 
           remaining_snd_wnd = TCP_SEQ_SUB(snd_wnd_edge, seq);
@@ -1099,10 +1337,21 @@ static uint16_t psock_send_eventhandler(FAR struct net_driver_s *dev,
             }
 #endif
 
+#ifdef CONFIG_NETDEV_GSO
+          /* Let the driver cut what exceeds the MSS into segments.  This
+           * also lets devif_iob_send() accept more than the MTU.
+           */
+
+          dev->d_gsosize = sndlen > conn->mss ? conn->mss : 0;
+#endif
+
           ret = devif_iob_send(dev, TCP_WBIOB(wrb), sndlen,
                                TCP_WBSENT(wrb), tcpip_hdrsize(conn));
           if (ret <= 0)
             {
+#ifdef CONFIG_NETDEV_GSO
+              dev->d_gsosize = 0;
+#endif
               return flags;
             }
 
@@ -1115,6 +1364,22 @@ static uint16_t psock_send_eventhandler(FAR struct net_driver_s *dev,
           conn->tx_unacked += sndlen;
           conn->sent       += sndlen;
 
+#ifdef CONFIG_NET_TCP_PACING
+          tcp_pacing_sent(conn, sndlen);
+#endif
+
+#ifdef CONFIG_NET_TCP_RACK
+          TCP_WBXMIT(wrb)   = tcp_cc_time_us();
+          TCP_WBSACKED(wrb) = false;
+
+          /* Arm the loss probe for the flight, unless a timer is running */
+
+          if (work_available(&conn->rack_work))
+            {
+              tcp_rack_arm(conn, tcp_rack_pto(conn), true);
+            }
+#endif
+
           /* Below prediction will become true,
            * unless retransmission occurrence
            */
@@ -1194,6 +1459,15 @@ static uint32_t tcp_max_wrb_size(FAR struct tcp_conn_s *conn)
 
   size = 4 * mss;
 
+#ifdef CONFIG_NETDEV_GSO
+  /* and enough to fill a GSO packet */
+
+  if (size < CONFIG_NETDEV_GSO_MAXSIZE)
+    {
+      size = CONFIG_NETDEV_GSO_MAXSIZE;
+    }
+#endif
+
   /* but it should not hog too many IOB buffers */
 
   if (size > CONFIG_IOB_NBUFFERS * CONFIG_IOB_BUFSIZE / 2)
@@ -1308,6 +1582,9 @@ ssize_t psock_tcp_send(FAR struct socket *psock, FAR const void *buf,
   FAR struct tcp_conn_s *conn;
   FAR struct tcp_wrbuffer_s *wrb;
   FAR const uint8_t *cp;
+#ifdef CONFIG_NET_ZEROCOPY
+  FAR struct zerocopy_s *zc = NULL;
+#endif
   unsigned int timeout;
   ssize_t    result = 0;
   bool       nonblock;
@@ -1362,6 +1639,16 @@ ssize_t psock_tcp_send(FAR struct socket *psock, FAR const void *buf,
     }
 #endif /* CONFIG_NET_ARP_SEND || CONFIG_NET_ICMPv6_NEIGHBOR */
 
+#ifdef CONFIG_NET_ZEROCOPY
+  /* Queue the user buffer in place for MSG_ZEROCOPY */
+
+  ret = zerocopy_begin(&conn->sconn, buf, len, flags, &zc);
+  if (ret < 0)
+    {
+      goto errout;
+    }
+#endif
+
   nonblock = _SS_ISNONBLOCK(conn->sconn.s_flags) ||
                             (flags & MSG_DONTWAIT) != 0;
   start    = clock_systime_ticks();
@@ -1539,7 +1826,15 @@ ssize_t psock_tcp_send(FAR struct socket *psock, FAR const void *buf,
            * remaining data.
            */
 
-          chunk_result = TCP_WBTRYCOPYIN(wrb, cp, chunk_len, off);
+#ifdef CONFIG_NET_ZEROCOPY
+          chunk_result = zerocopy_iob_append(zc, &TCP_WBIOB(wrb), cp,
+                                             chunk_len);
+          if (chunk_result < 0)
+#endif
+            {
+              chunk_result = TCP_WBTRYCOPYIN(wrb, cp, chunk_len, off);
+            }
+
           if (chunk_result == -ENOMEM)
             {
               if (TCP_WBPKTLEN(wrb) > 0)
@@ -1666,12 +1961,19 @@ ssize_t psock_tcp_send(FAR struct socket *psock, FAR const void *buf,
 
   /* Return the number of bytes actually sent */
 
+#ifdef CONFIG_NET_ZEROCOPY
+  zerocopy_end(zc, result);
+#endif
   return result;
 
 errout_with_lock:
   net_unlock();
 
 errout:
+#ifdef CONFIG_NET_ZEROCOPY
+  zerocopy_end(zc, result);
+#endif
+
   if (result > 0)
     {
       return result;
@@ -31,9 +31,11 @@
 #include <errno.h>
 #include <assert.h>
 #include <debug.h>
+#include <string.h>
 
 #include <netinet/tcp.h>
 
+#include <nuttx/kmalloc.h>
 #include <nuttx/net/net.h>
 #include <nuttx/net/tcp.h>
 
@@ -43,6 +45,52 @@
 
 #ifdef CONFIG_NET_TCPPROTO_OPTIONS
 
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: tcp_keepalive_alloc
+ *
+ * Description:
+ *   Return the keep-alive state of the connection, allocating it with the
+ *   default values the first time a keep-alive option is set.
+ *
+ * Returned Value:
+ *   The keep-alive state, NULL if it could not be allocated.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_TCP_KEEPALIVE
+static FAR struct tcp_keepalive_s *
+tcp_keepalive_alloc(FAR struct tcp_conn_s *conn)
+{
+  FAR struct tcp_keepalive_s *ka = conn->ka;
+
+  if (ka == NULL)
+    {
+      ka = kmm_zalloc(sizeof(struct tcp_keepalive_s));
+      if (ka == NULL)
+        {
+          nerr("ERROR: Failed to allocate the keep-alive state\n");
+          return NULL;
+        }
+
+      ka->keepidle  = TCP_KEEPIDLE_DEFAULT;
+      ka->keepintvl = TCP_KEEPINTVL_DEFAULT;
+      ka->keepcnt   = TCP_KEEPCNT_DEFAULT;
+
+      /* The timer looks at it with the network locked */
+
+      net_lock();
+      conn->ka = ka;
+      net_unlock();
+    }
+
+  return ka;
+}
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -120,14 +168,21 @@ int tcp_setsockopt(FAR struct socket *psock, int option,
                      keepalive);
                 return -EDOM;
               }
-            else
+            else if (keepalive != 0 || conn->ka != NULL)
               {
-                conn->keepalive = keepalive;
+                FAR struct tcp_keepalive_s *ka = tcp_keepalive_alloc(conn);
+
+                if (ka == NULL)
+                  {
+                    return -ENOMEM;
+                  }
+
+                ka->enabled = keepalive;
 
                 /* Reset timer */
 
-                tcp_update_keeptimer(conn, keepalive ? conn->keepidle : 0);
-                conn->keepretries = 0;
+                tcp_update_keeptimer(conn, keepalive ? ka->keepidle : 0);
+                ka->keepretries = 0;
               }
           }
         break;
@@ -135,6 +190,7 @@ int tcp_setsockopt(FAR struct socket *psock, int option,
       case TCP_KEEPIDLE:  /* Start keepalives after this IDLE period */
       case TCP_KEEPINTVL: /* Interval between keepalives */
         {
+          FAR struct tcp_keepalive_s *ka;
           unsigned int dsecs;
 
           if (value == NULL)
@@ -166,21 +222,27 @@ int tcp_setsockopt(FAR struct socket *psock, int option,
                return -EDOM;
              }
 
+          ka = tcp_keepalive_alloc(conn);
+          if (ka == NULL)
+            {
+              return -ENOMEM;
+            }
+
           if (option == TCP_KEEPIDLE)
             {
-              conn->keepidle = dsecs;
+              ka->keepidle = dsecs;
             }
           else
             {
-              conn->keepintvl = dsecs;
+              ka->keepintvl = dsecs;
             }
 
            /* Reset timer */
 
-          if (conn->keepalive)
+          if (ka->enabled)
             {
-              tcp_update_keeptimer(conn, conn->keepidle);
-              conn->keepretries = 0;
+              tcp_update_keeptimer(conn, ka->keepidle);
+              ka->keepretries = 0;
             }
         }
         break;
@@ -192,6 +254,7 @@ int tcp_setsockopt(FAR struct socket *psock, int option,
           }
         else
           {
+            FAR struct tcp_keepalive_s *ka;
             int keepcnt = *(FAR int *)value;
 
             if (keepcnt < 0 || keepcnt > UINT8_MAX)
@@ -199,16 +262,22 @@ int tcp_setsockopt(FAR struct socket *psock, int option,
                 nerr("ERROR: TCP_KEEPCNT value out of range: %d\n", keepcnt);
                 return -EDOM;
               }
+
+            ka = tcp_keepalive_alloc(conn);
+            if (ka == NULL)
+              {
+                return -ENOMEM;
+              }
             else
               {
-                conn->keepcnt = keepcnt;
+                ka->keepcnt = keepcnt;
 
                 /* Reset time */
 
-                if (conn->keepalive)
+                if (ka->enabled)
                   {
-                    tcp_update_keeptimer(conn, conn->keepidle);
-                    conn->keepretries = 0;
+                    tcp_update_keeptimer(conn, ka->keepidle);
+                    ka->keepretries = 0;
                   }
               }
           }
@@ -260,6 +329,29 @@ int tcp_setsockopt(FAR struct socket *psock, int option,
           }
         break;
 
+#ifdef CONFIG_NET_TCP_CC_NEWRENO
+      case TCP_CONGESTION: /* Congestion control algorithm */
+        {
+          char name[TCP_CA_NAME_MAX];
+          size_t len;
+
+          if (value == NULL || value_len == 0)
+            {
+              return -EINVAL;
+            }
+
+          /* The user buffer need not be NUL terminated */
+
+          len = MIN(value_len, sizeof(name) - 1);
+          memcpy(name, value, len);
+          name[len] = '\0';
+          net_lock();
+          ret = tcp_cc_select(conn, name);
+          net_unlock();
+        }
+        break;
+#endif
+
       default:
         nerr("ERROR: Unrecognized TCP option: %d\n", option);
         ret = -ENOPROTOOPT;
@@ -105,17 +105,19 @@ static int tcp_get_timeout(FAR struct tcp_conn_s *conn)
   int timeout = conn->timer;
 
 #ifdef CONFIG_NET_TCP_KEEPALIVE
+  uint32_t keeptimer = conn->ka != NULL ? conn->ka->keeptimer : 0;
+
   if (timeout == 0)
     {
-      /* The conn->keeptimer units is decisecond and the timeout
+      /* The keeptimer units is decisecond and the timeout
        * units is half-seconds, therefore they need to be unified.
        */
 
-      timeout = conn->keeptimer / DSEC_PER_HSEC;
+      timeout = keeptimer / DSEC_PER_HSEC;
     }
-  else if (conn->keeptimer > 0 && timeout > conn->keeptimer / DSEC_PER_HSEC)
+  else if (keeptimer > 0 && timeout > keeptimer / DSEC_PER_HSEC)
     {
-      timeout = conn->keeptimer / DSEC_PER_HSEC;
+      timeout = keeptimer / DSEC_PER_HSEC;
     }
 #endif
 
@@ -313,7 +315,9 @@ void tcp_update_retrantimer(FAR struct tcp_conn_s *conn, int timeout)
 #ifdef CONFIG_NET_TCP_KEEPALIVE
 void tcp_update_keeptimer(FAR struct tcp_conn_s *conn, int timeout)
 {
-  conn->keeptimer = timeout;
+  DEBUGASSERT(conn->ka != NULL);
+
+  conn->ka->keeptimer = timeout;
   tcp_update_timer(conn);
 }
 #endif
@@ -536,9 +540,10 @@ void tcp_timer(FAR struct net_driver_s *dev, FAR struct tcp_conn_s *conn)
 
 #if defined(CONFIG_NET_IPv4) && defined(CONFIG_NET_IPv6)
                   listener = tcp_findlistener(&conn->u, conn->lport,
-                                              conn->domain);
+                                              conn->rport, conn->domain);
 #else
-                  listener = tcp_findlistener(&conn->u, conn->lport);
+                  listener = tcp_findlistener(&conn->u, conn->lport,
+                                              conn->rport);
 #endif
                   if (listener != NULL)
                     {
@@ -652,22 +657,9 @@ void tcp_timer(FAR struct net_driver_s *dev, FAR struct tcp_conn_s *conn)
                     tcp_rexmit(dev, conn, result);
 
 #ifdef CONFIG_NET_TCP_CC_NEWRENO
-                    /* If conn is TCP_INFR, it should enter to slow start */
-
-                    if (conn->flags & TCP_INFR)
-                      {
-                        conn->flags &= ~TCP_INFR;
-                      }
-
-                    /* update the max_cwnd */
-
-                    conn->max_cwnd = (conn->max_cwnd + 7 * conn->cwnd) >> 3;
-
-                    /* reset cwnd and ssthresh, refers to RFC5861. */
+                    /* Let the congestion control restart from slow start */
 
-                    conn->ssthresh =
-                                    MAX(conn->tx_unacked / 2, 2 * conn->mss);
-                    conn->cwnd = conn->mss;
+                    tcp_cc_timeout(conn);
 #endif
                     goto done;
 
@@ -697,23 +689,23 @@ void tcp_timer(FAR struct net_driver_s *dev, FAR struct tcp_conn_s *conn)
 #ifdef CONFIG_NET_TCP_KEEPALIVE
           /* Is this an established connected with KeepAlive enabled? */
 
-          if (conn->keepalive)
+          if (TCP_KEEPALIVE(conn))
             {
               /* Yes... has the idle period elapsed with no data or ACK
                * received from the remote peer?
                */
 
-              if (conn->keeptimer > hsec * DSEC_PER_HSEC)
+              if (conn->ka->keeptimer > hsec * DSEC_PER_HSEC)
                 {
                   /* Will not yet decrement to zero */
 
-                  conn->keeptimer -= hsec * DSEC_PER_HSEC;
+                  conn->ka->keeptimer -= hsec * DSEC_PER_HSEC;
                 }
               else
                 {
                   /* Yes.. Has the retry count expired? */
 
-                  if (conn->keepretries >= conn->keepcnt)
+                  if (conn->ka->keepretries >= conn->ka->keepcnt)
                     {
                       /* Yes... stop the network monitor, closing the
                        * connection and all sockets associated with the
@@ -733,8 +725,8 @@ void tcp_timer(FAR struct net_driver_s *dev, FAR struct tcp_conn_s *conn)
 #endif
                       /* Update for the next probe */
 
-                      conn->keeptimer = conn->keepintvl;
-                      conn->keepretries++;
+                      conn->ka->keeptimer = conn->ka->keepintvl;
+                      conn->ka->keepretries++;
                     }
 
                   goto done;
@@ -0,0 +1,206 @@
+/****************************************************************************
+ * net/tcp/tcp_timestamp.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <debug.h>
+#include <inttypes.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <time.h>
+
+#include <nuttx/clock.h>
+#include <nuttx/net/tcp.h>
+
+#include "tcp/tcp.h"
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: tcp_ts_find
+ *
+ * Description:
+ *   Find the Timestamps option in the options of a TCP header.
+ *
+ ****************************************************************************/
+
+static FAR uint8_t *tcp_ts_find(FAR struct tcp_hdr_s *tcp)
+{
+  int optlen = ((tcp->tcpoffset >> 4) - 5) << 2;
+  int i;
+
+  for (i = 0; i < optlen; )
+    {
+      uint8_t opt = tcp->optdata[i];
+
+      if (opt == TCP_OPT_END)
+        {
+          break;
+        }
+      else if (opt == TCP_OPT_NOOP)
+        {
+          i++;
+          continue;
+        }
+      else if (i + 1 >= optlen || tcp->optdata[i + 1] < 2)
+        {
+          /* Malformed options */
+
+          break;
+        }
+      else if (opt == TCP_OPT_TS && tcp->optdata[i + 1] == TCP_OPT_TS_LEN &&
+               i + TCP_OPT_TS_LEN <= optlen)
+        {
+          return &tcp->optdata[i];
+        }
+
+      i += tcp->optdata[i + 1];
+    }
+
+  return NULL;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: tcp_ts_now
+ *
+ * Description:
+ *   Return the current value of the timestamp clock (msec).
+ *
+ ****************************************************************************/
+
+uint32_t tcp_ts_now(void)
+{
+  struct timespec ts;
+
+  clock_systime_timespec(&ts);
+  return (uint32_t)ts.tv_sec * MSEC_PER_SEC + ts.tv_nsec / NSEC_PER_MSEC;
+}
+
+/****************************************************************************
+ * Name: tcp_ts_option
+ *
+ * Description:
+ *   Write the Timestamps option, padded to TCP_OPT_TS_SPACE bytes, for a
+ *   segment sent on a connection.
+ *
+ * Input Parameters:
+ *   conn   - The TCP connection of interest
+ *   opt    - Where to write the option
+ *
+ * Returned Value:
+ *   The number of bytes written.
+ *
+ ****************************************************************************/
+
+int tcp_ts_option(FAR struct tcp_conn_s *conn, FAR uint8_t *opt)
+{
+  opt[0] = TCP_OPT_NOOP;
+  opt[1] = TCP_OPT_NOOP;
+  opt[2] = TCP_OPT_TS;
+  opt[3] = TCP_OPT_TS_LEN;
+
+  /* TSval, and TSecr that is only valid if TCP_TSTAMP was negotiated */
+
+  tcp_setsequence(&opt[4], tcp_ts_now());
+  tcp_setsequence(&opt[8], (conn->flags & TCP_TSTAMP) != 0 ?
+                           conn->ts_recent : 0);
+
+  return TCP_OPT_TS_SPACE;
+}
+
+/****************************************************************************
+ * Name: tcp_ts_input
+ *
+ * Description:
+ *   Process the Timestamps option of an incoming segment: reject old
+ *   duplicates (PAWS) and remember the timestamp to echo.
+ *
+ * Input Parameters:
+ *   conn   - The TCP connection of interest
+ *   tcp    - The TCP header of the incoming segment
+ *   tsecr  - Returns the echoed timestamp, 0 if there is none
+ *
+ * Returned Value:
+ *   False if the segment must be dropped.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+bool tcp_ts_input(FAR struct tcp_conn_s *conn, FAR struct tcp_hdr_s *tcp,
+                  FAR uint32_t *tsecr)
+{
+  FAR uint8_t *opt;
+  uint32_t tsval;
+
+  *tsecr = 0;
+
+  /* A segment without the option is accepted, as most stacks do */
+
+  opt = tcp_ts_find(tcp);
+  if (opt == NULL)
+    {
+      return true;
+    }
+
+  tsval = tcp_getsequence(&opt[2]);
+
+  /* PAWS (RFC 7323, 5.3): a segment with a timestamp older than the last
+   * one received is an old duplicate.  Resets are not checked, they are
+   * validated by their sequence number.
+   */
+
+  if ((tcp->flags & TCP_RST) == 0 && TCP_SEQ_LT(tsval, conn->ts_recent))
+    {
+      ninfo("PAWS: tsval %" PRIu32 " < ts_recent %" PRIu32 "\n",
+            tsval, conn->ts_recent);
+      return false;
+    }
+
+  /* Echo the timestamp of the segment that the next ACK acknowledges, the
+   * oldest not yet ACKed one if ACKs are delayed.
+   */
+
+  if (TCP_SEQ_LTE(tcp_getsequence(tcp->seqno),
+                  tcp_getsequence(conn->rcvseq)))
+    {
+      conn->ts_recent = tsval;
+    }
+
+  if ((tcp->flags & TCP_ACK) != 0)
+    {
+      *tsecr = tcp_getsequence(&opt[6]);
+    }
+
+  return true;
+}
@@ -0,0 +1,436 @@
+/****************************************************************************
+ * net/tcp/tcp_timewait.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <debug.h>
+
+#include <nuttx/clock.h>
+#include <nuttx/nuttx.h>
+#include <nuttx/queue.h>
+#include <nuttx/net/netconfig.h>
+#include <nuttx/net/netdev.h>
+#include <nuttx/net/ip.h>
+#include <nuttx/net/tcp.h>
+
+#include "devif/devif.h"
+#include "inet/inet.h"
+#include "utils/utils.h"
+#include "tcp/tcp.h"
+
+#if defined(NET_TCP_HAVE_STACK) && CONFIG_NET_TCP_TIMEWAIT_RECORDS > 0
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Four records per hash chain on average when all of them are in use */
+
+#define TCP_TIMEWAIT_NHASH   ((CONFIG_NET_TCP_TIMEWAIT_RECORDS + 3) / 4)
+
+#define TCP_TIMEWAIT_TICKS   SEC2TICK(TCP_TIME_WAIT_TIMEOUT)
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static struct tcp_timewait_s g_tcp_timewait[CONFIG_NET_TCP_TIMEWAIT_RECORDS];
+
+/* Records in use by their hash, and in the order they were added */
+
+static sq_queue_t g_tcp_timewait_hash[TCP_TIMEWAIT_NHASH];
+static dq_queue_t g_tcp_timewait_age;
+
+/* Records not in use */
+
+static sq_queue_t g_tcp_timewait_free;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: tcp_timewait_hash
+ *
+ * Description:
+ *   Return the hash chain of the ports and the remote address.
+ *
+ ****************************************************************************/
+
+static FAR sq_queue_t *tcp_timewait_hash(uint16_t lport, uint16_t rport,
+                                         FAR const union ip_binding_u *u,
+                                         uint8_t domain)
+{
+  uint32_t key = ((uint32_t)lport << 16) ^ rport;
+
+#ifdef CONFIG_NET_IPv4
+#  ifdef CONFIG_NET_IPv6
+  if (domain == PF_INET)
+#  endif
+    {
+      key ^= u->ipv4.raddr;
+    }
+#endif
+
+#ifdef CONFIG_NET_IPv6
+#  ifdef CONFIG_NET_IPv4
+  else
+#  endif
+    {
+      key ^= ((uint32_t)u->ipv6.raddr[6] << 16) ^ u->ipv6.raddr[7];
+    }
+#endif
+
+  key ^= key >> 16;
+  return &g_tcp_timewait_hash[key % TCP_TIMEWAIT_NHASH];
+}
+
+/****************************************************************************
+ * Name: tcp_timewait_release
+ *
+ * Description:
+ *   Return a record to the free list.
+ *
+ ****************************************************************************/
+
+static void tcp_timewait_release(FAR struct tcp_timewait_s *tw)
+{
+#if defined(CONFIG_NET_IPv4) && defined(CONFIG_NET_IPv6)
+  uint8_t domain = tw->domain;
+#else
+  uint8_t domain = net_ip_domain_select(0, PF_INET, PF_INET6);
+#endif
+
+  sq_rem(&tw->hnode, tcp_timewait_hash(tw->lport, tw->rport, &tw->u,
+                                       domain));
+  dq_rem(&tw->anode, &g_tcp_timewait_age);
+  sq_addlast(&tw->hnode, &g_tcp_timewait_free);
+}
+
+/****************************************************************************
+ * Name: tcp_timewait_expire
+ *
+ * Description:
+ *   Release the records whose TIME_WAIT is over.  They are added with the
+ *   same timeout, so the age list is also ordered by expiry.
+ *
+ ****************************************************************************/
+
+static void tcp_timewait_expire(clock_t now)
+{
+  FAR struct tcp_timewait_s *tw;
+  FAR dq_entry_t *entry;
+
+  while ((entry = dq_peek(&g_tcp_timewait_age)) != NULL)
+    {
+      tw = container_of(entry, struct tcp_timewait_s, anode);
+      if ((sclock_t)(tw->expire - now) > 0)
+        {
+          break;
+        }
+
+      tcp_timewait_release(tw);
+    }
+}
+
+/****************************************************************************
+ * Name: tcp_timewait_find
+ *
+ * Description:
+ *   Find the record of the connection a received segment belongs to.
+ *
+ ****************************************************************************/
+
+static FAR struct tcp_timewait_s *
+tcp_timewait_find(FAR struct net_driver_s *dev, FAR struct tcp_hdr_s *tcp,
+                  uint8_t domain)
+{
+  FAR struct tcp_timewait_s *tw;
+  FAR sq_entry_t *entry;
+  union ip_binding_u u;
+
+#ifdef CONFIG_NET_IPv4
+#  ifdef CONFIG_NET_IPv6
+  if (domain == PF_INET)
+#  endif
+    {
+      net_ipv4addr_copy(u.ipv4.laddr,
+                        net_ip4addr_conv32(IPv4BUF->destipaddr));
+      net_ipv4addr_copy(u.ipv4.raddr,
+                        net_ip4addr_conv32(IPv4BUF->srcipaddr));
+    }
+#endif
+
+#ifdef CONFIG_NET_IPv6
+#  ifdef CONFIG_NET_IPv4
+  else
+#  endif
+    {
+      net_ipv6addr_copy(u.ipv6.laddr, IPv6BUF->destipaddr);
+      net_ipv6addr_copy(u.ipv6.raddr, IPv6BUF->srcipaddr);
+    }
+#endif
+
+  entry = sq_peek(tcp_timewait_hash(tcp->destport, tcp->srcport, &u,
+                                    domain));
+  for (; entry != NULL; entry = sq_next(entry))
+    {
+      tw = container_of(entry, struct tcp_timewait_s, hnode);
+
+      if (tw->lport != tcp->destport || tw->rport != tcp->srcport)
+        {
+          continue;
+        }
+
+#if defined(CONFIG_NET_IPv4) && defined(CONFIG_NET_IPv6)
+      if (tw->domain != domain)
+        {
+          continue;
+        }
+#endif
+
+#ifdef CONFIG_NET_IPv4
+#  ifdef CONFIG_NET_IPv6
+      if (domain == PF_INET)
+#  endif
+        {
+          if (net_ipv4addr_cmp(tw->u.ipv4.raddr, u.ipv4.raddr) &&
+              (net_ipv4addr_cmp(tw->u.ipv4.laddr, INADDR_ANY) ||
+               net_ipv4addr_cmp(tw->u.ipv4.laddr, u.ipv4.laddr)))
+            {
+              return tw;
+            }
+        }
+#endif
+
+#ifdef CONFIG_NET_IPv6
+#  ifdef CONFIG_NET_IPv4
+      else
+#  endif
+        {
+          if (net_ipv6addr_cmp(tw->u.ipv6.raddr, u.ipv6.raddr) &&
+              (net_ipv6addr_cmp(tw->u.ipv6.laddr, g_ipv6_unspecaddr) ||
+               net_ipv6addr_cmp(tw->u.ipv6.laddr, u.ipv6.laddr)))
+            {
+              return tw;
+            }
+        }
+#endif
+    }
+
+  return NULL;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: tcp_timewait_initialize
+ *
+ * Description:
+ *   Put all of the TIME_WAIT records on the free list.  Called once from
+ *   tcp_initialize().
+ *
+ ****************************************************************************/
+
+void tcp_timewait_initialize(void)
+{
+  int i;
+
+  for (i = 0; i < CONFIG_NET_TCP_TIMEWAIT_RECORDS; i++)
+    {
+      sq_addlast(&g_tcp_timewait[i].hnode, &g_tcp_timewait_free);
+    }
+}
+
+/****************************************************************************
+ * Name: tcp_timewait_add
+ *
+ * Description:
+ *   Keep a TIME_WAIT record for a connection that is being released in the
+ *   TIME_WAIT state, recycling the oldest record if all of them are in use.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+void tcp_timewait_add(FAR struct tcp_conn_s *conn)
+{
+  FAR struct tcp_timewait_s *tw;
+  FAR sq_entry_t *entry;
+  clock_t now = clock_systime_ticks();
+  uint8_t domain;
+
+  tcp_timewait_expire(now);
+
+  entry = sq_remfirst(&g_tcp_timewait_free);
+  if (entry == NULL)
+    {
+      /* Recycle the oldest one, the least likely to still be needed */
+
+      tcp_timewait_release(container_of(dq_peek(&g_tcp_timewait_age),
+                                        struct tcp_timewait_s, anode));
+      entry = sq_remfirst(&g_tcp_timewait_free);
+    }
+
+  tw = container_of(entry, struct tcp_timewait_s, hnode);
+
+#if defined(CONFIG_NET_IPv4) && defined(CONFIG_NET_IPv6)
+  domain     = conn->domain;
+  tw->domain = domain;
+#else
+  domain     = net_ip_domain_select(0, PF_INET, PF_INET6);
+#endif
+
+  memcpy(&tw->u, &conn->u, sizeof(union ip_binding_u));
+  tw->lport  = conn->lport;
+  tw->rport  = conn->rport;
+  tw->rcvseq = tcp_getsequence(conn->rcvseq);
+  tw->sndseq = tcp_getsequence(conn->sndseq);
+  tw->expire = now + TCP_TIMEWAIT_TICKS;
+
+  sq_addfirst(&tw->hnode, tcp_timewait_hash(tw->lport, tw->rport, &tw->u,
+                                            domain));
+  dq_addlast(&tw->anode, &g_tcp_timewait_age);
+}
+
+/****************************************************************************
+ * Name: tcp_timewait_input
+ *
+ * Description:
+ *   Handle a segment that matches no connection against the TIME_WAIT
+ *   records.
+ *
+ * Input Parameters:
+ *   dev    - The device driver structure containing the received packet
+ *   tcp    - The TCP header of the received packet
+ *   domain - IP domain (PF_INET or PF_INET6)
+ *
+ * Returned Value:
+ *   True if the segment was handled, dev->d_len then holds the reply, if
+ *   any.  False if it should go through the normal processing.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+bool tcp_timewait_input(FAR struct net_driver_s *dev,
+                        FAR struct tcp_hdr_s *tcp, uint8_t domain)
+{
+  FAR struct tcp_timewait_s *tw;
+  clock_t now;
+
+  if (dq_empty(&g_tcp_timewait_age))
+    {
+      return false;
+    }
+
+  now = clock_systime_ticks();
+  tcp_timewait_expire(now);
+
+  tw = tcp_timewait_find(dev, tcp, domain);
+  if (tw == NULL)
+    {
+      return false;
+    }
+
+  /* A new connection request with a higher sequence number may reuse the
+   * address pair right away (RFC 1122, 4.2.2.13).
+   */
+
+  if ((tcp->flags & TCP_CTL) == TCP_SYN &&
+      TCP_SEQ_GT(tcp_getsequence(tcp->seqno), tw->rcvseq))
+    {
+      ninfo("TIME_WAIT record reused by a new SYN\n");
+      tcp_timewait_release(tw);
+      return false;
+    }
+
+  /* Ignore a RST, it must not end TIME_WAIT early (RFC 1337) */
+
+  if ((tcp->flags & TCP_RST) != 0)
+    {
+      dev->d_len = 0;
+      return true;
+    }
+
+  /* Anything else is from the old connection: ACK it again, and restart
+   * the TIME_WAIT on a retransmitted FIN (RFC 793).
+   */
+
+  if ((tcp->flags & TCP_FIN) != 0)
+    {
+      tw->expire = now + TCP_TIMEWAIT_TICKS;
+      dq_rem(&tw->anode, &g_tcp_timewait_age);
+      dq_addlast(&tw->anode, &g_tcp_timewait_age);
+    }
+
+  tcp_ack(dev, tw->sndseq, tw->rcvseq);
+  return true;
+}
+
+/****************************************************************************
+ * Name: tcp_timewait_next
+ *
+ * Description:
+ *   Traverse the list of live TIME_WAIT records, oldest first.
+ *
+ * Input Parameters:
+ *   tw - The last record returned, NULL to get the first one
+ *
+ * Returned Value:
+ *   The next record, NULL at the end of the list.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+FAR struct tcp_timewait_s *tcp_timewait_next(FAR struct tcp_timewait_s *tw)
+{
+  FAR dq_entry_t *entry;
+
+  if (tw == NULL)
+    {
+      tcp_timewait_expire(clock_systime_ticks());
+      entry = dq_peek(&g_tcp_timewait_age);
+    }
+  else
+    {
+      entry = dq_next(&tw->anode);
+    }
+
+  return entry != NULL ?
+         container_of(entry, struct tcp_timewait_s, anode) : NULL;
+}
+
+#endif /* NET_TCP_HAVE_STACK && CONFIG_NET_TCP_TIMEWAIT_RECORDS > 0 */
@@ -119,6 +119,20 @@ struct udp_conn_s
   uint8_t  domain;        /* IP domain: PF_INET or PF_INET6 */
   uint8_t  crefs;         /* Reference counts on this instance */
 
+#if CONFIG_NET_UDP_HASH_SIZE > 0
+  /* Demultiplexing hash chains.
+   *
+   *   pnode/phash - The chain of the local port, NULL if not bound.
+   *   cnode/chash - The chain of the ports and the remote address, NULL if
+   *                 the socket is not connected to a remote peer.
+   */
+
+  dq_entry_t pnode;
+  dq_entry_t cnode;
+  FAR dq_queue_t *phash;
+  FAR dq_queue_t *chash;
+#endif
+
 #if CONFIG_NET_RECV_BUFSIZE > 0
   int32_t  rcvbufs;       /* Maximum amount of bytes queued in recv */
 #endif
@@ -164,6 +178,12 @@ struct udp_conn_s
 #ifdef CONFIG_NET_TIMESTAMP
   int timestamp; /* Nonzero when SO_TIMESTAMP is enabled */
 #endif
+#ifdef CONFIG_NET_UDP_SEGMENT
+  uint16_t gsosize; /* UDP_SEGMENT datagram size, zero if disabled */
+#endif
+#ifdef CONFIG_NET_UDP_GRO
+  uint8_t  gro;     /* Nonzero when UDP_GRO is enabled */
+#endif
 };
 
 /* This structure supports UDP write buffering.  It is simply a container
@@ -284,6 +304,22 @@ FAR struct udp_conn_s *udp_nextconn(FAR struct udp_conn_s *conn);
 
 uint16_t udp_select_port(uint8_t domain, FAR union ip_binding_u *u);
 
+/****************************************************************************
+ * Name: udp_conn_rehash
+ *
+ * Description:
+ *   Move the connection to the hash chains matching its current local port,
+ *   remote port and remote address.  This must be called whenever one of
+ *   them or the connection mode changes.
+ *
+ ****************************************************************************/
+
+#if CONFIG_NET_UDP_HASH_SIZE > 0
+void udp_conn_rehash(FAR struct udp_conn_s *conn);
+#else
+#  define udp_conn_rehash(conn)
+#endif
+
 /****************************************************************************
  * Name: udp_bind
  *
@@ -482,6 +518,32 @@ int udp_setsockopt(FAR struct socket *psock, int option,
                    FAR const void *value, socklen_t value_len);
 #endif
 
+/****************************************************************************
+ * Name: udp_getsockopt
+ *
+ * Description:
+ *   udp_getsockopt() retrieves the value for the UDP-protocol option
+ *   specified by the 'option' argument for the socket specified by the
+ *   'psock' argument.
+ *
+ * Input Parameters:
+ *   psock     Socket structure of the socket to query
+ *   option    identifies the option to get
+ *   value     Points to the argument value
+ *   value_len The length of the argument value
+ *
+ * Returned Value:
+ *   Returns zero (OK) on success.  On failure, it returns a negated errno
+ *   value to indicate the nature of the error.  See psock_getsockopt() for
+ *   the complete list of appropriate return error codes.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_UDPPROTO_OPTIONS
+int udp_getsockopt(FAR struct socket *psock, int option,
+                   FAR void *value, FAR socklen_t *value_len);
+#endif
+
 /****************************************************************************
  * Name: udp_wrbuffer_initialize
  *
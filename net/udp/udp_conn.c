@@ -59,6 +59,7 @@
 #include <nuttx/clock.h>
 #include <nuttx/kmalloc.h>
 #include <nuttx/mutex.h>
+#include <nuttx/nuttx.h>
 #include <nuttx/net/netconfig.h>
 #include <nuttx/net/net.h>
 #include <nuttx/net/netdev.h>
@@ -93,10 +94,126 @@ static mutex_t g_free_lock = NXMUTEX_INITIALIZER;
 
 static dq_queue_t g_active_udp_connections;
 
+#if CONFIG_NET_UDP_HASH_SIZE > 0
+/* Bound connections by their local port, and connected ones also by their
+ * ports and remote address.
+ */
+
+static dq_queue_t g_udp_porthash[CONFIG_NET_UDP_HASH_SIZE];
+static dq_queue_t g_udp_connhash[CONFIG_NET_UDP_HASH_SIZE];
+#endif
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
 
+#if CONFIG_NET_UDP_HASH_SIZE > 0
+/****************************************************************************
+ * Name: udp_porthash
+ *
+ * Description:
+ *   Return the hash chain of a local port (network byte order).
+ *
+ ****************************************************************************/
+
+static FAR dq_queue_t *udp_porthash(uint16_t lport)
+{
+  return &g_udp_porthash[NTOHS(lport) % CONFIG_NET_UDP_HASH_SIZE];
+}
+
+/****************************************************************************
+ * Name: udp_connhash
+ *
+ * Description:
+ *   Return the hash chain of the ports and a 32-bit digest of the remote
+ *   address.
+ *
+ ****************************************************************************/
+
+static FAR dq_queue_t *udp_connhash(uint16_t lport, uint16_t rport,
+                                    uint32_t raddr)
+{
+  uint32_t key = ((uint32_t)lport << 16) ^ rport ^ raddr;
+
+  key ^= key >> 16;
+  return &g_udp_connhash[key % CONFIG_NET_UDP_HASH_SIZE];
+}
+
+/****************************************************************************
+ * Name: udp_nextbound
+ *
+ * Description:
+ *   Traverse the connections bound to a local port.  Other connections in
+ *   the same hash chain may be returned too.
+ *
+ ****************************************************************************/
+
+static FAR struct udp_conn_s *udp_nextbound(FAR struct udp_conn_s *conn,
+                                            uint16_t portno)
+{
+  FAR dq_entry_t *entry;
+
+  entry = conn == NULL ? dq_peek(udp_porthash(portno)) :
+                         dq_next(&conn->pnode);
+
+  return entry != NULL ? container_of(entry, struct udp_conn_s, pnode) :
+                         NULL;
+}
+
+/****************************************************************************
+ * Name: udp_nextactive
+ *
+ * Description:
+ *   Traverse the connections that may accept a received datagram: first
+ *   the connected ones in chash, then the others in phash.  All connections
+ *   are traversed if phash is NULL.
+ *
+ ****************************************************************************/
+
+static FAR struct udp_conn_s *udp_nextactive(FAR struct udp_conn_s *conn,
+                                             FAR dq_queue_t *chash,
+                                             FAR dq_queue_t *phash)
+{
+  FAR dq_entry_t *entry;
+
+  if (phash == NULL)
+    {
+      return udp_nextconn(conn);
+    }
+
+  /* Connections in phash that are also in a chash were checked in the
+   * first pass, so the pass of the previous connection is given by its
+   * chash.
+   */
+
+  if (conn == NULL || conn->chash != NULL)
+    {
+      entry = conn == NULL ? dq_peek(chash) : dq_next(&conn->cnode);
+      if (entry != NULL)
+        {
+          return container_of(entry, struct udp_conn_s, cnode);
+        }
+
+      entry = dq_peek(phash);
+    }
+  else
+    {
+      entry = dq_next(&conn->pnode);
+    }
+
+  for (; entry != NULL; entry = dq_next(entry))
+    {
+      conn = container_of(entry, struct udp_conn_s, pnode);
+      if (conn->chash == NULL)
+        {
+          return conn;
+        }
+    }
+
+  return NULL;
+}
+#endif /* CONFIG_NET_UDP_HASH_SIZE > 0 */
+
 /****************************************************************************
  * Name: udp_find_conn()
  *
@@ -126,7 +243,11 @@ static FAR struct udp_conn_s *udp_find_conn(uint8_t domain,
 
   /* Now search each connection structure. */
 
+#if CONFIG_NET_UDP_HASH_SIZE > 0
+  while ((conn = udp_nextbound(conn, portno)) != NULL)
+#else
   while ((conn = udp_nextconn(conn)) != NULL)
+#endif
     {
       /* With SO_REUSEADDR set for both sockets, we do not need to check its
        * address and port.
@@ -198,8 +319,27 @@ udp_ipv4_active(FAR struct net_driver_s *dev, FAR struct udp_conn_s *conn,
   static const in_addr_t bcast = INADDR_BROADCAST;
 #endif
   FAR struct ipv4_hdr_s *ip = IPv4BUF;
+#if CONFIG_NET_UDP_HASH_SIZE > 0
+  FAR dq_queue_t *chash = NULL;
+  FAR dq_queue_t *phash = NULL;
+
+  /* Connected sockets accept a limited broadcast from any peer, so only
+   * the other datagrams can be looked up by their sender.
+   */
+
+#ifdef CONFIG_NET_BROADCAST
+  if (!net_ipv4addr_hdrcmp(ip->destipaddr, &bcast))
+#endif
+    {
+      chash = udp_connhash(udp->destport, udp->srcport,
+                           net_ip4addr_conv32(ip->srcipaddr));
+      phash = udp_porthash(udp->destport);
+    }
 
+  conn = udp_nextactive(conn, chash, phash);
+#else
   conn = udp_nextconn(conn);
+#endif
 
   while (conn)
     {
@@ -313,7 +453,11 @@ udp_ipv4_active(FAR struct net_driver_s *dev, FAR struct udp_conn_s *conn,
 
       /* Look at the next active connection */
 
+#if CONFIG_NET_UDP_HASH_SIZE > 0
+      conn = udp_nextactive(conn, chash, phash);
+#else
       conn = (FAR struct udp_conn_s *)conn->sconn.node.flink;
+#endif
     }
 
   return conn;
@@ -338,8 +482,28 @@ udp_ipv6_active(FAR struct net_driver_s *dev, FAR struct udp_conn_s *conn,
                 FAR struct udp_hdr_s *udp)
 {
   FAR struct ipv6_hdr_s *ip = IPv6BUF;
+#if CONFIG_NET_UDP_HASH_SIZE > 0
+  FAR dq_queue_t *chash = NULL;
+  FAR dq_queue_t *phash = NULL;
+
+  /* Connected sockets accept the all-nodes multicast from any peer, so
+   * only the other datagrams can be looked up by their sender.
+   */
 
+#ifdef CONFIG_NET_BROADCAST
+  if (!net_ipv6addr_hdrcmp(ip->destipaddr, g_ipv6_allnodes))
+#endif
+    {
+      chash = udp_connhash(udp->destport, udp->srcport,
+                           ((uint32_t)ip->srcipaddr[6] << 16) ^
+                           ip->srcipaddr[7]);
+      phash = udp_porthash(udp->destport);
+    }
+
+  conn = udp_nextactive(conn, chash, phash);
+#else
   conn = udp_nextconn(conn);
+#endif
 
   while (conn != NULL)
     {
@@ -453,7 +617,11 @@ udp_ipv6_active(FAR struct net_driver_s *dev, FAR struct udp_conn_s *conn,
 
       /* Look at the next active connection */
 
+#if CONFIG_NET_UDP_HASH_SIZE > 0
+      conn = udp_nextactive(conn, chash, phash);
+#else
       conn = (FAR struct udp_conn_s *)conn->sconn.node.flink;
+#endif
     }
 
   return conn;
@@ -582,6 +750,101 @@ errout:
   return portno;
 }
 
+/****************************************************************************
+ * Name: udp_conn_rehash
+ *
+ * Description:
+ *   Move the connection to the hash chains matching its current local port,
+ *   remote port and remote address.  This must be called whenever one of
+ *   them or the connection mode changes.
+ *
+ ****************************************************************************/
+
+#if CONFIG_NET_UDP_HASH_SIZE > 0
+void udp_conn_rehash(FAR struct udp_conn_s *conn)
+{
+  FAR dq_queue_t *phash = NULL;
+  FAR dq_queue_t *chash = NULL;
+  bool wildcard = true;
+  bool connected = false;
+  uint32_t raddr = 0;
+
+  net_lock();
+
+  if (conn->lport != 0)
+    {
+#ifdef CONFIG_NET_IPv4
+#ifdef CONFIG_NET_IPv6
+      if (conn->domain == PF_INET)
+#endif
+        {
+          wildcard  = net_ipv4addr_cmp(conn->u.ipv4.laddr, INADDR_ANY);
+          connected = !net_ipv4addr_cmp(conn->u.ipv4.raddr, INADDR_ANY);
+          raddr     = conn->u.ipv4.raddr;
+        }
+#endif /* CONFIG_NET_IPv4 */
+
+#ifdef CONFIG_NET_IPv6
+#ifdef CONFIG_NET_IPv4
+      else
+#endif
+        {
+          wildcard  = net_ipv6addr_cmp(conn->u.ipv6.laddr,
+                                       g_ipv6_unspecaddr);
+          connected = !net_ipv6addr_cmp(conn->u.ipv6.raddr,
+                                        g_ipv6_unspecaddr);
+          raddr     = ((uint32_t)conn->u.ipv6.raddr[6] << 16) ^
+                      conn->u.ipv6.raddr[7];
+        }
+#endif /* CONFIG_NET_IPv6 */
+
+      phash = udp_porthash(conn->lport);
+      if (_UDP_ISCONNECTMODE(conn->flags) && conn->rport != 0 && connected)
+        {
+          chash = udp_connhash(conn->lport, conn->rport, raddr);
+        }
+    }
+
+  if (conn->phash != phash)
+    {
+      if (conn->phash != NULL)
+        {
+          dq_rem(&conn->pnode, conn->phash);
+        }
+
+      /* Sockets bound to a specific local address come first */
+
+      if (phash != NULL && wildcard)
+        {
+          dq_addlast(&conn->pnode, phash);
+        }
+      else if (phash != NULL)
+        {
+          dq_addfirst(&conn->pnode, phash);
+        }
+
+      conn->phash = phash;
+    }
+
+  if (conn->chash != chash)
+    {
+      if (conn->chash != NULL)
+        {
+          dq_rem(&conn->cnode, conn->chash);
+        }
+
+      if (chash != NULL)
+        {
+          dq_addlast(&conn->cnode, chash);
+        }
+
+      conn->chash = chash;
+    }
+
+  net_unlock();
+}
+#endif /* CONFIG_NET_UDP_HASH_SIZE > 0 */
+
 /****************************************************************************
  * Name: udp_initialize
  *
@@ -686,6 +949,7 @@ void udp_free(FAR struct udp_conn_s *conn)
 
   nxmutex_lock(&g_free_lock);
   conn->lport = 0;
+  udp_conn_rehash(conn);
 
   /* Remove the connection from the active list */
 
@@ -704,6 +968,12 @@ void udp_free(FAR struct udp_conn_s *conn)
       udp_wrbuffer_release(wrbuffer);
     }
 
+#ifdef CONFIG_NET_ZEROCOPY
+  /* Drop the pending MSG_ZEROCOPY completions */
+
+  zerocopy_release(&conn->sconn);
+#endif
+
 #if CONFIG_NET_SEND_BUFSIZE > 0
   /* Notify the send buffer available */
 
@@ -962,6 +1232,7 @@ int udp_bind(FAR struct udp_conn_s *conn, FAR const struct sockaddr *addr)
         }
     }
 
+  udp_conn_rehash(conn);
   net_unlock();
   return ret;
 }
@@ -1089,6 +1360,7 @@ int udp_connect(FAR struct udp_conn_s *conn, FAR const struct sockaddr *addr)
 #endif /* CONFIG_NET_IPv6 */
     }
 
+  udp_conn_rehash(conn);
   return OK;
 }
 
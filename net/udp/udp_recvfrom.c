@@ -41,6 +41,7 @@
 #include <nuttx/net/udp.h>
 #include <nuttx/tls.h>
 #include <netinet/in.h>
+#include <netinet/udp.h>
 
 #include "netdev/netdev.h"
 #include "devif/devif.h"
@@ -121,6 +122,107 @@ static void udp_recvpktinfo(FAR struct udp_recvfrom_s *pstate,
 #define udp_recvpktinfo(p, s, i) {(void)(p); (void)(s); (void)(i);}
 #endif
 
+/****************************************************************************
+ * Name: udp_readahead_gro
+ *
+ * Description:
+ *   UDP_GRO: After the first read-ahead datagram has been copied, append
+ *   the following datagrams of the same sender to the user buffer as long
+ *   as they fit and are not larger than the first one.  A shorter datagram
+ *   ends the batch.  The datagram size is reported as a UDP_GRO control
+ *   message so that the application can split the buffer again.
+ *
+ * Input Parameters:
+ *   pstate        - recvfrom state structure
+ *   srcaddr       - Sender of the first datagram
+ *   src_addr_size - Size of srcaddr
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_UDP_GRO
+static void udp_readahead_gro(FAR struct udp_recvfrom_s *pstate,
+                              FAR const uint8_t *srcaddr,
+                              uint8_t src_addr_size)
+{
+  FAR struct udp_conn_s *conn = pstate->ir_conn;
+  FAR struct iovec *iov = pstate->ir_msg->msg_iov;
+  int gsosize = pstate->ir_recvlen;
+  int nsegs = 1;
+  FAR struct iob_s *iob;
+
+  while ((iob = conn->readahead) != NULL)
+    {
+#ifdef CONFIG_NET_IPv6
+      uint8_t addr[sizeof(struct sockaddr_in6)];
+#else
+      uint8_t addr[sizeof(struct sockaddr_in)];
+#endif
+      uint16_t datalen;
+      uint8_t addrsize;
+      int offset = 0;
+
+      /* Peek at the saved information, see udp_readahead() for the layout */
+
+      iob_copyout((FAR uint8_t *)&datalen, iob, sizeof(datalen), offset);
+      offset += sizeof(datalen);
+#ifdef CONFIG_NETDEV_IFINDEX
+      offset += sizeof(uint8_t);
+#endif
+      iob_copyout(&addrsize, iob, sizeof(addrsize), offset);
+      offset += sizeof(addrsize);
+
+      if (addrsize != src_addr_size || datalen > gsosize ||
+          pstate->ir_recvlen + datalen > iov->iov_len)
+        {
+          break;
+        }
+
+      iob_copyout(addr, iob, addrsize, offset);
+      offset += addrsize;
+      if (memcmp(addr, srcaddr, addrsize) != 0)
+        {
+          break;
+        }
+
+#ifdef CONFIG_NET_TIMESTAMP
+      offset += sizeof(struct timespec);
+#endif
+
+      pstate->ir_recvlen += iob_copyout((FAR uint8_t *)iov->iov_base +
+                                        pstate->ir_recvlen, iob,
+                                        datalen, offset);
+      nsegs++;
+
+      if (offset + datalen >= iob->io_pktlen)
+        {
+          iob_free_chain(iob);
+          conn->readahead = NULL;
+        }
+      else
+        {
+          conn->readahead = iob_trimhead(iob, offset + datalen);
+        }
+
+      if (datalen < gsosize)
+        {
+          break;
+        }
+    }
+
+  if (nsegs > 1)
+    {
+      cmsg_append(pstate->ir_msg, SOL_UDP, UDP_GRO,
+                  &gsosize, sizeof(gsosize));
+    }
+}
+#endif
+
 /****************************************************************************
  * Name: udp_recvfrom_newdata
  *
@@ -273,6 +375,13 @@ static inline void udp_readahead(struct udp_recvfrom_s *pstate)
             {
               conn->readahead = iob_trimhead(iob, offset + datalen);
             }
+
+#ifdef CONFIG_NET_UDP_GRO
+          if (conn->gro && recvlen == datalen && datalen > 0)
+            {
+              udp_readahead_gro(pstate, srcaddr, src_addr_size);
+            }
+#endif
         }
     }
 }
@@ -760,6 +869,13 @@ ssize_t psock_udp_recvfrom(FAR struct socket *psock, FAR struct msghdr *msg,
           info.sem = &state.ir_sem;
           tls_cleanup_push(tls_get_info(), udp_callback_cleanup, &info);
 
+#ifdef CONFIG_NET_BUSY_POLL
+          /* Receive from the device here for a while before sleeping */
+
+          netdev_busypoll(dev, conn->sconn.s_busypoll,
+                          netdev_busypoll_sem, &state.ir_sem);
+#endif
+
           /* Wait for either the receive to complete or for an error/timeout
            * to occur.  net_sem_timedwait will also terminate if a signal is
            * received.
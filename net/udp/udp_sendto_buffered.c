@@ -264,6 +264,8 @@ static int sendto_next_transfer(FAR struct udp_conn_s *conn)
           nerr("ERROR: Failed to get a local port!\n");
           return -EADDRINUSE;
         }
+
+      udp_conn_rehash(conn);
     }
 
   /* Get the device that will handle the remote packet transfers.  This
@@ -513,6 +515,62 @@ static unsigned int udp_send_gettimeout(clock_t start, unsigned int timeout)
   return timeout;
 }
 
+/****************************************************************************
+ * Name: sendto_segments
+ *
+ * Description:
+ *   Split a UDP_SEGMENT send into datagrams of conn->gsosize bytes.  They
+ *   are all queued under one network lock, so the device gets them as one
+ *   burst when it is next polled.  With MSG_ZEROCOPY, each datagram is
+ *   reported as a send of its own.
+ *
+ * Returned Value:
+ *   The number of bytes queued, or a negated errno value if none was.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_UDP_SEGMENT
+static ssize_t sendto_segments(FAR struct socket *psock,
+                               FAR const void *buf, size_t len, int flags,
+                               FAR const struct sockaddr *to,
+                               socklen_t tolen)
+{
+  FAR struct udp_conn_s *conn = psock->s_conn;
+  FAR const uint8_t *ptr = buf;
+  size_t sent = 0;
+  ssize_t ret = OK;
+
+  net_lock();
+
+#if CONFIG_NET_SEND_BUFSIZE > 0
+  /* A non-blocking send should not fail half way through */
+
+  if ((_SS_ISNONBLOCK(conn->sconn.s_flags) || (flags & MSG_DONTWAIT) != 0)
+      && udp_wrbuffer_inqueue_size(conn) + len > conn->sndbufs)
+    {
+      net_unlock();
+      return -EAGAIN;
+    }
+#endif
+
+  while (sent < len)
+    {
+      ret = psock_udp_sendto(psock, ptr + sent,
+                             MIN(len - sent, conn->gsosize),
+                             flags, to, tolen);
+      if (ret < 0)
+        {
+          break;
+        }
+
+      sent += ret;
+    }
+
+  net_unlock();
+  return sent > 0 ? sent : ret;
+}
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -548,6 +606,9 @@ ssize_t psock_udp_sendto(FAR struct socket *psock, FAR const void *buf,
 {
   FAR struct udp_wrbuffer_s *wrb;
   FAR struct udp_conn_s *conn;
+#ifdef CONFIG_NET_ZEROCOPY
+  FAR struct zerocopy_s *zc = NULL;
+#endif
   unsigned int timeout;
   uint16_t udpiplen;
   bool nonblock;
@@ -566,6 +627,15 @@ ssize_t psock_udp_sendto(FAR struct socket *psock, FAR const void *buf,
       return -EMSGSIZE;
     }
 
+#ifdef CONFIG_NET_UDP_SEGMENT
+  /* Let sendto_segments() split the large sends of UDP_SEGMENT */
+
+  if (conn->gsosize > 0 && len > conn->gsosize)
+    {
+      return sendto_segments(psock, buf, len, flags, to, tolen);
+    }
+#endif
+
   /* If the UDP socket was previously assigned a remote peer address via
    * connect(), then as with connection-mode socket, sendto() may not be
    * used with a non-NULL destination address.  Normally send() would be
@@ -813,31 +883,45 @@ ssize_t psock_udp_sendto(FAR struct socket *psock, FAR const void *buf,
       iob_reserve(wrb->wb_iob, CONFIG_NET_LL_GUARDSIZE);
       iob_update_pktlen(wrb->wb_iob, udpiplen, false);
 
-      /* Copy the user data into the write buffer.  We cannot wait for
-       * buffer space if the socket was opened non-blocking.
-       */
+#ifdef CONFIG_NET_ZEROCOPY
+      /* Queue the user buffer in place for MSG_ZEROCOPY */
 
-      if (nonblock)
+      ret = zerocopy_begin(&conn->sconn, buf, len, flags, &zc);
+      if (ret < 0)
         {
-          ret = iob_trycopyin(wrb->wb_iob, (FAR uint8_t *)buf,
-                              len, udpiplen, false);
+          goto errout_with_wrb;
         }
-      else
-        {
-          unsigned int count;
-          int blresult;
 
-          /* iob_copyin might wait for buffers to be freed, but if
-           * network is locked this might never happen, since network
-           * driver is also locked, therefore we need to break the lock
+      ret = zerocopy_iob_append(zc, &wrb->wb_iob, buf, len);
+      if (ret < 0)
+#endif
+        {
+          /* Copy the user data into the write buffer.  We cannot wait for
+           * buffer space if the socket was opened non-blocking.
            */
 
-          blresult = net_breaklock(&count);
-          ret = iob_copyin(wrb->wb_iob, (FAR uint8_t *)buf,
-                           len, udpiplen, false);
-          if (blresult >= 0)
+          if (nonblock)
             {
-              net_restorelock(count);
+              ret = iob_trycopyin(wrb->wb_iob, (FAR uint8_t *)buf,
+                                  len, udpiplen, false);
+            }
+          else
+            {
+              unsigned int count;
+              int blresult;
+
+              /* iob_copyin might wait for buffers to be freed, but if
+               * network is locked this might never happen, since network
+               * driver is also locked, therefore we need to break the lock
+               */
+
+              blresult = net_breaklock(&count);
+              ret = iob_copyin(wrb->wb_iob, (FAR uint8_t *)buf,
+                               len, udpiplen, false);
+              if (blresult >= 0)
+                {
+                  net_restorelock(count);
+                }
             }
         }
 
@@ -884,6 +968,9 @@ ssize_t psock_udp_sendto(FAR struct socket *psock, FAR const void *buf,
             }
         }
 
+#ifdef CONFIG_NET_ZEROCOPY
+      zerocopy_end(zc, len);
+#endif
       net_unlock();
     }
 
@@ -893,6 +980,9 @@ ssize_t psock_udp_sendto(FAR struct socket *psock, FAR const void *buf,
 
 errout_with_wrb:
   udp_wrbuffer_release(wrb);
+#ifdef CONFIG_NET_ZEROCOPY
+  zerocopy_end(zc, ret);
+#endif
 
 errout_with_lock:
   net_unlock();
@@ -76,7 +76,50 @@
 int udp_setsockopt(FAR struct socket *psock, int option,
                    FAR const void *value, socklen_t value_len)
 {
-  return -ENOPROTOOPT;
+  FAR struct udp_conn_s *conn;
+  int optval;
+
+  DEBUGASSERT(psock != NULL && psock->s_conn != NULL);
+  conn = psock->s_conn;
+
+  if (psock->s_type != SOCK_DGRAM)
+    {
+      nerr("ERROR:  Not a UDP socket\n");
+      return -ENOTCONN;
+    }
+
+  if (value == NULL || value_len != sizeof(int))
+    {
+      return -EINVAL;
+    }
+
+  optval = *(FAR const int *)value;
+
+  switch (option)
+    {
+#ifdef CONFIG_NET_UDP_SEGMENT
+      case UDP_SEGMENT: /* Split the sends into datagrams of this size */
+        if (optval < 0 || optval > UINT16_MAX)
+          {
+            return -EINVAL;
+          }
+
+        conn->gsosize = optval;
+        break;
+#endif
+
+#ifdef CONFIG_NET_UDP_GRO
+      case UDP_GRO: /* Coalesce the received datagrams */
+        conn->gro = optval != 0;
+        break;
+#endif
+
+      default:
+        nerr("ERROR: Unrecognized UDP option: %d\n", option);
+        return -ENOPROTOOPT;
+    }
+
+  return OK;
 }
 
 #endif /* CONFIG_NET_UDPPROTO_OPTIONS */
@@ -27,92 +27,282 @@
 #include <nuttx/config.h>
 #ifdef CONFIG_NET
 
+#include <errno.h>
+#include <string.h>
+#include <sys/param.h>
+
 #include "utils/utils.h"
 
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define CHKSUM_SWAP(s) ((uint16_t)(((s) << 8) | ((s) >> 8)))
+
+/* Convert a sum of native order 16-bit words into network order */
+
+#ifdef CONFIG_ENDIAN_BIG
+#  define CHKSUM_HTONS(s) (s)
+#else
+#  define CHKSUM_HTONS(s) CHKSUM_SWAP(s)
+#endif
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
 
+#ifndef CONFIG_NET_ARCH_CHKSUM
+
 /****************************************************************************
- * Name: checksum
+ * Name: chksum_fold
  *
  * Description:
- *   Calculate the raw change sum over the memory region described by
- *   data and len.
+ *   Fold a 64-bit one's complement accumulator into 16 bits.
  *
- * Input Parameters:
- *   sum  - Partial calculations carried over from a previous call to
- *          chksum().  This should be zero on the first time that check
- *          sum is called.
- *   data - Beginning of the data to include in the checksum.
- *   len  - Length of the data to include in the checksum.
- *   odd  - the flag of the Calculated data sum
+ ****************************************************************************/
+
+static inline uint16_t chksum_fold(uint64_t acc)
+{
+  acc = (acc & 0xffffffff) + (acc >> 32);
+  acc = (acc & 0xffffffff) + (acc >> 32);
+  acc = (acc & 0xffff) + (acc >> 16);
+  acc = (acc & 0xffff) + (acc >> 16);
+
+  return (uint16_t)acc;
+}
+
+/****************************************************************************
+ * Name: chksum_native
  *
- * Returned Value:
- *   The updated checksum value.
+ * Description:
+ *   Add up the 16-bit words of src in native byte order, 32 bits at a time
+ *   into a 64-bit accumulator, and copy them to dest on the way when copy
+ *   is true.  src must be 16-bit aligned and dest must have the same
+ *   alignment as src modulo 4.
  *
  ****************************************************************************/
 
-#ifndef CONFIG_NET_ARCH_CHKSUM
-uint16_t checksum(uint16_t sum, FAR const uint8_t *data,
-                    uint16_t len, bool *odd)
+static inline_function uint64_t
+chksum_native(FAR uint8_t *dest, FAR const uint8_t *src, size_t len,
+              bool copy)
 {
-  FAR const uint8_t *dataptr;
-  FAR const uint8_t *last_byte;
-  uint16_t t;
+  FAR const uint32_t *words;
+  uint32_t w0;
+  uint32_t w1;
+  uint32_t w2;
+  uint32_t w3;
+  uint64_t acc = 0;
+
+  if (((uintptr_t)src & 2) != 0 && len >= 2)
+    {
+      acc += *(FAR const uint16_t *)src;
+      if (copy)
+        {
+          *(FAR uint16_t *)dest = *(FAR const uint16_t *)src;
+          dest += 2;
+        }
+
+      src += 2;
+      len -= 2;
+    }
 
-  dataptr = data;
-  last_byte = data + len - 1;
+  words = (FAR const uint32_t *)src;
+  while (len >= 16)
+    {
+      w0   = words[0];
+      w1   = words[1];
+      w2   = words[2];
+      w3   = words[3];
+      acc += (uint64_t)w0 + w1 + w2 + w3;
+      if (copy)
+        {
+          ((FAR uint32_t *)dest)[0] = w0;
+          ((FAR uint32_t *)dest)[1] = w1;
+          ((FAR uint32_t *)dest)[2] = w2;
+          ((FAR uint32_t *)dest)[3] = w3;
+          dest += 16;
+        }
 
-  if (*odd == true)
+      words += 4;
+      len   -= 16;
+    }
+
+  while (len >= 4)
     {
-      t = dataptr[0];
-      sum += t;
-      if (sum < t)
+      w0   = *words++;
+      acc += w0;
+      if (copy)
         {
-          sum++; /* carry */
+          *(FAR uint32_t *)dest = w0;
+          dest += 4;
         }
 
-      dataptr += 1;
+      len -= 4;
     }
 
-  while (dataptr < last_byte)
+  src = (FAR const uint8_t *)words;
+  if (len >= 2)
     {
-      /* At least two more bytes */
+      acc += *(FAR const uint16_t *)src;
+      if (copy)
+        {
+          *(FAR uint16_t *)dest = *(FAR const uint16_t *)src;
+          dest += 2;
+        }
+
+      src += 2;
+      len -= 2;
+    }
 
-      t = ((uint16_t)dataptr[0] << 8) + dataptr[1];
-      sum += t;
-      if (sum < t)
+  if (len > 0)
+    {
+      /* The last byte is the first byte of a zero padded word */
+
+#ifdef CONFIG_ENDIAN_BIG
+      acc += (uint16_t)src[0] << 8;
+#else
+      acc += src[0];
+#endif
+      if (copy)
         {
-          sum++; /* carry */
+          *dest = src[0];
         }
+    }
+
+  return acc;
+}
+
+/****************************************************************************
+ * Name: chksum_block
+ *
+ * Description:
+ *   Return the sum of the network order 16-bit words of src, which starts
+ *   at an even offset of the message, copying it to dest when copy is true.
+ *
+ ****************************************************************************/
 
-      dataptr += 2;
+static inline_function uint16_t
+chksum_block(FAR uint8_t *dest, FAR const uint8_t *src, size_t len,
+             bool copy)
+{
+  uint32_t acc;
+  uint16_t sum;
+
+  if (((uintptr_t)src & 1) == 0 || len == 0)
+    {
+      return CHKSUM_HTONS(chksum_fold(chksum_native(dest, src, len, copy)));
     }
 
-  *odd = false;
+  /* Sum the first byte alone to keep the word loads aligned.  The rest is
+   * then read one byte out of phase, which byte swaps its sum.
+   */
+
+  acc = (uint32_t)src[0] << 8;
+  if (copy)
+    {
+      *dest++ = src[0];
+    }
+
+  sum  = chksum_fold(chksum_native(dest, src + 1, len - 1, copy));
+  acc += CHKSUM_SWAP(CHKSUM_HTONS(sum));
+
+  return chksum_fold(acc);
+}
+
+/****************************************************************************
+ * Name: chksum_common
+ *
+ * Description:
+ *   Continue the checksum sum over len bytes of src, copying them to dest
+ *   when copy is true.  odd tells whether the data summed so far had an odd
+ *   length, and is updated for the next call.
+ *
+ ****************************************************************************/
+
+static inline_function uint16_t
+chksum_common(uint16_t sum, FAR uint8_t *dest, FAR const uint8_t *src,
+              uint16_t len, FAR bool *odd, bool copy)
+{
+  uint32_t acc = sum;
 
-  if (dataptr == last_byte)
+  if (len == 0)
     {
-      t = (dataptr[0] << 8) + 0;
-      sum += t;
-      if (sum < t)
+      return sum;
+    }
+
+  if (*odd)
+    {
+      /* Complete the word started by the previous call */
+
+      acc += src[0];
+      if (copy)
         {
-          sum++; /* carry */
+          *dest++ = src[0];
         }
 
-      *odd = true;
+      src++;
+      len--;
     }
 
-  /* Return sum in host byte order. */
+  acc += chksum_block(dest, src, len, copy);
+  *odd = (len & 1) != 0;
 
-  return sum;
+  return chksum_fold(acc);
+}
+
+#ifdef CONFIG_NET_CHKSUM_COPY
+static uint16_t checksum_copy(uint16_t sum, FAR uint8_t *dest,
+                              FAR const uint8_t *src, uint16_t len,
+                              FAR bool *odd)
+{
+  if ((((uintptr_t)dest ^ (uintptr_t)src) & 3) != 0)
+    {
+      /* The word stores would not be aligned, let memcpy() deal with that
+       * and sum the data while it is still in the cache.
+       */
+
+      memcpy(dest, src, len);
+      return chksum_common(sum, NULL, src, len, odd, false);
+    }
+
+  return chksum_common(sum, dest, src, len, odd, true);
 }
+#endif
+
+/****************************************************************************
+ * Name: checksum
+ *
+ * Description:
+ *   Calculate the raw change sum over the memory region described by
+ *   data and len.
+ *
+ * Input Parameters:
+ *   sum  - Partial calculations carried over from a previous call to
+ *          chksum().  This should be zero on the first time that check
+ *          sum is called.
+ *   data - Beginning of the data to include in the checksum.
+ *   len  - Length of the data to include in the checksum.
+ *   odd  - the flag of the Calculated data sum
+ *
+ * Returned Value:
+ *   The updated checksum value.
+ *
+ ****************************************************************************/
+
+uint16_t checksum(uint16_t sum, FAR const uint8_t *data,
+                    uint16_t len, bool *odd)
+{
+  return chksum_common(sum, NULL, data, len, odd, false);
+}
+
+#endif /* CONFIG_NET_ARCH_CHKSUM */
 
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
 
+#ifndef CONFIG_NET_ARCH_CHKSUM
+
 /****************************************************************************
  * Name: chksum
  *
@@ -188,6 +378,167 @@ uint16_t chksum_iob(uint16_t sum, FAR struct iob_s *iob, uint16_t offset)
 }
 #endif /* CONFIG_MM_IOB */
 
+#ifdef CONFIG_NET_CHKSUM_COPY
+
+/****************************************************************************
+ * Name: chksum_copy
+ *
+ * Description:
+ *   Copy a buffer and calculate its raw checksum in the same pass.
+ *
+ * Input Parameters:
+ *   sum  - Partial calculations carried over from a previous call to
+ *          chksum().  This should be zero on the first time that check
+ *          sum is called.
+ *   dest - Where to copy the data.
+ *   src  - Beginning of the data to copy and include in the checksum.
+ *   len  - Length of the data.
+ *
+ * Returned Value:
+ *   The updated checksum value.
+ *
+ ****************************************************************************/
+
+uint16_t chksum_copy(uint16_t sum, FAR uint8_t *dest,
+                     FAR const uint8_t *src, uint16_t len)
+{
+  bool odd = false;
+
+  return checksum_copy(sum, dest, src, len, &odd);
+}
+
+/****************************************************************************
+ * Name: chksum_iob_copyin
+ *
+ * Description:
+ *   Copy a buffer into an iob chain and calculate the raw checksum of the
+ *   copied data in the same pass.  The chain is grown or trimmed so that it
+ *   ends with the copied data.
+ *
+ * Input Parameters:
+ *   iob    - The iob chain to copy into.
+ *   src    - The data to copy.
+ *   len    - Number of bytes to copy.
+ *   offset - Byte offset in the chain where the data is copied to.
+ *   sum    - Returns the checksum of the copied data.
+ *
+ * Returned Value:
+ *   Zero on success, a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int chksum_iob_copyin(FAR struct iob_s *iob, FAR const uint8_t *src,
+                      unsigned int len, unsigned int offset,
+                      FAR uint16_t *sum)
+{
+  unsigned int ncopy;
+  bool odd = false;
+  int ret;
+
+  ret = iob_update_pktlen(iob, offset + len, false);
+  if (ret < 0 || ret < offset + len)
+    {
+      return -ENOMEM;
+    }
+
+  while (iob != NULL && offset >= iob->io_len)
+    {
+      offset -= iob->io_len;
+      iob     = iob->io_flink;
+    }
+
+  *sum = 0;
+  while (iob != NULL && len > 0)
+    {
+      ncopy = MIN(iob->io_len - offset, len);
+      *sum  = checksum_copy(*sum, iob->io_data + iob->io_offset + offset,
+                            src, ncopy, &odd);
+      src    += ncopy;
+      len    -= ncopy;
+      iob     = iob->io_flink;
+      offset  = 0;
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Name: chksum_iob_clone
+ *
+ * Description:
+ *   Copy data from one iob chain to another like iob_clone_partial(), and
+ *   calculate the raw checksum of the copied data in the same pass.  iob2
+ *   is grown or trimmed so that it ends with the copied data.
+ *
+ * Input Parameters:
+ *   iob1    - The iob chain to copy from.
+ *   len     - Number of bytes to copy.
+ *   offset1 - Byte offset of the data in iob1.
+ *   iob2    - The iob chain to copy to.
+ *   offset2 - Byte offset in iob2 where the data is copied to.
+ *   sum     - Returns the checksum of the copied data.
+ *
+ * Returned Value:
+ *   Zero on success, a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int chksum_iob_clone(FAR struct iob_s *iob1, unsigned int len,
+                     unsigned int offset1, FAR struct iob_s *iob2,
+                     unsigned int offset2, FAR uint16_t *sum)
+{
+  unsigned int ncopy;
+  bool odd = false;
+  int ret;
+
+  ret = iob_update_pktlen(iob2, offset2 + len, false);
+  if (ret < 0 || ret < offset2 + len)
+    {
+      return -ENOMEM;
+    }
+
+  while (iob1 != NULL && offset1 >= iob1->io_len)
+    {
+      offset1 -= iob1->io_len;
+      iob1     = iob1->io_flink;
+    }
+
+  while (iob2 != NULL && offset2 >= iob2->io_len)
+    {
+      offset2 -= iob2->io_len;
+      iob2     = iob2->io_flink;
+    }
+
+  *sum = 0;
+  while (iob1 != NULL && iob2 != NULL && len > 0)
+    {
+      ncopy = MIN(iob1->io_len - offset1, iob2->io_len - offset2);
+      ncopy = MIN(ncopy, len);
+      *sum  = checksum_copy(*sum, iob2->io_data + iob2->io_offset + offset2,
+                            iob1->io_data + iob1->io_offset + offset1,
+                            ncopy, &odd);
+      len     -= ncopy;
+      offset1 += ncopy;
+      offset2 += ncopy;
+
+      if (offset1 >= iob1->io_len)
+        {
+          iob1    = iob1->io_flink;
+          offset1 = 0;
+        }
+
+      if (offset2 >= iob2->io_len)
+        {
+          iob2    = iob2->io_flink;
+          offset2 = 0;
+        }
+    }
+
+  return len == 0 ? OK : -EINVAL;
+}
+
+#endif /* CONFIG_NET_CHKSUM_COPY */
+
 /****************************************************************************
  * Name: net_chksum
  *
@@ -35,6 +35,71 @@
 
 #ifdef CONFIG_NET
 
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* The transport header in front of a cached payload sum.  It must hold
+ * the checksum field, which is why devif_send() of a whole ICMPv6 message
+ * does not qualify.
+ */
+
+#define UPPERLAYER_MIN_HDRLEN 8
+#define UPPERLAYER_MAX_HDRLEN 60
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: upperlayer_payload_chksum
+ *
+ * Description:
+ *   Sum the transport header and payload that start at offset in the
+ *   device buffer.  If the payload was summed while it was copied in, only
+ *   the transport header in front of it is read here.
+ *
+ ****************************************************************************/
+
+#if !defined(CONFIG_NET_ARCH_CHKSUM) && defined(CONFIG_MM_IOB)
+static uint16_t upperlayer_payload_chksum(FAR struct net_driver_s *dev,
+                                          unsigned int offset, uint16_t sum)
+{
+#ifdef CONFIG_NET_CHKSUM_COPY
+  uint8_t hdr[UPPERLAYER_MAX_HDRLEN];
+  unsigned int hdrlen;
+
+  if (dev->d_sndsumlen != 0 && dev->d_sndsumlen == dev->d_sndlen &&
+      dev->d_iob->io_pktlen >= offset + dev->d_sndlen)
+    {
+      hdrlen = dev->d_iob->io_pktlen - offset - dev->d_sndlen;
+
+      /* The cached sum is used once, it does not follow later changes of
+       * the payload.
+       */
+
+      dev->d_sndsumlen = 0;
+
+      if ((hdrlen & 1) == 0 && hdrlen >= UPPERLAYER_MIN_HDRLEN &&
+          hdrlen <= UPPERLAYER_MAX_HDRLEN &&
+          iob_copyout(hdr, dev->d_iob, hdrlen, offset) == hdrlen)
+        {
+          sum = chksum(sum, hdr, hdrlen);
+          sum += dev->d_sndsum;
+          if (sum < dev->d_sndsum)
+            {
+              sum++; /* carry */
+            }
+
+          return sum;
+        }
+    }
+#endif
+
+  return chksum_iob(sum, dev->d_iob, offset);
+}
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -119,7 +184,7 @@ uint16_t ipv4_upperlayer_payload_chksum(FAR struct net_driver_s *dev,
 
   /* Sum IP payload data. */
 
-  return chksum_iob(sum, dev->d_iob, iphdrlen);
+  return upperlayer_payload_chksum(dev, iphdrlen, sum);
 }
 
 /****************************************************************************
@@ -236,7 +301,7 @@ uint16_t ipv6_upperlayer_payload_chksum(FAR struct net_driver_s *dev,
 {
   /* Sum IP payload data. */
 
-  return chksum_iob(sum, dev->d_iob, iplen);
+  return upperlayer_payload_chksum(dev, iplen, sum);
 }
 
 /****************************************************************************
@@ -418,6 +418,14 @@ void nxsched_suspend_critmon(FAR struct tcb_s *tcb);
 void nxsched_update_critmon(FAR struct tcb_s *tcb);
 #endif
 
+/* Scheduler latency statistics */
+
+#ifdef CONFIG_SCHED_SCHEDSTAT
+void nxsched_schedstat_wakeup(FAR struct tcb_s *tcb);
+void nxsched_schedstat_resume(FAR struct tcb_s *tcb);
+void nxsched_schedstat_suspend(FAR struct tcb_s *tcb);
+#endif
+
 #if CONFIG_SCHED_CRITMONITOR_MAXTIME_PREEMPTION >= 0
 void nxsched_critmon_preemption(FAR struct tcb_s *tcb, bool state,
                                 FAR void *caller);
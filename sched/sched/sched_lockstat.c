@@ -0,0 +1,808 @@
+/****************************************************************************
+ * sched/sched/sched_lockstat.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/param.h>
+#include <sys/stat.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <fcntl.h>
+#include <string.h>
+#include <assert.h>
+#include <debug.h>
+#include <errno.h>
+
+#include <nuttx/allsyms.h>
+#include <nuttx/clock.h>
+#include <nuttx/irq.h>
+#include <nuttx/kmalloc.h>
+#include <nuttx/semaphore.h>
+#include <nuttx/spinlock.h>
+#include <nuttx/symtab.h>
+#include <nuttx/fs/fs.h>
+#include <nuttx/fs/procfs.h>
+
+#include "sched/sched.h"
+#include "semaphore/semaphore.h"
+
+#ifdef CONFIG_SCHED_LOCKSTAT
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define LOCKSTAT_NSITES   CONFIG_SCHED_LOCKSTAT_NSITES
+#define LOCKSTAT_NHELD    CONFIG_SCHED_LOCKSTAT_NHELD
+
+/* Frames searched to step over nxmutex_lock() and friends when a mutex is
+ * taken, so that the reported site is the caller of the mutex API.
+ */
+
+#define LOCKSTAT_UNWIND   6
+
+/* spin_lock_irqsave(NULL) takes the global g_irq_spin */
+
+#define LOCKSTAT_SPINKEY(l) \
+  ((l) != NULL ? (FAR const void *)(l) : (FAR const void *)&g_irq_spin)
+
+/* Determines the size of an intermediate buffer that must be large enough
+ * to handle the longest line generated by this logic.
+ */
+
+#define LOCKSTAT_LINELEN  160
+
+/* Output format:
+ *
+ *   TYPE LOCK SITE CONTENDED ACQUIRED WAITTOTAL WAITMAX HOLDMAX
+ *
+ * All times are in microseconds.
+ */
+
+#define HDR_FMT "%-5s %-18s %-40s %10s %10s %12s %10s %10s\n"
+#define ENT_FMT "%-5s %-18p %-40s %10" PRIu32 " %10" PRIu32 \
+                " %12lu %10lu %10lu\n"
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+enum lockstat_type_e
+{
+  LOCKSTAT_SPIN = 1,                  /* spinlock_t */
+  LOCKSTAT_SEM,                       /* Counting semaphore */
+  LOCKSTAT_MUTEX                      /* Semaphore used as a mutex */
+};
+
+/* Statistics of one lock acquired from one call site */
+
+struct lockstat_entry_s
+{
+  FAR const void *lock;               /* Lock address, the table key */
+  FAR void *site;                     /* Call site, the table key */
+  uint8_t   type;                     /* See enum lockstat_type_e */
+  uint32_t  nacquired;                /* Number of acquisitions */
+  uint32_t  ncontended;               /* Acquisitions that had to wait */
+  clock_t   wait_total;               /* Accumulated wait time */
+  clock_t   wait_max;                 /* Longest wait */
+  clock_t   hold_max;                 /* Longest hold */
+};
+
+/* This structure describes one open "file" */
+
+struct lockstat_file_s
+{
+  struct procfs_file_s base;          /* Base open file structure */
+  FAR struct lockstat_entry_s *snap;  /* Sorted copy of the table */
+  size_t   nsnap;                     /* Number of entries in snap[] */
+  char     line[LOCKSTAT_LINELEN];    /* Buffer for formatted lines */
+};
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+/* File system methods */
+
+#if !defined(CONFIG_DISABLE_MOUNTPOINT) && defined(CONFIG_FS_PROCFS)
+static int     lockstat_open(FAR struct file *filep, FAR const char *relpath,
+                             int oflags, mode_t mode);
+static int     lockstat_close(FAR struct file *filep);
+static ssize_t lockstat_read(FAR struct file *filep, FAR char *buffer,
+                             size_t buflen);
+static ssize_t lockstat_write(FAR struct file *filep, FAR const char *buffer,
+                              size_t buflen);
+static int     lockstat_dup(FAR const struct file *oldp,
+                            FAR struct file *newp);
+static int     lockstat_stat(FAR const char *relpath, FAR struct stat *buf);
+#endif
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static struct lockstat_entry_s g_lockstat[LOCKSTAT_NSITES];
+static spinlock_t g_lockstat_lock = SP_UNLOCKED;
+static uint32_t g_lockstat_dropped;
+
+static FAR const char * const g_lockstat_names[] =
+{
+  "", "spin", "sem", "mutex"
+};
+
+#ifdef CONFIG_SPINLOCK
+/* Spinlocks do not sleep, so the ones held are tracked per CPU */
+
+static struct lockstat_held_s g_lockstat_spin[CONFIG_SMP_NCPUS]
+                                             [LOCKSTAT_NHELD];
+#endif
+
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+/* See fs_mount.c -- this structure is explicitly extern'ed there.
+ * We use the old-fashioned kind of initializers so that this will compile
+ * with any compiler.
+ */
+
+#if !defined(CONFIG_DISABLE_MOUNTPOINT) && defined(CONFIG_FS_PROCFS)
+const struct procfs_operations g_lockstat_operations =
+{
+  lockstat_open,       /* open */
+  lockstat_close,      /* close */
+  lockstat_read,       /* read */
+  lockstat_write,      /* write */
+  NULL,                /* poll */
+
+  lockstat_dup,        /* dup */
+
+  NULL,                /* opendir */
+  NULL,                /* closedir */
+  NULL,                /* readdir */
+  NULL,                /* rewinddir */
+
+  lockstat_stat        /* stat */
+};
+#endif
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: lockstat_find
+ *
+ * Description:
+ *   Return the entry for (lock, site), allocating a free one when the pair
+ *   is new.  Must be called with g_lockstat_lock held.
+ *
+ ****************************************************************************/
+
+static FAR struct lockstat_entry_s *
+lockstat_find(FAR const void *lock, FAR void *site, uint8_t type)
+{
+  FAR struct lockstat_entry_s *entry;
+  uintptr_t hash;
+  int i;
+
+  hash = ((uintptr_t)lock >> 2) * 2654435761u ^ ((uintptr_t)site >> 1);
+
+  for (i = 0; i < LOCKSTAT_NSITES; i++)
+    {
+      entry = &g_lockstat[(hash + i) % LOCKSTAT_NSITES];
+      if (entry->lock == lock && entry->site == site)
+        {
+          return entry;
+        }
+      else if (entry->type == 0)
+        {
+          entry->lock = lock;
+          entry->site = site;
+          entry->type = type;
+          return entry;
+        }
+    }
+
+  g_lockstat_dropped++;
+  return NULL;
+}
+
+/****************************************************************************
+ * Name: lockstat_acquired
+ ****************************************************************************/
+
+static void lockstat_acquired(FAR const void *lock, FAR void *site,
+                              uint8_t type, bool contended, clock_t wait)
+{
+  FAR struct lockstat_entry_s *entry;
+  irqstate_t flags;
+
+  flags = spin_lock_irqsave_wo_note(&g_lockstat_lock);
+  entry = lockstat_find(lock, site, type);
+  if (entry != NULL)
+    {
+      entry->nacquired++;
+      if (contended)
+        {
+          entry->ncontended++;
+          entry->wait_total += wait;
+          if (wait > entry->wait_max)
+            {
+              entry->wait_max = wait;
+            }
+        }
+    }
+
+  spin_unlock_irqrestore_wo_note(&g_lockstat_lock, flags);
+}
+
+/****************************************************************************
+ * Name: lockstat_released
+ ****************************************************************************/
+
+static void lockstat_released(FAR struct lockstat_held_s *held,
+                              uint8_t type, clock_t now)
+{
+  FAR struct lockstat_entry_s *entry;
+  irqstate_t flags;
+  clock_t hold = now - held->start;
+
+  flags = spin_lock_irqsave_wo_note(&g_lockstat_lock);
+  entry = lockstat_find(held->lock, held->site, type);
+  if (entry != NULL && hold > entry->hold_max)
+    {
+      entry->hold_max = hold;
+    }
+
+  spin_unlock_irqrestore_wo_note(&g_lockstat_lock, flags);
+  held->lock = NULL;
+}
+
+/****************************************************************************
+ * Name: lockstat_held_find
+ *
+ * Description:
+ *   Find the innermost slot holding 'lock', or a free slot if 'lock' is
+ *   NULL.
+ *
+ ****************************************************************************/
+
+static FAR struct lockstat_held_s *
+lockstat_held_find(FAR struct lockstat_held_s *held, FAR const void *lock)
+{
+  int i;
+
+  for (i = LOCKSTAT_NHELD - 1; i >= 0; i--)
+    {
+      if (held[i].lock == lock)
+        {
+          return &held[i];
+        }
+    }
+
+  return NULL;
+}
+
+/****************************************************************************
+ * Name: lockstat_sem_site
+ *
+ * Description:
+ *   nxsem_wait() records its own caller.  For mutexes that caller is the
+ *   mutex wrapper, so walk one frame further up when a backtrace is
+ *   available.
+ *
+ ****************************************************************************/
+
+static FAR void *lockstat_sem_site(FAR struct tcb_s *rtcb, FAR sem_t *sem)
+{
+  FAR void *caller = rtcb->lockstat_site;
+#ifdef CONFIG_SCHED_BACKTRACE
+  FAR void *frames[LOCKSTAT_UNWIND];
+  int n;
+  int i;
+
+  if ((sem->flags & SEM_TYPE_MUTEX) != 0 && caller != NULL)
+    {
+      n = sched_backtrace(rtcb->pid, frames, LOCKSTAT_UNWIND, 0);
+      for (i = 0; i < n - 1; i++)
+        {
+          if (frames[i] == caller)
+            {
+              return frames[i + 1];
+            }
+        }
+    }
+#endif
+
+  return caller;
+}
+
+#if !defined(CONFIG_DISABLE_MOUNTPOINT) && defined(CONFIG_FS_PROCFS)
+
+/****************************************************************************
+ * Name: lockstat_compare
+ *
+ * Description:
+ *   Sort by total wait time, then by the longest hold, both descending.
+ *
+ ****************************************************************************/
+
+static int lockstat_compare(FAR const void *a, FAR const void *b)
+{
+  FAR const struct lockstat_entry_s *ea = a;
+  FAR const struct lockstat_entry_s *eb = b;
+
+  if (ea->wait_total != eb->wait_total)
+    {
+      return ea->wait_total > eb->wait_total ? -1 : 1;
+    }
+
+  if (ea->hold_max != eb->hold_max)
+    {
+      return ea->hold_max > eb->hold_max ? -1 : 1;
+    }
+
+  return 0;
+}
+
+/****************************************************************************
+ * Name: lockstat_usec
+ ****************************************************************************/
+
+static unsigned long lockstat_usec(clock_t elapsed)
+{
+  struct timespec ts;
+
+  perf_convert(elapsed, &ts);
+  return ts.tv_sec * USEC_PER_SEC + ts.tv_nsec / NSEC_PER_USEC;
+}
+
+/****************************************************************************
+ * Name: lockstat_site_name
+ ****************************************************************************/
+
+static FAR const char *lockstat_site_name(FAR void *site, FAR char *buf,
+                                          size_t len)
+{
+#ifdef CONFIG_ALLSYMS
+  FAR const struct symtab_s *symbol;
+  size_t symbolsize;
+
+  symbol = allsyms_findbyvalue(site, &symbolsize);
+  if (symbol != NULL)
+    {
+      snprintf(buf, len, "%s+0x%zx", symbol->sym_name,
+               (size_t)((uintptr_t)site - (uintptr_t)symbol->sym_value));
+      return buf;
+    }
+#endif
+
+  snprintf(buf, len, "%p", site);
+  return buf;
+}
+
+/****************************************************************************
+ * Name: lockstat_open
+ ****************************************************************************/
+
+static int lockstat_open(FAR struct file *filep, FAR const char *relpath,
+                         int oflags, mode_t mode)
+{
+  FAR struct lockstat_file_s *priv;
+  irqstate_t flags;
+  size_t i;
+
+  finfo("Open '%s'\n", relpath);
+
+  /* Allocate a container to hold the file attributes */
+
+  priv = kmm_zalloc(sizeof(struct lockstat_file_s));
+  if (priv == NULL)
+    {
+      ferr("ERROR: Failed to allocate file attributes\n");
+      return -ENOMEM;
+    }
+
+  /* Take a sorted snapshot so that partial reads see consistent data */
+
+  if ((oflags & O_RDONLY) != 0)
+    {
+      priv->snap = kmm_malloc(sizeof(g_lockstat));
+      if (priv->snap == NULL)
+        {
+          kmm_free(priv);
+          return -ENOMEM;
+        }
+
+      flags = spin_lock_irqsave_wo_note(&g_lockstat_lock);
+      for (i = 0; i < LOCKSTAT_NSITES; i++)
+        {
+          if (g_lockstat[i].type != 0)
+            {
+              priv->snap[priv->nsnap++] = g_lockstat[i];
+            }
+        }
+
+      spin_unlock_irqrestore_wo_note(&g_lockstat_lock, flags);
+
+      qsort(priv->snap, priv->nsnap, sizeof(struct lockstat_entry_s),
+            lockstat_compare);
+    }
+
+  /* Save the attributes as the open-specific state in filep->f_priv */
+
+  filep->f_priv = priv;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: lockstat_close
+ ****************************************************************************/
+
+static int lockstat_close(FAR struct file *filep)
+{
+  FAR struct lockstat_file_s *priv;
+
+  /* Recover our private data from the struct file instance */
+
+  priv = filep->f_priv;
+  DEBUGASSERT(priv);
+
+  /* Release the file attributes structure */
+
+  kmm_free(priv->snap);
+  kmm_free(priv);
+  filep->f_priv = NULL;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: lockstat_read
+ ****************************************************************************/
+
+static ssize_t lockstat_read(FAR struct file *filep, FAR char *buffer,
+                             size_t buflen)
+{
+  FAR struct lockstat_file_s *priv;
+  char site[48];
+  size_t linesize;
+  size_t copysize;
+  size_t totalsize;
+  off_t offset;
+  size_t i;
+
+  finfo("buffer=%p buflen=%d\n", buffer, (int)buflen);
+
+  /* Recover our private data from the struct file instance */
+
+  priv = filep->f_priv;
+  DEBUGASSERT(priv);
+
+  offset   = filep->f_pos;
+  linesize = procfs_snprintf(priv->line, LOCKSTAT_LINELEN, HDR_FMT,
+                             "TYPE", "LOCK", "SITE", "CONTENDED",
+                             "ACQUIRED", "WAITTOTAL", "WAITMAX",
+                             "HOLDMAX");
+  copysize = procfs_memcpy(priv->line, linesize, buffer, buflen, &offset);
+  totalsize = copysize;
+
+  for (i = 0; i < priv->nsnap && totalsize < buflen; i++)
+    {
+      FAR struct lockstat_entry_s *entry = &priv->snap[i];
+
+      linesize = procfs_snprintf(priv->line, LOCKSTAT_LINELEN, ENT_FMT,
+                                 g_lockstat_names[entry->type], entry->lock,
+                                 lockstat_site_name(entry->site, site,
+                                                    sizeof(site)),
+                                 entry->ncontended, entry->nacquired,
+                                 lockstat_usec(entry->wait_total),
+                                 lockstat_usec(entry->wait_max),
+                                 lockstat_usec(entry->hold_max));
+      copysize = procfs_memcpy(priv->line, linesize, buffer + totalsize,
+                               buflen - totalsize, &offset);
+      totalsize += copysize;
+    }
+
+  if (i == priv->nsnap && totalsize < buflen && g_lockstat_dropped > 0)
+    {
+      linesize = procfs_snprintf(priv->line, LOCKSTAT_LINELEN,
+                                 "dropped %" PRIu32 "\n",
+                                 g_lockstat_dropped);
+      copysize = procfs_memcpy(priv->line, linesize, buffer + totalsize,
+                               buflen - totalsize, &offset);
+      totalsize += copysize;
+    }
+
+  /* Update the file offset */
+
+  filep->f_pos += totalsize;
+  return totalsize;
+}
+
+/****************************************************************************
+ * Name: lockstat_write
+ *
+ * Description:
+ *   Writing "reset" clears all of the collected statistics.
+ *
+ ****************************************************************************/
+
+static ssize_t lockstat_write(FAR struct file *filep, FAR const char *buffer,
+                              size_t buflen)
+{
+  irqstate_t flags;
+
+  if (buflen < 5 || strncmp(buffer, "reset", 5) != 0)
+    {
+      return -EINVAL;
+    }
+
+  flags = spin_lock_irqsave_wo_note(&g_lockstat_lock);
+  memset(g_lockstat, 0, sizeof(g_lockstat));
+  g_lockstat_dropped = 0;
+  spin_unlock_irqrestore_wo_note(&g_lockstat_lock, flags);
+
+  return buflen;
+}
+
+/****************************************************************************
+ * Name: lockstat_dup
+ *
+ * Description:
+ *   Duplicate open file data in the new file structure.
+ *
+ ****************************************************************************/
+
+static int lockstat_dup(FAR const struct file *oldp, FAR struct file *newp)
+{
+  FAR struct lockstat_file_s *oldpriv;
+  FAR struct lockstat_file_s *newpriv;
+
+  finfo("Dup %p->%p\n", oldp, newp);
+
+  /* Recover our private data from the old struct file instance */
+
+  oldpriv = oldp->f_priv;
+  DEBUGASSERT(oldpriv);
+
+  /* Allocate a new container to hold the task and attribute selection */
+
+  newpriv = kmm_zalloc(sizeof(struct lockstat_file_s));
+  if (newpriv == NULL)
+    {
+      ferr("ERROR: Failed to allocate file attributes\n");
+      return -ENOMEM;
+    }
+
+  /* The copy the file attributes from the old attributes to the new */
+
+  if (oldpriv->snap != NULL)
+    {
+      newpriv->snap = kmm_malloc(sizeof(g_lockstat));
+      if (newpriv->snap == NULL)
+        {
+          kmm_free(newpriv);
+          return -ENOMEM;
+        }
+
+      memcpy(newpriv->snap, oldpriv->snap,
+             oldpriv->nsnap * sizeof(struct lockstat_entry_s));
+      newpriv->nsnap = oldpriv->nsnap;
+    }
+
+  /* Save the new attributes in the new file structure */
+
+  newp->f_priv = newpriv;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: lockstat_stat
+ *
+ * Description: Return information about a file or directory
+ *
+ ****************************************************************************/
+
+static int lockstat_stat(FAR const char *relpath, FAR struct stat *buf)
+{
+  memset(buf, 0, sizeof(struct stat));
+  buf->st_mode = S_IFREG | S_IROTH | S_IRGRP | S_IRUSR | S_IWUSR;
+  return OK;
+}
+
+#endif /* !CONFIG_DISABLE_MOUNTPOINT && CONFIG_FS_PROCFS */
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: nxsched_lockstat_sem_acquire
+ *
+ * Description:
+ *   Called when the current task obtains a semaphore.  Records the wait,
+ *   if there was one, and starts timing the hold of a mutex.
+ *
+ * Input Parameters:
+ *   sem       - The semaphore that was obtained
+ *   contended - True if the task had to block
+ *   wait      - Time blocked, in perf_gettime() units
+ *
+ ****************************************************************************/
+
+void nxsched_lockstat_sem_acquire(FAR sem_t *sem, bool contended,
+                                  clock_t wait)
+{
+  FAR struct tcb_s *rtcb = this_task();
+  FAR struct lockstat_held_s *held;
+  bool mutex = (sem->flags & SEM_TYPE_MUTEX) != 0;
+  FAR void *site;
+
+  if ((!contended && !mutex) || up_interrupt_context())
+    {
+      return;
+    }
+
+  site = lockstat_sem_site(rtcb, sem);
+  lockstat_acquired(sem, site, mutex ? LOCKSTAT_MUTEX : LOCKSTAT_SEM,
+                    contended, wait);
+
+  if (mutex)
+    {
+      held = lockstat_held_find(rtcb->lockstat_held, NULL);
+      if (held != NULL)
+        {
+          held->lock      = sem;
+          held->site      = site;
+          held->start     = perf_gettime();
+          held->contended = contended;
+        }
+    }
+}
+
+/****************************************************************************
+ * Name: nxsched_lockstat_sem_release
+ *
+ * Description:
+ *   Called when the current task posts a semaphore.  Completes the hold
+ *   time measurement if the task is known to hold it as a mutex.
+ *
+ ****************************************************************************/
+
+void nxsched_lockstat_sem_release(FAR sem_t *sem)
+{
+  FAR struct lockstat_held_s *held;
+
+  if ((sem->flags & SEM_TYPE_MUTEX) == 0 || up_interrupt_context())
+    {
+      return;
+    }
+
+  held = lockstat_held_find(this_task()->lockstat_held, sem);
+  if (held != NULL)
+    {
+      lockstat_released(held, LOCKSTAT_MUTEX, perf_gettime());
+    }
+}
+
+#ifdef CONFIG_SPINLOCK
+
+/****************************************************************************
+ * Name: nxsched_lockstat_spin_lock
+ *
+ * Description:
+ *   Called from the spinlock primitives before trying to take 'spinlock'.
+ *   The return address of this function identifies the call site, since
+ *   the primitives themselves are always inlined.
+ *
+ ****************************************************************************/
+
+void nxsched_lockstat_spin_lock(FAR volatile spinlock_t *spinlock)
+{
+  FAR struct lockstat_held_s *held;
+  irqstate_t flags;
+
+  flags = up_irq_save();
+  held  = lockstat_held_find(g_lockstat_spin[this_cpu()], NULL);
+  if (held != NULL)
+    {
+      held->lock      = LOCKSTAT_SPINKEY(spinlock);
+      held->site      = return_address(0);
+      held->contended = spin_is_locked((FAR volatile spinlock_t *)
+                                       held->lock);
+      held->start     = perf_gettime();
+    }
+
+  up_irq_restore(flags);
+}
+
+/****************************************************************************
+ * Name: nxsched_lockstat_spin_locked
+ ****************************************************************************/
+
+void nxsched_lockstat_spin_locked(FAR volatile spinlock_t *spinlock)
+{
+  FAR struct lockstat_held_s *held;
+  irqstate_t flags;
+  clock_t now;
+
+  flags = up_irq_save();
+  held  = lockstat_held_find(g_lockstat_spin[this_cpu()],
+                             LOCKSTAT_SPINKEY(spinlock));
+  if (held != NULL)
+    {
+      now = perf_gettime();
+      lockstat_acquired(held->lock, held->site, LOCKSTAT_SPIN,
+                        held->contended, now - held->start);
+      held->start = now;
+    }
+
+  up_irq_restore(flags);
+}
+
+/****************************************************************************
+ * Name: nxsched_lockstat_spin_abort
+ ****************************************************************************/
+
+void nxsched_lockstat_spin_abort(FAR volatile spinlock_t *spinlock)
+{
+  FAR struct lockstat_held_s *held;
+  irqstate_t flags;
+
+  flags = up_irq_save();
+  held  = lockstat_held_find(g_lockstat_spin[this_cpu()],
+                             LOCKSTAT_SPINKEY(spinlock));
+  if (held != NULL)
+    {
+      held->lock = NULL;
+    }
+
+  up_irq_restore(flags);
+}
+
+/****************************************************************************
+ * Name: nxsched_lockstat_spin_unlock
+ ****************************************************************************/
+
+void nxsched_lockstat_spin_unlock(FAR volatile spinlock_t *spinlock)
+{
+  FAR struct lockstat_held_s *held;
+  irqstate_t flags;
+
+  flags = up_irq_save();
+  held  = lockstat_held_find(g_lockstat_spin[this_cpu()],
+                             LOCKSTAT_SPINKEY(spinlock));
+  if (held != NULL)
+    {
+      lockstat_released(held, LOCKSTAT_SPIN, perf_gettime());
+    }
+
+  up_irq_restore(flags);
+}
+
+#endif /* CONFIG_SPINLOCK */
+#endif /* CONFIG_SCHED_LOCKSTAT */
@@ -79,4 +79,10 @@ void nxsched_remove_blocked(FAR struct tcb_s *btcb)
    */
 
   btcb->task_state = TSTATE_TASK_INVALID;
+
+#ifdef CONFIG_SCHED_SCHEDSTAT
+  /* Start timing the wakeup latency */
+
+  nxsched_schedstat_wakeup(btcb);
+#endif
 }
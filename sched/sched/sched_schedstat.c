@@ -0,0 +1,499 @@
+/****************************************************************************
+ * sched/sched/sched_schedstat.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/stat.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <strings.h>
+#include <fcntl.h>
+#include <assert.h>
+#include <debug.h>
+#include <errno.h>
+
+#include <nuttx/clock.h>
+#include <nuttx/irq.h>
+#include <nuttx/kmalloc.h>
+#include <nuttx/fs/fs.h>
+#include <nuttx/fs/procfs.h>
+
+#include "sched/sched.h"
+
+#ifdef CONFIG_SCHED_SCHEDSTAT
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define SCHEDSTAT_NBUCKETS CONFIG_SCHED_SCHEDSTAT_NBUCKETS
+
+/* Determines the size of an intermediate buffer that must be large enough
+ * to handle the longest line generated by this logic.
+ */
+
+#define SCHEDLAT_LINELEN   (16 + 11 * SCHEDSTAT_NBUCKETS)
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* This structure describes one open "file" */
+
+struct schedlat_file_s
+{
+  struct procfs_file_s base;                /* Base open file structure */
+  struct schedstat_s cpu[CONFIG_SMP_NCPUS]; /* Statistics snapshot */
+  char line[SCHEDLAT_LINELEN];              /* Buffer for formatted lines */
+};
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+/* File system methods */
+
+#if !defined(CONFIG_DISABLE_MOUNTPOINT) && defined(CONFIG_FS_PROCFS)
+static int     schedlat_open(FAR struct file *filep, FAR const char *relpath,
+                             int oflags, mode_t mode);
+static int     schedlat_close(FAR struct file *filep);
+static ssize_t schedlat_read(FAR struct file *filep, FAR char *buffer,
+                             size_t buflen);
+static ssize_t schedlat_write(FAR struct file *filep, FAR const char *buffer,
+                              size_t buflen);
+static int     schedlat_dup(FAR const struct file *oldp,
+                            FAR struct file *newp);
+static int     schedlat_stat(FAR const char *relpath, FAR struct stat *buf);
+#endif
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* Statistics of all non-idle tasks, by the CPU they ran on.  Each CPU only
+ * updates its own entry, from the context switch path.
+ */
+
+static struct schedstat_s g_schedstat[CONFIG_SMP_NCPUS];
+
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+/* See fs_mount.c -- this structure is explicitly extern'ed there.
+ * We use the old-fashioned kind of initializers so that this will compile
+ * with any compiler.
+ */
+
+#if !defined(CONFIG_DISABLE_MOUNTPOINT) && defined(CONFIG_FS_PROCFS)
+const struct procfs_operations g_schedlat_operations =
+{
+  schedlat_open,       /* open */
+  schedlat_close,      /* close */
+  schedlat_read,       /* read */
+  schedlat_write,      /* write */
+  NULL,                /* poll */
+
+  schedlat_dup,        /* dup */
+
+  NULL,                /* opendir */
+  NULL,                /* closedir */
+  NULL,                /* readdir */
+  NULL,                /* rewinddir */
+
+  schedlat_stat        /* stat */
+};
+#endif
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: schedstat_account
+ *
+ * Description:
+ *   Add one sample of elapsed perf_gettime() units to a histogram.
+ *
+ ****************************************************************************/
+
+static void schedstat_account(FAR uint32_t *hist, clock_t elapsed)
+{
+  uint64_t usec = (uint64_t)elapsed * USEC_PER_SEC / perf_getfreq();
+  int bucket = flsll(usec);
+
+  if (bucket >= SCHEDSTAT_NBUCKETS)
+    {
+      bucket = SCHEDSTAT_NBUCKETS - 1;
+    }
+
+  hist[bucket]++;
+}
+
+#if !defined(CONFIG_DISABLE_MOUNTPOINT) && defined(CONFIG_FS_PROCFS)
+
+/****************************************************************************
+ * Name: schedlat_hist
+ *
+ * Description:
+ *   Format one histogram as a single line of bucket counts.
+ *
+ ****************************************************************************/
+
+static size_t schedlat_hist(FAR char *line, FAR const char *name,
+                            FAR const uint32_t *hist)
+{
+  size_t linesize;
+  int i;
+
+  linesize = procfs_snprintf(line, SCHEDLAT_LINELEN, "%-9s", name);
+  for (i = 0; i < SCHEDSTAT_NBUCKETS; i++)
+    {
+      linesize += procfs_snprintf(line + linesize,
+                                  SCHEDLAT_LINELEN - linesize,
+                                  " %" PRIu32, hist[i]);
+    }
+
+  linesize += procfs_snprintf(line + linesize, SCHEDLAT_LINELEN - linesize,
+                              "\n");
+  return linesize;
+}
+
+/****************************************************************************
+ * Name: schedlat_open
+ ****************************************************************************/
+
+static int schedlat_open(FAR struct file *filep, FAR const char *relpath,
+                         int oflags, mode_t mode)
+{
+  FAR struct schedlat_file_s *priv;
+  irqstate_t flags;
+
+  finfo("Open '%s'\n", relpath);
+
+  /* Allocate a container to hold the file attributes */
+
+  priv = kmm_zalloc(sizeof(struct schedlat_file_s));
+  if (priv == NULL)
+    {
+      ferr("ERROR: Failed to allocate file attributes\n");
+      return -ENOMEM;
+    }
+
+  /* Take a snapshot so that partial reads see consistent data */
+
+  flags = enter_critical_section();
+  memcpy(priv->cpu, g_schedstat, sizeof(g_schedstat));
+  leave_critical_section(flags);
+
+  /* Save the attributes as the open-specific state in filep->f_priv */
+
+  filep->f_priv = priv;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: schedlat_close
+ ****************************************************************************/
+
+static int schedlat_close(FAR struct file *filep)
+{
+  FAR struct schedlat_file_s *priv;
+
+  /* Recover our private data from the struct file instance */
+
+  priv = filep->f_priv;
+  DEBUGASSERT(priv);
+
+  /* Release the file attributes structure */
+
+  kmm_free(priv);
+  filep->f_priv = NULL;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: schedlat_read
+ *
+ * Description:
+ *   Output, for every CPU, the exact busy time and number of switches to
+ *   non-idle tasks, followed by the wakeup, runnable wait and time slice
+ *   histograms.
+ *
+ ****************************************************************************/
+
+static ssize_t schedlat_read(FAR struct file *filep, FAR char *buffer,
+                             size_t buflen)
+{
+  FAR struct schedlat_file_s *priv;
+  FAR struct schedstat_s *stat;
+  struct timespec busy;
+  size_t linesize;
+  size_t copysize;
+  size_t totalsize;
+  off_t offset;
+  int cpu;
+
+  finfo("buffer=%p buflen=%d\n", buffer, (int)buflen);
+
+  /* Recover our private data from the struct file instance */
+
+  priv = filep->f_priv;
+  DEBUGASSERT(priv);
+
+  offset    = filep->f_pos;
+  totalsize = 0;
+
+  for (cpu = 0; cpu < CONFIG_SMP_NCPUS && totalsize < buflen; cpu++)
+    {
+      stat = &priv->cpu[cpu];
+      perf_convert(stat->run_time, &busy);
+
+      linesize = procfs_snprintf(priv->line, SCHEDLAT_LINELEN,
+                                 "CPU%d busy %lu.%09lu switches %" PRIu32
+                                 "\n", cpu, (unsigned long)busy.tv_sec,
+                                 (unsigned long)busy.tv_nsec,
+                                 stat->nswitch);
+      copysize = procfs_memcpy(priv->line, linesize, buffer + totalsize,
+                               buflen - totalsize, &offset);
+      totalsize += copysize;
+
+      linesize = schedlat_hist(priv->line, "wakeup", stat->wakeup);
+      copysize = procfs_memcpy(priv->line, linesize, buffer + totalsize,
+                               buflen - totalsize, &offset);
+      totalsize += copysize;
+
+      linesize = schedlat_hist(priv->line, "wait", stat->wait);
+      copysize = procfs_memcpy(priv->line, linesize, buffer + totalsize,
+                               buflen - totalsize, &offset);
+      totalsize += copysize;
+
+      linesize = schedlat_hist(priv->line, "slice", stat->slice);
+      copysize = procfs_memcpy(priv->line, linesize, buffer + totalsize,
+                               buflen - totalsize, &offset);
+      totalsize += copysize;
+    }
+
+  /* Update the file offset */
+
+  filep->f_pos += totalsize;
+  return totalsize;
+}
+
+/****************************************************************************
+ * Name: schedlat_write
+ *
+ * Description:
+ *   Writing "reset" clears the per-CPU statistics.
+ *
+ ****************************************************************************/
+
+static ssize_t schedlat_write(FAR struct file *filep, FAR const char *buffer,
+                              size_t buflen)
+{
+  irqstate_t flags;
+
+  if (buflen < 5 || strncmp(buffer, "reset", 5) != 0)
+    {
+      return -EINVAL;
+    }
+
+  flags = enter_critical_section();
+  memset(g_schedstat, 0, sizeof(g_schedstat));
+  leave_critical_section(flags);
+  return buflen;
+}
+
+/****************************************************************************
+ * Name: schedlat_dup
+ *
+ * Description:
+ *   Duplicate open file data in the new file structure.
+ *
+ ****************************************************************************/
+
+static int schedlat_dup(FAR const struct file *oldp, FAR struct file *newp)
+{
+  FAR struct schedlat_file_s *oldpriv;
+  FAR struct schedlat_file_s *newpriv;
+
+  finfo("Dup %p->%p\n", oldp, newp);
+
+  /* Recover our private data from the old struct file instance */
+
+  oldpriv = oldp->f_priv;
+  DEBUGASSERT(oldpriv);
+
+  /* Allocate a new container to hold the task and attribute selection */
+
+  newpriv = kmm_malloc(sizeof(struct schedlat_file_s));
+  if (newpriv == NULL)
+    {
+      ferr("ERROR: Failed to allocate file attributes\n");
+      return -ENOMEM;
+    }
+
+  /* The copy the file attributes from the old attributes to the new */
+
+  memcpy(newpriv, oldpriv, sizeof(struct schedlat_file_s));
+
+  /* Save the new attributes in the new file structure */
+
+  newp->f_priv = newpriv;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: schedlat_stat
+ *
+ * Description: Return information about a file or directory
+ *
+ ****************************************************************************/
+
+static int schedlat_stat(FAR const char *relpath, FAR struct stat *buf)
+{
+  memset(buf, 0, sizeof(struct stat));
+  buf->st_mode = S_IFREG | S_IROTH | S_IRGRP | S_IRUSR | S_IWUSR;
+  return OK;
+}
+
+#endif /* !CONFIG_DISABLE_MOUNTPOINT && CONFIG_FS_PROCFS */
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: nxsched_schedstat_wakeup
+ *
+ * Description:
+ *   Called when a task is removed from a blocked list to be made ready to
+ *   run.  Starts timing its wakeup latency.
+ *
+ * Assumptions:
+ *   - Called within a critical section.
+ *
+ ****************************************************************************/
+
+void nxsched_schedstat_wakeup(FAR struct tcb_s *tcb)
+{
+  tcb->schedstat.ready_start = perf_gettime();
+  tcb->schedstat.woken       = true;
+}
+
+/****************************************************************************
+ * Name: nxsched_schedstat_resume
+ *
+ * Description:
+ *   Called when a task is switched in.  Accounts the time it has been
+ *   waiting to run and starts timing its time slice.
+ *
+ * Assumptions:
+ *   - Called within a critical section.
+ *   - Might be called from an interrupt handler
+ *
+ ****************************************************************************/
+
+void nxsched_schedstat_resume(FAR struct tcb_s *tcb)
+{
+  FAR struct schedstat_s *stat = &tcb->schedstat;
+  FAR struct schedstat_s *cpustat = &g_schedstat[this_cpu()];
+  clock_t current = perf_gettime();
+  clock_t elapsed;
+
+  stat->run_start = current;
+  stat->nswitch++;
+
+  if (is_idle_task(tcb))
+    {
+      stat->ready_start = 0;
+      return;
+    }
+
+  cpustat->nswitch++;
+
+  /* Tasks that are starting for the first time were never made ready */
+
+  if (stat->ready_start != 0)
+    {
+      elapsed = current - stat->ready_start;
+      schedstat_account(stat->wait, elapsed);
+      schedstat_account(cpustat->wait, elapsed);
+
+      if (stat->woken)
+        {
+          schedstat_account(stat->wakeup, elapsed);
+          schedstat_account(cpustat->wakeup, elapsed);
+        }
+
+      stat->ready_start = 0;
+      stat->woken       = false;
+    }
+}
+
+/****************************************************************************
+ * Name: nxsched_schedstat_suspend
+ *
+ * Description:
+ *   Called when a task is switched out.  Accounts its time slice and, if
+ *   it remains ready to run, starts timing the wait for the CPU.
+ *
+ * Assumptions:
+ *   - Called within a critical section.
+ *   - Might be called from an interrupt handler
+ *
+ ****************************************************************************/
+
+void nxsched_schedstat_suspend(FAR struct tcb_s *tcb)
+{
+  FAR struct schedstat_s *stat = &tcb->schedstat;
+  FAR struct schedstat_s *cpustat = &g_schedstat[this_cpu()];
+  clock_t current = perf_gettime();
+  clock_t elapsed = current - stat->run_start;
+
+  stat->run_time += elapsed;
+  schedstat_account(stat->slice, elapsed);
+
+  if (is_idle_task(tcb))
+    {
+      return;
+    }
+
+  cpustat->run_time += elapsed;
+  schedstat_account(cpustat->slice, elapsed);
+
+  /* Preempted, yielded or round-robined: still ready to run */
+
+  if (tcb->task_state >= TSTATE_TASK_PENDING &&
+      tcb->task_state <= TSTATE_TASK_RUNNING)
+    {
+      stat->ready_start = current;
+      stat->woken       = false;
+    }
+}
+
+#endif /* CONFIG_SCHED_SCHEDSTAT */
@@ -0,0 +1,723 @@
+/****************************************************************************
+ * sched/sched/sched_stackprof.c
+ *
+ * SPDX-License-Identifier: Apache-2.0
+ *
+ * Licensed to the Apache Software Foundation (ASF) under one or more
+ * contributor license agreements.  See the NOTICE file distributed with
+ * this work for additional information regarding copyright ownership.  The
+ * ASF licenses this file to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance with the
+ * License.  You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS, WITHOUT
+ * WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  See the
+ * License for the specific language governing permissions and limitations
+ * under the License.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/param.h>
+#include <sys/stat.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <fcntl.h>
+#include <string.h>
+#include <assert.h>
+#include <debug.h>
+#include <errno.h>
+
+#include <nuttx/allsyms.h>
+#include <nuttx/clock.h>
+#include <nuttx/kmalloc.h>
+#include <nuttx/spinlock.h>
+#include <nuttx/symtab.h>
+#include <nuttx/wdog.h>
+#include <nuttx/fs/fs.h>
+#include <nuttx/fs/procfs.h>
+
+#include "sched/sched.h"
+
+#if !defined(CONFIG_DISABLE_MOUNTPOINT) && defined(CONFIG_FS_PROCFS)
+#ifdef CONFIG_SCHED_STACKPROF
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define STACKPROF_DEPTH     CONFIG_SCHED_STACKPROF_DEPTH
+#define STACKPROF_NENTRIES  CONFIG_SCHED_STACKPROF_NENTRIES
+#define STACKPROF_SKIP      CONFIG_SCHED_STACKPROF_SKIP
+
+/* Bound the work done in interrupt context: a sample whose stack does not
+ * hash into one of the next STACKPROF_MAXPROBE slots is counted as dropped
+ * rather than searched for across the whole table.
+ */
+
+#define STACKPROF_MAXPROBE  8
+
+/* Determines the size of an intermediate buffer that must be large enough
+ * to handle the longest frame or task name generated by this logic.
+ */
+
+#define STACKPROF_LINELEN   96
+
+#define STACKPROF_TICKS(hz) \
+  MAX(NSEC2TICK(NSEC_PER_SEC / (hz)), 1)
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* One unique (task, call stack) pair and the number of times it was seen */
+
+struct stackprof_entry_s
+{
+  uint32_t hash;                     /* Hash of pid and the frames */
+  pid_t    pid;                      /* Task that was running */
+  uint16_t depth;                    /* Number of valid frames, 0 = free */
+  uint32_t count;                    /* Number of samples */
+  FAR void *stack[STACKPROF_DEPTH];  /* Frames, innermost first */
+};
+
+/* Per-CPU sample buffer, only touched by its own CPU while sampling */
+
+struct stackprof_cpu_s
+{
+  spinlock_t lock;                   /* Protects against the reader */
+  uint32_t   nsamples;               /* Total samples taken */
+  uint32_t   ndropped;               /* Samples lost to a full table */
+  struct stackprof_entry_s entries[STACKPROF_NENTRIES];
+};
+
+/* This structure describes one open "file" */
+
+struct stackprof_file_s
+{
+  struct procfs_file_s base;         /* Base open file structure */
+  FAR struct stackprof_entry_s *snap;
+  size_t   nsnap;                    /* Number of entries in snap[] */
+  uint32_t nsamples;                 /* Samples at snapshot time */
+  uint32_t ndropped;                 /* Dropped at snapshot time */
+  FAR char *buffer;                  /* User provided buffer */
+  size_t   remaining;                /* Number of available characters */
+  size_t   ncopied;                  /* Number of characters in buffer */
+  off_t    offset;                   /* Current file offset */
+  char     line[STACKPROF_LINELEN];  /* Buffer for formatted output */
+};
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+/* File system methods */
+
+static int     stackprof_open(FAR struct file *filep,
+                              FAR const char *relpath,
+                              int oflags, mode_t mode);
+static int     stackprof_close(FAR struct file *filep);
+static ssize_t stackprof_read(FAR struct file *filep, FAR char *buffer,
+                              size_t buflen);
+static ssize_t stackprof_write(FAR struct file *filep,
+                               FAR const char *buffer, size_t buflen);
+static int     stackprof_dup(FAR const struct file *oldp,
+                             FAR struct file *newp);
+static int     stackprof_stat(FAR const char *relpath, FAR struct stat *buf);
+
+#ifdef CONFIG_SMP
+static int stackprof_sample_cpu(FAR void *arg);
+#endif
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static struct stackprof_cpu_s g_stackprof[CONFIG_SMP_NCPUS];
+static struct wdog_s g_stackprof_timer;
+static clock_t g_stackprof_ticks;
+static unsigned int g_stackprof_hz = CONFIG_SCHED_STACKPROF_TICKSPERSEC;
+static bool g_stackprof_running;
+
+#ifdef CONFIG_SMP
+static struct smp_call_data_s g_stackprof_call =
+SMP_CALL_INITIALIZER(stackprof_sample_cpu, NULL);
+#endif
+
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+/* See fs_mount.c -- this structure is explicitly extern'ed there.
+ * We use the old-fashioned kind of initializers so that this will compile
+ * with any compiler.
+ */
+
+const struct procfs_operations g_stackprof_operations =
+{
+  stackprof_open,       /* open */
+  stackprof_close,      /* close */
+  stackprof_read,       /* read */
+  stackprof_write,      /* write */
+  NULL,                 /* poll */
+
+  stackprof_dup,        /* dup */
+
+  NULL,                 /* opendir */
+  NULL,                 /* closedir */
+  NULL,                 /* readdir */
+  NULL,                 /* rewinddir */
+
+  stackprof_stat        /* stat */
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: stackprof_hash
+ *
+ * Description:
+ *   FNV-1a hash of the task ID and the return addresses of one sample.
+ *
+ ****************************************************************************/
+
+static uint32_t stackprof_mix(uint32_t hash, uintptr_t value)
+{
+  size_t n;
+
+  for (n = 0; n < sizeof(uintptr_t); n++)
+    {
+      hash ^= (uint8_t)(value >> (n * 8));
+      hash *= 16777619u;
+    }
+
+  return hash;
+}
+
+static uint32_t stackprof_hash(pid_t pid, FAR void **stack, int depth)
+{
+  uint32_t hash = stackprof_mix(2166136261u, (uintptr_t)pid);
+  int i;
+
+  for (i = 0; i < depth; i++)
+    {
+      hash = stackprof_mix(hash, (uintptr_t)stack[i]);
+    }
+
+  return hash;
+}
+
+/****************************************************************************
+ * Name: stackprof_sample_cpu
+ *
+ * Description:
+ *   Take one sample of the task running on this CPU.  Runs in interrupt
+ *   context, either from the watchdog or from an SMP call.
+ *
+ ****************************************************************************/
+
+static int stackprof_sample_cpu(FAR void *arg)
+{
+  FAR struct stackprof_cpu_s *cpu = &g_stackprof[this_cpu()];
+  FAR struct tcb_s *tcb = this_task();
+  FAR struct stackprof_entry_s *entry;
+  FAR void *stack[STACKPROF_DEPTH];
+  irqstate_t flags;
+  uint32_t hash;
+  int depth;
+  int probe;
+
+  depth = sched_backtrace(tcb->pid, stack, STACKPROF_DEPTH, STACKPROF_SKIP);
+  if (depth <= 0)
+    {
+      stack[0] = (FAR void *)up_getusrpc(NULL);
+      depth    = 1;
+    }
+
+  hash  = stackprof_hash(tcb->pid, stack, depth);
+  flags = spin_lock_irqsave(&cpu->lock);
+  cpu->nsamples++;
+
+  for (probe = 0; probe < STACKPROF_MAXPROBE; probe++)
+    {
+      entry = &cpu->entries[(hash + probe) % STACKPROF_NENTRIES];
+      if (entry->depth == 0)
+        {
+          entry->hash  = hash;
+          entry->pid   = tcb->pid;
+          entry->depth = depth;
+          entry->count = 1;
+          memcpy(entry->stack, stack, depth * sizeof(FAR void *));
+          break;
+        }
+      else if (entry->hash == hash && entry->pid == tcb->pid &&
+               entry->depth == depth &&
+               memcmp(entry->stack, stack, depth * sizeof(FAR void *)) == 0)
+        {
+          entry->count++;
+          break;
+        }
+    }
+
+  if (probe == STACKPROF_MAXPROBE)
+    {
+      cpu->ndropped++;
+    }
+
+  spin_unlock_irqrestore(&cpu->lock, flags);
+  return OK;
+}
+
+/****************************************************************************
+ * Name: stackprof_timer
+ ****************************************************************************/
+
+static void stackprof_timer(wdparm_t arg)
+{
+#ifdef CONFIG_SMP
+  cpu_set_t cpus = (1 << CONFIG_SMP_NCPUS) - 1;
+  CPU_CLR(this_cpu(), &cpus);
+  nxsched_smp_call_async(cpus, &g_stackprof_call);
+#endif
+
+  stackprof_sample_cpu(NULL);
+  wd_start(&g_stackprof_timer, g_stackprof_ticks, stackprof_timer, arg);
+}
+
+/****************************************************************************
+ * Name: stackprof_reset
+ ****************************************************************************/
+
+static void stackprof_reset(void)
+{
+  irqstate_t flags;
+  int i;
+
+  for (i = 0; i < CONFIG_SMP_NCPUS; i++)
+    {
+      FAR struct stackprof_cpu_s *cpu = &g_stackprof[i];
+
+      flags = spin_lock_irqsave(&cpu->lock);
+      cpu->nsamples = 0;
+      cpu->ndropped = 0;
+      memset(cpu->entries, 0, sizeof(cpu->entries));
+      spin_unlock_irqrestore(&cpu->lock, flags);
+    }
+}
+
+/****************************************************************************
+ * Name: stackprof_compare
+ *
+ * Description:
+ *   qsort() comparison used to group the snapshot by task and to bring
+ *   identical stacks taken on different CPUs next to each other.
+ *
+ ****************************************************************************/
+
+static int stackprof_compare(FAR const void *a, FAR const void *b)
+{
+  FAR const struct stackprof_entry_s *ea = a;
+  FAR const struct stackprof_entry_s *eb = b;
+
+  if (ea->pid != eb->pid)
+    {
+      return ea->pid < eb->pid ? -1 : 1;
+    }
+
+  if (ea->hash != eb->hash)
+    {
+      return ea->hash < eb->hash ? -1 : 1;
+    }
+
+  if (ea->depth != eb->depth)
+    {
+      return ea->depth < eb->depth ? -1 : 1;
+    }
+
+  return memcmp(ea->stack, eb->stack, ea->depth * sizeof(FAR void *));
+}
+
+/****************************************************************************
+ * Name: stackprof_snapshot
+ *
+ * Description:
+ *   Copy the per-CPU tables into one sorted array with duplicate stacks
+ *   merged.  This keeps the folded output stable across partial reads.
+ *
+ ****************************************************************************/
+
+static int stackprof_snapshot(FAR struct stackprof_file_s *priv)
+{
+  FAR struct stackprof_entry_s *snap;
+  irqstate_t flags;
+  size_t nsnap = 0;
+  size_t i;
+  size_t j;
+
+  snap = kmm_malloc(sizeof(struct stackprof_entry_s) *
+                    STACKPROF_NENTRIES * CONFIG_SMP_NCPUS);
+  if (snap == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  for (i = 0; i < CONFIG_SMP_NCPUS; i++)
+    {
+      FAR struct stackprof_cpu_s *cpu = &g_stackprof[i];
+
+      flags = spin_lock_irqsave(&cpu->lock);
+      priv->nsamples += cpu->nsamples;
+      priv->ndropped += cpu->ndropped;
+
+      for (j = 0; j < STACKPROF_NENTRIES; j++)
+        {
+          if (cpu->entries[j].depth != 0)
+            {
+              snap[nsnap++] = cpu->entries[j];
+            }
+        }
+
+      spin_unlock_irqrestore(&cpu->lock, flags);
+    }
+
+  qsort(snap, nsnap, sizeof(struct stackprof_entry_s), stackprof_compare);
+
+  for (i = 0, j = 0; i < nsnap; i++)
+    {
+      if (j > 0 && stackprof_compare(&snap[j - 1], &snap[i]) == 0)
+        {
+          snap[j - 1].count += snap[i].count;
+        }
+      else
+        {
+          snap[j++] = snap[i];
+        }
+    }
+
+  priv->snap  = snap;
+  priv->nsnap = j;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: stackprof_copy
+ ****************************************************************************/
+
+static bool stackprof_copy(FAR struct stackprof_file_s *priv, size_t len)
+{
+  size_t copysize;
+
+  copysize = procfs_memcpy(priv->line, len, priv->buffer,
+                           priv->remaining, &priv->offset);
+
+  priv->ncopied   += copysize;
+  priv->buffer    += copysize;
+  priv->remaining -= copysize;
+
+  return priv->remaining > 0;
+}
+
+/****************************************************************************
+ * Name: stackprof_frame
+ *
+ * Description:
+ *   Format one frame, by symbol name when the symbol table is available.
+ *
+ ****************************************************************************/
+
+static size_t stackprof_frame(FAR struct stackprof_file_s *priv,
+                              FAR void *addr)
+{
+#ifdef CONFIG_ALLSYMS
+  FAR const struct symtab_s *symbol;
+  size_t symbolsize;
+
+  symbol = allsyms_findbyvalue(addr, &symbolsize);
+  if (symbol != NULL)
+    {
+      return procfs_snprintf(priv->line, STACKPROF_LINELEN, ";%s",
+                             symbol->sym_name);
+    }
+#endif
+
+  return procfs_snprintf(priv->line, STACKPROF_LINELEN, ";%p", addr);
+}
+
+/****************************************************************************
+ * Name: stackprof_open
+ ****************************************************************************/
+
+static int stackprof_open(FAR struct file *filep, FAR const char *relpath,
+                          int oflags, mode_t mode)
+{
+  FAR struct stackprof_file_s *priv;
+  int ret;
+
+  finfo("Open '%s'\n", relpath);
+
+  /* Allocate a container to hold the file attributes */
+
+  priv = kmm_zalloc(sizeof(struct stackprof_file_s));
+  if (priv == NULL)
+    {
+      ferr("ERROR: Failed to allocate file attributes\n");
+      return -ENOMEM;
+    }
+
+  if ((oflags & O_RDONLY) != 0)
+    {
+      ret = stackprof_snapshot(priv);
+      if (ret < 0)
+        {
+          kmm_free(priv);
+          return ret;
+        }
+    }
+
+  /* Save the attributes as the open-specific state in filep->f_priv */
+
+  filep->f_priv = priv;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: stackprof_close
+ ****************************************************************************/
+
+static int stackprof_close(FAR struct file *filep)
+{
+  FAR struct stackprof_file_s *priv;
+
+  /* Recover our private data from the struct file instance */
+
+  priv = filep->f_priv;
+  DEBUGASSERT(priv);
+
+  /* Release the snapshot and the file attributes structure */
+
+  kmm_free(priv->snap);
+  kmm_free(priv);
+  filep->f_priv = NULL;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: stackprof_read
+ *
+ * Description:
+ *   Emit the snapshot in the folded stack format consumed by
+ *   flamegraph.pl and compatible tools:
+ *
+ *     <task>-<pid>;<outermost frame>;...;<innermost frame> <count>
+ *
+ *   The first line summarizes the session and is ignored by those tools.
+ *
+ ****************************************************************************/
+
+static ssize_t stackprof_read(FAR struct file *filep, FAR char *buffer,
+                              size_t buflen)
+{
+  FAR struct stackprof_file_s *priv;
+  size_t linesize;
+  size_t i;
+  int j;
+
+  finfo("buffer=%p buflen=%d\n", buffer, (int)buflen);
+
+  /* Recover our private data from the struct file instance */
+
+  priv = filep->f_priv;
+  DEBUGASSERT(priv);
+
+  /* Save the file offset and the user buffer information */
+
+  priv->offset    = filep->f_pos;
+  priv->buffer    = buffer;
+  priv->remaining = buflen;
+  priv->ncopied   = 0;
+
+  linesize = procfs_snprintf(priv->line, STACKPROF_LINELEN,
+                             "# %s %uHz samples %" PRIu32
+                             " dropped %" PRIu32 " stacks %zu\n",
+                             g_stackprof_running ? "running" : "stopped",
+                             g_stackprof_hz, priv->nsamples,
+                             priv->ndropped, priv->nsnap);
+  if (!stackprof_copy(priv, linesize))
+    {
+      goto out;
+    }
+
+  for (i = 0; i < priv->nsnap; i++)
+    {
+      FAR struct stackprof_entry_s *entry = &priv->snap[i];
+      FAR struct tcb_s *tcb = nxsched_get_tcb(entry->pid);
+
+      linesize = procfs_snprintf(priv->line, STACKPROF_LINELEN, "%s-%d",
+                                 tcb != NULL ? get_task_name(tcb) : "?",
+                                 (int)entry->pid);
+      if (!stackprof_copy(priv, linesize))
+        {
+          goto out;
+        }
+
+      for (j = entry->depth - 1; j >= 0; j--)
+        {
+          linesize = stackprof_frame(priv, entry->stack[j]);
+          if (!stackprof_copy(priv, linesize))
+            {
+              goto out;
+            }
+        }
+
+      linesize = procfs_snprintf(priv->line, STACKPROF_LINELEN,
+                                 " %" PRIu32 "\n", entry->count);
+      if (!stackprof_copy(priv, linesize))
+        {
+          goto out;
+        }
+    }
+
+out:
+
+  /* Update the file position */
+
+  filep->f_pos += priv->ncopied;
+  return priv->ncopied;
+}
+
+/****************************************************************************
+ * Name: stackprof_write
+ *
+ * Description:
+ *   Control the profiler:
+ *
+ *     start [hz] - Begin sampling, optionally at a new rate
+ *     stop       - Stop sampling, keep the collected stacks
+ *     reset      - Discard the collected stacks and counters
+ *
+ ****************************************************************************/
+
+static ssize_t stackprof_write(FAR struct file *filep,
+                               FAR const char *buffer, size_t buflen)
+{
+  char cmd[32];
+  size_t len;
+
+  len = MIN(buflen, sizeof(cmd) - 1);
+  memcpy(cmd, buffer, len);
+  cmd[len] = '\0';
+
+  if (strncmp(cmd, "start", 5) == 0)
+    {
+      unsigned long hz = strtoul(cmd + 5, NULL, 0);
+
+      if (hz > 0)
+        {
+          if (hz > TICK_PER_SEC)
+            {
+              return -EINVAL;
+            }
+
+          g_stackprof_hz = hz;
+        }
+
+      g_stackprof_ticks   = STACKPROF_TICKS(g_stackprof_hz);
+      g_stackprof_running = true;
+      wd_start(&g_stackprof_timer, g_stackprof_ticks, stackprof_timer, 0);
+    }
+  else if (strncmp(cmd, "stop", 4) == 0)
+    {
+      wd_cancel(&g_stackprof_timer);
+      g_stackprof_running = false;
+    }
+  else if (strncmp(cmd, "reset", 5) == 0)
+    {
+      stackprof_reset();
+    }
+  else
+    {
+      return -EINVAL;
+    }
+
+  return buflen;
+}
+
+/****************************************************************************
+ * Name: stackprof_dup
+ *
+ * Description:
+ *   Duplicate open file data in the new file structure.
+ *
+ ****************************************************************************/
+
+static int stackprof_dup(FAR const struct file *oldp, FAR struct file *newp)
+{
+  FAR struct stackprof_file_s *oldpriv;
+  FAR struct stackprof_file_s *newpriv;
+
+  finfo("Dup %p->%p\n", oldp, newp);
+
+  /* Recover our private data from the old struct file instance */
+
+  oldpriv = oldp->f_priv;
+  DEBUGASSERT(oldpriv);
+
+  /* Allocate a new container to hold the task and attribute selection */
+
+  newpriv = kmm_malloc(sizeof(struct stackprof_file_s));
+  if (newpriv == NULL)
+    {
+      ferr("ERROR: Failed to allocate file attributes\n");
+      return -ENOMEM;
+    }
+
+  /* The copy the file attributes from the old attributes to the new */
+
+  memcpy(newpriv, oldpriv, sizeof(struct stackprof_file_s));
+
+  if (oldpriv->snap != NULL)
+    {
+      size_t size = oldpriv->nsnap * sizeof(struct stackprof_entry_s);
+
+      newpriv->snap = kmm_malloc(MAX(size, 1));
+      if (newpriv->snap == NULL)
+        {
+          kmm_free(newpriv);
+          return -ENOMEM;
+        }
+
+      memcpy(newpriv->snap, oldpriv->snap, size);
+    }
+
+  /* Save the new attributes in the new file structure */
+
+  newp->f_priv = newpriv;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: stackprof_stat
+ *
+ * Description: Return information about a file or directory
+ *
+ ****************************************************************************/
+
+static int stackprof_stat(FAR const char *relpath, FAR struct stat *buf)
+{
+  memset(buf, 0, sizeof(struct stat));
+  buf->st_mode = S_IFREG | S_IROTH | S_IRGRP | S_IRUSR | S_IWUSR;
+  return OK;
+}
+
+#endif /* CONFIG_SCHED_STACKPROF */
+#endif /* !CONFIG_DISABLE_MOUNTPOINT && CONFIG_FS_PROCFS */
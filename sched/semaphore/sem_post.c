@@ -252,6 +252,8 @@ int nxsem_post(FAR sem_t *sem)
 {
   DEBUGASSERT(sem != NULL);
 
+  nxsched_lockstat_sem_release(sem);
+
   /* If this is a mutex, we can try to unlock the mutex in fast mode,
    * else try to get it in slow mode.
    */
@@ -101,6 +101,7 @@ static int nxsem_trywait_slow(FAR sem_t *sem)
     }
 
   nxsem_add_holder(sem);
+  nxsched_lockstat_sem_acquire(sem, false, 0);
   rtcb->waitobj = NULL;
   ret = OK;
 
@@ -146,6 +147,10 @@ int nxsem_trywait(FAR sem_t *sem)
   DEBUGASSERT(!OSINIT_IDLELOOP() || !sched_idletask() ||
               up_interrupt_context());
 
+  /* Remember the caller for the lock contention profiler */
+
+  nxsem_lockstat_site(return_address(0));
+
   /* If this is a mutex, we can try to get the mutex in fast mode,
    * else try to get it in slow mode.
    */
@@ -158,6 +163,7 @@ int nxsem_trywait(FAR sem_t *sem)
                                                 memory_order_acquire,
                                                 memory_order_relaxed))
         {
+          nxsched_lockstat_sem_acquire(sem, false, 0);
           return OK;
         }
 
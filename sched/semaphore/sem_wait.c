@@ -30,6 +30,7 @@
 #include <errno.h>
 #include <assert.h>
 
+#include <nuttx/clock.h>
 #include <nuttx/init.h>
 #include <nuttx/irq.h>
 #include <nuttx/arch.h>
@@ -97,6 +98,7 @@ static int nxsem_wait_slow(FAR sem_t *sem)
         }
 
       nxsem_add_holder(sem);
+      nxsched_lockstat_sem_acquire(sem, false, 0);
       rtcb->waitobj = NULL;
       ret = OK;
     }
@@ -110,6 +112,9 @@ static int nxsem_wait_slow(FAR sem_t *sem)
 #ifdef CONFIG_PRIORITY_INHERITANCE
       uint8_t prioinherit = sem->flags & SEM_PRIO_MASK;
 #endif
+#ifdef CONFIG_SCHED_LOCKSTAT
+      clock_t start = perf_gettime();
+#endif
 
       /* First, verify that the task is not already waiting on a
        * semaphore
@@ -201,6 +206,13 @@ static int nxsem_wait_slow(FAR sem_t *sem)
 
       ret = rtcb->errcode != OK ? -rtcb->errcode : OK;
 
+#ifdef CONFIG_SCHED_LOCKSTAT
+      if (ret == OK)
+        {
+          nxsched_lockstat_sem_acquire(sem, true, perf_gettime() - start);
+        }
+#endif
+
 #ifdef CONFIG_PRIORITY_INHERITANCE
       if (prioinherit != 0)
         {
@@ -252,6 +264,10 @@ int nxsem_wait(FAR sem_t *sem)
   DEBUGASSERT(sem != NULL && up_interrupt_context() == false);
   DEBUGASSERT(!OSINIT_IDLELOOP() || !sched_idletask());
 
+  /* Remember the caller for the lock contention profiler */
+
+  nxsem_lockstat_site(return_address(0));
+
   /* If this is a mutex, we can try to get the mutex in fast mode,
    * else try to get it in slow mode.
    */
@@ -264,6 +280,7 @@ int nxsem_wait(FAR sem_t *sem)
                                                 memory_order_acquire,
                                                 memory_order_relaxed))
         {
+          nxsched_lockstat_sem_acquire(sem, false, 0);
           return OK;
         }
     }
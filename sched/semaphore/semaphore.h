@@ -110,6 +110,27 @@ void nxsem_protect_post(FAR sem_t *sem);
 #  define nxsem_protect_post(sem)
 #endif
 
+/* Lock contention profiler hooks, see sched/sched/sched_lockstat.c */
+
+#ifdef CONFIG_SCHED_LOCKSTAT
+void nxsched_lockstat_sem_acquire(FAR sem_t *sem, bool contended,
+                                  clock_t wait);
+void nxsched_lockstat_sem_release(FAR sem_t *sem);
+#  define nxsem_lockstat_site(site) \
+     do \
+       { \
+         if (!up_interrupt_context()) \
+           { \
+             this_task()->lockstat_site = (site); \
+           } \
+       } \
+     while (0)
+#else
+#  define nxsched_lockstat_sem_acquire(sem, contended, wait)
+#  define nxsched_lockstat_sem_release(sem)
+#  define nxsem_lockstat_site(site)
+#endif
+
 #undef EXTERN
 #ifdef __cplusplus
 }